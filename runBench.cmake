@@ -0,0 +1,59 @@
+# run the per-kernel benchmarks, and write the results as a JSON array in BENCH_OUTPUT
+if( NOT TEST_PROGRAM )
+  message( FATAL_ERROR "Require TEST_PROGRAM to be defined" )
+endif( NOT TEST_PROGRAM )
+if( NOT TEST_ARGS )
+  message( FATAL_ERROR "Require TEST_ARGS to be defined" )
+endif( NOT TEST_ARGS )
+if( NOT BENCH_OUTPUT )
+  message( FATAL_ERROR "Require BENCH_OUTPUT to be defined" )
+endif( NOT BENCH_OUTPUT )
+if( NOT BENCH_SCALE )
+  set(BENCH_SCALE 1)
+endif( NOT BENCH_SCALE )
+if(NOT DEFINED ENV{INTERPRETER})
+    set(ENV{INTERPRETER} "")
+endif()
+
+set(ENV{BOX64_LOG} 0)
+set(ENV{BOX64_NOBANNER} 1)
+# native code size of each kernel, on Dynarec builds
+set(ENV{BOX64_DYNAREC_SYMSTATS} "bench_")
+if( EXISTS ${CMAKE_SOURCE_DIR}/x64lib )
+  set(ENV{LD_LIBRARY_PATH} ${CMAKE_SOURCE_DIR}/x64lib)
+else()
+  set(ENV{LD_LIBRARY_PATH} ${CMAKE_SOURCE_DIR}/../x64lib)
+endif( EXISTS ${CMAKE_SOURCE_DIR}/x64lib )
+
+execute_process(
+  COMMAND $ENV{INTERPRETER} ${TEST_PROGRAM} ${TEST_ARGS} -j ${BENCH_SCALE}
+  OUTPUT_VARIABLE BENCH_RESULT_OUT
+  ERROR_VARIABLE BENCH_ERROR
+  RESULT_VARIABLE BENCH_RESULT
+  )
+
+if( BENCH_RESULT )
+  message( FATAL_ERROR "Failed: Benchmark ${TEST_ARGS} exited != 0.\n${BENCH_ERROR}" )
+endif( BENCH_RESULT )
+
+# one object per kernel, with the Dynarec statistics of its function if any
+string(REGEX MATCHALL "{\"kernel\":\"[a-z0-9_]+\"[^\n]*}" KERNELS "${BENCH_RESULT_OUT}")
+if( NOT KERNELS )
+  message( FATAL_ERROR "Failed: Benchmark ${TEST_ARGS} did not report any kernel.\n${BENCH_RESULT_OUT}" )
+endif( NOT KERNELS )
+set(JSON "")
+foreach(KERNEL ${KERNELS})
+  string(REGEX REPLACE "^{\"kernel\":\"([a-z0-9_]+)\".*" "\\1" NAME "${KERNEL}")
+  string(REGEX MATCH "Dynarec symbol bench_${NAME}: ([0-9]+) blocks, ([0-9]+) x64 bytes, ([0-9]+) native bytes \\(([0-9.]+) native" STATS "${BENCH_RESULT_OUT}")
+  if( STATS )
+    string(REGEX REPLACE "}$" ",\"blocks\":${CMAKE_MATCH_1},\"x64_bytes\":${CMAKE_MATCH_2},\"native_bytes\":${CMAKE_MATCH_3},\"native_per_x64\":${CMAKE_MATCH_4}}" KERNEL "${KERNEL}")
+  endif( STATS )
+  message( STATUS "${KERNEL}" )
+  if( JSON )
+    set(JSON "${JSON},\n")
+  endif( JSON )
+  set(JSON "${JSON}  ${KERNEL}")
+endforeach()
+
+file(WRITE ${BENCH_OUTPUT} "[\n${JSON}\n]\n")
+message( STATUS "Results written in ${BENCH_OUTPUT}" )
@@ -68,8 +68,10 @@ void free_tlsdatasize(void* p)
     if(!p)
         return;
     tlsdatasize_t *data = (tlsdatasize_t*)p;
-    box_free(data->ptr);
-    box_free(p);
+    if(!recycleTLSData(data)) {
+        box_free(data->ptr);
+        box_free(p);
+    }
     if(my_context)
         pthread_setspecific(my_context->tlskey, NULL);
 }
@@ -304,6 +306,7 @@ void FreeBox64Context(box64context_t** context)
         FreeElfHeader(&ctx->elfs[i]);
     }
     box_free(ctx->elfs);
+    FreeElfRanges(ctx);
 
     FreeCollection(&ctx->box64_path);
     FreeCollection(&ctx->box64_ld_lib);
@@ -362,6 +365,7 @@ void FreeBox64Context(box64context_t** context)
         free_tlsdatasize(ptr);
     }
     pthread_key_delete(ctx->tlskey);
+    freeTLSDataPool();
 
     if(ctx->tlsdata)
         box_free(ctx->tlsdata);
@@ -411,6 +415,7 @@ int AddElfHeader(box64context_t* ctx, elfheader_t* head) {
     } else {
         ctx->elfs[idx] = head;
     }
+    RefreshElfRanges(ctx);
     printf_log(LOG_DEBUG, "Adding \"%s\" as #%d in elf collection\n", ElfName(head), idx);
     return idx;
 }
@@ -429,6 +434,7 @@ void RemoveElfHeader(box64context_t* ctx, elfheader_t* head) {
     for(int i=0; i<ctx->elfsize; ++i)
         if(ctx->elfs[i] == head) {
             ctx->elfs[i] = NULL;
+            RefreshElfRanges(ctx);
             return;
         }
 }
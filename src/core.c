@@ -24,6 +24,8 @@
 #include "fileutils.h"
 #include "box64context.h"
 #include "wine_tools.h"
+#include "zygote.h"
+#include "startprof.h"
 #include "elfloader.h"
 #include "custommem.h"
 #include "box64stack.h"
@@ -54,6 +56,7 @@ int box64_inprocessgpu = 0;
 int box64_cefdisablegpu = 0;
 int box64_cefdisablegpucompositor = 0;
 int box64_malloc_hack = 0;
+int box64_elfcache = 0;
 int box64_dynarec_test = 0;
 path_collection_t box64_addlibs = {0};
 int box64_maxcpu = 0;
@@ -74,6 +77,8 @@ int box64_dynarec_forced = 0;
 int box64_dynarec_bigblock = 1;
 int box64_dynarec_forward = 128;
 int box64_dynarec_strongmem = 0;
+int box64_dynarec_strongmem_local = 0;
+int box64_dynarec_strongmem_auto = 0;
 int box64_dynarec_x87double = 0;
 int box64_dynarec_div0 = 0;
 int box64_dynarec_fastnan = 1;
@@ -84,6 +89,12 @@ int box64_dynarec_bleeding_edge = 1;
 int box64_dynarec_tbb = 1;
 int box64_dynarec_wait = 1;
 int box64_dynarec_missing = 0;
+int box64_dynarec_fastpass = 0;
+int box64_dynarec_linkstate = 0;
+int box64_dynarec_uffd = 0;
+int box64_dynarec_tune = 0;
+int box64_dynarec_hugepage = 0;
+char* box64_dynarec_symstats = NULL;
 int box64_dynarec_aligned_atomics = 0;
 uintptr_t box64_nodynarec_start = 0;
 uintptr_t box64_nodynarec_end = 0;
@@ -123,6 +134,7 @@ int la64_lbt = 0;
 int la64_lam_bh = 0;
 int la64_lamcas = 0;
 int la64_scq = 0;
+int la64_lasx = 0;
 #endif
 #else   //DYNAREC
 int box64_dynarec = 0;
@@ -156,6 +168,7 @@ int box64_x87_no80bits = 0;
 int box64_sync_rounding = 0;
 int box64_shaext = 1;
 int box64_sse42 = 1;
+// the LA64 dynarec only translates part of AVX/AVX2 (no VPMOVMSKB, VPSHUFB, BMI, FMA...): opt-in with BOX64_AVX there
 #if defined(DYNAREC) && defined(ARM64)
 int box64_avx = 1;
 int box64_avx2 = 1;
@@ -409,6 +422,10 @@ HWCAP2_AFP
         box64_dynarec=0;
         return;
     }
+    char* p = getenv("BOX64_DYNAREC_ARM64NOEXT");
+    int noext = (p && p[0]!='0');
+    if(noext)
+        hwcap = HWCAP_ASIMD;    // only the mandatory ASIMD, to compare with the fallbacks
     if(hwcap&HWCAP_CRC32)
         arm64_crc32 = 1;
     if(hwcap&HWCAP_PMULL)
@@ -433,7 +450,7 @@ HWCAP2_AFP
     if(hwcap&HWCAP_FLAGM)
         arm64_flagm = 1;
     #endif
-    unsigned long hwcap2 = real_getauxval(AT_HWCAP2);
+    unsigned long hwcap2 = noext?0:real_getauxval(AT_HWCAP2);
     #ifdef HWCAP2_FLAGM2
     if(hwcap2&HWCAP2_FLAGM2)
         arm64_flagm2 = 1;
@@ -497,6 +514,8 @@ HWCAP2_AFP
             printf_log(LOG_INFO, " LAMCAS");
         if ((la64_scq = (cpucfg2 >> 30) & 0b1))
             printf_log(LOG_INFO, " SCQ");
+        if ((la64_lasx = (cpucfg2 >> 7) & 0b1))
+            printf_log(LOG_INFO, " LASX");
     }
 #elif defined(RV64)
     void RV64_Detect_Function();
@@ -716,6 +735,24 @@ void LoadLogEnv()
         if(box64_dynarec_strongmem)
             printf_log(LOG_INFO, "Dynarec will try to emulate a strong memory model%s\n", (box64_dynarec_strongmem==1)?" with limited performance loss":((box64_dynarec_strongmem>1)?" with more performance loss":""));
     }
+    p = getenv("BOX64_DYNAREC_STRONGMEM_LOCAL");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_strongmem_local = p[0]-'0';
+        }
+        if(box64_dynarec_strongmem_local)
+            printf_log(LOG_INFO, "Dynarec will not emulate strong memory model on [RSP+disp] and thread local accesses\n");
+    }
+    p = getenv("BOX64_DYNAREC_STRONGMEM_AUTO");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='3')
+                box64_dynarec_strongmem_auto = p[0]-'0';
+        }
+        if(box64_dynarec_strongmem_auto)
+            printf_log(LOG_INFO, "Dynarec will enable strong memory model emulation (level %d) when a 2nd thread is created\n", box64_dynarec_strongmem_auto);
+    }
     p = getenv("BOX64_DYNAREC_X87DOUBLE");
     if(p) {
         if(strlen(p)==1) {
@@ -828,6 +865,58 @@ void LoadLogEnv()
         if(box64_dynarec_missing)
             printf_log(LOG_INFO, "Dynarec will print missing opcodes\n");
     }
+    p = getenv("BOX64_DYNAREC_FASTPASS");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_fastpass = p[0]-'0';
+        }
+        if(box64_dynarec_fastpass)
+            printf_log(LOG_INFO, "Dynarec will try to emit blocks without the size pass\n");
+    }
+    p = getenv("BOX64_DYNAREC_LINKSTATE");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_linkstate = p[0]-'0';
+        }
+        if(box64_dynarec_linkstate)
+            printf_log(LOG_INFO, "Dynarec will specialize the entry of blocks on the flags state of their predecessor\n");
+    }
+    p = getenv("BOX64_DYNAREC_UFFD");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_uffd = p[0]-'0';
+        }
+        if(box64_dynarec_uffd)
+            printf_log(LOG_INFO, "Dynarec will use userfaultfd to detect writes to translated code\n");
+    }
+    p = getenv("BOX64_DYNAREC_TUNE");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='1')
+                box64_dynarec_tune = p[0]-'0';
+        }
+        if(box64_dynarec_tune) {
+            tune_stats.pid = getpid();
+            printf_log(LOG_INFO, "Dynarec will gather runtime statistics and write suggested settings in ~%s\n", TUNED_RCFILE);
+        }
+    }
+    p = getenv("BOX64_DYNAREC_HUGEPAGE");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='2')
+                box64_dynarec_hugepage = p[0]-'0';
+        }
+        if(box64_dynarec_hugepage)
+            printf_log(LOG_INFO, "Dynarec will put the translated code and the jump table on %s huge pages\n", (box64_dynarec_hugepage==2)?"explicit and transparent":"transparent");
+    }
+    p = getenv("BOX64_DYNAREC_SYMSTATS");
+    if(p && *p) {
+        box64_dynarec_symstats = box_strdup(p);
+        printf_log(LOG_INFO, "Dynarec will print translation statistics of symbols starting with \"%s\" at exit\n", box64_dynarec_symstats);
+    }
     p = getenv("BOX64_NODYNAREC");
     if(p) {
         if (strchr(p,'-')) {
@@ -1012,6 +1101,17 @@ void LoadLogEnv()
         if(!box64_dummy_crashhandler)
             printf_log(LOG_INFO, "Don't use dummy crashhandler lib\n");
     }
+    p = getenv("BOX64_ELFCACHE");
+    if(p) {
+        if(strlen(p)==1) {
+            if(p[0]>='0' && p[0]<='0'+2)
+                box64_elfcache = p[0]-'0';
+        }
+        if(box64_elfcache==1)
+            printf_log(LOG_INFO, "Use shareable image cache for elfs that cannot be mmaped directly\n");
+        else if(box64_elfcache==2)
+            printf_log(LOG_INFO, "Use shareable image cache for all elfs\n");
+    }
     p = getenv("BOX64_MALLOC_HACK");
     if(p) {
         if(strlen(p)==1) {
@@ -1341,6 +1441,7 @@ void PrintHelp() {
     printf("    '-v'|'--version' to print box64 version and quit\n");
     printf("    '-h'|'--help' to print this and quit\n");
     printf("    '-f'|'--flags' to print box64 flags and quit\n");
+    printf("    '--zygote' to stay resident and run the x86_64 programs exec'd by box64 processes using BOX64_ZYGOTE\n");
 }
 
 void addNewEnvVar(const char* s)
@@ -1651,6 +1752,9 @@ void endBox64()
     if(needed)
         for(int i=0; i<needed->size; ++i)
             DecRefCount(&needed->libs[i], emu);
+    #ifdef DYNAREC
+    WriteTunedParams();
+    #endif
     // all done, free context
     #ifndef STATICBUILD
     endMallocHook();
@@ -1716,6 +1820,15 @@ static void load_rcfiles()
         if(FileExist(tmp, IS_FILE))
             LoadRCFile(tmp);
     }
+    #ifdef DYNAREC
+    // tuned sections last, only for what the hand written ones don't set (and not when tuning again)
+    if(!box64_dynarec_tune && p) {
+        char tmp[4096];
+        snprintf(tmp, sizeof(tmp), "%s%s", p, TUNED_RCFILE);
+        if(FileExist(tmp, IS_FILE))
+            LoadTunedRCFile(tmp);
+    }
+    #endif
 }
 
 #ifndef STATICBUILD
@@ -1730,6 +1843,7 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     init_malloc_hook();
     #endif
     init_auxval(argc, argv, environ?environ:env);
+    StartProfInit();
     // analogue to QEMU_VERSION in qemu-user-mode emulation
     if(getenv("BOX64_VERSION")) {
         PrintBox64Version();
@@ -1754,9 +1868,21 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     }
 
     // check BOX64_LOG debug level
+    int sp = StartProfBegin("logenv", NULL);
     LoadLogEnv();
+    StartProfEnd(sp);
+    // resident zygote, only its forked children get past this, with the argv/env of the exec'd program
+    if(argc==4 && !strcmp(argv[1], "--zygote-proxy"))
+        ZygoteProxy(atoi(argv[2]), atoi(argv[3]));
+    if(argc>1 && !strcmp(argv[1], "--zygote")) {
+        ZygoteServer(&argc, &argv, &env);
+        StartProfInit();
+        LoadLogEnv();
+    }
     if(!getenv("BOX64_NORCFILES")) {
+        sp = StartProfBegin("rcfiles", NULL);
         load_rcfiles();
+        StartProfEnd(sp);
     }
     char* bashpath = NULL;
     {
@@ -1894,10 +2020,14 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
         box64_wine = 1;
     }
     // Create a new context
+    sp = StartProfBegin("context", NULL);
     my_context = NewBox64Context(argc - nextarg);
+    StartProfEnd(sp);
 
     // check BOX64_LD_LIBRARY_PATH and load it
+    sp = StartProfBegin("envvars", NULL);
     LoadEnvVars(my_context);
+    StartProfEnd(sp);
     // Append ld_list if it exist
     if(ld_libs_args!=-1)
         PrependList(&my_context->box64_ld_lib, argv[ld_libs_args], 1);
@@ -2057,7 +2187,9 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
         FreeCollection(&ld_preload);
         return -1;
     }
+    sp = StartProfBegin("parse", my_context->fullpath);
     elfheader_t *elf_header = LoadAndCheckElfHeader(f, my_context->fullpath, 1);
+    StartProfEnd(sp);
     if(!elf_header) {
         int x86 = my_context->box86path?FileIsX86ELF(my_context->fullpath):0;
         int script = my_context->bashpath?FileIsShell(my_context->fullpath):0;
@@ -2093,6 +2225,7 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     AddElfHeader(my_context, elf_header);
     *elfheader = elf_header;
 
+    sp = StartProfBegin("map", my_context->fullpath);
     if(CalcLoadAddr(elf_header)) {
         printf_log(LOG_NONE, "Error: Reading elf header of %s\n", my_context->fullpath);
         FreeElfHeader(&elf_header);
@@ -2110,6 +2243,7 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
         FreeCollection(&ld_preload);
         return -1;
     }
+    StartProfEnd(sp);
     if(ElfCheckIfUseTCMallocMinimal(elf_header)) {
         if(!box64_tcmalloc_minimal) {
             // need to reload with tcmalloc_minimal as a LD_PRELOAD!
@@ -2216,7 +2350,9 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     thread_set_emu(emu);
 
     // export symbols
+    sp = StartProfBegin("symbols", my_context->fullpath);
     AddSymbols(my_context->maplib, elf_header);
+    StartProfEnd(sp);
     if(wine_preloaded) {
         uintptr_t wineinfo = 0;
         int ver = -1, veropt = 0;
@@ -2235,6 +2371,7 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     }
     AddMainElfToLinkmap(elf_header);
     // pre-load lib if needed
+    sp = StartProfBegin("preload", NULL);
     if(ld_preload.size) {
         my_context->preload = new_neededlib(0);
         for(int i=0; i<ld_preload.size; ++i) {
@@ -2251,14 +2388,18 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
         }
     }
     FreeCollection(&ld_preload);
+    StartProfEnd(sp);
     // Call librarian to load all dependant elf
+    sp = StartProfBegin("needed", NULL);
     if(LoadNeededLibs(elf_header, my_context->maplib, 0, 0, 0, my_context, emu)) {
         printf_log(LOG_NONE, "Error: Loading needed libs in elf %s\n", my_context->argv[0]);
         FreeBox64Context(&my_context);
         return -1;
     }
+    StartProfEnd(sp);
     // reloc...
     printf_log(LOG_DEBUG, "And now export symbols / relocation for %s...\n", ElfName(elf_header));
+    sp = StartProfBegin("relocate", my_context->fullpath);
     if(RelocateElf(my_context->maplib, NULL, 0, 0, elf_header)) {
         printf_log(LOG_NONE, "Error: Relocating symbols in elf %s\n", my_context->argv[0]);
         FreeBox64Context(&my_context);
@@ -2266,15 +2407,19 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     }
     // and handle PLT
     RelocateElfPlt(my_context->maplib, NULL, 0, 0, elf_header);
+    StartProfEnd(sp);
     // deferred init
     setupTraceInit();
+    sp = StartProfBegin("deferredinit", NULL);
     RunDeferredElfInit(emu);
+    StartProfEnd(sp);
     // update TLS of main elf
     RefreshElfTLS(elf_header);
     // do some special case check, _IO_2_1_stderr_ and friends, that are setup by libc, but it's already done here, so need to do a copy
     ResetSpecialCaseMainElf(elf_header);
     // init...
     setupTrace();
+    StartProfDone();
 
     *emulator = emu;
 
@@ -31,6 +31,13 @@
 #include "dynarec/dynablock_private.h"
 #include "dynarec/native_lock.h"
 #include "dynarec/dynarec_next.h"
+#include "dynarec_native.h"
+#include "rcfile.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#include <linux/userfaultfd.h>
 
 #define USE_MMAP
 
@@ -367,18 +374,51 @@ static size_t roundSize(size_t size)
 #define UNLOCK_DYNAREC()
 #define UNLOCK_NODYNAREC()  UNLOCK_PROT()
 #endif
-static uintptr_t    defered_prot_p = 0;
-static size_t       defered_prot_sz = 0;
-static uint32_t     defered_prot_prot = 0;
+// mappings to register with setProtection at the next UNLOCK_PROT, when it cannot be done at once (mutex_prot might be locked)
+typedef struct defered_prot_s {
+    uintptr_t   p;
+    size_t      sz;
+    uint32_t    prot;
+} defered_prot_t;
+static defered_prot_t* defered_prot = NULL;   // with box_realloc, customMalloc might be the one defering
+static int          n_defered_prot = 0;
+static int          cap_defered_prot = 0;
 static sigset_t     critical_prot = {0};
+// both take mutex_blocks
+static void deferProtection(uintptr_t p, size_t sz, uint32_t prot)
+{
+    mutex_lock(&mutex_blocks);
+    if(n_defered_prot==cap_defered_prot) {
+        cap_defered_prot += 8;
+        defered_prot = (defered_prot_t*)box_realloc(defered_prot, cap_defered_prot*sizeof(defered_prot_t));
+    }
+    defered_prot[n_defered_prot].p = p;
+    defered_prot[n_defered_prot].sz = sz;
+    defered_prot[n_defered_prot].prot = prot;
+    ++n_defered_prot;
+    mutex_unlock(&mutex_blocks);
+}
+// the caller gets the array, to box_free once done
+static int popDeferedProtection(defered_prot_t** out)
+{
+    mutex_lock(&mutex_blocks);
+    int n = n_defered_prot;
+    *out = defered_prot;
+    defered_prot = NULL;
+    n_defered_prot = cap_defered_prot = 0;
+    mutex_unlock(&mutex_blocks);
+    return n;
+}
 #define LOCK_PROT()         sigset_t old_sig = {0}; pthread_sigmask(SIG_BLOCK, &critical_prot, &old_sig); mutex_lock(&mutex_prot)
 #define LOCK_PROT_READ()    sigset_t old_sig = {0}; pthread_sigmask(SIG_BLOCK, &critical_prot, &old_sig); mutex_lock(&mutex_prot)
-#define UNLOCK_PROT()       if(defered_prot_p) {                                \
-                                uintptr_t p = defered_prot_p; size_t sz = defered_prot_sz; uint32_t prot = defered_prot_prot; \
-                                defered_prot_p = 0;                             \
+#define UNLOCK_PROT()       if(n_defered_prot) {                                \
+                                defered_prot_t* defered;                        \
+                                int n = popDeferedProtection(&defered);         \
                                 pthread_sigmask(SIG_SETMASK, &old_sig, NULL);   \
                                 mutex_unlock(&mutex_prot);                      \
-                                setProtection(p, sz, prot);                     \
+                                for(int i_=0; i_<n; ++i_)                       \
+                                    setProtection(defered[i_].p, defered[i_].sz, defered[i_].prot); \
+                                box_free(defered);                              \
                             } else {                                            \
                                 pthread_sigmask(SIG_SETMASK, &old_sig, NULL);   \
                                 mutex_unlock(&mutex_prot);                      \
@@ -446,9 +486,7 @@ void* customMalloc(size_t size)
     if(mapallmem) {
         // defer the setProtection...
         //setProtection((uintptr_t)p, allocsize, PROT_READ | PROT_WRITE);
-        defered_prot_p = (uintptr_t)p;
-        defered_prot_sz = allocsize;
-        defered_prot_prot = PROT_READ|PROT_WRITE;
+        deferProtection((uintptr_t)p, allocsize, PROT_READ|PROT_WRITE);
     }
     return ret;
 }
@@ -552,6 +590,168 @@ dynablock_t* FindDynablockFromNativeAddress(void* p)
     return NULL;
 }
 
+// BOX64_DYNAREC_HUGEPAGE: the chunks of translated code are carved, in order, from one contiguous region aligned on 2M,
+// and the levels of the jump table from an arena of the same kind. Each 2M of the regions is mapped on first use,
+// as transparent huge page. With BOX64_DYNAREC_HUGEPAGE=2, explicit 2M pages (hugetlbfs) are used first, up to half the
+// pages that were free at start. A copy-on-write of those after a fork needs another free huge page, or the child gets a SIGBUS.
+#define HUGEPAGESZ      (2*1024*1024)
+#define HUGECODE_SZ     (1024*1024*1024LL)  // address space reserved for the translated code
+#define HUGEJMPTBL_SZ   (256*1024*1024LL)   // address space reserved for the jump table
+typedef struct hugeregion_s {
+    uintptr_t   start;
+    uintptr_t   end;
+    uintptr_t   cur;        // next free byte
+    uintptr_t   mapped;     // end of the part already mapped
+    int         prot;
+    int         hugetlb;    // explicit huge pages can be tried
+    int         failed;     // the reservation failed, don't try again
+    int         n_hugetlb;  // number of 2M mapped with hugetlbfs
+    int         n_thp;      // number of 2M mapped as transparent huge page
+} hugeregion_t;
+static hugeregion_t hugecode = {0};
+static hugeregion_t hugejmptbl = {0};
+static int          hugetlb_budget = -1;   // 2M hugetlbfs pages that can still be taken, shared by both regions
+
+static int freeHugeTLB(void)
+{
+    int ret = 0;
+    FILE* f = fopen("/sys/kernel/mm/hugepages/hugepages-2048kB/free_hugepages", "r");
+    if(f) {
+        if(fscanf(f, "%d", &ret)!=1)
+            ret = 0;
+        fclose(f);
+    }
+    return ret;
+}
+
+static int initHugeRegion(hugeregion_t* r, size_t size, int prot, const char* name)
+{
+    if(r->start)
+        return 1;
+    if(r->failed)
+        return 0;
+    // reserve 2M more, to align the start
+    void* p = internal_mmap(NULL, size+HUGEPAGESZ, PROT_NONE, MAP_ANONYMOUS|MAP_PRIVATE|MAP_NORESERVE, -1, 0);
+    if(p==MAP_FAILED) {
+        dynarec_log(LOG_INFO, "Cannot reserve %zu bytes for the huge page %s (%s)\n", size, name, strerror(errno));
+        r->failed = 1;
+        return 0;
+    }
+    uintptr_t start = ((uintptr_t)p+HUGEPAGESZ-1)&~(uintptr_t)(HUGEPAGESZ-1);
+    uintptr_t end = (uintptr_t)p+size+HUGEPAGESZ;
+    if(start!=(uintptr_t)p)
+        internal_munmap(p, start-(uintptr_t)p);
+    if(end!=start+size)
+        internal_munmap((void*)(start+size), end-(start+size));
+    r->start = r->cur = r->mapped = start;
+    r->end = start+size;
+    r->prot = prot;
+    #if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if(box64_dynarec_hugepage>1) {
+        // keep half of the pool for the rest of the system
+        int unset = -1;
+        __atomic_compare_exchange_n(&hugetlb_budget, &unset, freeHugeTLB()/2, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        r->hugetlb = hugetlb_budget?1:0;
+    }
+    #endif
+    dynarec_log(LOG_INFO, "Reserved %p-%p for the huge page %s%s\n", (void*)r->start, (void*)r->end, name, r->hugetlb?" (with HugeTLB)":"");
+    return 1;
+}
+
+// map the next size bytes of the region (size is a multiple of 2M)
+static int growHugeRegion(hugeregion_t* r, size_t size)
+{
+    if(r->mapped+size>r->end)
+        return 0;
+    void* p = MAP_FAILED;
+    #if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    if(r->hugetlb && __atomic_sub_fetch(&hugetlb_budget, size/HUGEPAGESZ, __ATOMIC_RELAXED)<0) {
+        __atomic_add_fetch(&hugetlb_budget, size/HUGEPAGESZ, __ATOMIC_RELAXED);
+        dynarec_log(LOG_INFO, "HugeTLB budget used, using transparent huge pages\n");
+        r->hugetlb = 0;
+    }
+    if(r->hugetlb) {
+        p = internal_mmap((void*)r->mapped, size, r->prot, MAP_ANONYMOUS|MAP_PRIVATE|MAP_FIXED|MAP_HUGETLB|(21<<MAP_HUGE_SHIFT), -1, 0);
+        if(p==MAP_FAILED) {
+            // pool exhausted, stay with THP from now on
+            dynarec_log(LOG_INFO, "No more HugeTLB pages (%s), using transparent huge pages\n", strerror(errno));
+            r->hugetlb = 0;
+            __atomic_add_fetch(&hugetlb_budget, size/HUGEPAGESZ, __ATOMIC_RELAXED);
+        } else
+            r->n_hugetlb += size/HUGEPAGESZ;
+    }
+    #endif
+    if(p==MAP_FAILED) {
+        p = internal_mmap((void*)r->mapped, size, r->prot, MAP_ANONYMOUS|MAP_PRIVATE|MAP_FIXED, -1, 0);
+        if(p==MAP_FAILED)
+            return 0;
+        #ifdef MADV_HUGEPAGE
+        madvise(p, size, MADV_HUGEPAGE);
+        #endif
+        r->n_thp += size/HUGEPAGESZ;
+    }
+    r->mapped += size;
+    return 1;
+}
+
+static void freeHugeRegion(hugeregion_t* r, const char* name)
+{
+    if(r->start) {
+        dynarec_log(LOG_INFO, "Huge page %s: %zu bytes used, %d x 2M with HugeTLB, %d x 2M with THP\n", name, (size_t)(r->cur-r->start), r->n_hugetlb, r->n_thp);
+        internal_munmap((void*)r->start, r->end-r->start);
+    }
+    memset(r, 0, sizeof(hugeregion_t));
+}
+
+// a new chunk of translated code, carved from the huge page region, that is mapped 2M at a time (so the chunks share
+// the huge pages). allocsize is rounded to the page size
+static void* allocHugeCode(size_t* allocsize)
+{
+    int isnew = !hugecode.start;
+    if(!initHugeRegion(&hugecode, HUGECODE_SZ, PROT_READ|PROT_WRITE|PROT_EXEC, "code cache"))
+        return MAP_FAILED;
+    if(isnew && mapallmem)
+        setProtection(hugecode.start, hugecode.end-hugecode.start, hugecode.prot);
+    size_t size = (*allocsize+box64_pagesize-1)&~(size_t)(box64_pagesize-1);
+    if(hugecode.cur+size>hugecode.mapped) {
+        size_t grow = (hugecode.cur+size-hugecode.mapped+HUGEPAGESZ-1)&~(size_t)(HUGEPAGESZ-1);
+        if(!growHugeRegion(&hugecode, grow))
+            return MAP_FAILED;
+    }
+    void* ret = (void*)hugecode.cur;
+    hugecode.cur += size;
+    *allocsize = size;
+    return ret;
+}
+
+// a level of the jump table, from the huge page arena if enabled (never freed until exit)
+static void* jmptblAlloc(size_t size)
+{
+    if(box64_dynarec_hugepage) {
+        void* ret = NULL;
+        mutex_lock(&mutex_blocks);
+        int isnew = !hugejmptbl.start;
+        if(initHugeRegion(&hugejmptbl, HUGEJMPTBL_SZ, PROT_READ|PROT_WRITE, "jump table"))
+            if(hugejmptbl.cur+size<=hugejmptbl.mapped || growHugeRegion(&hugejmptbl, HUGEPAGESZ)) {
+                ret = (void*)hugejmptbl.cur;
+                hugejmptbl.cur += size;
+            }
+        mutex_unlock(&mutex_blocks);
+        // mutex_prot might already be locked (when called from setJumpTableIfRef64)
+        if(isnew && hugejmptbl.start && mapallmem)
+            deferProtection(hugejmptbl.start, hugejmptbl.end-hugejmptbl.start, hugejmptbl.prot);
+        if(ret)
+            return ret;
+    }
+    return customMalloc(size);
+}
+static void jmptblFree(void* p)
+{
+    if((uintptr_t)p>=hugejmptbl.start && (uintptr_t)p<hugejmptbl.end)
+        return;
+    customFree(p);
+}
+
 #ifdef TRACE_MEMSTAT
 static uint64_t dynarec_allocated = 0;
 #endif
@@ -597,25 +797,21 @@ uintptr_t AllocDynarecMap(size_t size)
             mprotect(p, allocsize, PROT_READ | PROT_WRITE | PROT_EXEC);
             #else
             void* p=MAP_FAILED;
-            // disabling for now. explicit hugepage needs to be enabled to be used on userspace 
-            // with`/sys/kernel/mm/hugepages/hugepages-2048kB/nr_hugepages` as the number of allowaed 2M huge page
-            // At least with a 2M allocation, transparent huge page should kick-in
-            #if 0//def MAP_HUGETLB
-            if(allocsize==DYNMMAPSZ) {
-                p = internal_mmap(NULL, allocsize, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_ANONYMOUS|MAP_PRIVATE|MAP_HUGETLB, -1, 0);
-                if(p!=MAP_FAILED) printf_log(LOG_INFO, "Allocated a dynarec memory block with HugeTLB\n");
-                else printf_log(LOG_INFO, "Failled to allocated a dynarec memory block with HugeTLB (%s)\n", strerror(errno));
-            }
-            #endif
-            if(p==MAP_FAILED)
-                p = internal_mmap(NULL, allocsize, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+            // explicit hugepage needs to be enabled to be used on userspace
+            // with`/sys/kernel/mm/hugepages/hugepages-2048kB/nr_hugepages` as the number of allowaed 2M huge page,
+            // so it's only tried with BOX64_DYNAREC_HUGEPAGE=2. At least with a 2M allocation, transparent huge page should kick-in
+            if(box64_dynarec_hugepage)
+                p = allocHugeCode(&allocsize);  // already advised
             if(p==MAP_FAILED) {
-                dynarec_log(LOG_INFO, "Cannot create dynamic map of %zu bytes (%s)\n", allocsize, strerror(errno));
-                return 0;
+                p = internal_mmap(NULL, allocsize, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+                if(p==MAP_FAILED) {
+                    dynarec_log(LOG_INFO, "Cannot create dynamic map of %zu bytes (%s)\n", allocsize, strerror(errno));
+                    return 0;
+                }
+                #ifdef MADV_HUGEPAGE
+                madvise(p, allocsize, MADV_HUGEPAGE);
+                #endif
             }
-            #ifdef MADV_HUGEPAGE
-            madvise(p, allocsize, MADV_HUGEPAGE);
-            #endif
             #endif
 #ifdef TRACE_MEMSTAT
             dynarec_allocated += allocsize;
@@ -769,11 +965,11 @@ int isDBFromAddressRange(uintptr_t addr, size_t size)
 static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2, uintptr_t idx3, uintptr_t idx4)
 {
     if(box64_jmptbl4[idx4] == box64_jmptbldefault3) {
-        uintptr_t**** tbl = (uintptr_t****)customMalloc((1<<JMPTABL_SHIFT3)*sizeof(uintptr_t***));
+        uintptr_t**** tbl = (uintptr_t****)jmptblAlloc((1<<JMPTABL_SHIFT3)*sizeof(uintptr_t***));
         for(int i=0; i<(1<<JMPTABL_SHIFT3); ++i)
             tbl[i] = box64_jmptbldefault2;
         if(native_lock_storeifref(&box64_jmptbl4[idx4], tbl, box64_jmptbldefault3)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT3)*sizeof(uintptr_t***);
@@ -782,11 +978,11 @@ static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2,
 #endif
     }
     if(box64_jmptbl4[idx4][idx3] == box64_jmptbldefault2) {
-        uintptr_t*** tbl = (uintptr_t***)customMalloc((1<<JMPTABL_SHIFT2)*sizeof(uintptr_t**));
+        uintptr_t*** tbl = (uintptr_t***)jmptblAlloc((1<<JMPTABL_SHIFT2)*sizeof(uintptr_t**));
         for(int i=0; i<(1<<JMPTABL_SHIFT2); ++i)
             tbl[i] = box64_jmptbldefault1;
         if(native_lock_storeifref(&box64_jmptbl4[idx4][idx3], tbl, box64_jmptbldefault2)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT2)*sizeof(uintptr_t**);
@@ -795,11 +991,11 @@ static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2,
 #endif
     }
     if(box64_jmptbl4[idx4][idx3][idx2] == box64_jmptbldefault1) {
-        uintptr_t** tbl = (uintptr_t**)customMalloc((1<<JMPTABL_SHIFT1)*sizeof(uintptr_t*));
+        uintptr_t** tbl = (uintptr_t**)jmptblAlloc((1<<JMPTABL_SHIFT1)*sizeof(uintptr_t*));
         for(int i=0; i<(1<<JMPTABL_SHIFT1); ++i)
             tbl[i] = box64_jmptbldefault0;
         if(native_lock_storeifref(&box64_jmptbl4[idx4][idx3][idx2], tbl, box64_jmptbldefault1)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT1)*sizeof(uintptr_t*);
@@ -808,11 +1004,11 @@ static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2,
 #endif
     }
     if(box64_jmptbl4[idx4][idx3][idx2][idx1] == box64_jmptbldefault0) {
-        uintptr_t* tbl = (uintptr_t*)customMalloc((1<<JMPTABL_SHIFT0)*sizeof(uintptr_t));
+        uintptr_t* tbl = (uintptr_t*)jmptblAlloc((1<<JMPTABL_SHIFT0)*sizeof(uintptr_t));
         for(int i=0; i<(1<<JMPTABL_SHIFT0); ++i)
             tbl[i] = (uintptr_t)native_next;
         if(native_lock_storeifref(&box64_jmptbl4[idx4][idx3][idx2][idx1], tbl, box64_jmptbldefault0)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT0)*sizeof(uintptr_t);
@@ -826,11 +1022,11 @@ static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2,
 static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2, uintptr_t idx3)
 {
     if(box64_jmptbl3[idx3] == box64_jmptbldefault2) {
-        uintptr_t*** tbl = (uintptr_t***)customMalloc((1<<JMPTABL_SHIFT2)*sizeof(uintptr_t**));
+        uintptr_t*** tbl = (uintptr_t***)jmptblAlloc((1<<JMPTABL_SHIFT2)*sizeof(uintptr_t**));
         for(int i=0; i<(1<<JMPTABL_SHIFT2); ++i)
             tbl[i] = box64_jmptbldefault1;
         if(native_lock_storeifref(&box64_jmptbl3[idx3], tbl, box64_jmptbldefault2)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT2)*sizeof(uintptr_t**);
@@ -839,11 +1035,11 @@ static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2,
 #endif
     }
     if(box64_jmptbl3[idx3][idx2] == box64_jmptbldefault1) {
-        uintptr_t** tbl = (uintptr_t**)customMalloc((1<<JMPTABL_SHIFT1)*sizeof(uintptr_t*));
+        uintptr_t** tbl = (uintptr_t**)jmptblAlloc((1<<JMPTABL_SHIFT1)*sizeof(uintptr_t*));
         for(int i=0; i<(1<<JMPTABL_SHIFT1); ++i)
             tbl[i] = box64_jmptbldefault0;
         if(native_lock_storeifref(&box64_jmptbl3[idx3][idx2], tbl, box64_jmptbldefault1)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT1)*sizeof(uintptr_t*);
@@ -852,11 +1048,11 @@ static uintptr_t *create_jmptbl(uintptr_t idx0, uintptr_t idx1, uintptr_t idx2,
 #endif
     }
     if(box64_jmptbl3[idx3][idx2][idx1] == box64_jmptbldefault0) {
-        uintptr_t* tbl = (uintptr_t*)customMalloc((1<<JMPTABL_SHIFT0)*sizeof(uintptr_t));
+        uintptr_t* tbl = (uintptr_t*)jmptblAlloc((1<<JMPTABL_SHIFT0)*sizeof(uintptr_t));
         for(int i=0; i<(1<<JMPTABL_SHIFT0); ++i)
             tbl[i] = (uintptr_t)native_next;
         if(native_lock_storeifref(&box64_jmptbl3[idx3][idx2][idx1], tbl, box64_jmptbldefault0)!=tbl)
-            customFree(tbl);
+            jmptblFree(tbl);
 #ifdef TRACE_MEMSTAT
         else {
             jmptbl_allocated += (1<<JMPTABL_SHIFT0)*sizeof(uintptr_t);
@@ -1058,6 +1254,178 @@ uintptr_t getJumpAddress64(uintptr_t addr)
     #endif
 }
 
+#ifdef UFFDIO_WRITEPROTECT
+// userfaultfd backend for the write protection of the pages with dynablocks (BOX64_DYNAREC_UFFD)
+// Those pages keep PROT_WRITE and are write-protected with UFFDIO_WRITEPROTECT (PROT_UFFD in memprot). A write to
+// them stops the writing thread and is reported to uffd_handler, that unprotects the page and marks the blocks dirty,
+// so no SIGSEGV, no signal frame and no mprotect (and its TLB shootdown) are involved
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+static int uffd = -1;
+static int tryUnprotectDB(uintptr_t page);
+static void uffd_unprotect(uintptr_t addr, size_t size);
+
+// The writing thread might hold the prot lock or the dynablock locks, so it is woken up first, and the blocks are
+// marked dirty (and memprot updated) only when the prot lock can be taken: until then, the blocks of the page can
+// still run with the old code, a SMC is detected a bit later than with the SIGSEGV of mprotect
+static void* uffd_handler(void* arg)
+{
+    (void)arg;
+    uintptr_t repeated_page = 0;
+    struct uffd_msg msg[16];
+    uintptr_t* pending = NULL; // pages written, still to be marked
+    int npending = 0, cappending = 0;
+    while(1) {
+        if(npending) {
+            int i = 0;
+            while(i<npending)
+                if(tryUnprotectDB(pending[i]))
+                    pending[i] = pending[--npending];
+                else
+                    ++i;
+            // retry a bit later, unless there are new faults to handle first
+            struct pollfd pfd = {uffd, POLLIN, 0};
+            if(npending && poll(&pfd, 1, 1)<=0)
+                continue;
+        }
+        ssize_t n = read(uffd, msg, sizeof(msg));
+        if(n<0) {
+            if(errno==EINTR || errno==EAGAIN)
+                continue;
+            printf_log(LOG_NONE, "Warning, userfaultfd handler stopped (%s)\n", strerror(errno));
+            box_free(pending);
+            return NULL;
+        }
+        for(int i=0; i<(int)(n/sizeof(msg[0])); ++i) {
+            if(msg[i].event!=UFFD_EVENT_PAGEFAULT || !(msg[i].arg.pagefault.flags&UFFD_PAGEFAULT_FLAG_WP))
+                continue;
+            uintptr_t page = msg[i].arg.pagefault.address&~(box64_pagesize-1);
+            dynarec_log(LOG_DEBUG, "userfaultfd write on protected page %p\n", (void*)page);
+            if(repeated_page==page) {
+                SetHotPage(page);
+                TUNE_INC(hotpage);
+            } else
+                repeated_page = page;
+            TUNE_INC(smc);
+            // removing the write protection wakes the writing thread, without any lock
+            uffd_unprotect(page, box64_pagesize);
+            int known = 0;
+            for(int j=0; j<npending && !known; ++j)
+                known = (pending[j]==page);
+            if(known)
+                continue;
+            if(npending==cappending) {
+                cappending += 16;
+                pending = (uintptr_t*)box_realloc(pending, cappending*sizeof(uintptr_t));
+            }
+            pending[npending++] = page;
+        }
+    }
+    return NULL;
+}
+
+// called with the prot lock held, return 1 if the userfaultfd backend is ready
+static int uffd_init(void)
+{
+    if(uffd>=0)
+        return 1;
+    if(!box64_dynarec_uffd)
+        return 0;
+    // writes from the kernel (like a read() in a protected page) are handled too if allowed
+    int fd = syscall(__NR_userfaultfd, O_CLOEXEC);
+    if(fd<0)
+        fd = syscall(__NR_userfaultfd, O_CLOEXEC|UFFD_USER_MODE_ONLY);
+    struct uffdio_api api = {0};
+    api.api = UFFD_API;
+    api.features = UFFD_FEATURE_PAGEFAULT_FLAG_WP;
+    if(fd<0 || ioctl(fd, UFFDIO_API, &api) || !(api.ioctls&(1ULL<<_UFFDIO_REGISTER))) {
+        printf_log(LOG_INFO, "Warning, userfaultfd write-protect not available (%s), using mprotect for the dynablocks\n", strerror(errno));
+        if(fd>=0)
+            close(fd);
+        box64_dynarec_uffd = 0;
+        return 0;
+    }
+    // the handler is not an emulated thread, and must not get any signal
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    pthread_t thread;
+    uffd = fd;
+    if(pthread_create(&thread, NULL, uffd_handler, NULL)) {
+        printf_log(LOG_INFO, "Warning, cannot create the userfaultfd handler, using mprotect for the dynablocks\n");
+        close(fd);
+        uffd = -1;
+        box64_dynarec_uffd = 0;
+    } else
+        pthread_detach(thread);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    return (uffd>=0);
+}
+
+// return PROT_UFFD if the range is now write-protected by userfaultfd, 0 if mprotect needs to be used
+static uint32_t uffd_protect(uintptr_t addr, size_t size)
+{
+    if(!uffd_init())
+        return 0;
+    // only private anonymous (and shmem) mappings can be registered, not the file mappings
+    struct uffdio_register reg = {0};
+    reg.range.start = addr;
+    reg.range.len = size;
+    reg.mode = UFFDIO_REGISTER_MODE_WP;
+    if(ioctl(uffd, UFFDIO_REGISTER, &reg) || !(reg.ioctls&(1ULL<<_UFFDIO_WRITEPROTECT)))
+        return 0;
+    struct uffdio_writeprotect wp = {0};
+    wp.range.start = addr;
+    wp.range.len = size;
+    wp.mode = UFFDIO_WRITEPROTECT_MODE_WP;
+    if(ioctl(uffd, UFFDIO_WRITEPROTECT, &wp))
+        return 0;
+    return PROT_UFFD;
+}
+
+static void uffd_unprotect(uintptr_t addr, size_t size)
+{
+    struct uffdio_writeprotect wp = {0};
+    wp.range.start = addr;
+    wp.range.len = size;
+    wp.mode = 0;    // also wakes the threads waiting on the range
+    if(ioctl(uffd, UFFDIO_WRITEPROTECT, &wp))
+        dynarec_log(LOG_INFO, "Warning, cannot remove userfaultfd write-protection on %p-%p (%s)\n", (void*)addr, (void*)(addr+size), strerror(errno));
+}
+
+// a forked child doesn't inherit the userfaultfd registration (nor its handler), so go back to mprotect there
+static void uffd_atfork_child(void)
+{
+    if(uffd<0)
+        return;
+    close(uffd);
+    uffd = -1;
+    box64_dynarec_uffd = 0;
+    uintptr_t cur = 0, bend = 0;
+    uint32_t prot;
+    while(cur!=(uintptr_t)-1) {
+        if(rb_get_end(memprot, cur, &prot, &bend) && (prot&PROT_UFFD)) {
+            mprotect((void*)cur, bend-cur, prot&~(PROT_CUSTOM|PROT_WRITE));
+            rb_set(memprot, cur, bend, prot&~PROT_UFFD);
+        }
+        cur = bend;
+    }
+}
+#else
+static uint32_t uffd_protect(uintptr_t addr, size_t size) { (void)addr; (void)size; return 0; }
+static void uffd_unprotect(uintptr_t addr, size_t size) { (void)addr; (void)size; }
+#endif
+
+// remove the write access of a range that get dynablocks, and return the extra memprot flags
+static uint32_t protectDBRange(uintptr_t addr, size_t size, uint32_t prot)
+{
+    uint32_t ret = uffd_protect(addr, size);
+    if(!ret)
+        mprotect((void*)addr, size, prot&~(PROT_CUSTOM|PROT_WRITE));
+    return ret;
+}
+
 // Remove the Write flag from an adress range, so DB can be executed safely
 void protectDBJumpTable(uintptr_t addr, size_t size, void* jump, void* ref)
 {
@@ -1081,7 +1449,9 @@ void protectDBJumpTable(uintptr_t addr, size_t size, void* jump, void* ref)
             prot&=~PROT_CUSTOM;
             if(prot&PROT_WRITE) {
                 if(!dyn) 
-                    mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
+                    prot |= protectDBRange(cur, bend-cur, prot);
+                else
+                    prot |= dyn&PROT_UFFD;
                 prot |= PROT_DYNAREC;
             } else 
                 prot |= PROT_DYNAREC_R;
@@ -1118,7 +1488,9 @@ void protectDB(uintptr_t addr, uintptr_t size)
             prot&=~PROT_CUSTOM;
             if(prot&PROT_WRITE) {
                 if(!dyn) 
-                    mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
+                    prot |= protectDBRange(cur, bend-cur, prot);
+                else
+                    prot |= dyn&PROT_UFFD;
                 prot |= PROT_DYNAREC;
             } else 
                 prot |= PROT_DYNAREC_R;
@@ -1130,15 +1502,9 @@ void protectDB(uintptr_t addr, uintptr_t size)
     UNLOCK_PROT();
 }
 
-// Add the Write flag from an adress range, and mark all block as dirty
-void unprotectDB(uintptr_t addr, size_t size, int mark)
+// called with the prot lock held
+static void unprotectDBRange(uintptr_t cur, uintptr_t end, int mark)
 {
-    dynarec_log(LOG_DEBUG, "unprotectDB %p -> %p (mark=%d)\n", (void*)addr, (void*)(addr+size-1), mark);
-
-    uintptr_t cur = addr&~(box64_pagesize-1);
-    uintptr_t end = ALIGN(addr+size);
-
-    LOCK_PROT();
     while(cur!=end) {
         uint32_t prot = 0, oprot;
         uintptr_t bend = 0;
@@ -1157,7 +1523,10 @@ void unprotectDB(uintptr_t addr, size_t size, int mark)
                 prot&=~PROT_DYN;
                 if(mark)
                     cleanDBFromAddressRange(cur, bend-cur, 0);
-                mprotect((void*)cur, bend-cur, prot);
+                if(oprot&PROT_UFFD)
+                    uffd_unprotect(cur, bend-cur);
+                else
+                    mprotect((void*)cur, bend-cur, prot);
             } else if(prot&PROT_DYNAREC_R)
                 prot &= ~PROT_CUSTOM;
         }
@@ -1165,9 +1534,37 @@ void unprotectDB(uintptr_t addr, size_t size, int mark)
             rb_set(memprot, cur, bend, prot);
         cur = bend;
     }
+}
+
+// Add the Write flag from an adress range, and mark all block as dirty
+void unprotectDB(uintptr_t addr, size_t size, int mark)
+{
+    dynarec_log(LOG_DEBUG, "unprotectDB %p -> %p (mark=%d)\n", (void*)addr, (void*)(addr+size-1), mark);
+
+    uintptr_t cur = addr&~(box64_pagesize-1);
+    uintptr_t end = ALIGN(addr+size);
+
+    LOCK_PROT();
+    unprotectDBRange(cur, end, mark);
     UNLOCK_PROT();
 }
 
+#ifdef UFFDIO_WRITEPROTECT
+// same as unprotectDB(page, 1, 1), but return 0 instead of waiting for the prot lock
+static int tryUnprotectDB(uintptr_t page)
+{
+    sigset_t old_sig = {0};
+    pthread_sigmask(SIG_BLOCK, &critical_prot, &old_sig);
+    if(mutex_trylock(&mutex_prot)) {
+        pthread_sigmask(SIG_SETMASK, &old_sig, NULL);
+        return 0;
+    }
+    unprotectDBRange(page, page+box64_pagesize, 1);
+    UNLOCK_PROT();
+    return 1;
+}
+#endif
+
 int isprotectedDB(uintptr_t addr, size_t size)
 {
     dynarec_log(LOG_DEBUG, "isprotectedDB %p -> %p => ", (void*)addr, (void*)(addr+size-1));
@@ -1228,9 +1625,18 @@ void updateProtection(uintptr_t addr, size_t size, uint32_t prot)
         uint32_t dyn=(oprot&PROT_DYN);
         if(!(dyn&PROT_NEVERPROT)) {
             if(dyn && (prot&PROT_WRITE)) {   // need to remove the write protection from this block
-                dyn = PROT_DYNAREC;
-                mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
+                // the userfaultfd write-protection stays on the pages with a new protection
+                if(dyn&PROT_UFFD)
+                    dyn = PROT_DYNAREC|PROT_UFFD;
+                else {
+                    dyn = PROT_DYNAREC;
+                    mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
+                }
             } else if(dyn && !(prot&PROT_WRITE)) {
+                #ifdef DYNAREC
+                if(dyn&PROT_UFFD)
+                    uffd_unprotect(cur, bend-cur);
+                #endif
                 dyn = PROT_DYNAREC_R;
             }
         }
@@ -1501,6 +1907,9 @@ static void atfork_child_custommem(void)
 {
     // (re)init mutex if it was lock before the fork
     init_mutexes();
+    #if defined(DYNAREC) && defined(UFFDIO_WRITEPROTECT)
+    uffd_atfork_child();
+    #endif
 }
 
 void my_reserveHighMem()
@@ -1616,6 +2025,7 @@ void fini_custommem_helper(box64context_t *ctx)
     inited = 0;
 #ifdef DYNAREC
     if(box64_dynarec) {
+        PrintDynarecStats();
         dynarec_log(LOG_DEBUG, "Free global Dynarecblocks\n");
         mmaplist_t* head = mmaplist;
         mmaplist = NULL;
@@ -1646,16 +2056,18 @@ void fini_custommem_helper(box64context_t *ctx)
                     if(box64_jmptbl3[i3][i2]!=box64_jmptbldefault1) {
                         for (int i1=0; i1<(1<<JMPTABL_SHIFT1); ++i1)
                             if(box64_jmptbl3[i3][i2][i1]!=box64_jmptbldefault0) {
-                                customFree(box64_jmptbl3[i3][i2][i1]);
+                                jmptblFree(box64_jmptbl3[i3][i2][i1]);
                             }
-                        customFree(box64_jmptbl3[i3][i2]);
+                        jmptblFree(box64_jmptbl3[i3][i2]);
                     }
-                customFree(box64_jmptbl3[i3]);
+                jmptblFree(box64_jmptbl3[i3]);
             }
         #ifdef JMPTABL_SHIFT4
-                customFree(box64_jmptbl4[i4]);
+                jmptblFree(box64_jmptbl4[i4]);
             }
         #endif
+        freeHugeRegion(&hugejmptbl, "jump table");
+        freeHugeRegion(&hugecode, "code cache");
     }
     kh_destroy(lockaddress, lockaddress);
     lockaddress = NULL;
@@ -1695,6 +2107,56 @@ int isLockAddress(uintptr_t addr)
     return (k==kh_end(lockaddress))?0:1;
 }
 
+// LOCK'd access that are split across a 16bytes boundary cannot be done atomicaly by the Dynarec, so they take the
+// small locks of the (one or two) 16bytes granules they touch, lowest index first. Two of them touching the same bytes
+// share a granule, so they are serialized, but nothing serializes them with a non-split atomic access to those bytes
+uint8_t lock_stripes[(LOCK_STRIPES+1)<<LOCK_STRIPE_SHIFT] __attribute__((aligned(64))) = {0};
+
+// with LSE2, an unaligned access inside a 16bytes window is still single-copy atomic for the CAS and LD<op> of the Dynarec
+int isSplitLock(uintptr_t addr, int size)
+{
+    #ifdef ARM64
+    if(arm64_uscat)
+        return ((addr&15)+size)>16;
+    #endif
+    return (addr&(size-1))?1:0;
+}
+
+static void takeStripe(uint8_t* stripe)
+{
+    while(__atomic_exchange_n(stripe, 1, __ATOMIC_ACQUIRE))
+        while(__atomic_load_n(stripe, __ATOMIC_RELAXED))
+            sched_yield();
+}
+
+void lockStripe(uintptr_t held[2], uintptr_t addr, int size)
+{
+    uintptr_t first = LOCK_STRIPE_IDX(addr);
+    uintptr_t last = LOCK_STRIPE_IDX(addr+size-1);
+    if(first>last) {    // the stripes wrap around
+        uintptr_t tmp = first;
+        first = last;
+        last = tmp;
+    }
+    takeStripe(&lock_stripes[first<<LOCK_STRIPE_SHIFT]);
+    held[0] = (uintptr_t)&lock_stripes[first<<LOCK_STRIPE_SHIFT];
+    if(last!=first) {
+        takeStripe(&lock_stripes[last<<LOCK_STRIPE_SHIFT]);
+        held[1] = (uintptr_t)&lock_stripes[last<<LOCK_STRIPE_SHIFT];
+    }
+}
+
+void unlockStripe(uintptr_t held[2])
+{
+    uint8_t* first = (uint8_t*)held[0];
+    uint8_t* last = (uint8_t*)held[1];
+    held[0] = held[1] = 0;
+    if(last)
+        __atomic_store_n(last, 0, __ATOMIC_RELEASE);
+    if(first)
+        __atomic_store_n(first, 0, __ATOMIC_RELEASE);
+}
+
 #endif
 
 void* internal_mmap(void *addr, unsigned long length, int prot, int flags, int fd, ssize_t offset)
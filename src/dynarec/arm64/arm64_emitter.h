@@ -454,6 +454,13 @@ int convert_bitmask(uint64_t bitmask);
 #define LDXRxw(Rt, Rn)                  EMIT(MEMX_gen(2+rex.w, 1, 31, Rn, Rt))
 #define STXRxw(Rs, Rt, Rn)              EMIT(MEMX_gen(2+rex.w, 0, Rs, Rn, Rt))
 
+// STORE Release
+#define STLR_gen(size, Rn, Rt)              ((size)<<30 | 0b001000<<24 | 1<<23 | 0b11111<<16 | 1<<15 | 0b11111<<10 | (Rn)<<5 | (Rt))
+#define STLRB(Rt, Rn)                   EMIT(STLR_gen(0b00, Rn, Rt))
+#define STLRH(Rt, Rn)                   EMIT(STLR_gen(0b01, Rn, Rt))
+#define STLRw(Rt, Rn)                   EMIT(STLR_gen(0b10, Rn, Rt))
+#define STLRx(Rt, Rn)                   EMIT(STLR_gen(0b11, Rn, Rt))
+
 // Prefetch
 #define PRFM_register(Rm, option, S, Rn, Rt)    (0b11<<30 | 0b111<<27 | 0b10<<22 | 1<<21 | (Rm)<<16 | (option)<<13 | (S)<<12 | 0b10<<10 | (Rn)<<5 | (Rt))
 #define PLD_L1_KEEP(Rn, Rm)             EMIT(PRFM_register(Rm, 0b011, 0, Rn, 0b00000))
@@ -1001,24 +1008,24 @@ int convert_bitmask(uint64_t bitmask);
 #define VEXTQ_8(Rd, Rn, Rm, index)          EMIT(EXT_vector(1, Rm, index, Rn, Rd))
 
 // Shift Left and Insert (not touching lower part of dest)
-#define SLI_vector(Q, immh, immb, Rn, Rd)   ((Q)<<30 | 1<<29 | 0b011110<<23 | (immh)<<19 | (immb)<<16 | 0b01010<<1 | 1<<10 | (Rn)<<5 | (Rd))
-#define VSLIQ_8(Vd, Vn, shift)              EMIT(VSLI_vector(1, 0b0001, (shift)&7, Vn, Vd))
-#define VSLIQ_16(Vd, Vn, shift)             EMIT(VSLI_vector(1, 0b0010 | ((shift)>>3)&1, (shift)&7, Vn, Vd))
-#define VSLIQ_32(Vd, Vn, shift)             EMIT(VSLI_vector(1, 0b0100 | (((shift)>>3)&3), (shift)&7, Vn, Vd))
-#define VSLIQ_64(Vd, Vn, shift)             EMIT(VSLI_vector(1, 0b1000 | (((shift)>>3)&7), (shift)&7, Vn, Vd))
-#define VSLI_8(Vd, Vn, shift)               EMIT(VSLI_vector(0, 0b0001, (shift)&7, Vn, Vd))
-#define VSLI_16(Vd, Vn, shift)              EMIT(VSLI_vector(0, 0b0010 | ((shift)>>3)&1, (shift)&7, Vn, Vd))
-#define VSLI_32(Vd, Vn, shift)              EMIT(VSLI_vector(0, 0b0100 | (((shift)>>3)&3), (shift)&7, Vn, Vd))
+#define SLI_vector(Q, immh, immb, Rn, Rd)   ((Q)<<30 | 1<<29 | 0b011110<<23 | (immh)<<19 | (immb)<<16 | 0b01010<<11 | 1<<10 | (Rn)<<5 | (Rd))
+#define VSLIQ_8(Vd, Vn, shift)              EMIT(SLI_vector(1, 0b0001, (shift)&7, Vn, Vd))
+#define VSLIQ_16(Vd, Vn, shift)             EMIT(SLI_vector(1, 0b0010 | ((shift)>>3)&1, (shift)&7, Vn, Vd))
+#define VSLIQ_32(Vd, Vn, shift)             EMIT(SLI_vector(1, 0b0100 | (((shift)>>3)&3), (shift)&7, Vn, Vd))
+#define VSLIQ_64(Vd, Vn, shift)             EMIT(SLI_vector(1, 0b1000 | (((shift)>>3)&7), (shift)&7, Vn, Vd))
+#define VSLI_8(Vd, Vn, shift)               EMIT(SLI_vector(0, 0b0001, (shift)&7, Vn, Vd))
+#define VSLI_16(Vd, Vn, shift)              EMIT(SLI_vector(0, 0b0010 | ((shift)>>3)&1, (shift)&7, Vn, Vd))
+#define VSLI_32(Vd, Vn, shift)              EMIT(SLI_vector(0, 0b0100 | (((shift)>>3)&3), (shift)&7, Vn, Vd))
 
 // Shift Right and Insert (not touching higher part of dest)
-#define SRI_vector(Q, immh, immb, Rn, Rd)   ((Q)<<30 | 1<<29 | 0b011110<<23 | (immh)<<19 | (immb)<<16 | 0b01000<<1 | 1<<10 | (Rn)<<5 | (Rd))
-#define VSRIQ_8(Vd, Vn, shift)              EMIT(VSRI_vector(1, 0b0001, (shift)&7, Vn, Vd))
-#define VSRIQ_16(Vd, Vn, shift)             EMIT(VSRI_vector(1, 0b0010 | ((shift)>>3)&1, (shift)&7, Vn, Vd))
-#define VSRIQ_32(Vd, Vn, shift)             EMIT(VSRI_vector(1, 0b0100 | (((shift)>>3)&3), (shift)&7, Vn, Vd))
-#define VSRIQ_64(Vd, Vn, shift)             EMIT(VSRI_vector(1, 0b1000 | (((shift)>>3)&7), (shift)&7, Vn, Vd))
-#define VSRI_8(Vd, Vn, shift)               EMIT(VSRI_vector(0, 0b0001, (shift)&7, Vn, Vd))
-#define VSRI_16(Vd, Vn, shift)              EMIT(VSRI_vector(0, 0b0010 | ((shift)>>3)&1, (shift)&7, Vn, Vd))
-#define VSRI_32(Vd, Vn, shift)              EMIT(VSRI_vector(0, 0b0100 | (((shift)>>3)&3), (shift)&7, Vn, Vd))
+#define SRI_vector(Q, immh, immb, Rn, Rd)   ((Q)<<30 | 1<<29 | 0b011110<<23 | (immh)<<19 | (immb)<<16 | 0b01000<<11 | 1<<10 | (Rn)<<5 | (Rd))
+#define VSRIQ_8(Vd, Vn, shift)              EMIT(SRI_vector(1, 0b0001, (8-(shift))&7, Vn, Vd))
+#define VSRIQ_16(Vd, Vn, shift)             EMIT(SRI_vector(1, 0b0010 | (((16-(shift))>>3)&1), (16-(shift))&7, Vn, Vd))
+#define VSRIQ_32(Vd, Vn, shift)             EMIT(SRI_vector(1, 0b0100 | (((32-(shift))>>3)&3), (32-(shift))&7, Vn, Vd))
+#define VSRIQ_64(Vd, Vn, shift)             EMIT(SRI_vector(1, 0b1000 | (((64-(shift))>>3)&7), (64-(shift))&7, Vn, Vd))
+#define VSRI_8(Vd, Vn, shift)               EMIT(SRI_vector(0, 0b0001, (8-(shift))&7, Vn, Vd))
+#define VSRI_16(Vd, Vn, shift)              EMIT(SRI_vector(0, 0b0010 | (((16-(shift))>>3)&1), (16-(shift))&7, Vn, Vd))
+#define VSRI_32(Vd, Vn, shift)              EMIT(SRI_vector(0, 0b0100 | (((32-(shift))>>3)&3), (32-(shift))&7, Vn, Vd))
 
 // Reverse elements in 64-bit doublewords (vector). This instruction reverses the order of 8-bit, 16-bit, or 32-bit elements in each doubleword
 #define VREVx_vector(Q, U, size, o0, Rn, Rd)    ((Q)<<30 | (U)<<29 | 0b01110<<24 | (size)<<22 | 0b10000<<17 | (o0)<<12 | 0b10<<10 | (Rn)<<5 | (Rd))
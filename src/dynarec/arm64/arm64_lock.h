@@ -78,6 +78,12 @@ extern uint8_t arm64_lock_get_b(void*p);
 // atomic get (with memory barrier)
 extern uint32_t arm64_lock_get_d(void*p);
 
+// CASAL of val at [p] if [p] is ref, return 0 if ok, 1 if not. Needs LSE. With LSE2, p can be unaligned inside a 16bytes window
+extern int arm64_lock_cas_d(void* p, uint32_t ref, uint32_t val);
+
+// CASAL of val at [p] if [p] is ref, return 0 if ok, 1 if not. Needs LSE. With LSE2, p can be unaligned inside a 16bytes window
+extern int arm64_lock_cas_dd(void* p, uint64_t ref, uint64_t val);
+
 // atomic get (with memory barrier)
 extern void* arm64_lock_get_dd(void*p);
 
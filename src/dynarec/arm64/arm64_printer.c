@@ -370,6 +370,10 @@ const char* arm64_print(uint32_t opcode, uintptr_t addr)
             snprintf(buff, sizeof(buff), "STLXR%s %s, %s, [%s]", (sf==0)?"B":((sf==1)?"H":""), (sf==2)?Wt[Rs]:Xt[Rs], (sf==2)?Wt[Rt]:Xt[Rt], XtSp[Rn]);
         return buff;
     }
+    if(isMask(opcode, "ff00100010011111111111nnnnnttttt", &a)) {
+        snprintf(buff, sizeof(buff), "STLR%s %s, [%s]", (sf==0)?"B":((sf==1)?"H":""), (sf==3)?Xt[Rt]:Wt[Rt], XtSp[Rn]);
+        return buff;
+    }
 
     if(isMask(opcode, "ff0010000L0sssss011111nnnnnttttt", &a)) {
         if(a.L)
@@ -1642,6 +1646,18 @@ const char* arm64_print(uint32_t opcode, uintptr_t addr)
         snprintf(buff, sizeof(buff), "SHL%s V%d.%s, V%d.%s, #%d", a.Q?"Q":"", Rd, Vd, Rn, Vd, sh);
         return buff;
     }
+    // SLI / SRI
+    if(isMask(opcode, "0Q1011110hhhhiii010r01nnnnnddddd", &a) && (a.h != 0b0000)) {
+        const char* Y[] = {"8B", "16B", "4H", "8H", "2S", "4S", "??", "2D"};
+        int sz = 3;
+        if((a.h&0b1111)==0b0001) sz=0;
+        else if((a.h&0b1110)==0b0010) sz=1;
+        else if((a.h&0b1100)==0b0100) sz=2;
+        int sh = a.r?((((a.h)<<3)|(imm)) - (8<<sz)):((16<<sz) - (((a.h)<<3)|(imm)));
+        const char* Vd = Y[(sz<<1)|a.Q];
+        snprintf(buff, sizeof(buff), "S%cI%s V%d.%s, V%d.%s, #%d", a.r?'L':'R', a.Q?"Q":"", Rd, Vd, Rn, Vd, sh);
+        return buff;
+    }
 
     // DUP
     if(isMask(opcode, "0Q001110000iiiii000001nnnnnddddd", &a)) {
@@ -1569,6 +1569,28 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 INST_NAME("REP MOVSB");
                 CBZx_NEXT(xRCX);
                 TBNZ_MARK2(xFlags, F_DF);
+                {
+                    // 32 bytes at a time, unless RDI is less than 32 bytes after RSI (the copy then repeats a pattern)
+                    // RSI, RDI and RCX are updated after each chunk, so a fault restarts the opcode from a valid state
+                    // (the CPYF* of FEAT_MOPS can leave them in an implementation defined form that doesn't map back to x86)
+                    int v0 = fpu_get_scratch(dyn, ninst);
+                    int v1 = fpu_get_scratch(dyn, ninst);
+                    SUBx_REG(x1, xRDI, xRSI);
+                    CMPSx_U12(x1, 32);
+                    B_MARK(cCC);
+                    MARKF;
+                    CMPSx_U12(xRCX, 32);
+                    B_MARK(cCC);
+                    VLDR128_U12(v0, xRSI, 0);
+                    VLDR128_U12(v1, xRSI, 16);
+                    VSTR128_U12(v0, xRDI, 0);
+                    VSTR128_U12(v1, xRDI, 16);
+                    ADDx_U12(xRSI, xRSI, 32);
+                    ADDx_U12(xRDI, xRDI, 32);
+                    SUBx_U12(xRCX, xRCX, 32);
+                    CBNZx_MARKF(xRCX);
+                    B_NEXT_nocond;
+                }
                 MARK;   // Part with DF==0
                 LDRB_S9_postindex(x1, xRSI, 1);
                 STRB_S9_postindex(x1, xRDI, 1);
@@ -1597,6 +1619,26 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 INST_NAME("REP MOVSD");
                 CBZx_NEXT(xRCX);
                 TBNZ_MARK2(xFlags, F_DF);
+                {
+                    // 32 bytes at a time, unless RDI is less than 32 bytes after RSI
+                    int v0 = fpu_get_scratch(dyn, ninst);
+                    int v1 = fpu_get_scratch(dyn, ninst);
+                    SUBx_REG(x1, xRDI, xRSI);
+                    CMPSx_U12(x1, 32);
+                    B_MARK(cCC);
+                    MARKF;
+                    CMPSx_U12(xRCX, rex.w?4:8);
+                    B_MARK(cCC);
+                    VLDR128_U12(v0, xRSI, 0);
+                    VLDR128_U12(v1, xRSI, 16);
+                    VSTR128_U12(v0, xRDI, 0);
+                    VSTR128_U12(v1, xRDI, 16);
+                    ADDx_U12(xRSI, xRSI, 32);
+                    ADDx_U12(xRDI, xRDI, 32);
+                    SUBx_U12(xRCX, xRCX, rex.w?4:8);
+                    CBNZx_MARKF(xRCX);
+                    B_NEXT_nocond;
+                }
                 MARK;   // Part with DF==0
                 LDRxw_S9_postindex(x1, xRSI, rex.w?8:4);
                 STRxw_S9_postindex(x1, xRDI, rex.w?8:4);
@@ -1629,14 +1671,49 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 SETFLAGS(X_ALL, SF_SET_PENDING);
                 CBZx_NEXT(xRCX);
                 TBNZ_MARK2(xFlags, F_DF);
+                {
+                    // 16 bytes at a time while RSI is aligned and RDI+15 is in the same page,
+                    // so nothing after the stopping byte can fault. The bytewise loop finds the exact stop
+                    int v0 = fpu_get_scratch(dyn, ninst);
+                    int v1 = fpu_get_scratch(dyn, ninst);
+                    TSTx_mask(xRSI, 1, 0, 3);   // mask=15
+                    B_MARK(cNE);
+                    MARKF;
+                    CMPSx_U12(xRCX, 16);
+                    B_MARK(cCC);
+                    ANDx_mask(x3, xRDI, 1, 0, 11);  // mask=0xfff
+                    CMPSx_U12(x3, 0xff0);
+                    B_MARK(cHI);
+                    VLDR128_U12(v0, xRSI, 0);
+                    VLDR128_U12(v1, xRDI, 0);
+                    VCMEQQ_8(v0, v0, v1);
+                    if(rep==1) {
+                        UMAXVQ_8(v0, v0);
+                        VMOVBto(x3, v0, 0);
+                        CBNZw_MARK(x3);
+                    } else {
+                        UMINVQ_8(v0, v0);
+                        VMOVBto(x3, v0, 0);
+                        CBZw_MARK(x3);
+                    }
+                    ADDx_U12(xRSI, xRSI, 16);
+                    ADDx_U12(xRDI, xRDI, 16);
+                    SUBx_U12(xRCX, xRCX, 16);
+                    CBNZx_MARKF(xRCX);
+                    LDURB_I9(x1, xRSI, -1);
+                    LDURB_I9(x2, xRDI, -1);
+                    B_MARK3_nocond;
+                }
                 MARK;   // Part with DF==0
                 LDRB_S9_postindex(x1, xRSI, 1);
                 LDRB_S9_postindex(x2, xRDI, 1);
                 SUBx_U12(xRCX, xRCX, 1);
                 CMPSw_REG(x1, x2);
                 B_MARK3((rep==1)?cEQ:cNE);
-                CBNZx_MARK(xRCX);
-                B_MARK3_nocond;
+                CBZx_MARK3(xRCX);
+                TSTx_mask(xRSI, 1, 0, 3);
+                B_MARK(cNE);
+                B_MARKF_nocond;
                 MARK2;  // Part with DF==1
                 LDRB_S9_postindex(x1, xRSI, -1);
                 LDRB_S9_postindex(x2, xRDI, -1);
@@ -1722,6 +1799,20 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 INST_NAME("REP STOSB");
                 CBZx_NEXT(xRCX);
                 TBNZ_MARK2(xFlags, F_DF);
+                {
+                    // 32 bytes at a time (not SET* of FEAT_MOPS, for the same reason as REP MOVSB)
+                    int v0 = fpu_get_scratch(dyn, ninst);
+                    VDUPQB(v0, xRAX);
+                    MARKF;
+                    CMPSx_U12(xRCX, 32);
+                    B_MARK(cCC);
+                    VSTR128_U12(v0, xRDI, 0);
+                    VSTR128_U12(v0, xRDI, 16);
+                    ADDx_U12(xRDI, xRDI, 32);
+                    SUBx_U12(xRCX, xRCX, 32);
+                    CBNZx_MARKF(xRCX);
+                    B_NEXT_nocond;
+                }
                 MARK;   // Part with DF==0
                 STRB_S9_postindex(xRAX, xRDI, 1);
                 SUBx_U12(xRCX, xRCX, 1);
@@ -1747,6 +1838,24 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 INST_NAME("REP STOSD");
                 CBZx_NEXT(xRCX);
                 TBNZ_MARK2(xFlags, F_DF);
+                {
+                    // 32 bytes at a time
+                    int v0 = fpu_get_scratch(dyn, ninst);
+                    if(rex.w) {
+                        VDUPQD(v0, xRAX);
+                    } else {
+                        VDUPQS(v0, xRAX);
+                    }
+                    MARKF;
+                    CMPSx_U12(xRCX, rex.w?4:8);
+                    B_MARK(cCC);
+                    VSTR128_U12(v0, xRDI, 0);
+                    VSTR128_U12(v0, xRDI, 16);
+                    ADDx_U12(xRDI, xRDI, 32);
+                    SUBx_U12(xRCX, xRCX, rex.w?4:8);
+                    CBNZx_MARKF(xRCX);
+                    B_NEXT_nocond;
+                }
                 MARK;   // Part with DF==0
                 STRxw_S9_postindex(xRAX, xRDI, rex.w?8:4);
                 SUBx_U12(xRCX, xRCX, 1);
@@ -1815,13 +1924,43 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 CBZx_NEXT(xRCX);
                 UBFXw(x1, xRAX, 0, 8);
                 TBNZ_MARK2(xFlags, F_DF);
+                {
+                    // 16 bytes at a time once RDI is aligned, so nothing after the stopping byte can fault.
+                    // The bytewise loop finds the exact stop
+                    int v0 = fpu_get_scratch(dyn, ninst);
+                    int v1 = fpu_get_scratch(dyn, ninst);
+                    VDUPQB(v0, x1);
+                    TSTx_mask(xRDI, 1, 0, 3);   // mask=15
+                    B_MARK(cNE);
+                    MARKF;
+                    CMPSx_U12(xRCX, 16);
+                    B_MARK(cCC);
+                    VLDR128_U12(v1, xRDI, 0);
+                    VCMEQQ_8(v1, v1, v0);
+                    if(rep==1) {
+                        UMAXVQ_8(v1, v1);
+                        VMOVBto(x3, v1, 0);
+                        CBNZw_MARK(x3);
+                    } else {
+                        UMINVQ_8(v1, v1);
+                        VMOVBto(x3, v1, 0);
+                        CBZw_MARK(x3);
+                    }
+                    ADDx_U12(xRDI, xRDI, 16);
+                    SUBx_U12(xRCX, xRCX, 16);
+                    CBNZx_MARKF(xRCX);
+                    LDURB_I9(x2, xRDI, -1);
+                    B_MARK3_nocond;
+                }
                 MARK;   // Part with DF==0
                 LDRB_S9_postindex(x2, xRDI, 1);
                 SUBx_U12(xRCX, xRCX, 1);
                 CMPSw_REG(x1, x2);
                 B_MARK3((rep==1)?cEQ:cNE);
-                CBNZx_MARK(xRCX);
-                B_MARK3_nocond;
+                CBZx_MARK3(xRCX);
+                TSTx_mask(xRDI, 1, 0, 3);
+                B_MARK(cNE);
+                B_MARKF_nocond;
                 MARK2;  // Part with DF==1
                 LDRB_S9_postindex(x2, xRDI, -1);
                 SUBx_U12(xRCX, xRCX, 1);
@@ -56,7 +56,7 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
     MAYUSE(s0);
     MAYUSE(j64);
     MAYUSE(cacheupd);
-    #if STEP > 1
+    #if STEP > 0
     static const int8_t mask_shift8[] = { -7, -6, -5, -4, -3, -2, -1, 0 };
     #endif
 
@@ -710,21 +710,21 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         VEXTQ_8(q0, q0, q0, 8);
                         VREV64Q_32(q0, q0);
                     } else {
-                        if(MODREG) {
-                            ed = (nextop&7)+(rex.b<<3);
-                            sse_reflect_reg(dyn, ninst, ed);
-                            ADDx_U12(x2, xEmu, offsetof(x64emu_t, xmm[ed]));
-                        } else {
-                            SMREAD();
-                            addr = geted(dyn, addr, ninst, nextop, &wback, x2, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
-                            if(wback!=x2) {
-                                MOVx_REG(x2, wback);
-                            }
-                        }
-                        GETG;
-                        sse_forget_reg(dyn, ninst, gd);
-                        ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[gd]));
-                        CALL(sha1msg2, -1);
+                        // W16..W18 in parallel, then W19 that needs W16, with ROL 1 as USHR+SLI
+                        GETGX(q0, 1);
+                        GETEX(q1, 0, 0);
+                        v0 = fpu_get_scratch(dyn, ninst);
+                        v1 = fpu_get_scratch(dyn, ninst);
+                        d0 = fpu_get_scratch(dyn, ninst);
+                        VEORQ(d0, d0, d0);
+                        VEXTQ_8(v0, d0, q1, 12);    // 0, W15, W14, W13
+                        VEORQ(v0, v0, q0);
+                        VSHRQ_32(v1, v0, 31);
+                        VSLIQ_32(v1, v0, 1);        // W16 in high
+                        VEXTQ_8(v1, v1, d0, 12);    // W16, 0, 0, 0
+                        VEORQ(v0, v0, v1);
+                        VSHRQ_32(q0, v0, 31);
+                        VSLIQ_32(q0, v0, 1);
                     }
                     break;
                 case 0xCB:
@@ -781,21 +781,21 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         GETEX(q1, 0, 0);
                         SHA256SU0(q0, q1);
                     } else {
-                        if(MODREG) {
-                            ed = (nextop&7)+(rex.b<<3);
-                            sse_reflect_reg(dyn, ninst, ed);
-                            ADDx_U12(x2, xEmu, offsetof(x64emu_t, xmm[ed]));
-                        } else {
-                            SMREAD();
-                            addr = geted(dyn, addr, ninst, nextop, &wback, x2, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
-                            if(wback!=x2) {
-                                MOVx_REG(x2, wback);
-                            }
-                        }
-                        GETG;
-                        sse_forget_reg(dyn, ninst, gd);
-                        ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[gd]));
-                        CALL(sha256msg1, -1);
+                        // W0..W3 + sigma0(W1..W4), sigma0(x) = ROR(x, 7) ^ ROR(x, 18) ^ (x >> 3)
+                        GETGX(q0, 1);
+                        GETEX(q1, 0, 0);
+                        v0 = fpu_get_scratch(dyn, ninst);
+                        d0 = fpu_get_scratch(dyn, ninst);
+                        d1 = fpu_get_scratch(dyn, ninst);
+                        VEXTQ_8(v0, q0, q1, 4);
+                        VSHRQ_32(d0, v0, 7);
+                        VSLIQ_32(d0, v0, 32-7);
+                        VSHRQ_32(d1, v0, 18);
+                        VSLIQ_32(d1, v0, 32-18);
+                        VEORQ(d0, d0, d1);
+                        VSHRQ_32(d1, v0, 3);
+                        VEORQ(d0, d0, d1);
+                        VADDQ_32(q0, q0, d0);
                     }
                     break;
                 case 0xCD:
@@ -815,21 +815,28 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         SHA256SU1(q0, v1, d0);  // low is destination high
                         VEXTQ_8(q0, d0, q0, 8);
                     } else {
-                        if(MODREG) {
-                            ed = (nextop&7)+(rex.b<<3);
-                            sse_reflect_reg(dyn, ninst, ed);
-                            ADDx_U12(x2, xEmu, offsetof(x64emu_t, xmm[ed]));
-                        } else {
-                            SMREAD();
-                            addr = geted(dyn, addr, ninst, nextop, &wback, x2, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 0);
-                            if(wback!=x2) {
-                                MOVx_REG(x2, wback);
-                            }
+                        // W16/W17 from W14/W15, then W18/W19 from W16/W17, sigma1(x) = ROR(x, 17) ^ ROR(x, 19) ^ (x >> 10)
+                        GETGX(q0, 1);
+                        GETEX(q1, 0, 0);
+                        v0 = fpu_get_scratch(dyn, ninst);
+                        v1 = fpu_get_scratch(dyn, ninst);
+                        d0 = fpu_get_scratch(dyn, ninst);
+                        d1 = fpu_get_scratch(dyn, ninst);
+                        VEORQ(v1, v1, v1);
+                        for(int i=0; i<2; ++i) {
+                            if(i)
+                                VEXTQ_8(v0, v1, q0, 8); // 0, 0, W16, W17
+                            else
+                                VEXTQ_8(v0, q1, v1, 8); // W14, W15, 0, 0
+                            VSHRQ_32(d0, v0, 17);
+                            VSLIQ_32(d0, v0, 32-17);
+                            VSHRQ_32(d1, v0, 19);
+                            VSLIQ_32(d1, v0, 32-19);
+                            VEORQ(d0, d0, d1);
+                            VSHRQ_32(d1, v0, 10);
+                            VEORQ(d0, d0, d1);
+                            VADDQ_32(q0, q0, d0);
                         }
-                        GETG;
-                        sse_forget_reg(dyn, ninst, gd);
-                        ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[gd]));
-                        CALL(sha256msg2, -1);
                     }
                     break;
 
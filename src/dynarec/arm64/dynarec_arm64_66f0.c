@@ -156,14 +156,12 @@ uintptr_t dynarec64_66F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int n
                             B_MARK_nocond;
                             // Unaligned version
                             MARK3;
+                            LOCK_STRIPE(wback, 2, x5, x3, x4, x1);
                             LDRH_U12(x1, wback, 0);
-                            LDAXRB(x3, wback); // dummy read, to arm the write...
                             CMPSw_REG(x6, x1);
-                            B_MARK(cNE);
-                            // EAX == Ed
-                            STLXRB(x4, gd, wback);
-                            CBNZx_MARK3(x4);
-                            STRH_U12(gd, wback, 0);
+                            CSELw(x4, gd, x1, cEQ); // write back the old value if EAX != Ed
+                            STRH_U12(x4, wback, 0);
+                            UNLOCK_STRIPE(x5, x4);
                         }
                     }
                     SMDMB();
@@ -309,14 +307,12 @@ uintptr_t dynarec64_66F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int n
                         SMDMB();
                         if(!ALIGNED_ATOMICH) {
                             B_NEXT_nocond;
-                            MARK;   // unaligned! also, not enough
+                            MARK;   // unaligned, and maybe split across a 16bytes boundary
+                            LOCK_STRIPE(wback, 2, x6, x3, x4, x1);
                             LDRH_U12(x1, wback, 0);
-                            LDAXRB(x4, wback);
-                            BFIw(x1, x4, 0, 8); // re-inject
                             emit_add16(dyn, ninst, x1, x5, x3, x4);
-                            STLXRB(x3, x1, wback);
-                            CBNZx_MARK(x3);
-                            STRH_U12(x1, wback, 0);    // put the whole value
+                            STRH_U12(x1, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
                             SMDMB();
                         }
                     }
@@ -473,14 +469,12 @@ uintptr_t dynarec64_66F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int n
                         SMDMB();
                         if(!ALIGNED_ATOMICH) {
                             B_NEXT_nocond;
-                            MARK;   // unaligned! also, not enough
+                            MARK;   // unaligned, and maybe split across a 16bytes boundary
+                            LOCK_STRIPE(wback, 2, x6, x3, x4, x1);
                             LDRH_U12(x1, wback, 0);
-                            LDAXRB(x4, wback);
-                            BFIw(x1, x4, 0, 8); // re-inject
                             emit_sub16(dyn, ninst, x1, x5, x3, x4);
-                            STLXRB(x3, x1, wback);
-                            CBNZx_MARK(x3);
-                            STRH_U12(x1, wback, 0);    // put the whole value
+                            STRH_U12(x1, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
                             SMDMB();
                         }
                     }
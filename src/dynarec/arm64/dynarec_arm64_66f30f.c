@@ -47,7 +47,7 @@ uintptr_t dynarec64_66F30F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int
     MAYUSE(eb1);
     MAYUSE(eb2);
     MAYUSE(j64);
-    #if STEP > 1
+    #if STEP > 0
     static const int8_t mask_shift8[] = { -7, -6, -5, -4, -3, -2, -1, 0 };
     static const int8_t mask_string8[] = { 7, 6, 5, 4, 3, 2, 1, 0 };
     static const int8_t mask_string16[] = { 15, 14, 13, 12, 11, 10, 9, 8 };
@@ -56,7 +56,7 @@ uintptr_t dynarec64_AVX_66_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip,
     MAYUSE(s0);
     MAYUSE(j64);
     MAYUSE(cacheupd);
-    #if STEP > 1
+    #if STEP > 0
     static const int8_t mask_shift8[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
     #endif
 
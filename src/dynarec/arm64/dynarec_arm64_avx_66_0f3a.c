@@ -56,7 +56,7 @@ uintptr_t dynarec64_AVX_66_0F3A(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
     MAYUSE(s0);
     MAYUSE(j64);
     MAYUSE(cacheupd);
-    #if STEP > 1
+    #if STEP > 0
     static const int8_t round_round[] = { 0, 2, 1, 3};
     #endif
 
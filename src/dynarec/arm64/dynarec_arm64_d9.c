@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include <errno.h>
+#include <math.h>
 
 #include "debug.h"
 #include "box64context.h"
@@ -270,29 +271,53 @@ uintptr_t dynarec64_D9(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
 
         case 0xF0:
             INST_NAME("F2XM1");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             CALL(native_f2xm1, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            CALL_D(exp2, v1, -1, v1);
+            s0 = fpu_get_scratch(dyn, ninst);
+            FMOVD_8(s0, 0b01110000);    // 1.0
+            FSUBD(v1, v1, s0);
+            #endif
             break;
         case 0xF1:
             INST_NAME("FYL2X");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             x87_forget(dyn, ninst, x1, x2, 1);
             CALL(native_fyl2x, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            v2 = x87_get_st(dyn, ninst, x1, x2, 1, NEON_CACHE_ST_D);
+            s0 = fpu_get_scratch(dyn, ninst);
+            CALL_D(log2, v1, -1, s0);
+            FMULD(v2, v2, s0);
+            #endif
             X87_POP_OR_FAIL(dyn, ninst, x3);
             break;
         case 0xF2:
             INST_NAME("FPTAN");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             CALL(native_ftan, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            CALL_D(tan, v1, -1, v1);
+            LDRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            BFCw(x1, 10, 1);    // C2 = 0
+            STRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            #endif
             if(PK(0)==0xdd && PK(1)==0xd8) {
                 MESSAGE(LOG_DUMP, "Optimized next DD D8 fstp st0, st0, not emitting 1\n");
                 u8 = F8;
@@ -308,12 +333,18 @@ uintptr_t dynarec64_D9(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             break;
         case 0xF3:
             INST_NAME("FPATAN");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             x87_forget(dyn, ninst, x1, x2, 1);
             CALL(native_fpatan, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            v2 = x87_get_st(dyn, ninst, x1, x2, 1, NEON_CACHE_ST_D);
+            CALL_D(atan2, v2, v1, v2);
+            #endif
             X87_POP_OR_FAIL(dyn, ninst, x3);
             break;
         case 0xF4:
@@ -407,12 +438,22 @@ uintptr_t dynarec64_D9(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             break;
         case 0xF9:
             INST_NAME("FYL2XP1");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             x87_forget(dyn, ninst, x1, x2, 1);
             CALL(native_fyl2xp1, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            v2 = x87_get_st(dyn, ninst, x1, x2, 1, NEON_CACHE_ST_D);
+            s0 = fpu_get_scratch(dyn, ninst);
+            FMOVD_8(s0, 0b01110000);    // 1.0
+            FADDD(s0, v1, s0);
+            CALL_D(log2, s0, -1, s0);
+            FMULD(v2, v2, s0);
+            #endif
             X87_POP_OR_FAIL(dyn, ninst, x3);
             break;
         case 0xFA:
@@ -426,12 +467,22 @@ uintptr_t dynarec64_D9(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             break;
         case 0xFB:
             INST_NAME("FSINCOS");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, 0);
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 1);
             CALL(native_fsincos, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, NEON_CACHE_ST_D);
+            v2 = x87_get_st(dyn, ninst, x1, x2, 1, NEON_CACHE_ST_D);
+            CALL_D(cos, v2, -1, v1);
+            CALL_D(sin, v2, -1, v2);
+            LDRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            BFCw(x1, 10, 1);    // C2 = 0
+            STRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            #endif
             break;
         case 0xFC:
             INST_NAME("FRNDINT");
@@ -453,28 +504,68 @@ uintptr_t dynarec64_D9(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             break;
         case 0xFD:
             INST_NAME("FSCALE");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             x87_forget(dyn, ninst, x1, x2, 1);
             CALL(native_fscale, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            v2 = x87_get_st(dyn, ninst, x1, x2, 1, NEON_CACHE_ST_D);
+            s0 = fpu_get_scratch(dyn, ninst);
+            // fast path when trunc(ST1) is in [-1022, 1023], so 2^ST1 is a normal double
+            FCVTZSwD(x2, v2);
+            ADDw_U12(x3, x2, 1022);
+            CMPSw_U12(x3, 2045);
+            B_MARK(cHI);
+            FCMPD(v2, v2);
+            B_MARK(cVS);    // ST1 is NaN
+            ADDw_U12(x3, x3, 1);
+            LSLx(x3, x3, 52);
+            FMOVDx(s0, x3);
+            FMULD(v1, v1, s0);
+            B_NEXT_nocond;
+            MARK;
+            FRINTZD(s0, v2);
+            CALL_D(exp2, s0, -1, s0);
+            FMULD(s0, v1, s0);
+            FCMPD_0(v1);
+            FCSELD(v1, v1, s0, cEQ);    // ST0 is left untouched if 0
+            #endif
             break;
         case 0xFE:
             INST_NAME("FSIN");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             CALL(native_fsin, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            CALL_D(sin, v1, -1, v1);
+            LDRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            BFCw(x1, 10, 1);    // C2 = 0
+            STRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            #endif
             break;
         case 0xFF:
             INST_NAME("FCOS");
+            #if 0
             MESSAGE(LOG_DUMP, "Need Optimization\n");
             i1 = x87_stackcount(dyn, ninst, x1);
             x87_forget(dyn, ninst, x1, x2, 0);
             CALL(native_fcos, -1);
             x87_unstackcount(dyn, ninst, x1, i1);
+            #else
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, NEON_CACHE_ST_D);
+            CALL_D(cos, v1, -1, v1);
+            LDRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            BFCw(x1, 10, 1);    // C2 = 0
+            STRH_U12(x1, xEmu, offsetof(x64emu_t, sw));
+            #endif
             break;
         default:
             DEFAULT;
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "arm64_printer.h"
+#include "dynarec_arm64_private.h"
+#include "dynarec_arm64_functions.h"
+#include "dynarec_arm64_helper.h"
+
+static const uint8_t pcmpstr_idx8[16] __attribute__((aligned(16))) = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+static const uint16_t pcmpstr_idx16[8] __attribute__((aligned(16))) = { 0, 1, 2, 3, 4, 5, 6, 7 };
+static const uint8_t pcmpstr_bits8[16] __attribute__((aligned(16))) = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+
+// build in vd a mask of the elements of vs that are before the first 0 element (implicit length), t is scratch, zero is a zeroed register
+static void emit_pcmpstr_implicit_valid(dynarec_arm_t* dyn, int ninst, int vd, int vs, int t, int zero, int word)
+{
+    if(word) {
+        CMEQQ_0_16(vd, vs);
+    } else {
+        CMEQQ_0_8(vd, vs);
+    }
+    // propagate the "zero found" lanes upward
+    for(int k=(word?2:1); k<16; k<<=1) {
+        VEXTQ_8(t, zero, vd, 16-k);    // vd shifted up by k bytes
+        VORRQ(vd, vd, t);
+    }
+    VMVNQ(vd, vd);
+}
+
+// build in vd a mask of the elements with an index lower than |len| (explicit length), len is clamped in place, using s as scratch
+static void emit_pcmpstr_explicit_valid(dynarec_arm_t* dyn, int ninst, rex_t rex, int vd, int vidx, int len, int s, int word)
+{
+    int n = word?8:16;
+    ADDSxw_U12(len, len, 0);
+    Bcond(cPL, 4+4);
+    NEGxw_REG(len, len);
+    MOV32w(s, n);
+    CMPSxw_REG(len, s);
+    CSELxw(len, len, s, cLT);
+    if(word) {
+        VDUPQH(vd, len);
+        VCMGTQ_16(vd, vd, vidx);
+    } else {
+        VDUPQB(vd, len);
+        VCMGTQ_8(vd, vd, vidx);
+    }
+}
+
+// emit PCMPxSTRx string compare of v0 (Gx, the "reg" operand) and v1 (Ex, the "mem" operand) with control imm8
+// explicit length are taken from RAX/RDX if expl is set. IntRes2 is returned as a bitmask in s1, flags are set
+// return the scratch register holding IntRes2 as a full element mask (for PCMPxSTRM)
+int emit_pcmpstr(dynarec_arm_t* dyn, int ninst, rex_t rex, int v0, int v1, uint8_t imm8, int expl, int s1, int s2, int s3, int s4)
+{
+    int word = imm8&1;
+    int n = word?8:16;
+    int esz = word?2:1;
+    int vr = fpu_get_scratch(dyn, ninst);  // valid elements of reg
+    int vm = fpu_get_scratch(dyn, ninst);  // valid elements of mem
+    int acc = fpu_get_scratch(dyn, ninst);
+    int t = fpu_get_scratch(dyn, ninst);
+    int t2 = fpu_get_scratch(dyn, ninst);
+    int ones;
+    MAYUSE(esz);
+    MAYUSE(t2);
+    MAYUSE(ones);
+    // compute validity masks
+    if(expl) {
+        TABLE64(s1, word?((uintptr_t)&pcmpstr_idx16):((uintptr_t)&pcmpstr_idx8));
+        VLDR128_U12(t, s1, 0);
+        MOVxw_REG(s2, xRAX);
+        emit_pcmpstr_explicit_valid(dyn, ninst, rex, vr, t, s2, s4, word);
+        MOVxw_REG(s3, xRDX);
+        emit_pcmpstr_explicit_valid(dyn, ninst, rex, vm, t, s3, s4, word);
+    } else {
+        VEORQ(acc, acc, acc);
+        emit_pcmpstr_implicit_valid(dyn, ninst, vr, v0, t, acc, word);
+        emit_pcmpstr_implicit_valid(dyn, ninst, vm, v1, t, acc, word);
+    }
+    // aggregate to IntRes1
+    switch((imm8>>2)&3) {
+        case 0b00:  // equal any
+            VEORQ(acc, acc, acc);
+            for(int i=0; i<n; ++i) {
+                if(word) {
+                    VDUPQ_16(t, v0, i);
+                    VCMEQQ_16(t, t, v1);
+                    VDUPQ_16(t2, vr, i);
+                } else {
+                    VDUPQ_8(t, v0, i);
+                    VCMEQQ_8(t, t, v1);
+                    VDUPQ_8(t2, vr, i);
+                }
+                VANDQ(t, t, t2);
+                VORRQ(acc, acc, t);
+            }
+            VANDQ(acc, acc, vm);
+            break;
+        case 0b01:  // ranges
+            VEORQ(acc, acc, acc);
+            for(int i=0; i<n; i+=2) {
+                switch(imm8&3) {
+                    case 0b00:
+                        VDUPQ_8(t, v0, i);
+                        VDUPQ_8(t2, v0, i+1);
+                        VCMHSQ_8(t, v1, t);
+                        VCMHSQ_8(t2, t2, v1);
+                        break;
+                    case 0b01:
+                        VDUPQ_16(t, v0, i);
+                        VDUPQ_16(t2, v0, i+1);
+                        VCMHSQ_16(t, v1, t);
+                        VCMHSQ_16(t2, t2, v1);
+                        break;
+                    case 0b10:
+                        VDUPQ_8(t, v0, i);
+                        VDUPQ_8(t2, v0, i+1);
+                        VCMGEQ_8(t, v1, t);
+                        VCMGEQ_8(t2, t2, v1);
+                        break;
+                    case 0b11:
+                        VDUPQ_16(t, v0, i);
+                        VDUPQ_16(t2, v0, i+1);
+                        VCMGEQ_16(t, v1, t);
+                        VCMGEQ_16(t2, t2, v1);
+                        break;
+                }
+                VANDQ(t, t, t2);
+                // the range is only used if both bounds are valid
+                if(word) {
+                    VDUPQ_16(t2, vr, i+1);
+                } else {
+                    VDUPQ_8(t2, vr, i+1);
+                }
+                VANDQ(t, t, t2);
+                VORRQ(acc, acc, t);
+            }
+            VANDQ(acc, acc, vm);
+            break;
+        case 0b10:  // equal each
+            if(word) {
+                VCMEQQ_16(t, v0, v1);
+            } else {
+                VCMEQQ_8(t, v0, v1);
+            }
+            VANDQ(t, t, vr);
+            VANDQ(t, t, vm);
+            // both invalid is a match
+            VORRQ(t2, vr, vm);
+            VORNQ(acc, t, t2);
+            break;
+        case 0b11:  // equal ordered
+            ones = fpu_get_scratch(dyn, ninst);
+            MOVIQ_8(ones, 0xff);
+            MOVIQ_8(acc, 0xff);
+            for(int i=0; i<n; ++i) {
+                // compare reg[i] with mem[i+j], lanes past the end of mem are forced to match
+                if(word) {
+                    VDUPQ_16(t2, v0, i);
+                } else {
+                    VDUPQ_8(t2, v0, i);
+                }
+                if(i) {
+                    VEXTQ_8(t, v1, t2, i*esz);
+                } else {
+                    VMOVQ(t, v1);
+                }
+                if(word) {
+                    VCMEQQ_16(t, t, t2);
+                } else {
+                    VCMEQQ_8(t, t, t2);
+                }
+                if(i) {
+                    VEXTQ_8(t2, vm, ones, i*esz);
+                    VANDQ(t, t, t2);
+                } else {
+                    VANDQ(t, t, vm);
+                }
+                // invalid reg element is a match
+                if(word) {
+                    VDUPQ_16(t2, vr, i);
+                } else {
+                    VDUPQ_8(t2, vr, i);
+                }
+                VORNQ(t, t, t2);
+                VANDQ(acc, acc, t);
+            }
+            break;
+    }
+    // polarity, to IntRes2
+    switch((imm8>>4)&3) {
+        case 0b01:
+            VMVNQ(acc, acc);
+            break;
+        case 0b11:
+            VEORQ(acc, acc, vm);
+            break;
+    }
+    // IntRes2 as a bitmask in s1
+    TABLE64(s1, (uintptr_t)&pcmpstr_bits8);
+    VLDR128_U12(t2, s1, 0);
+    if(word) {
+        XTN_8(t, acc);
+        VANDQ(t, t, t2);
+        UADDLV_8(t, t);
+        VMOVBto(s1, t, 0);
+    } else {
+        VANDQ(t, acc, t2);
+        VEXTQ_8(t2, t, t, 8);
+        UADDLV_8(t, t);
+        UADDLV_8(t2, t2);
+        VMOVBto(s1, t, 0);
+        VMOVBto(s2, t2, 0);
+        BFIw(s1, s2, 8, 8);
+    }
+    // flags
+    IFX(X_ALL) {
+        SET_DFNONE(s4);
+        IFX(X_CF) {
+            CMPSw_U12(s1, 0);
+            CSETw(s4, cNE);
+            BFIw(xFlags, s4, F_CF, 1);
+        }
+        IFX(X_ZF) {
+            // last mem element invalid <=> lmem<n
+            if(word) {
+                VMOVHto(s4, vm, n-1);
+            } else {
+                VMOVBto(s4, vm, n-1);
+            }
+            CMPSw_U12(s4, 0);
+            CSETw(s4, cEQ);
+            BFIw(xFlags, s4, F_ZF, 1);
+        }
+        IFX(X_SF) {
+            if(word) {
+                VMOVHto(s4, vr, n-1);
+            } else {
+                VMOVBto(s4, vr, n-1);
+            }
+            CMPSw_U12(s4, 0);
+            CSETw(s4, cEQ);
+            BFIw(xFlags, s4, F_SF, 1);
+        }
+        IFX(X_OF) {
+            BFIw(xFlags, s1, F_OF, 1);
+        }
+        IFX(X_AF) {
+            BFCw(xFlags, F_AF, 1);
+        }
+        IFX(X_PF) {
+            BFCw(xFlags, F_PF, 1);
+        }
+    }
+    return acc;
+}
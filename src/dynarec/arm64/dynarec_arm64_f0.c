@@ -129,14 +129,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 }
                 if(!ALIGNED_ATOMICxw) {
                     B_NEXT_nocond;
-                    MARK;   // unaligned! also, not enough
+                    MARK;   // unaligned, and maybe split across a 16bytes boundary
+                    LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                     LDRxw_U12(x1, wback, 0);
-                    LDAXRB(x4, wback);
-                    BFIxw(x1, x4, 0, 8); // re-inject
                     emit_add32(dyn, ninst, rex, x1, gd, x3, x4);
-                    STLXRB(x3, x1, wback);
-                    CBNZx_MARK(x3);
-                    STRxw_U12(x1, wback, 0);    // put the whole value
+                    STRxw_U12(x1, wback, 0);
+                    UNLOCK_STRIPE(x6, x4);
                     SMDMB();
                 }
             }
@@ -370,14 +368,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                                 if(!ALIGNED_ATOMICxw) {
                                     // Unaligned version
                                     MARK3;
+                                    LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                                     LDRxw_U12(x1, wback, 0);
-                                    LDAXRB(x3, wback); // dummy read, to arm the write...
                                     CMPSxw_REG(xRAX, x1);
-                                    B_MARK(cNE);
-                                    // EAX == Ed
-                                    STLXRB(x4, gd, wback);
-                                    CBNZx_MARK3(x4);
-                                    STRxw_U12(gd, wback, 0);
+                                    CSELxw(x4, gd, x1, cEQ); // write back the old value if EAX != Ed
+                                    STRxw_U12(x4, wback, 0);
+                                    UNLOCK_STRIPE(x6, x4);
                                     SMDMB();
                                 }
                                 if(!ALIGNED_ATOMICxw || !arm64_atomics) {
@@ -659,13 +655,11 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                                 }
                                 if(!ALIGNED_ATOMICxw) {
                                     MARK;
+                                    LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                                     LDRxw_U12(x1, wback, 0);
-                                    LDAXRB(x4, wback);
-                                    BFIxw(x1, x4, 0, 8);
                                     ADDxw_REG(x4, x1, gd);
-                                    STLXRB(x3, x4, wback);
-                                    CBNZx_MARK(x3);
                                     STRxw_U12(x4, wback, 0);
+                                    UNLOCK_STRIPE(x6, x4);
                                     SMDMB();
                                 }
                                 if(!ALIGNED_ATOMICxw || !arm64_atomics) {
@@ -748,25 +742,19 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         }
                         if(!ALIGNED_ATOMICxw) {
                             MARK2;
+                            LOCK_STRIPE(wback, 8<<rex.w, x6, x4, x5, x2);
                             LDPxw_S7_offset(x2, x3, wback, 0);
-                            LDAXRB(x5, wback);
                             CMPSxw_REG(xRAX, x2);
                             CCMPxw(xRDX, x3, 0, cEQ);
-                            B_MARKSEG(cNE);    // EAX!=ED[0] || EDX!=Ed[1]
-                            STLXRB(x4, xRBX, wback);
-                            CBNZx_MARK2(x4);
-                            STPxw_S7_offset(xRBX, xRCX, wback, 0);
-                            UFLAG_IF {
-                                MOV32w(x1, 1);
-                            }
-                            B_MARK3_nocond;
-                            MARKSEG;
-                            STLXRB(x4, x5, wback); //write back
-                            CBNZx_MARK2(x4);
-                            MOVxw_REG(xRAX, x2);
-                            MOVxw_REG(xRDX, x3);
+                            // no branch (so no other mark): ECX:EBX if equal, else write back ED
+                            CSELx(x4, xRBX, x2, cEQ);
+                            CSELx(x5, xRCX, x3, cEQ);
+                            STPxw_S7_offset(x4, x5, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
+                            CSELx(xRAX, xRAX, x2, cEQ);
+                            CSELx(xRDX, xRDX, x3, cEQ);
                             UFLAG_IF {
-                                MOV32w(x1, 0);
+                                CSETw(x1, cEQ);
                             }
                         }
                         MARK3;
@@ -898,14 +886,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 }
                 if(!ALIGNED_ATOMICxw) {
                     B_NEXT_nocond;
-                    MARK;   // unaligned! also, not enough
+                    MARK;   // unaligned, and maybe split across a 16bytes boundary
+                    LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                     LDRxw_U12(x1, wback, 0);
-                    LDAXRB(x4, wback);
-                    BFIxw(x1, x4, 0, 8); // re-inject
                     emit_sub32(dyn, ninst, rex, x1, gd, x3, x4);
-                    STLXRB(x3, x1, wback);
-                    CBNZx_MARK(x3);
-                    STRxw_U12(x1, wback, 0);    // put the whole value
+                    STRxw_U12(x1, wback, 0);
+                    UNLOCK_STRIPE(x6, x4);
                     SMDMB();
                 }
             }
@@ -949,14 +935,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 }
                 if(!ALIGNED_ATOMICxw) {
                     B_NEXT_nocond;
-                    MARK;   // unaligned! also, not enough
+                    MARK;   // unaligned, and maybe split across a 16bytes boundary
+                    LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                     LDRxw_U12(x1, wback, 0);
-                    LDAXRB(x4, wback);
-                    BFIxw(x1, x4, 0, 8); // re-inject
                     emit_xor32(dyn, ninst, rex, x1, gd, x3, x4);
-                    STLXRB(x3, x1, wback);
-                    CBNZx_MARK(x3);
-                    STRxw_U12(x1, wback, 0);    // put the whole value
+                    STRxw_U12(x1, wback, 0);
+                    UNLOCK_STRIPE(x6, x4);
                     SMDMB();
                 }
             }
@@ -1233,14 +1217,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         }
                         if(!ALIGNED_ATOMICxw) {
                             B_NEXT_nocond;
-                            MARK;   // unaligned! also, not enough
+                            MARK;   // unaligned, and maybe split across a 16bytes boundary
+                            LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                             LDRxw_U12(x1, wback, 0);
-                            LDAXRB(x4, wback);
-                            BFIxw(x1, x4, 0, 8); // re-inject
                             emit_add32c(dyn, ninst, rex, x1, i64, x3, x4, x5);
-                            STLXRB(x3, x1, wback);
-                            CBNZx_MARK(x3);
-                            STRxw_U12(x1, wback, 0);    // put the whole value
+                            STRxw_U12(x1, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
                             SMDMB();
                         }
                     }
@@ -1389,14 +1371,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         }
                         if(!ALIGNED_ATOMICxw) {
                             B_NEXT_nocond;
-                            MARK;   // unaligned! also, not enough
+                            MARK;   // unaligned, and maybe split across a 16bytes boundary
+                            LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                             LDRxw_U12(x1, wback, 0);
-                            LDAXRB(x4, wback);
-                            BFIxw(x1, x4, 0, 8); // re-inject
                             emit_sub32c(dyn, ninst, rex, x1, i64, x3, x4, x5);
-                            STLXRB(x3, x1, wback);
-                            CBNZx_MARK(x3);
-                            STRxw_U12(x1, wback, 0);    // put the whole value
+                            STRxw_U12(x1, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
                             SMDMB();
                         }
                     }
@@ -1670,14 +1650,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         SMDMB();
                         if(!ALIGNED_ATOMICxw) {
                             B_NEXT_nocond;
-                            MARK;
+                            MARK;   // unaligned, and maybe split across a 16bytes boundary
+                            LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                             LDRxw_U12(x1, wback, 0);
-                            LDAXRB(x4, wback);
-                            BFIxw(x1, x4, 0, 8); // re-inject
                             emit_inc32(dyn, ninst, rex, x1, x3, x4);
-                            STLXRB(x3, x1, wback);
-                            CBNZw_MARK(x3);
                             STRxw_U12(x1, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
                             SMDMB();
                         }
                     }
@@ -1718,14 +1696,12 @@ uintptr_t dynarec64_F0(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         SMDMB();
                         if(!ALIGNED_ATOMICxw) {
                             B_NEXT_nocond;
-                            MARK;
+                            MARK;   // unaligned, and maybe split across a 16bytes boundary
+                            LOCK_STRIPE(wback, 1<<(2+rex.w), x6, x3, x4, x1);
                             LDRxw_U12(x1, wback, 0);
-                            LDAXRB(x4, wback);
-                            BFIxw(x1, x4, 0, 8); // re-inject
                             emit_dec32(dyn, ninst, rex, x1, x3, x4);
-                            STLXRB(x3, x1, wback);
-                            CBNZw_MARK(x3);
                             STRxw_U12(x1, wback, 0);
+                            UNLOCK_STRIPE(x6, x4);
                             SMDMB();
                         }
                     }
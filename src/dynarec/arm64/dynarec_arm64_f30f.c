@@ -184,10 +184,14 @@ uintptr_t dynarec64_F30F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int n
                     SETFLAGS(X_OF, SF_SUBSET);
                     GETED(0);
                     GETGD;
-                    MRS_nzvc(x3);
-                    LSRw(x4, xFlags, F_OF);
-                    BFIx(x3, x4, 29, 1); // set C
-                    MSR_nzvc(x3);      // load CC into ARM CF
+                    if(arm64_flagm) {
+                        RMIF(xFlags, F_OF-1, 0b0010);   // load OF into ARM CF
+                    } else {
+                        MRS_nzvc(x3);
+                        LSRw(x4, xFlags, F_OF);
+                        BFIx(x3, x4, 29, 1); // set C
+                        MSR_nzvc(x3);      // load CC into ARM CF
+                    }
                     IFX(X_OF) {
                         ADCSxw_REG(gd, gd, ed);
                         CSETw(x3, cCS);
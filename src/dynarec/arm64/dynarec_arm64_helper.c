@@ -32,6 +32,8 @@ uintptr_t geted(dynarec_arm_t* dyn, uintptr_t addr, int ninst, uint8_t nextop, u
 {
     MAYUSE(dyn); MAYUSE(ninst); MAYUSE(delta);
 
+    smclassify_ed(dyn, addr, ninst, nextop, rex);
+
     if(l==LOCK_LOCK) { /*SMDMB();*/DMB_ISH(); }
 
     if(rex.is32bits)
@@ -328,6 +330,8 @@ uintptr_t geted32(dynarec_arm_t* dyn, uintptr_t addr, int ninst, uint8_t nextop,
 {
     MAYUSE(dyn); MAYUSE(ninst); MAYUSE(delta);
 
+    smclassify_ed(dyn, addr, ninst, nextop, rex);
+
     int lock = l?((l==LOCK_LOCK)?1:2):0;
     if(unscaled)
         *unscaled = 0;
@@ -604,6 +608,9 @@ void jump_to_next(dynarec_arm_t* dyn, uintptr_t ip, int reg, int ninst, int is32
         MOVx_REG(x1, xRIP);
     }
     CLEARIP();
+    if(LINKSTATE_ON() && dyn->f.dfnone) {
+        ADDx_U12(x2, x2, 8);    // flags are computed, skip the fallback entry of the next block
+    }
     #ifdef HAVE_TRACE
     //MOVx(x3, 15);    no access to PC reg
     #endif
@@ -826,11 +833,40 @@ void call_n(dynarec_arm_t* dyn, int ninst, void* fnc, int w)
     //SET_NODF();
 }
 
+// the x87 cache is in v8..v15, with only the low 64bits used, and those are preserved by the native ABI
+void call_d(dynarec_arm_t* dyn, int ninst, void* fnc, int arg1, int arg2, int ret)
+{
+    MAYUSE(fnc);
+    fpu_pushcache(dyn, ninst, x3, 0);
+    // args are x87 or scratch regs, so not d0/d1
+    FMOVD(0, arg1);
+    if(arg2!=-1) {
+        FMOVD(1, arg2);
+    }
+    STPx_S7_preindex(xEmu, x1, xSP, -16);   // ARM64 stack needs to be 16byte aligned
+    STPx_S7_offset(xRAX, xRCX, xEmu, offsetof(x64emu_t, regs[_AX]));    // x9..x15, x16,x17,x18 those needs to be saved by caller
+    STPx_S7_offset(xRDX, xRBX, xEmu, offsetof(x64emu_t, regs[_DX]));
+    STPx_S7_offset(xRSP, xRBP, xEmu, offsetof(x64emu_t, regs[_SP]));
+    STPx_S7_offset(xRSI, xRDI, xEmu, offsetof(x64emu_t, regs[_SI]));
+    STRx_U12(xR8, xEmu, offsetof(x64emu_t, regs[_R8]));
+    TABLE64(x7, (uintptr_t)fnc);
+    BLR(x7);
+    LDPx_S7_postindex(xEmu, x1, xSP, 16);
+    LDPx_S7_offset(xRAX, xRCX, xEmu, offsetof(x64emu_t, regs[_AX]));
+    LDPx_S7_offset(xRDX, xRBX, xEmu, offsetof(x64emu_t, regs[_DX]));
+    LDPx_S7_offset(xRSP, xRBP, xEmu, offsetof(x64emu_t, regs[_SP]));
+    LDPx_S7_offset(xRSI, xRDI, xEmu, offsetof(x64emu_t, regs[_SI]));
+    LDRx_U12(xR8, xEmu, offsetof(x64emu_t, regs[_R8]));
+    FMOVD(ret, 0);
+    fpu_popcache(dyn, ninst, x3, 0);
+}
+
 void grab_segdata(dynarec_arm_t* dyn, uintptr_t addr, int ninst, int reg, int segment)
 {
     (void)addr;
     int64_t j64;
     MAYUSE(j64);
+    dyn->insts[ninst].x64.mem_tls = 1;   // segment based access are thread local
     MESSAGE(LOG_DUMP, "Get %s Offset\n", (segment==_FS)?"FS":"GS");
     int t1 = x1, t2 = x4;
     if(reg==t1) ++t1;
@@ -851,6 +887,54 @@ void grab_segdata(dynarec_arm_t* dyn, uintptr_t addr, int ninst, int reg, int se
     MESSAGE(LOG_DUMP, "----%s Offset\n", (segment==_FS)?"FS":"GS");
 }
 
+// spin until the stripe at s1 is taken, s2 and s3 are scratch (the flags are not changed)
+static void take_stripe(dynarec_arm_t* dyn, int ninst, int s1, int s2, int s3)
+{
+    MOV32w(s2, 1);
+    int retry = dyn->native_size;
+    if(arm64_atomics) {
+        // test and test-and-set, so waiters only read the line
+        LDRB_U12(s3, s1, 0);
+        CBNZw(s3, retry-dyn->native_size);
+        SWPAB(s2, s3, s1);
+        CBNZw(s3, retry-dyn->native_size);
+    } else {
+        LDAXRB(s3, s1);
+        CBNZw(s3, retry-dyn->native_size);
+        STXRB(s3, s2, s1);
+        CBNZw(s3, retry-dyn->native_size);
+    }
+}
+
+// grab the striped locks of a LOCK'd access of size bytes at wback that is split across a 16bytes boundary: the stripes
+// of its first and last 16bytes granules, lowest index first. If it's only one granule, the second is the spare stripe
+// (never taken, so UNLOCK_STRIPE can release it without test)
+// s1 and s4 will hold the address of the stripes (for UNLOCK_STRIPE), s2 and s3 are scratch
+void lock_stripe(dynarec_arm_t* dyn, int ninst, int wback, int size, int s1, int s2, int s3, int s4)
+{
+    MESSAGE(LOG_DUMP, "Lock stripe\n");
+    UBFXx(s2, wback, 4, LOCK_STRIPES_BITS);
+    ADDx_U12(s4, wback, size-1);
+    UBFXx(s4, s4, 4, LOCK_STRIPES_BITS);
+    MOV32w(s3, LOCK_STRIPES);
+    CMPSx_REG(s2, s4);
+    CSELx(s4, s3, s4, cEQ);
+    CMPSx_REG(s2, s4);
+    CSELx(s3, s2, s4, cLO);
+    CSELx(s4, s4, s2, cLO);
+    CMPSw_U12(s4, LOCK_STRIPES);    // kept until the second stripe
+    TABLE64(s1, (uintptr_t)lock_stripes);
+    ADDx_REG_LSL(s4, s1, s4, LOCK_STRIPE_SHIFT);
+    ADDx_REG_LSL(s1, s1, s3, LOCK_STRIPE_SHIFT);
+    take_stripe(dyn, ninst, s1, s2, s3);
+    // so a signal that cancels the access can release them
+    STRx_U12(s1, xEmu, offsetof(x64emu_t, held_stripe[0]));
+    Bcond(cEQ, 4+5*4);
+    take_stripe(dyn, ninst, s4, s2, s3);
+    STRx_U12(s4, xEmu, offsetof(x64emu_t, held_stripe[1]));
+    MESSAGE(LOG_DUMP, "----Lock stripe\n");
+}
+
 // x87 stuffs
 int x87_stackcount(dynarec_arm_t* dyn, int ninst, int scratch)
 {
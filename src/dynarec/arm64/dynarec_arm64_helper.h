@@ -38,9 +38,11 @@
 #define SMFIRST_MIN 1
 #define SMSEQ_MIN 2
 #define SMSEQ_MAX 3
+// Opcode only access the stack or thread local storage, so no barrier is needed
+#define SMLOCAL()   (box64_dynarec_strongmem_local && (dyn->insts[ninst].x64.mem_tls || (dyn->insts[ninst].x64.mem_local && !dyn->insts[ninst].x64.mem_shared)))
 #if STEP == 1
 // pass 1 has the jump point available
-#define SMWRITE()   dyn->insts[ninst].will_write = 1; dyn->smwrite = 1
+#define SMWRITE()   if(!SMLOCAL()) {dyn->insts[ninst].will_write = 1; dyn->smwrite = 1;}
 #define SMREAD()
 #define SMREADLOCK(lock)
 #define SMMIGHTREAD()
@@ -58,13 +60,13 @@
 // Block will trigget at 1st and last if strongmem is >= SMFIRST_MIN
 // Read will contribute to trigger a DMB on "first" read if strongmem is >= SMREAD_MIN
 // Opcode will read
-#define SMREAD()    if(dyn->insts[ninst].will_write) {WILLWRITE();} else if(box64_dynarec_strongmem==SMREAD_VAL && !dyn->smread) {DSB_SY(); dyn->smread = 1;}
+#define SMREAD()    if(dyn->insts[ninst].will_write) {WILLWRITE();} else if(box64_dynarec_strongmem==SMREAD_VAL && !dyn->smread && !SMLOCAL()) {DSB_SY(); dyn->smread = 1;}
 // Opcode will read with option forced lock
 #define SMREADLOCK(lock)    if((lock)) {SMWRITELOCK(lock);} else {SMREAD();}
 // Opcode might read (depend on nextop)
 #define SMMIGHTREAD()   if(!MODREG) {SMREAD();}
 // Opcode has wrote
-#define SMWRITE()   if((box64_dynarec_strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} if(box64_dynarec_strongmem>SMSEQ_MIN && (box64_dynarec_strongmem!=SMREAD_VAL)) {if(++dyn->smwrite>=SMSEQ_MAX) {SMDMB(); dyn->smwrite=1;}} else dyn->smwrite=1
+#define SMWRITE()   if(!SMLOCAL()) {if((box64_dynarec_strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} if(box64_dynarec_strongmem>SMSEQ_MIN && (box64_dynarec_strongmem!=SMREAD_VAL)) {if(++dyn->smwrite>=SMSEQ_MAX) {SMDMB(); dyn->smwrite=1;}} else dyn->smwrite=1;}
 // Opcode has wrote (strongmem>1 only)
 #define WILLWRITE2()   if(box64_dynarec_strongmem>SMWRITE2_MIN) {WILLWRITE();}
 #define SMWRITE2()   if(box64_dynarec_strongmem>SMWRITE2_MIN) {SMWRITE();}
@@ -75,7 +77,7 @@
 // Opcode might have wrote (depend on nextop)
 #define SMMIGHTWRITE()   if(!MODREG) {SMWRITE();}
 // Opcode will write (without reading)
-#define WILLWRITE() if((box64_dynarec_strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} else if(box64_dynarec_strongmem>=SMFIRST_MIN && dyn->insts[ninst].last_write && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} dyn->smwrite=1
+#define WILLWRITE() if(!SMLOCAL()) {if((box64_dynarec_strongmem>=SMFIRST_MIN) && dyn->smwrite==0 && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} else if(box64_dynarec_strongmem>=SMFIRST_MIN && dyn->insts[ninst].last_write && (box64_dynarec_strongmem!=SMREAD_VAL)) {SMDMB();} dyn->smwrite=1;}
 // Start of sequence
 #define SMSTART()   SMEND()
 // End of sequence
@@ -709,6 +711,16 @@
 
 #define ALIGNED_ATOMICxw ((fixedaddress && !(fixedaddress&(((1<<(2+rex.w))-1)))) || box64_dynarec_aligned_atomics)
 #define ALIGNED_ATOMICH ((fixedaddress && !(fixedaddress&1)) || box64_dynarec_aligned_atomics)
+// Serialize a LOCK'd access split across a 16bytes boundary (so not single-copy atomic, even with LSE2) using the striped locks
+// s1 will hold the first stripe address until UNLOCK_STRIPE, s2, s3 and s4 are scratch. The stripes are also noted in emu->held_stripe
+#define LOCK_STRIPE(wback, size, s1, s2, s3, s4)    lock_stripe(dyn, ninst, wback, size, s1, s2, s3, s4)
+// s2 is scratch
+#define UNLOCK_STRIPE(s1, s2)                       \
+    LDRx_U12(s2, xEmu, offsetof(x64emu_t, held_stripe[1])); \
+    STRx_U12(xZR, xEmu, offsetof(x64emu_t, held_stripe[0])); \
+    STRx_U12(xZR, xEmu, offsetof(x64emu_t, held_stripe[1])); \
+    STLRB(xZR, s2);                                 \
+    STLRB(xZR, s1)
 
 // CALL will use x7 for the call address. Return value can be put in ret (unless ret is -1)
 // R0 will not be pushed/popd if ret is -2
@@ -719,20 +731,23 @@
 // CALL_S will use x7 for the call address. Return value can be put in ret (unless ret is -1)
 // R0 will not be pushed/popd if ret is -2. Flags are not save/restored
 #define CALL_S(F, ret) call_c(dyn, ninst, F, x7, ret, 0, 0)
+// CALL_D will use x7 for the call address. Call a native double function with 1 or 2 double args (B is -1 if only 1)
+// The x87 cache stays in place, result is put in R
+#define CALL_D(F, A, B, R) call_d(dyn, ninst, F, A, B, R)
 
-#define MARK        dyn->insts[ninst].mark = dyn->native_size
+#define MARK        SETMARK(dyn->insts[ninst].mark)
 #define GETMARK     dyn->insts[ninst].mark
-#define MARK2       dyn->insts[ninst].mark2 = dyn->native_size
+#define MARK2       SETMARK(dyn->insts[ninst].mark2)
 #define GETMARK2    dyn->insts[ninst].mark2
-#define MARK3       dyn->insts[ninst].mark3 = dyn->native_size
+#define MARK3       SETMARK(dyn->insts[ninst].mark3)
 #define GETMARK3    dyn->insts[ninst].mark3
-#define MARKF       dyn->insts[ninst].markf = dyn->native_size
+#define MARKF       SETMARK(dyn->insts[ninst].markf)
 #define GETMARKF    dyn->insts[ninst].markf
-#define MARKF2      dyn->insts[ninst].markf2 = dyn->native_size
+#define MARKF2      SETMARK(dyn->insts[ninst].markf2)
 #define GETMARKF2   dyn->insts[ninst].markf2
-#define MARKSEG     dyn->insts[ninst].markseg = dyn->native_size
+#define MARKSEG     SETMARK(dyn->insts[ninst].markseg)
 #define GETMARKSEG  dyn->insts[ninst].markseg
-#define MARKLOCK    dyn->insts[ninst].marklock = dyn->native_size
+#define MARKLOCK    SETMARK(dyn->insts[ninst].marklock)
 #define GETMARKLOCK dyn->insts[ninst].marklock
 
 // Branch to MARK if cond (use j64)
@@ -747,6 +762,10 @@
 #define CBZxw_MARK(reg)             \
     j64 = GETMARK-(dyn->native_size);  \
     CBZxw(reg, j64)
+// Branch to MARK if reg is 0 (use j64)
+#define CBZw_MARK(reg)              \
+    j64 = GETMARK-(dyn->native_size);  \
+    CBZw(reg, j64)
 // Branch to MARK if reg is not 0 (use j64)
 #define CBNZx_MARK(reg)             \
     j64 = GETMARK-(dyn->native_size);  \
@@ -819,6 +838,18 @@
 #define TBNZ_MARK3(A, N)            \
     j64 = GETMARK3-(dyn->native_size); \
     TBNZ(A, N, j64)
+// Branch to MARKF if cond (use j64)
+#define B_MARKF(cond)               \
+    j64 = GETMARKF-(dyn->native_size); \
+    Bcond(cond, j64)
+// Branch to MARKF unconditionnal (use j64)
+#define B_MARKF_nocond              \
+    j64 = GETMARKF-(dyn->native_size); \
+    B(j64)
+// Branch to MARKF if reg is not 0 (use j64)
+#define CBNZx_MARKF(reg)            \
+    j64 = GETMARKF-(dyn->native_size); \
+    CBNZx(reg, j64)
 // Branch to next instruction if cond (use j64)
 #define B_NEXT(cond)     \
     j64 = (dyn->insts)?(dyn->insts[ninst].epilog-(dyn->native_size)):0; \
@@ -1034,6 +1065,35 @@
 #define SET_NODF()          dyn->f.dfnone = 0
 #define SET_DFOK()          dyn->f.dfnone = 1; dyn->f.dfnone_here=1
 
+// BOX64_DYNAREC_LINKSTATE: the 2 first opcodes of a block are its fallback entry, that computes the deferred flags if any
+// A block that exits with df==d_none jumps to the next one 8 bytes later, so all jump table targets must accept that entry
+#define LINKSTATE_ON()      (box64_dynarec_linkstate && !box64_dynarec_test)
+#define LINKSTATE_SPECIALIZED(A) (LINKSTATE_ON() && !(A) && !dyn->insts[0].pred_sz)
+#if STEP == 0
+#define LINKSTATE_ENTRY(A)
+#define LINKSTATE_FALLBACK(A)
+#else
+#define LINKSTATE_ENTRY(A)                                              \
+    if(LINKSTATE_SPECIALIZED(A)) {                                      \
+        MESSAGE(LOG_DUMP, "Fallback entry\n");                          \
+        LDRw_U12(x3, xEmu, offsetof(x64emu_t, df));                     \
+        CBNZw(x3, dyn->linkstate_slow-dyn->native_size);                \
+        dyn->f.pending = SF_SET;                                        \
+        SET_DFOK();                                                     \
+    } else if(LINKSTATE_ON()) {                                         \
+        NOP;                                                            \
+        NOP;                                                            \
+    }
+#define LINKSTATE_FALLBACK(A)                                           \
+    if(LINKSTATE_SPECIALIZED(A)) {                                      \
+        MESSAGE(LOG_DUMP, "Fallback entry with deferred flags\n");      \
+        SETMARK(dyn->linkstate_slow);                                   \
+        fpu_reset(dyn);                                                 \
+        CALL_(UpdateFlags, -1, 0);                                      \
+        B(8-dyn->native_size);                                          \
+    }
+#endif
+
 #ifndef MAYSETFLAGS
 #define MAYSETFLAGS() do {} while (0)
 #endif
@@ -1108,7 +1168,7 @@
     dyn->doublepush = 0;            \
     dyn->doublepop = 0;
 
-#if STEP < 2
+#if STEP == 0
 #define GETIP(A) TABLE64(0, 0)
 #define GETIP_(A) TABLE64(0, 0)
 #else
@@ -1140,9 +1200,9 @@
 #endif
 #define CLEARIP()   dyn->last_ip=0
 
-#if STEP < 2
+#if STEP == 0
 #define PASS2IF(A, B) if(A)
-#elif STEP == 2
+#elif STEP < 3
 #define PASS2IF(A, B) if(A) dyn->insts[ninst].pass2choice = B; if(dyn->insts[ninst].pass2choice == B)
 #else
 #define PASS2IF(A, B) if(dyn->insts[ninst].pass2choice == B)
@@ -1207,7 +1267,9 @@ void* arm64_next(x64emu_t* emu, uintptr_t addr);
 #define iret_to_epilog  STEPNAME(iret_to_epilog)
 #define call_c          STEPNAME(call_c)
 #define call_n          STEPNAME(call_n)
+#define call_d          STEPNAME(call_d)
 #define grab_segdata    STEPNAME(grab_segdata)
+#define lock_stripe     STEPNAME(lock_stripe)
 #define emit_cmp8       STEPNAME(emit_cmp8)
 #define emit_cmp16      STEPNAME(emit_cmp16)
 #define emit_cmp32      STEPNAME(emit_cmp32)
@@ -1307,6 +1369,7 @@ void* arm64_next(x64emu_t* emu, uintptr_t addr);
 #define emit_shld16     STEPNAME(emit_shld16)
 
 #define emit_pf         STEPNAME(emit_pf)
+#define emit_pcmpstr    STEPNAME(emit_pcmpstr)
 
 #define x87_do_push         STEPNAME(x87_do_push)
 #define x87_do_push_empty   STEPNAME(x87_do_push_empty)
@@ -1371,7 +1434,9 @@ void retn_to_epilog(dynarec_arm_t* dyn, int ninst, rex_t rex, int n);
 void iret_to_epilog(dynarec_arm_t* dyn, int ninst, int is64bits);
 void call_c(dynarec_arm_t* dyn, int ninst, void* fnc, int reg, int ret, int saveflags, int save_reg);
 void call_n(dynarec_arm_t* dyn, int ninst, void* fnc, int w);
+void call_d(dynarec_arm_t* dyn, int ninst, void* fnc, int arg1, int arg2, int ret);
 void grab_segdata(dynarec_arm_t* dyn, uintptr_t addr, int ninst, int reg, int segment);
+void lock_stripe(dynarec_arm_t* dyn, int ninst, int wback, int size, int s1, int s2, int s3, int s4);
 void emit_cmp8(dynarec_arm_t* dyn, int ninst, int s1, int s2, int s3, int s4, int s5);
 void emit_cmp16(dynarec_arm_t* dyn, int ninst, int s1, int s2, int s3, int s4, int s5);
 void emit_cmp32(dynarec_arm_t* dyn, int ninst, rex_t rex, int s1, int s2, int s3, int s4, int s5);
@@ -1472,6 +1537,8 @@ void emit_shld16(dynarec_arm_t* dyn, int ninst, int s1, int s2, int s5, int s3,
 
 void emit_pf(dynarec_arm_t* dyn, int ninst, int s1, int s4);
 
+int emit_pcmpstr(dynarec_arm_t* dyn, int ninst, rex_t rex, int v0, int v1, uint8_t imm8, int expl, int s1, int s2, int s3, int s4);
+
 // x87 helper
 // cache of the local stack counter, to avoid update at every call, return old internal stack counter
 int x87_stackcount(dynarec_arm_t* dyn, int ninst, int scratch);
@@ -1722,17 +1789,29 @@ uintptr_t dynarec64_AVX_F2_0F3A(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         break;                                              \
     case B+0xE:                                             \
         INST_NAME(T1 "LE " T2);                             \
-        GO( EORw_REG_LSL(x1, xFlags, xFlags, F_OF-F_SF);    \
-            ORRw_REG_LSL(x1, x1, xFlags, F_OF-F_ZF);        \
-            TSTw_mask(x1, 0b010101, 0)                      \
-            , cEQ, cNE, X_SF|X_OF|X_ZF)                     \
+        GO( if(arm64_flagm) {                               \
+                /* SF, ZF and OF as N, Z and V */           \
+                RMIF(xFlags, F_SF-3, 0b1100);               \
+                RMIF(xFlags, F_OF, 0b0001);                 \
+            } else {                                        \
+                EORw_REG_LSL(x1, xFlags, xFlags, F_OF-F_SF);\
+                ORRw_REG_LSL(x1, x1, xFlags, F_OF-F_ZF);    \
+                TSTw_mask(x1, 0b010101, 0);                 \
+            }                                               \
+            , (arm64_flagm?cGT:cEQ), (arm64_flagm?cLE:cNE), X_SF|X_OF|X_ZF) \
         break;                                              \
     case B+0xF:                                             \
         INST_NAME(T1 "G " T2);                              \
-        GO( EORw_REG_LSL(x1, xFlags, xFlags, F_OF-F_SF);    \
-            ORRw_REG_LSL(x1, x1, xFlags, F_OF-F_ZF);        \
-            TSTw_mask(x1, 0b010101, 0)                      \
-            , cNE, cEQ, X_SF|X_OF|X_ZF)                     \
+        GO( if(arm64_flagm) {                               \
+                /* SF, ZF and OF as N, Z and V */           \
+                RMIF(xFlags, F_SF-3, 0b1100);               \
+                RMIF(xFlags, F_OF, 0b0001);                 \
+            } else {                                        \
+                EORw_REG_LSL(x1, xFlags, xFlags, F_OF-F_SF);\
+                ORRw_REG_LSL(x1, x1, xFlags, F_OF-F_ZF);    \
+                TSTw_mask(x1, 0b010101, 0);                 \
+            }                                               \
+            , (arm64_flagm?cLE:cNE), (arm64_flagm?cGT:cEQ), X_SF|X_OF|X_ZF) \
         break
 
 #define NOTEST(s1)                                          \
@@ -1762,13 +1841,20 @@ uintptr_t dynarec64_AVX_F2_0F3A(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
     IFX(X_ZF|X_SF) {                            \
         if(arm64_flagm) {                       \
             SETF##A(s1);                        \
-            IFX(X_ZF) {                         \
-                CSETw(s3, cEQ);                 \
-                BFIw(xFlags, s3, F_ZF, 1);      \
-            }                                   \
-            IFX(X_SF) {                         \
-                CSETw(s3, cMI);                 \
-                BFIw(xFlags, s3, F_SF, 1);      \
+            IFX2(X_ZF, && (dyn->insts[ninst].x64.gen_flags&X_SF)) { \
+                /* Z and N are next to each other, like ZF and SF */ \
+                MRS_nzvc(s3);                   \
+                UBFXw(s3, s3, 30, 2);           \
+                BFIw(xFlags, s3, F_ZF, 2);      \
+            } else {                            \
+                IFX(X_ZF) {                     \
+                    CSETw(s3, cEQ);             \
+                    BFIw(xFlags, s3, F_ZF, 1);  \
+                }                               \
+                IFX(X_SF) {                     \
+                    CSETw(s3, cMI);             \
+                    BFIw(xFlags, s3, F_SF, 1);  \
+                }                               \
             }                                   \
         } else {                                \
             IFX(X_ZF) {                         \
@@ -1783,6 +1869,27 @@ uintptr_t dynarec64_AVX_F2_0F3A(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
         }                                       \
     }
 
+// Load x86 CF in ARM carry, for ADC (s1 is a scratch without FlagM)
+#define CARRY_IN(s1)                            \
+    if(arm64_flagm) {                           \
+        RMIF(xFlags, 64-F_CF-1, 0b0010);        \
+    } else {                                    \
+        MRS_nzvc(s1);                           \
+        BFIx(s1, xFlags, 29, 1); /* set C */    \
+        MSR_nzvc(s1);                           \
+    }
+// Load inverted x86 CF in ARM carry, for SBC (s1 and s2 are scratch without FlagM)
+#define BORROW_IN(s1, s2)                       \
+    if(arm64_flagm) {                           \
+        RMIF(xFlags, 64-F_CF-1, 0b0010);        \
+        CFINV();                                \
+    } else {                                    \
+        EORw_mask(s2, xFlags, 0, 0);            \
+        MRS_nzvc(s1);                           \
+        BFIx(s1, s2, 29, 1); /* set C */        \
+        MSR_nzvc(s1);                           \
+    }
+
 #define PURGE_YMM()    avx_purge_ymm(dyn, ninst, dyn->insts[ninst+1].purge_ymm, x1)
 
 #endif //__DYNAREC_ARM64_HELPER_H__
@@ -8,4 +8,7 @@ void CreateJmpNext(void* addr, void* next)
     uint32_t* block = (uint32_t*)addr;
     LDRx_literal(x2, (intptr_t)next - (intptr_t)addr);
     BR(x2);
+    // same again, for the jumps that skip the fallback entry (BOX64_DYNAREC_LINKSTATE)
+    LDRx_literal(x2, (intptr_t)next - (intptr_t)addr - 8);
+    BR(x2);
 }
\ No newline at end of file
@@ -1,14 +1,28 @@
-#define INIT    
-#define FINI
+// pass1 also computes the size of the block, so pass2 can be skipped if that layout is still valid on pass3
+#define INIT        dyn->native_size = 0
+#define FINI                                                                                            \
+        if(ninst) {                                                                                     \
+                dyn->insts[ninst].address = (dyn->insts[ninst-1].address+dyn->insts[ninst-1].size);     \
+                dyn->insts_size += 1+((dyn->insts[ninst].x64.size>(dyn->insts[ninst].size/4))?dyn->insts[ninst].x64.size:(dyn->insts[ninst].size/4))/15; \
+        }
+
 #define MESSAGE(A, ...) do {} while (0)
-#define EMIT(A) do {} while (0)
+#define EMIT(A)     do{dyn->insts[ninst].size+=4; dyn->native_size+=4;}while(0)
+#define SETMARK(A)  A = dyn->native_size
 #define NEW_INST                                \
+        if(ninst) {                                                                                     \
+                dyn->insts[ninst].address = (dyn->insts[ninst-1].address+dyn->insts[ninst-1].size);     \
+                dyn->insts_size += 1+((dyn->insts[ninst-1].x64.size>(dyn->insts[ninst-1].size/4))?dyn->insts[ninst-1].x64.size:(dyn->insts[ninst-1].size/4))/15; \
+        }                                       \
         dyn->insts[ninst].f_entry = dyn->f;     \
         dyn->n.combined1 = dyn->n.combined2 = 0;\
         dyn->n.swapped = 0; dyn->n.barrier = 0
 
 #define INST_EPILOG                             \
+        dyn->insts[ninst].epilog = dyn->native_size; \
         dyn->insts[ninst].n = dyn->n;           \
         dyn->insts[ninst].f_exit = dyn->f
 
 #define INST_NAME(name)  
+#define TABLE64(A, V)   {Table64(dyn, (V), 1); EMIT(0);}
+#define FTABLE64(A, V)  {mmx87_regs_t v = {.d = V}; Table64(dyn, v.q, 1); EMIT(0);}
@@ -126,9 +126,11 @@ typedef struct dynarec_arm_s {
     dynablock_t*        dynablock;
     instsize_t*         instsize;
     size_t              insts_size; // size of the instruction size array (calculated)
+    size_t              insts_cap;  // size allocated for the instruction size array in pass3
     uintptr_t           forward;    // address of the last end of code while testing forward
     uintptr_t           forward_to; // address of the next jump to (to check if everything is ok)
     int32_t             forward_size;   // size at the forward point
+    int32_t             linkstate_slow; // offset of the deferred flags computation of the fallback entry
     int                 forward_ninst;  // ninst at the forward point
     uint16_t            ymm_zero;   // bitmap of ymm to zero at purge
     uint8_t             smwrite;    // for strongmem model emulation
@@ -136,6 +138,8 @@ typedef struct dynarec_arm_s {
     uint8_t             doublepush;
     uint8_t             doublepop;
     uint8_t             always_test;
+    uint8_t             fastpass;   // pass3 is emitted with the layout computed in pass1
+    uint8_t             layout_diff;// pass3 layout doesn't match the computed one
     uint8_t             abort;      // abort the creation of the block
 } dynarec_arm_t;
 
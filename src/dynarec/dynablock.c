@@ -26,6 +26,7 @@
 #include "custommem.h"
 #include "khash.h"
 #include "rbtree.h"
+#include "rcfile.h"
 
 uint32_t X31_hash_code(void* addr, int len)
 {
@@ -269,7 +270,9 @@ dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits)
             sched_yield();  // just calm down...
         uint32_t hash = X31_hash_code(db->x64_addr, db->x64_size);
         int need_lock = mutex_trylock(&my_context->mutex_dyndump);
-        if(hash!=db->hash) {
+        if(hash!=db->hash || db->strongmem!=box64_dynarec_strongmem) {
+            if(hash!=db->hash)
+                TUNE_INC(modified);
             db->done = 0;   // invalidating the block
             dynarec_log(LOG_DEBUG, "Invalidating block %p from %p:%p (hash:%X/%X, always_test:%d) for %p\n", db, db->x64_addr, db->x64_addr+db->x64_size-1, hash, db->hash, db->always_test,(void*)addr);
             // Free db, it's now invalid!
@@ -307,7 +310,9 @@ dynablock_t* DBAlternateBlock(x64emu_t* emu, uintptr_t addr, uintptr_t filladdr,
             sched_yield();  // just calm down...
         int need_lock = mutex_trylock(&my_context->mutex_dyndump);
         uint32_t hash = X31_hash_code(db->x64_addr, db->x64_size);
-        if(hash!=db->hash) {
+        if(hash!=db->hash || db->strongmem!=box64_dynarec_strongmem) {
+            if(hash!=db->hash)
+                TUNE_INC(modified);
             db->done = 0;   // invalidating the block
             dynarec_log(LOG_DEBUG, "Invalidating alt block %p from %p:%p (hash:%X/%X) for %p\n", db, db->x64_addr, db->x64_addr+db->x64_size, hash, db->hash, (void*)addr);
             // Free db, it's now invalid!
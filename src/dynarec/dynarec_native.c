@@ -3,6 +3,7 @@
 #include <errno.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
 
 #include "debug.h"
 #include "box64context.h"
@@ -22,6 +23,9 @@
 #include "dynarec_native.h"
 #include "dynarec_arch.h"
 #include "dynarec_next.h"
+#include "rcfile.h"
+#include "startprof.h"
+#include "khash.h"
 
 void printf_x64_instruction(zydis_dec_t* dec, instruction_x64_t* inst, const char* name) {
     uint8_t *ip = (uint8_t*)inst->addr;
@@ -258,7 +262,8 @@ int is_instructions(dynarec_native_t *dyn, uintptr_t addr, int n)
     return (i==n)?1:0;
 }
 
-void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size)
+// add the sizes of an instruction to the insts array, returns 0 if it doesn't fit in the cap (nothing written)
+int addInst(instsize_t* insts, size_t* size, size_t cap, int x64_size, int native_size)
 {
     // x64 instruction is <16 bytes
     int toadd;
@@ -266,6 +271,10 @@ void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size)
         toadd = 1 + x64_size/15;
     else
         toadd = 1 + native_size/15;
+    if(*size+toadd>cap) {
+        *size += toadd;
+        return 0;
+    }
     while(toadd) {
         if(x64_size>15)
             insts[*size].x64 = 15;    
@@ -280,6 +289,7 @@ void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size)
         ++(*size);
         --toadd;
     }
+    return 1;
 }
 
 // add a value to table64 (if needed) and gives back the imm19 to use in LDR_literal
@@ -295,8 +305,11 @@ int Table64(dynarec_native_t *dyn, uint64_t val, int pass)
         idx = dyn->table64size++;
         if(idx < dyn->table64cap)
             dyn->table64[idx] = val;
-        else if(pass==3)
-            printf_log(LOG_NONE, "Warning, table64 bigger than expected %d vs %d\n", idx, dyn->table64cap);
+        else if(pass==3) {
+            dyn->layout_diff = 1;
+            if(!dyn->fastpass)
+                printf_log(LOG_NONE, "Warning, table64 bigger than expected %d vs %d\n", idx, dyn->table64cap);
+        }
     }
     // calculate offset
     int delta = dyn->tablestart + idx*sizeof(uint64_t) - (uintptr_t)dyn->block;
@@ -493,6 +506,109 @@ static uint64_t static_table64[(MAX_INSTS+3)/4];
 static instruction_native_t static_insts[MAX_INSTS+2] = {0};
 // TODO: ninst could be a uint16_t instead of an int, that could same some temp. memory
 
+// translation statistics, printed at exit with BOX64_DYNAREC_LOG
+static struct {
+    uint64_t    blocks;     // blocks created
+    uint64_t    x64_bytes;  // x64 bytes translated
+    uint64_t    native_bytes;
+    uint64_t    ns;         // time spent in FillBlock64
+    uint64_t    fastpass;   // blocks emitted without pass 2
+    uint64_t    redone;     // blocks where the layout of pass 1 was wrong
+} fill_stats = {0};
+
+static uint64_t fill_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+// per symbol translation statistics, printed at exit with BOX64_DYNAREC_SYMSTATS
+typedef struct symstats_s {
+    char*       name;
+    uint32_t    blocks;
+    uint64_t    x64_bytes;
+    uint64_t    native_bytes;
+} symstats_t;
+KHASH_MAP_INIT_INT64(symstats, symstats_t)
+static kh_symstats_t* symstats = NULL;
+
+static void AddSymStats(uintptr_t addr, uint64_t x64_size, uint64_t native_size)
+{
+    elfheader_t* h = FindElfAddress(my_context, addr);
+    uintptr_t start = 0;
+    uint64_t sz = 0;
+    const char* name = h?FindNearestSymbolName(h, (void*)addr, &start, &sz):NULL;
+    if(!name || strncmp(name, box64_dynarec_symstats, strlen(box64_dynarec_symstats)))
+        return;
+    if(!symstats)
+        symstats = kh_init(symstats);
+    int ret;
+    khint_t k = kh_put(symstats, symstats, start, &ret);
+    symstats_t* s = &kh_value(symstats, k);
+    if(ret)
+        memset(s, 0, sizeof(symstats_t));
+    if(!s->name)
+        s->name = box_strdup(name);
+    ++s->blocks;
+    s->x64_bytes += x64_size;
+    s->native_bytes += native_size;
+}
+
+static void PrintSymStats(void)
+{
+    if(!symstats)
+        return;
+    symstats_t* s;
+    kh_foreach_value_ref(symstats, s,
+        printf_log(LOG_NONE, "Dynarec symbol %s: %u blocks, %lu x64 bytes, %lu native bytes (%.2f native bytes per x64 byte)\n",
+            s->name, s->blocks, s->x64_bytes, s->native_bytes, s->x64_bytes?((double)s->native_bytes/s->x64_bytes):0.);
+        box_free(s->name);
+    );
+    kh_destroy(symstats, symstats);
+    symstats = NULL;
+}
+
+void PrintDynarecStats(void)
+{
+    PrintSymStats();
+    if(!fill_stats.blocks)
+        return;
+    double secs = fill_stats.ns/1000000000.;
+    dynarec_log(LOG_INFO, "Dynarec translated %lu x64 bytes to %lu native bytes in %lu blocks, in %.3fs (%.2f MB/s)",
+        fill_stats.x64_bytes, fill_stats.native_bytes, fill_stats.blocks, secs, secs?(fill_stats.x64_bytes/secs/(1024.*1024.)):0.);
+    if(fill_stats.fastpass || fill_stats.redone)
+        dynarec_log(LOG_INFO, ", %lu blocks without size pass, %lu redone", fill_stats.fastpass, fill_stats.redone);
+    dynarec_log(LOG_INFO, "\n");
+}
+
+// gather the BOX64_DYNAREC_TUNE evidence of a block
+static void tuneBlock(dynarec_native_t* dyn)
+{
+    TUNE_INC(blocks);
+    // flags used before being set in the straight code at the start of the block
+    uint8_t set = 0;
+    for(int i=0; i<dyn->size; ++i) {
+        if(dyn->insts[i].x64.use_flags&X_ALL&~set) {
+            TUNE_INC(entryflags);
+            break;
+        }
+        set |= dyn->insts[i].x64.set_flags&X_ALL;
+        if(set==X_ALL || dyn->insts[i].x64.jmp || (i+1<dyn->size && dyn->insts[i+1].pred_sz>1))
+            break;
+    }
+}
+
+// reset the layout computed by a previous pass, before computing it again
+static void resetLayout(dynarec_native_t* dyn)
+{
+    for(int i=0; i<=dyn->size; ++i)
+        dyn->insts[i].size = dyn->insts[i].size2 = 0;
+    dyn->native_size = 0;
+    dyn->insts_size = 0;
+    dyn->table64size = 0;
+}
+
 void CancelBlock64(int need_lock)
 {
     if(need_lock)
@@ -545,9 +661,8 @@ void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bit
         0x0008..8+4*n   : actual Native instructions, (n is the total number)
         A ..    A+8*n   : Table64: n 64bits values
         B ..    B+7     : dynablock_t* : self (as part of JmpNext, that simulate another block)
-        B+8 ..  B+15    : 2 Native code for jmpnext (or jmp epilog in case of empty block)
-        B+16 .. B+23    : jmpnext (or jmp_epilog) address. jumpnext is used when the block needs testing
-        B+24 .. B+31    : empty (in case an architecture needs more than 2 opcodes)
+        B+8 ..  B+23    : Native code for jmpnext (or jmp epilog in case of empty block), up to 4 opcodes
+        B+24 .. B+31    : jmpnext (or jmp_epilog) address. jumpnext is used when the block needs testing
         B+32 .. B+32+sz : instsize (compressed array with each instruction length on x64 and native side)
 
     */
@@ -559,12 +674,14 @@ void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bit
         dynarec_log(LOG_DEBUG, "Canceling dynarec FillBlock at %p as another one is going on\n", (void*)addr);
         return NULL;
     }
+    uint64_t start_time = box64_dynarec_log?fill_time():0;
     // protect the 1st page
     protectDB(addr, 1);
     // init the helper
     dynarec_native_t helper = {0};
     current_helper = &helper;
     helper.dynablock = block;
+    block->strongmem = box64_dynarec_strongmem;
     helper.start = addr;
     uintptr_t start = addr;
     helper.cap = MAX_INSTS;
@@ -681,65 +798,106 @@ void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bit
     updateYmm0s(&helper, 0, 0);
 
 
-    // pass 1, float optimizations, first pass for flags
+    // pass 1, float optimizations, first pass for flags, and a first computation of the layout
     native_pass1(&helper, addr, alternate, is32bits);
     if(helper.abort) {
         if(box64_dynarec_dump || box64_dynarec_log)dynarec_log(LOG_NONE, "Abort dynablock on pass1\n");
         CancelBlock64(0);
         return NULL;
     }
-    
-    // pass 2, instruction size
-    native_pass2(&helper, addr, alternate, is32bits);
-    if(helper.abort) {
-        if(box64_dynarec_dump || box64_dynarec_log)dynarec_log(LOG_NONE, "Abort dynablock on pass2\n");
-        CancelBlock64(0);
-        return NULL;
-    }
-    // keep size of instructions for signal handling
-    size_t insts_rsize = (helper.insts_size+2)*sizeof(instsize_t);
-    insts_rsize = (insts_rsize+7)&~7;   // round the size...
-    size_t native_size = (helper.native_size+7)&~7;   // round the size...
-    // ok, now allocate mapped memory, with executable flag on
-    size_t sz = sizeof(void*) + native_size + helper.table64size*sizeof(uint64_t) + 4*sizeof(void*) + insts_rsize;
-    //           dynablock_t*     block (arm insts)            table64               jmpnext code       instsize
-    void* actual_p = (void*)AllocDynarecMap(sz);
-    void* p = (void*)(((uintptr_t)actual_p) + sizeof(void*));
-    void* tablestart = p + native_size;
-    void* next = tablestart + helper.table64size*sizeof(uint64_t);
-    void* instsize = next + 4*sizeof(void*);
-    if(actual_p==NULL) {
-        dynarec_log(LOG_INFO, "AllocDynarecMap(%p, %zu) failed, canceling block\n", block, sz);
-        CancelBlock64(0);
-        return NULL;
-    }
-    helper.block = p;
-    block->actual_block = actual_p;
-    helper.native_start = (uintptr_t)p;
-    helper.tablestart = (uintptr_t)tablestart;
-    helper.jmp_next = (uintptr_t)next+sizeof(void*);
-    helper.instsize = (instsize_t*)instsize;
-    *(dynablock_t**)actual_p = block;
-    helper.table64cap = helper.table64size;
-    helper.table64 = (uint64_t*)helper.tablestart;
-    // pass 3, emit (log emit native opcode)
-    if(box64_dynarec_dump) {
-        dynarec_log(LOG_NONE, "%s%04d|Emitting %zu bytes for %u %s bytes", (box64_dynarec_dump>1)?"\e[01;36m":"", GetTID(), helper.native_size, helper.isize, is32bits?"x86":"x64"); 
-        printFunctionAddr(helper.start, " => ");
-        dynarec_log(LOG_NONE, "%s\n", (box64_dynarec_dump>1)?"\e[m":"");
+    // with fastpass, pass 2 is skipped and pass 3 uses the layout of pass 1. If it doesn't match, pass 2 is done and pass 3 redone
+    helper.fastpass = (box64_dynarec_fastpass && !box64_dynarec_dump)?1:0;
+    if(!helper.fastpass) {
+        // pass 2, instruction size
+        resetLayout(&helper);
+        native_pass2(&helper, addr, alternate, is32bits);
+        if(helper.abort) {
+            if(box64_dynarec_dump || box64_dynarec_log)dynarec_log(LOG_NONE, "Abort dynablock on pass2\n");
+            CancelBlock64(0);
+            return NULL;
+        }
     }
-    int oldtable64size = helper.table64size;
-    size_t oldnativesize = helper.native_size;
-    size_t oldinstsize = helper.insts_size;
-    int oldsize= helper.size;
-    helper.native_size = 0;
-    helper.table64size = 0; // reset table64 (but not the cap)
-    helper.insts_size = 0;  // reset
-    native_pass3(&helper, addr, alternate, is32bits);
-    if(helper.abort) {
-        if(box64_dynarec_dump || box64_dynarec_log)dynarec_log(LOG_NONE, "Abort dynablock on pass1\n");
-        CancelBlock64(0);
-        return NULL;
+    size_t insts_rsize, native_size, sz;
+    void *actual_p, *p, *tablestart, *next, *instsize;
+    int oldtable64size, oldsize;
+    size_t oldnativesize, oldinstsize;
+    while(1) {
+        // keep size of instructions for signal handling
+        insts_rsize = (helper.insts_size+2)*sizeof(instsize_t);
+        insts_rsize = (insts_rsize+7)&~7;   // round the size...
+        native_size = (helper.native_size+7)&~7;   // round the size...
+        // ok, now allocate mapped memory, with executable flag on
+        sz = sizeof(void*) + native_size + helper.table64size*sizeof(uint64_t) + 4*sizeof(void*) + insts_rsize;
+        //           dynablock_t*     block (arm insts)            table64               jmpnext code       instsize
+        actual_p = (void*)AllocDynarecMap(sz);
+        p = (void*)(((uintptr_t)actual_p) + sizeof(void*));
+        tablestart = p + native_size;
+        next = tablestart + helper.table64size*sizeof(uint64_t);
+        instsize = next + 4*sizeof(void*);
+        if(actual_p==NULL) {
+            dynarec_log(LOG_INFO, "AllocDynarecMap(%p, %zu) failed, canceling block\n", block, sz);
+            CancelBlock64(0);
+            return NULL;
+        }
+        helper.block = p;
+        block->actual_block = actual_p;
+        helper.native_start = (uintptr_t)p;
+        helper.tablestart = (uintptr_t)tablestart;
+        helper.jmp_next = (uintptr_t)next+sizeof(void*);
+        helper.instsize = (instsize_t*)instsize;
+        helper.insts_cap = insts_rsize/sizeof(instsize_t);
+        *(dynablock_t**)actual_p = block;
+        helper.table64cap = helper.table64size;
+        helper.table64 = (uint64_t*)helper.tablestart;
+        // pass 3, emit (log emit native opcode)
+        if(box64_dynarec_dump) {
+            dynarec_log(LOG_NONE, "%s%04d|Emitting %zu bytes for %u %s bytes", (box64_dynarec_dump>1)?"\e[01;36m":"", GetTID(), helper.native_size, helper.isize, is32bits?"x86":"x64"); 
+            printFunctionAddr(helper.start, " => ");
+            dynarec_log(LOG_NONE, "%s\n", (box64_dynarec_dump>1)?"\e[m":"");
+        }
+        oldtable64size = helper.table64size;
+        oldnativesize = helper.native_size;
+        oldinstsize = helper.insts_size;
+        oldsize= helper.size;
+        helper.native_size = 0;
+        helper.table64size = 0; // reset table64 (but not the cap)
+        helper.insts_size = 0;  // reset
+        helper.layout_diff = 0;
+        native_pass3(&helper, addr, alternate, is32bits);
+        if(helper.abort) {
+            if(box64_dynarec_dump || box64_dynarec_log)dynarec_log(LOG_NONE, "Abort dynablock on pass3\n");
+            CancelBlock64(0);
+            return NULL;
+        }
+        if(!helper.fastpass)
+            break;
+        if(!helper.layout_diff && (oldnativesize==helper.native_size) && (oldtable64size>=helper.table64size))
+            for(int i=0; i<helper.size && !helper.layout_diff; ++i)
+                if(helper.insts[i].size2!=helper.insts[i].size)
+                    helper.layout_diff = 1;
+        if(!helper.layout_diff) {
+            ++fill_stats.fastpass;
+            break;
+        }
+        // layout of pass 1 was not exact: do the pass 2 and emit again
+        ++fill_stats.redone;
+        FreeDynarecMap((uintptr_t)actual_p);
+        block->actual_block = NULL;
+        helper.fastpass = 0;
+        helper.block = NULL;
+        helper.native_start = 0;
+        helper.tablestart = 0;
+        helper.instsize = NULL;
+        helper.insts_cap = 0;
+        helper.table64 = static_table64;
+        helper.table64cap = sizeof(static_table64)/sizeof(uint64_t);
+        resetLayout(&helper);
+        native_pass2(&helper, addr, alternate, is32bits);
+        if(helper.abort) {
+            if(box64_dynarec_dump || box64_dynarec_log)dynarec_log(LOG_NONE, "Abort dynablock on pass2\n");
+            CancelBlock64(0);
+            return NULL;
+        }
     }
     // no need for jmps anymore
     helper.jmp_sz = helper.jmp_cap = 0;
@@ -769,7 +927,7 @@ void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bit
         CancelBlock64(0);
         return NULL;
     }
-    if((oldnativesize!=helper.native_size) || (oldtable64size<helper.table64size)) {
+    if((oldnativesize!=helper.native_size) || (oldtable64size<helper.table64size) || (helper.insts_size>helper.insts_cap)) {
         printf_log(LOG_NONE, "BOX64: Warning, size difference in block between pass2 (%zu, %d) & pass3 (%zu, %d)!\n", oldnativesize+oldtable64size*8, oldsize, helper.native_size+helper.table64size*8, helper.size);
         uint8_t *dump = (uint8_t*)helper.start;
         printf_log(LOG_NONE, "Dump of %d x64 opcodes:\n", helper.size);
@@ -787,6 +945,8 @@ void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bit
         CancelBlock64(0);
         return NULL;
     }
+    if(box64_dynarec_tune)
+        tuneBlock(&helper);
     // ok, free the helper now
     //dynaFree(helper.insts);
     helper.insts = NULL;
@@ -805,6 +965,16 @@ void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bit
     if(block->always_test) {
         dynarec_log(LOG_DEBUG, "Note: block marked as always dirty %p:%ld\n", block->x64_addr, block->x64_size);
     }
+    if(box64_dynarec_symstats)
+        AddSymStats(addr, block->x64_size, helper.native_size);
+    if(box64_startup_profile)
+        ++startprof_blocks;
+    if(box64_dynarec_log) {
+        ++fill_stats.blocks;
+        fill_stats.x64_bytes += block->x64_size;
+        fill_stats.native_bytes += helper.native_size;
+        fill_stats.ns += fill_time() - start_time;
+    }
     current_helper = NULL;
     //block->done = 1;
     return (void*)block;
@@ -49,6 +49,7 @@ void native_aeskeygenassist(x64emu_t* emu, int gx, int ex, void* p, uint32_t u8)
 void native_pclmul(x64emu_t* emu, int gx, int ex, void* p, uint32_t u8);
 void native_pclmul_x(x64emu_t* emu, int gx, int vx, void* p, uint32_t u8);
 void native_pclmul_y(x64emu_t* emu, int gy, int vy, void* p, uint32_t u8);
+extern const uint32_t native_crc32c_table[256];
 
 void native_clflush(x64emu_t* emu, void* p);
 
@@ -70,6 +71,8 @@ int getNominalPred(dynarec_native_t* dyn, int ninst);
 uintptr_t fakeed(dynarec_native_t* dyn, uintptr_t addr, int ninst, uint8_t nextop);
 // return Ib on a mod/rm opcode without emitting anything
 uint8_t geted_ib(dynarec_native_t* dyn, uintptr_t addr, int ninst, uint8_t nextop);
+// classify the memory operand of a mod/rm opcode as stack or shared, for strongmem emulation
+void smclassify_ed(dynarec_native_t* dyn, uintptr_t addr, int ninst, uint8_t nextop, rex_t rex);
 
 // Is what pointed at addr a native call? And if yes, to what function?
 int isNativeCall(dynarec_native_t* dyn, uintptr_t addr, uintptr_t* calladdress, uint16_t* retn);
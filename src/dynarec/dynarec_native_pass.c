@@ -118,6 +118,7 @@ uintptr_t native_pass(dynarec_native_t* dyn, uintptr_t addr, int alternate, int
         #endif
         if(!ninst) {
             GOTEST(x1, x2);
+            LINKSTATE_ENTRY(alternate);
         }
         if(dyn->insts[ninst].pred_sz>1) {SMSTART();}
         if((dyn->insts[ninst].x64.need_before&~X_PEND) && !dyn->insts[ninst].pred_sz) {
@@ -355,6 +356,7 @@ uintptr_t native_pass(dynarec_native_t* dyn, uintptr_t addr, int alternate, int
         fpu_purgecache(dyn, ninst, 0, x1, x2, x3);
         jump_to_epilog(dyn, ip, 0, ninst);  // no linker here, it's an unknown instruction
     }
+    LINKSTATE_FALLBACK(alternate);
     FINI;
     MESSAGE(LOG_DUMP, "---- END OF BLOCK ---- (%d)\n", dyn->size);
     return addr;
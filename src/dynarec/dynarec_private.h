@@ -38,6 +38,9 @@ typedef struct instruction_x64_s {
     uint8_t     has_next:1;   // does this opcode can continue to the next?
     uint8_t     has_callret:1;    // this instruction have an optimised call setup
     uint8_t     alive:1;    // this opcode gets executed (0 if dead code in that block)
+    uint8_t     mem_local:1;    // a memory operand is [RSP+disp] (stack, so most likely thread local)
+    uint8_t     mem_shared:1;   // a memory operand is computed from something else (might be shared between threads)
+    uint8_t     mem_tls:1;      // memory operand is FS/GS based (thread local storage)
     uint8_t     barrier;    // next instruction is a jump point, so no optim allowed
     uint8_t     barrier_next;   // next instruction needs a barrier
     uint8_t     state_flags;// One of SF_XXX state
@@ -1073,6 +1073,22 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                 CBZ_NEXT(xRCX);
                 ANDI(x1, xFlags, 1 << F_DF);
                 BNEZ_MARK2(x1);
+                {
+                    // 16 bytes at a time, unless RDI is less than 16 bytes after RSI (the copy then repeats a pattern)
+                    int v0 = fpu_get_scratch(dyn);
+                    SUB_D(x1, xRDI, xRSI);
+                    ADDI_D(x2, xZR, 16);
+                    BLTU_MARK(x1, x2);
+                    MARKF;
+                    BLTU_MARK(xRCX, x2);
+                    VLD(v0, xRSI, 0);
+                    VST(v0, xRDI, 0);
+                    ADDI_D(xRSI, xRSI, 16);
+                    ADDI_D(xRDI, xRDI, 16);
+                    ADDI_D(xRCX, xRCX, -16);
+                    BNEZ_MARKF(xRCX);
+                    B_NEXT_nocond;
+                }
                 MARK; // Part with DF==0
                 LD_BU(x1, xRSI, 0);
                 ST_B(x1, xRDI, 0);
@@ -1204,6 +1220,19 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                 CBZ_NEXT(xRCX);
                 ANDI(x1, xFlags, 1 << F_DF);
                 BNEZ_MARK2(x1);
+                {
+                    // 16 bytes at a time
+                    int v0 = fpu_get_scratch(dyn);
+                    VREPLGR2VR_B(v0, xRAX);
+                    ADDI_D(x2, xZR, 16);
+                    MARKF;
+                    BLTU_MARK(xRCX, x2);
+                    VST(v0, xRDI, 0);
+                    ADDI_D(xRDI, xRDI, 16);
+                    ADDI_D(xRCX, xRCX, -16);
+                    BNEZ_MARKF(xRCX);
+                    B_NEXT_nocond;
+                }
                 MARK; // Part with DF==0
                 ST_B(xRAX, xRDI, 0);
                 ADDI_D(xRDI, xRDI, 1);
@@ -1263,6 +1292,31 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     ANDI(x1, xRAX, 0xff);
                     ANDI(x2, xFlags, 1 << F_DF);
                     BNEZ_MARK2(x2);
+                    {
+                        // 16 bytes at a time once RDI is aligned, so nothing after the stopping byte can fault.
+                        // The bytewise loop finds the exact stop
+                        int v0 = fpu_get_scratch(dyn);
+                        int v1 = fpu_get_scratch(dyn);
+                        VREPLGR2VR_B(v0, x1);
+                        ADDI_D(x3, xZR, 16);
+                        ANDI(x2, xRDI, 15);
+                        BNEZ_MARK(x2);
+                        MARKF;
+                        BLTU_MARK(xRCX, x3);
+                        VLD(v1, xRDI, 0);
+                        VXOR_V(v1, v1, v0);
+                        if (rep == 1) {
+                            VSETANYEQZ_B(fcc0, v1);
+                        } else {
+                            VSETNEZ_V(fcc0, v1);
+                        }
+                        BCNEZ_MARK(fcc0);
+                        ADDI_D(xRDI, xRDI, 16);
+                        ADDI_D(xRCX, xRCX, -16);
+                        BNEZ_MARKF(xRCX);
+                        LD_BU(x2, xRDI, -1);
+                        B_MARK3_nocond;
+                    }
                     MARK; // Part with DF==0
                     LD_BU(x2, xRDI, 0);
                     ADDI_D(xRDI, xRDI, 1);
@@ -1272,8 +1326,10 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     } else {
                         BNE_MARK3(x1, x2);
                     }
-                    BNE_MARK(xRCX, xZR);
-                    B_MARK3_nocond;
+                    BEQZ_MARK3(xRCX);
+                    ANDI(x2, xRDI, 15);
+                    BNEZ_MARK(x2);
+                    B_MARKF_nocond;
                     MARK2; // Part with DF==1
                     LD_BU(x2, xRDI, 0);
                     ADDI_D(xRDI, xRDI, -1);
@@ -1544,6 +1600,49 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
             *need_epilog = 0;
             *ok = 0;
             break;
+        case 0xC4:
+            nextop = F8;
+            if (rex.is32bits && !(MODREG)) {
+                DEFAULT;
+            } else if (!la64_lasx) {
+                DEFAULT;
+            } else {
+                vex_t vex = { 0 };
+                vex.rex = rex;
+                u8 = nextop;
+                vex.m = u8 & 0b00011111;
+                vex.rex.b = (u8 & 0b00100000) ? 0 : 1;
+                vex.rex.x = (u8 & 0b01000000) ? 0 : 1;
+                vex.rex.r = (u8 & 0b10000000) ? 0 : 1;
+                u8 = F8;
+                vex.p = u8 & 0b00000011;
+                vex.l = (u8 >> 2) & 1;
+                vex.v = ((~u8) >> 3) & 0b1111;
+                vex.rex.w = (u8 >> 7) & 1;
+                addr = dynarec64_AVX(dyn, addr, ip, ninst, vex, ok, need_epilog);
+            }
+            break;
+        case 0xC5:
+            nextop = F8;
+            if (rex.is32bits && !(MODREG)) {
+                DEFAULT;
+            } else if (!la64_lasx) {
+                DEFAULT;
+            } else {
+                vex_t vex = { 0 };
+                vex.rex = rex;
+                u8 = nextop;
+                vex.p = u8 & 0b00000011;
+                vex.l = (u8 >> 2) & 1;
+                vex.v = ((~u8) >> 3) & 0b1111;
+                vex.rex.r = (u8 & 0b10000000) ? 0 : 1;
+                vex.rex.b = 0;
+                vex.rex.x = 0;
+                vex.rex.w = 0;
+                vex.m = VEX_M_0F;
+                addr = dynarec64_AVX(dyn, addr, ip, ninst, vex, ok, need_epilog);
+            }
+            break;
         case 0xC6:
             INST_NAME("MOV Eb, Ib");
             nextop = F8;
@@ -1755,6 +1854,30 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     DEFAULT;
             }
             break;
+        case 0xD8:
+            addr = dynarec64_D8(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xD9:
+            addr = dynarec64_D9(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xDA:
+            addr = dynarec64_DA(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xDB:
+            addr = dynarec64_DB(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xDC:
+            addr = dynarec64_DC(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xDD:
+            addr = dynarec64_DD(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xDE:
+            addr = dynarec64_DE(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
+        case 0xDF:
+            addr = dynarec64_DF(dyn, addr, ip, ninst, rex, rep, ok, need_epilog);
+            break;
         #define GO(Z)                                                                               \
             BARRIER(BARRIER_MAYBE);                                                                 \
             JUMP(addr + i8, 1);                                                                     \
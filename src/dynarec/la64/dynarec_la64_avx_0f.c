@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+#include "bitutils.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_AVX_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop, u8;
+    uint8_t gd, ed;
+    int v0, v1, v2;
+    int q0, q1;
+    int64_t fixedaddress;
+    rex_t rex = vex.rex;
+
+    MAYUSE(u8);
+    MAYUSE(v2);
+    MAYUSE(q0);
+    MAYUSE(q1);
+
+    switch (opcode) {
+        case 0x10:
+            INST_NAME("VMOVUPS Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                if (vex.l) {
+                    XVOR_V(v0, v1, v1);
+                } else {
+                    VOR_V(v0, v1, v1);
+                }
+            } else {
+                GETGY_empty(v0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                if (vex.l) {
+                    XVLD(v0, ed, fixedaddress);
+                } else {
+                    VLD(v0, ed, fixedaddress);
+                }
+            }
+            YMM0(v0);
+            break;
+        case 0x11:
+            INST_NAME("VMOVUPS Ex, Gx");
+            nextop = F8;
+            GETGY(v0, 0);
+            if (MODREG) {
+                v1 = avx_get_reg_empty(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                if (vex.l) {
+                    XVOR_V(v1, v0, v0);
+                } else {
+                    VOR_V(v1, v0, v0);
+                }
+                YMM0(v1);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                if (vex.l) {
+                    XVST(v0, ed, fixedaddress);
+                } else {
+                    VST(v0, ed, fixedaddress);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0x28:
+            INST_NAME("VMOVAPS Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                if (vex.l) {
+                    XVOR_V(v0, v1, v1);
+                } else {
+                    VOR_V(v0, v1, v1);
+                }
+            } else {
+                GETGY_empty(v0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                if (vex.l) {
+                    XVLD(v0, ed, fixedaddress);
+                } else {
+                    VLD(v0, ed, fixedaddress);
+                }
+            }
+            YMM0(v0);
+            break;
+        case 0x29:
+            INST_NAME("VMOVAPS Ex, Gx");
+            nextop = F8;
+            GETGY(v0, 0);
+            if (MODREG) {
+                v1 = avx_get_reg_empty(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                if (vex.l) {
+                    XVOR_V(v1, v0, v0);
+                } else {
+                    VOR_V(v1, v0, v0);
+                }
+                YMM0(v1);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                if (vex.l) {
+                    XVST(v0, ed, fixedaddress);
+                } else {
+                    VST(v0, ed, fixedaddress);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0x51:
+            INST_NAME("VSQRTPS Gx, Ex");
+            nextop = F8;
+            GETEY(v1, 0, 0);
+            GETGY_empty(v0);
+            if (vex.l) {
+                XVFSQRT_S(v0, v1);
+            } else {
+                VFSQRT_S(v0, v1);
+            }
+            YMM0(v0);
+            break;
+        case 0x54:
+            INST_NAME("VANDPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVAND_V(v0, v1, v2);
+            } else {
+                VAND_V(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x55:
+            INST_NAME("VANDNPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVANDN_V(v0, v1, v2);
+            } else {
+                VANDN_V(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x56:
+            INST_NAME("VORPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVOR_V(v0, v1, v2);
+            } else {
+                VOR_V(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x57:
+            INST_NAME("VXORPS Gx, Vx, Ex");
+            nextop = F8;
+            if (MODREG && ((nextop & 7) + (rex.b << 3) == vex.v)) {
+                // special case for VXORPS Gx, Vx, Vx
+                GETGY_empty(v0);
+                XVXOR_V(v0, v0, v0);
+            } else {
+                GETGY_empty_VYEY(v0, v1, v2);
+                if (vex.l) {
+                    XVXOR_V(v0, v1, v2);
+                } else {
+                    VXOR_V(v0, v1, v2);
+                }
+                YMM0(v0);
+            }
+            break;
+        case 0x58:
+            INST_NAME("VADDPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVFADD_S(v0, v1, v2);
+            } else {
+                VFADD_S(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x59:
+            INST_NAME("VMULPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVFMUL_S(v0, v1, v2);
+            } else {
+                VFMUL_S(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x5C:
+            INST_NAME("VSUBPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVFSUB_S(v0, v1, v2);
+            } else {
+                VFSUB_S(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x5D:
+            INST_NAME("VMINPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (!box64_dynarec_fastnan && v1 != v2) {
+                q0 = fpu_get_scratch(dyn);
+                q1 = fpu_get_scratch(dyn);
+                // always copy from v2 if any oprand is NaN
+                if (vex.l) {
+                    XVFCMP_S(q0, v1, v2, cUN);
+                } else {
+                    VFCMP_S(q0, v1, v2, cUN);
+                }
+                XVBITSEL_V(q1, v1, v2, q0);
+                v1 = q1;
+            }
+            if (vex.l) {
+                XVFMIN_S(v0, v1, v2);
+            } else {
+                VFMIN_S(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x5E:
+            INST_NAME("VDIVPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (vex.l) {
+                XVFDIV_S(v0, v1, v2);
+            } else {
+                VFDIV_S(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x5F:
+            INST_NAME("VMAXPS Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY(v0, v1, v2);
+            if (!box64_dynarec_fastnan && v1 != v2) {
+                q0 = fpu_get_scratch(dyn);
+                q1 = fpu_get_scratch(dyn);
+                // always copy from v2 if any oprand is NaN
+                if (vex.l) {
+                    XVFCMP_S(q0, v1, v2, cUN);
+                } else {
+                    VFCMP_S(q0, v1, v2, cUN);
+                }
+                XVBITSEL_V(q1, v1, v2, q0);
+                v1 = q1;
+            }
+            if (vex.l) {
+                XVFMAX_S(v0, v1, v2);
+            } else {
+                VFMAX_S(v0, v1, v2);
+            }
+            YMM0(v0);
+            break;
+        case 0x77:
+            if (vex.l) {
+                INST_NAME("VZEROALL");
+                for (int i = 0; i < (rex.is32bits ? 8 : 16); ++i) {
+                    v0 = avx_get_reg_empty(dyn, ninst, x1, i);
+                    XVXOR_V(v0, v0, v0);
+                }
+            } else {
+                INST_NAME("VZEROUPPER");
+                for (int i = 0; i < (rex.is32bits ? 8 : 16); ++i)
+                    avx_forget_upper(dyn, ninst, i);
+            }
+            break;
+
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
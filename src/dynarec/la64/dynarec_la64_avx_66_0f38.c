@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+#include "bitutils.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_AVX_66_0F38(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop, u8;
+    uint8_t gd, ed;
+    int v0, v1, v2;
+    int q0, q1;
+    int64_t fixedaddress;
+    rex_t rex = vex.rex;
+
+    MAYUSE(u8);
+    MAYUSE(v2);
+    MAYUSE(q0);
+    MAYUSE(q1);
+
+    switch (opcode) {
+        case 0x18:
+            INST_NAME("VBROADCASTSS Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                XVREPLVE0_W(v0, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                LD_WU(x4, ed, fixedaddress);
+                GETGY_empty(v0);
+                XVREPLGR2VR_W(v0, x4);
+            }
+            YMM0(v0);
+            break;
+        case 0x19:
+            INST_NAME("VBROADCASTSD Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                XVREPLVE0_D(v0, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                LD_D(x4, ed, fixedaddress);
+                GETGY_empty(v0);
+                XVREPLGR2VR_D(v0, x4);
+            }
+            YMM0(v0);
+            break;
+        case 0x1A:
+            INST_NAME("VBROADCASTF128 Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                DEFAULT;
+            } else {
+                GETGY_empty(v0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                VLD(v0, ed, fixedaddress);
+                XVREPLVE0_Q(v0, v0);
+            }
+            break;
+        case 0x58:
+            INST_NAME("VPBROADCASTD Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                XVREPLVE0_W(v0, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                LD_WU(x4, ed, fixedaddress);
+                GETGY_empty(v0);
+                XVREPLGR2VR_W(v0, x4);
+            }
+            YMM0(v0);
+            break;
+        case 0x59:
+            INST_NAME("VPBROADCASTQ Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                XVREPLVE0_D(v0, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                LD_D(x4, ed, fixedaddress);
+                GETGY_empty(v0);
+                XVREPLGR2VR_D(v0, x4);
+            }
+            YMM0(v0);
+            break;
+        case 0x5A:
+            INST_NAME("VBROADCASTI128 Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                DEFAULT;
+            } else {
+                GETGY_empty(v0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                VLD(v0, ed, fixedaddress);
+                XVREPLVE0_Q(v0, v0);
+            }
+            break;
+        case 0x78:
+            INST_NAME("VPBROADCASTB Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                XVREPLVE0_B(v0, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                LD_BU(x4, ed, fixedaddress);
+                GETGY_empty(v0);
+                XVREPLGR2VR_B(v0, x4);
+            }
+            YMM0(v0);
+            break;
+        case 0x79:
+            INST_NAME("VPBROADCASTW Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                XVREPLVE0_H(v0, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                LD_HU(x4, ed, fixedaddress);
+                GETGY_empty(v0);
+                XVREPLGR2VR_H(v0, x4);
+            }
+            YMM0(v0);
+            break;
+
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
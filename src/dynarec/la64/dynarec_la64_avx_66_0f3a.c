@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+#include "bitutils.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_AVX_66_0F3A(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop, u8;
+    uint8_t gd, ed;
+    int v0, v1, v2;
+    int q0, q1;
+    int64_t fixedaddress;
+    rex_t rex = vex.rex;
+
+    MAYUSE(u8);
+    MAYUSE(v2);
+    MAYUSE(q0);
+    MAYUSE(q1);
+
+    switch (opcode) {
+        case 0x18:
+            INST_NAME("VINSERTF128 Gx, Vx, Ex, Ib");
+            nextop = F8;
+            GETVY(v1, 0);
+            if (MODREG) {
+                v2 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 1);
+                v2 = fpu_get_scratch(dyn);
+                VLD(v2, ed, fixedaddress);
+            }
+            u8 = F8;
+            GETGY_empty(v0);
+            if (v0 == v2 && v0 != v1) {
+                q0 = fpu_get_scratch(dyn);
+                VOR_V(q0, v2, v2);
+                v2 = q0;
+            }
+            if (v0 != v1) XVOR_V(v0, v1, v1);
+            if (u8 & 1) {
+                // high part <- Ex, keep low part
+                XVPERMI_Q(v0, v2, 0b00000010);
+            } else {
+                // low part <- Ex, keep high part
+                XVPERMI_Q(v0, v2, 0b00110000);
+            }
+            break;
+        case 0x19:
+            INST_NAME("VEXTRACTF128 Ex, Gx, Ib");
+            nextop = F8;
+            GETGY(v0, 0);
+            if (MODREG) {
+                v1 = avx_get_reg_empty(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                u8 = F8;
+                if (u8 & 1) {
+                    XVPERMI_Q(v1, v0, 0b00000001);
+                } else if (v1 != v0) {
+                    VOR_V(v1, v0, v0);
+                }
+                avx_zero_upper(dyn, ninst, v1);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 1);
+                u8 = F8;
+                if (u8 & 1) {
+                    q0 = fpu_get_scratch(dyn);
+                    XVPERMI_Q(q0, v0, 0b00000001);
+                    VST(q0, ed, fixedaddress);
+                } else {
+                    VST(v0, ed, fixedaddress);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0x38:
+            INST_NAME("VINSERTI128 Gx, Vx, Ex, Ib");
+            nextop = F8;
+            GETVY(v1, 0);
+            if (MODREG) {
+                v2 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 1);
+                v2 = fpu_get_scratch(dyn);
+                VLD(v2, ed, fixedaddress);
+            }
+            u8 = F8;
+            GETGY_empty(v0);
+            if (v0 == v2 && v0 != v1) {
+                q0 = fpu_get_scratch(dyn);
+                VOR_V(q0, v2, v2);
+                v2 = q0;
+            }
+            if (v0 != v1) XVOR_V(v0, v1, v1);
+            if (u8 & 1) {
+                // high part <- Ex, keep low part
+                XVPERMI_Q(v0, v2, 0b00000010);
+            } else {
+                // low part <- Ex, keep high part
+                XVPERMI_Q(v0, v2, 0b00110000);
+            }
+            break;
+        case 0x39:
+            INST_NAME("VEXTRACTI128 Ex, Gx, Ib");
+            nextop = F8;
+            GETGY(v0, 0);
+            if (MODREG) {
+                v1 = avx_get_reg_empty(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                u8 = F8;
+                if (u8 & 1) {
+                    XVPERMI_Q(v1, v0, 0b00000001);
+                } else if (v1 != v0) {
+                    VOR_V(v1, v0, v0);
+                }
+                avx_zero_upper(dyn, ninst, v1);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 1);
+                u8 = F8;
+                if (u8 & 1) {
+                    q0 = fpu_get_scratch(dyn);
+                    XVPERMI_Q(q0, v0, 0b00000001);
+                    VST(q0, ed, fixedaddress);
+                } else {
+                    VST(v0, ed, fixedaddress);
+                }
+                SMWRITE2();
+            }
+            break;
+
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
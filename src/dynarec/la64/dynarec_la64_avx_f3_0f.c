@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+#include "bitutils.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_AVX_F3_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop, u8;
+    uint8_t gd, ed;
+    int v0, v1, v2;
+    int q0, q1;
+    int64_t fixedaddress;
+    rex_t rex = vex.rex;
+
+    MAYUSE(u8);
+    MAYUSE(v2);
+    MAYUSE(q0);
+    MAYUSE(q1);
+
+    switch (opcode) {
+        case 0x6F:
+            INST_NAME("VMOVDQU Gx, Ex");
+            nextop = F8;
+            if (MODREG) {
+                v1 = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGY_empty(v0);
+                if (vex.l) {
+                    XVOR_V(v0, v1, v1);
+                } else {
+                    VOR_V(v0, v1, v1);
+                }
+            } else {
+                GETGY_empty(v0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                if (vex.l) {
+                    XVLD(v0, ed, fixedaddress);
+                } else {
+                    VLD(v0, ed, fixedaddress);
+                }
+            }
+            YMM0(v0);
+            break;
+        case 0x7F:
+            INST_NAME("VMOVDQU Ex, Gx");
+            nextop = F8;
+            GETGY(v0, 0);
+            if (MODREG) {
+                v1 = avx_get_reg_empty(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                if (vex.l) {
+                    XVOR_V(v1, v0, v0);
+                } else {
+                    VOR_V(v1, v0, v0);
+                }
+                YMM0(v1);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                if (vex.l) {
+                    XVST(v0, ed, fixedaddress);
+                } else {
+                    VST(v0, ed, fixedaddress);
+                }
+                SMWRITE2();
+            }
+            break;
+
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
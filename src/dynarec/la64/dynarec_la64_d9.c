@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "emu/x87emu_private.h"
+#include "dynarec_native.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_D9(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)rep;
+    (void)need_epilog;
+
+    uint8_t nextop = F8;
+    uint8_t ed;
+    uint8_t wback, wb1;
+    uint8_t u8;
+    int64_t fixedaddress;
+    int v0, v1, v2;
+    int s0;
+    int64_t j64;
+
+    MAYUSE(s0);
+    MAYUSE(v0);
+    MAYUSE(v1);
+    MAYUSE(v2);
+    MAYUSE(j64);
+
+    switch (nextop) {
+        case 0xC0 ... 0xC7:
+            INST_NAME("FLD STx");
+            X87_PUSH_OR_FAIL(v2, dyn, ninst, x1, X87_ST(nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, (nextop & 7) + 1, X87_COMBINE(0, (nextop & 7) + 1));
+            FMOV_D(v2, v1);
+            break;
+
+        case 0xC8:
+            INST_NAME("FXCH ST0");
+            break;
+        case 0xC9 ... 0xCF:
+            INST_NAME("FXCH STx");
+            // swap the cache value, not the double value itself :p
+            x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_ST(nextop & 7));
+            x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            x87_swapreg(dyn, ninst, x1, x2, 0, nextop & 7);
+            // should set C1 to 0
+            break;
+
+        case 0xD0:
+            INST_NAME("FNOP");
+            break;
+
+        case 0xD8:
+            INST_NAME("FSTPNCE ST0, ST0");
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xD9 ... 0xDF:
+            INST_NAME("FSTPNCE ST0, STx");
+            // copy the cache value for st0 to stx
+            x87_get_st_empty(dyn, ninst, x1, x2, nextop & 7, X87_ST(nextop & 7));
+            x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            x87_swapreg(dyn, ninst, x1, x2, 0, nextop & 7);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xE0:
+            INST_NAME("FCHS");
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            FNEG_D(v1, v1);
+            break;
+        case 0xE1:
+            INST_NAME("FABS");
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            FABS_D(v1, v1);
+            break;
+
+        case 0xE4:
+            INST_NAME("FTST");
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            v2 = fpu_get_scratch(dyn);
+            MOVGR2FR_D(v2, xZR);
+            FCOM(v1, v2, x1, x2, x3);
+            break;
+        case 0xE5:
+            INST_NAME("FXAM");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_refresh(dyn, ninst, x1, x2, 0);
+            s0 = x87_stackcount(dyn, ninst, x1);
+            CALL(fpu_fxam, -1); // should be possible inline, but is it worth it?
+            x87_unstackcount(dyn, ninst, x1, s0);
+            break;
+
+        case 0xE8:
+            INST_NAME("FLD1");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x3FF0000000000000);
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xE9:
+            INST_NAME("FLDL2T");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x400A934F0979A371); // L2T
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xEA:
+            INST_NAME("FLDL2E");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x3FF71547652B82FE); // L2E
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xEB:
+            INST_NAME("FLDPI");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x400921FB54442D18); // PI
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xEC:
+            INST_NAME("FLDLG2");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x3FD34413509F79FF); // LG2
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xED:
+            INST_NAME("FLDLN2");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x3FE62E42FEFA39EF); // LN2
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xEE:
+            INST_NAME("FLDZ");
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOVGR2FR_D(v1, xZR);
+            break;
+
+        case 0xF0:
+            INST_NAME("F2XM1");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_f2xm1, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xF1:
+            INST_NAME("FYL2X");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fyl2x, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xF2:
+            INST_NAME("FPTAN");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_ftan, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+            MOV64x(x1, 0x3FF0000000000000);
+            MOVGR2FR_D(v1, x1);
+            break;
+        case 0xF3:
+            INST_NAME("FPATAN");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fpatan, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xF4:
+            INST_NAME("FXTRACT");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fxtract, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xF5:
+            INST_NAME("FPREM1");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fprem1, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xF6:
+            INST_NAME("FDECSTP");
+            fpu_purgecache(dyn, ninst, 0, x1, x2, x3);
+            LD_W(x2, xEmu, offsetof(x64emu_t, top));
+            ADDI_D(x2, x2, -1);
+            ANDI(x2, x2, 7);
+            ST_W(x2, xEmu, offsetof(x64emu_t, top));
+            break;
+        case 0xF7:
+            INST_NAME("FINCSTP");
+            fpu_purgecache(dyn, ninst, 0, x1, x2, x3);
+            LD_W(x2, xEmu, offsetof(x64emu_t, top));
+            ADDI_D(x2, x2, 1);
+            ANDI(x2, x2, 7);
+            ST_W(x2, xEmu, offsetof(x64emu_t, top));
+            break;
+        case 0xF8:
+            INST_NAME("FPREM");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fprem, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xF9:
+            INST_NAME("FYL2XP1");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fyl2xp1, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xFA:
+            INST_NAME("FSQRT");
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            FSQRT_D(v1, v1);
+            break;
+        case 0xFB:
+            INST_NAME("FSINCOS");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fsincos, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xFC:
+            INST_NAME("FRNDINT");
+            v0 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+            u8 = x87_setround(dyn, ninst, x1, x2);
+            FRINT_D(v0, v0); // uses the current rounding mode, keeps NaN/Inf and big values as-is
+            x87_restoreround(dyn, ninst, u8);
+            break;
+        case 0xFD:
+            INST_NAME("FSCALE");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            x87_forget(dyn, ninst, x1, x2, 1);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fscale, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xFE:
+            INST_NAME("FSIN");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fsin, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+        case 0xFF:
+            INST_NAME("FCOS");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_forget(dyn, ninst, x1, x2, 0);
+            s0 = x87_stackcount(dyn, ninst, x3);
+            CALL(native_fcos, -1);
+            x87_unstackcount(dyn, ninst, x3, s0);
+            break;
+
+        case 0xD1:
+        case 0xD4 ... 0xD7:
+        case 0xE2:
+        case 0xE3:
+        case 0xE6:
+        case 0xE7:
+        case 0xEF:
+            DEFAULT;
+            break;
+
+        default:
+            switch ((nextop >> 3) & 7) {
+                case 0:
+                    INST_NAME("FLD ST0, float[ED]");
+                    X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x2, x1, &fixedaddress, rex, NULL, 1, 0);
+                    FLD_S(v1, ed, fixedaddress);
+                    FCVT_D_S(v1, v1);
+                    break;
+                case 2:
+                    INST_NAME("FST float[ED], ST0");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    s0 = fpu_get_scratch(dyn);
+                    FCVT_S_D(s0, v1);
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x2, x1, &fixedaddress, rex, NULL, 1, 0);
+                    FST_S(s0, ed, fixedaddress);
+                    break;
+                case 3:
+                    INST_NAME("FSTP float[ED], ST0");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    s0 = fpu_get_scratch(dyn);
+                    FCVT_S_D(s0, v1);
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x2, x1, &fixedaddress, rex, NULL, 1, 0);
+                    FST_S(s0, ed, fixedaddress);
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                case 4:
+                    INST_NAME("FLDENV Ed");
+                    MESSAGE(LOG_DUMP, "Need Optimization\n");
+                    fpu_purgecache(dyn, ninst, 0, x1, x2, x3); // maybe only x87, not SSE?
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 0);
+                    if (ed != x1) {
+                        MV(x1, ed);
+                    }
+                    MOV32w(x2, 0);
+                    CALL(fpu_loadenv, -1);
+                    break;
+                case 5:
+                    INST_NAME("FLDCW Ew");
+                    GETEW(x1, 0);
+                    ST_H(x1, xEmu, offsetof(x64emu_t, cw));
+                    break;
+                case 6:
+                    INST_NAME("FNSTENV Ed");
+                    MESSAGE(LOG_DUMP, "Need Optimization\n");
+                    fpu_purgecache(dyn, ninst, 0, x1, x2, x3); // maybe only x87, not SSE?
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 0);
+                    if (ed != x1) {
+                        MV(x1, ed);
+                    }
+                    MOV32w(x2, 0);
+                    CALL(fpu_savenv, -1);
+                    break;
+                case 7:
+                    INST_NAME("FNSTCW Ew");
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x1, &fixedaddress, rex, NULL, 0, 0);
+                    ed = x1;
+                    wb1 = 1;
+                    LD_HU(x1, xEmu, offsetof(x64emu_t, cw));
+                    EWBACK;
+                    break;
+                default:
+                    DEFAULT;
+            }
+    }
+    return addr;
+}
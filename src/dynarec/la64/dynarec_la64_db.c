@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "emu/x87emu_private.h"
+#include "dynarec_native.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_DB(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)rep;
+    (void)need_epilog;
+
+    uint8_t nextop = F8;
+    uint8_t ed;
+    uint8_t wback;
+    uint8_t u8;
+    int64_t fixedaddress;
+    int64_t j64;
+    int v1, v2;
+    int s0;
+
+    MAYUSE(s0);
+    MAYUSE(v2);
+    MAYUSE(v1);
+    MAYUSE(j64);
+
+    switch (nextop) {
+        case 0xC0 ... 0xC7:
+            INST_NAME("FCMOVNB ST0, STx");
+            READFLAGS(X_CF);
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            ANDI(x1, xFlags, 1 << F_CF);
+            CBNZ_NEXT(x1);
+            FMOV_D(v1, v2);
+            break;
+        case 0xC8 ... 0xCF:
+            INST_NAME("FCMOVNE ST0, STx");
+            READFLAGS(X_ZF);
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            ANDI(x1, xFlags, 1 << F_ZF);
+            CBNZ_NEXT(x1);
+            FMOV_D(v1, v2);
+            break;
+        case 0xD0 ... 0xD7:
+            INST_NAME("FCMOVNBE ST0, STx");
+            READFLAGS(X_CF | X_ZF);
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            ANDI(x1, xFlags, (1 << F_CF) | (1 << F_ZF));
+            CBNZ_NEXT(x1);
+            FMOV_D(v1, v2);
+            break;
+        case 0xD8 ... 0xDF:
+            INST_NAME("FCMOVNU ST0, STx");
+            READFLAGS(X_PF);
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            ANDI(x1, xFlags, 1 << F_PF);
+            CBNZ_NEXT(x1);
+            FMOV_D(v1, v2);
+            break;
+        case 0xE1:
+            INST_NAME("FDISI8087_NOP"); // so.. NOP?
+            break;
+        case 0xE2:
+            INST_NAME("FNCLEX");
+            LD_H(x2, xEmu, offsetof(x64emu_t, sw));
+            MOV32w(x1, ~((1 << 15) | 0xff)); // B, IE .. PE, SF, ES
+            AND(x2, x2, x1);
+            ST_H(x2, xEmu, offsetof(x64emu_t, sw));
+            break;
+        case 0xE3:
+            INST_NAME("FNINIT");
+            MESSAGE(LOG_DUMP, "Need Optimization\n");
+            x87_purgecache(dyn, ninst, 0, x1, x2, x3);
+            CALL(reset_fpu, -1);
+            break;
+        case 0xE8 ... 0xEF:
+            INST_NAME("FUCOMI ST0, STx");
+            SETFLAGS(X_ALL, SF_SET);
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FCOMI(v1, v2, x1, x2, x3);
+            break;
+        case 0xF0 ... 0xF7:
+            INST_NAME("FCOMI ST0, STx");
+            SETFLAGS(X_ALL, SF_SET);
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FCOMI(v1, v2, x1, x2, x3);
+            break;
+
+        case 0xE0:
+        case 0xE4 ... 0xE7:
+        case 0xF8 ... 0xFF:
+            DEFAULT;
+            break;
+
+        default:
+            switch ((nextop >> 3) & 7) {
+                case 0:
+                    INST_NAME("FILD ST0, Ed");
+                    X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x2, x1, &fixedaddress, rex, NULL, 1, 0);
+                    FLD_S(v1, ed, fixedaddress);
+                    FFINT_D_W(v1, v1); // i32 -> double
+                    break;
+                case 1:
+                    INST_NAME("FISTTP Ed, ST0");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, LSX_CACHE_ST_D);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                    s0 = fpu_get_scratch(dyn);
+                    if (!box64_dynarec_fastround) {
+                        MOVGR2FCSR(FCSR2, xZR); // reset all bits
+                    }
+                    FTINTRZ_W_D(s0, v1);
+                    MOVFR2GR_S(x4, s0);
+                    if (!box64_dynarec_fastround) {
+                        MOVFCSR2GR(x5, FCSR2); // get back FPSR to check
+                        MOV32w(x6, (1 << FR_V) | (1 << FR_O));
+                        AND(x5, x5, x6);
+                        BEQZ_MARK(x5);
+                        MOV32w(x4, 0x80000000);
+                        MARK;
+                    }
+                    ST_W(x4, wback, fixedaddress);
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                case 2:
+                case 3:
+                    if (((nextop >> 3) & 7) == 2) {
+                        INST_NAME("FIST Ed, ST0");
+                    } else {
+                        INST_NAME("FISTP Ed, ST0");
+                    }
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, LSX_CACHE_ST_D);
+                    u8 = x87_setround(dyn, ninst, x1, x5);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                    s0 = fpu_get_scratch(dyn);
+                    if (!box64_dynarec_fastround) {
+                        MOVGR2FCSR(FCSR2, xZR); // reset all bits
+                    }
+                    FTINT_W_D(s0, v1);
+                    x87_restoreround(dyn, ninst, u8);
+                    MOVFR2GR_S(x4, s0);
+                    if (!box64_dynarec_fastround) {
+                        MOVFCSR2GR(x5, FCSR2); // get back FPSR to check
+                        MOV32w(x6, (1 << FR_V) | (1 << FR_O));
+                        AND(x5, x5, x6);
+                        BEQZ_MARK2(x5);
+                        MOV32w(x4, 0x80000000);
+                        MARK2;
+                    }
+                    ST_W(x4, wback, fixedaddress);
+                    if (((nextop >> 3) & 7) == 3) {
+                        X87_POP_OR_FAIL(dyn, ninst, x3);
+                    }
+                    break;
+                case 5:
+                    INST_NAME("FLD tbyte");
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 8, 0);
+                    if ((PK(0) == 0xDB && ((PK(1) >> 3) & 7) == 7) || (PK(0) >= 0x40 && PK(0) <= 0x4f && PK(1) == 0xDB && ((PK(2) >> 3) & 7) == 7)) {
+                        // the FLD is immediatly followed by an FSTP
+                        LD_D(x5, ed, fixedaddress + 0);
+                        LD_H(x6, ed, fixedaddress + 8);
+                        // no persistant scratch register, so unrool both instruction here...
+                        MESSAGE(LOG_DUMP, "\tHack: FSTP tbyte\n");
+                        nextop = F8; // 0xDB or rex
+                        if (nextop >= 0x40 && nextop <= 0x4f) {
+                            rex.rex = nextop;
+                            nextop = F8; // 0xDB
+                        } else
+                            rex.rex = 0;
+                        nextop = F8; // modrm
+                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 8, 0);
+                        ST_D(x5, ed, fixedaddress + 0);
+                        ST_H(x6, ed, fixedaddress + 8);
+                    } else {
+                        if (box64_x87_no80bits) {
+                            X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+                            FLD_D(v1, ed, fixedaddress);
+                        } else {
+                            if (ed != x1) {
+                                ADDI_D(x1, ed, fixedaddress);
+                            }
+                            X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, x3);
+                            CALL(native_fld, -1);
+                        }
+                    }
+                    break;
+                case 7:
+                    INST_NAME("FSTP tbyte");
+                    if (box64_x87_no80bits) {
+                        v1 = x87_get_st(dyn, ninst, x1, x2, 0, LSX_CACHE_ST_D);
+                        addr = geted(dyn, addr, ninst, nextop, &wback, x2, x1, &fixedaddress, rex, NULL, 1, 0);
+                        FST_D(v1, wback, fixedaddress);
+                    } else {
+                        x87_forget(dyn, ninst, x1, x3, 0);
+                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 0);
+                        if (ed != x1) {
+                            MV(x1, ed);
+                        }
+                        s0 = x87_stackcount(dyn, ninst, x3);
+                        CALL(native_fstp, -1);
+                        x87_unstackcount(dyn, ninst, x3, s0);
+                    }
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                default:
+                    DEFAULT;
+            }
+    }
+    return addr;
+}
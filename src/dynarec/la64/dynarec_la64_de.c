@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "emu/x87emu_private.h"
+#include "dynarec_native.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+uintptr_t dynarec64_DE(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)rep;
+    (void)need_epilog;
+
+    uint8_t nextop = F8;
+    uint8_t wback;
+    int64_t fixedaddress;
+    int v1, v2;
+
+    MAYUSE(v2);
+    MAYUSE(v1);
+
+    switch (nextop) {
+        case 0xC0 ... 0xC7:
+            INST_NAME("FADDP STx, ST0");
+            v2 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FADD_D(v1, v1, v2);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xC8 ... 0xCF:
+            INST_NAME("FMULP STx, ST0");
+            v2 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FMUL_D(v1, v1, v2);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xD0 ... 0xD7:
+            INST_NAME("FCOMP ST0, STx"); // yep
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FCOM(v1, v2, x1, x2, x3);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xD9:
+            INST_NAME("FCOMPP ST0, STx");
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FCOM(v1, v2, x1, x2, x3);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xE0 ... 0xE7:
+            INST_NAME("FSUBRP STx, ST0");
+            v2 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FSUB_D(v1, v2, v1);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xE8 ... 0xEF:
+            INST_NAME("FSUBP STx, ST0");
+            v2 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FSUB_D(v1, v1, v2);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xF0 ... 0xF7:
+            INST_NAME("FDIVRP STx, ST0");
+            v2 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FDIV_D(v1, v2, v1);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xF8 ... 0xFF:
+            INST_NAME("FDIVP STx, ST0");
+            v2 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v1 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FDIV_D(v1, v1, v2);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xD8:
+        case 0xDA ... 0xDF:
+            DEFAULT;
+            break;
+        default:
+            switch ((nextop >> 3) & 7) {
+                case 0:
+                    INST_NAME("FIADD ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FADD_D(v1, v1, v2);
+                    break;
+                case 1:
+                    INST_NAME("FIMUL ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FMUL_D(v1, v1, v2);
+                    break;
+                case 2:
+                    INST_NAME("FICOM ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FCOM(v1, v2, x1, x6, x4);
+                    break;
+                case 3:
+                    INST_NAME("FICOMP ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FCOM(v1, v2, x1, x6, x4);
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                case 4:
+                    INST_NAME("FISUB ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FSUB_D(v1, v1, v2);
+                    break;
+                case 5:
+                    INST_NAME("FISUBR ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FSUB_D(v1, v2, v1);
+                    break;
+                case 6:
+                    INST_NAME("FIDIV ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FDIV_D(v1, v1, v2);
+                    break;
+                case 7:
+                    INST_NAME("FIDIVR ST0, Ew");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_ST0);
+                    v2 = fpu_get_scratch(dyn);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v2, x1);
+                    FFINT_D_L(v2, v2); // i16 -> double
+                    FDIV_D(v1, v2, v1);
+                    break;
+            }
+    }
+    return addr;
+}
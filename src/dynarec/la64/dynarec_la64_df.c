@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "la64_emitter.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "emu/x87emu_private.h"
+#include "dynarec_native.h"
+
+#include "la64_printer.h"
+#include "dynarec_la64_private.h"
+#include "dynarec_la64_functions.h"
+#include "dynarec_la64_helper.h"
+
+
+uintptr_t dynarec64_DF(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)rep;
+    (void)need_epilog;
+
+    uint8_t nextop = F8;
+    uint8_t ed, wback, u8;
+    int64_t fixedaddress;
+    int64_t j64;
+    int v1, v2;
+    int s0;
+
+    MAYUSE(s0);
+    MAYUSE(v2);
+    MAYUSE(v1);
+    MAYUSE(j64);
+
+    switch (nextop) {
+        case 0xC0 ... 0xC7:
+            INST_NAME("FFREEP STx");
+            // not handling Tag...
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+
+        case 0xE0:
+            INST_NAME("FNSTSW AX");
+            LD_WU(x2, xEmu, offsetof(x64emu_t, top));
+            if (dyn->lsx.x87stack) {
+                ADDI_D(x2, x2, -dyn->lsx.x87stack);
+                ANDI(x2, x2, 0x7);
+            }
+            LD_HU(x1, xEmu, offsetof(x64emu_t, sw));
+            MOV32w(x3, 0b1100011111111111); // mask
+            AND(x1, x1, x3);
+            SLLI_D(x2, x2, 11);
+            OR(x1, x1, x2); // inject top
+            ST_H(x1, xEmu, offsetof(x64emu_t, sw));
+            BSTRINS_D(xRAX, x1, 15, 0);
+            break;
+        case 0xE8 ... 0xF7:
+            if (nextop < 0xF0) {
+                INST_NAME("FUCOMIP ST0, STx");
+            } else {
+                INST_NAME("FCOMIP ST0, STx");
+            }
+            SETFLAGS(X_ALL, SF_SET);
+            SET_DFNONE();
+            v1 = x87_get_st(dyn, ninst, x1, x2, 0, X87_COMBINE(0, nextop & 7));
+            v2 = x87_get_st(dyn, ninst, x1, x2, nextop & 7, X87_COMBINE(0, nextop & 7));
+            FCOMI(v1, v2, x1, x2, x3);
+            X87_POP_OR_FAIL(dyn, ninst, x3);
+            break;
+        case 0xC8 ... 0xDF:
+        case 0xE1 ... 0xE7:
+        case 0xF8 ... 0xFF:
+            DEFAULT;
+            break;
+
+        default:
+            switch ((nextop >> 3) & 7) {
+                case 0:
+                    INST_NAME("FILD ST0, Ew");
+                    X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    LD_H(x1, wback, fixedaddress);
+                    MOVGR2FR_D(v1, x1);
+                    FFINT_D_L(v1, v1); // i16 -> double
+                    break;
+                case 1:
+                    INST_NAME("FISTTP Ew, ST0");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, LSX_CACHE_ST_D);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x3, x4, &fixedaddress, rex, NULL, 1, 0);
+                    s0 = fpu_get_scratch(dyn);
+                    if (!box64_dynarec_fastround) {
+                        MOVGR2FCSR(FCSR2, xZR); // reset all bits
+                    }
+                    FTINTRZ_W_D(s0, v1);
+                    MOVFR2GR_S(x4, s0);
+                    if (!box64_dynarec_fastround) {
+                        MOVFCSR2GR(x5, FCSR2); // get back FPSR to check
+                        MOV32w(x6, (1 << FR_V) | (1 << FR_O));
+                        AND(x5, x5, x6);
+                        BNEZ_MARK(x5);
+                        EXT_W_H(x5, x4);
+                        BEQ_MARK2(x5, x4);
+                        MARK;
+                        MOV32w(x4, 0x8000);
+                    }
+                    MARK2;
+                    ST_H(x4, wback, fixedaddress);
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                case 2:
+                case 3:
+                    if (((nextop >> 3) & 7) == 2) {
+                        INST_NAME("FIST Ew, ST0");
+                    } else {
+                        INST_NAME("FISTP Ew, ST0");
+                    }
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, LSX_CACHE_ST_D);
+                    u8 = x87_setround(dyn, ninst, x1, x5);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                    s0 = fpu_get_scratch(dyn);
+                    if (!box64_dynarec_fastround) {
+                        MOVGR2FCSR(FCSR2, xZR); // reset all bits
+                    }
+                    FTINT_W_D(s0, v1);
+                    x87_restoreround(dyn, ninst, u8);
+                    MOVFR2GR_S(x4, s0);
+                    if (!box64_dynarec_fastround) {
+                        MOVFCSR2GR(x5, FCSR2); // get back FPSR to check
+                        MOV32w(x6, (1 << FR_V) | (1 << FR_O));
+                        AND(x5, x5, x6);
+                        BNEZ_MARK(x5);
+                        EXT_W_H(x5, x4);
+                        BEQ_MARK2(x5, x4);
+                        MARK;
+                        MOV32w(x4, 0x8000);
+                    }
+                    MARK2;
+                    ST_H(x4, wback, fixedaddress);
+                    if (((nextop >> 3) & 7) == 3) {
+                        X87_POP_OR_FAIL(dyn, ninst, x3);
+                    }
+                    break;
+                case 4:
+                    INST_NAME("FBLD ST0, tbytes");
+                    X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, x1);
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 0);
+                    if (ed != x1) { MV(x1, ed); }
+                    s0 = x87_stackcount(dyn, ninst, x3);
+                    CALL(fpu_fbld, -1);
+                    x87_unstackcount(dyn, ninst, x3, s0);
+                    break;
+                case 5:
+                    INST_NAME("FILD ST0, i64");
+                    X87_PUSH_OR_FAIL(v1, dyn, ninst, x1, LSX_CACHE_ST_D);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                    FLD_D(v1, wback, fixedaddress);
+                    FFINT_D_L(v1, v1); // i64 -> double
+                    break;
+                case 6:
+                    INST_NAME("FBSTP tbytes, ST0");
+                    x87_forget(dyn, ninst, x1, x2, 0);
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 0);
+                    if (ed != x1) { MV(x1, ed); }
+                    s0 = x87_stackcount(dyn, ninst, x3);
+                    CALL(fpu_fbst, -1);
+                    x87_unstackcount(dyn, ninst, x3, s0);
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                case 7:
+                    INST_NAME("FISTP i64, ST0");
+                    v1 = x87_get_st(dyn, ninst, x1, x2, 0, LSX_CACHE_ST_D);
+                    u8 = x87_setround(dyn, ninst, x1, x5);
+                    addr = geted(dyn, addr, ninst, nextop, &wback, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                    s0 = fpu_get_scratch(dyn);
+                    if (!box64_dynarec_fastround) {
+                        MOVGR2FCSR(FCSR2, xZR); // reset all bits
+                    }
+                    FTINT_L_D(s0, v1);
+                    x87_restoreround(dyn, ninst, u8);
+                    if (!box64_dynarec_fastround) {
+                        MOVFCSR2GR(x5, FCSR2); // get back FPSR to check
+                        MOV32w(x6, (1 << FR_V) | (1 << FR_O));
+                        AND(x5, x5, x6);
+                        BEQZ_MARK(x5);
+                        MOV64x(x4, 0x8000000000000000LL);
+                        MOVGR2FR_D(s0, x4);
+                        MARK;
+                    }
+                    FST_D(s0, wback, fixedaddress);
+                    X87_POP_OR_FAIL(dyn, ninst, x3);
+                    break;
+                default:
+                    DEFAULT;
+                    break;
+            }
+    }
+    return addr;
+}
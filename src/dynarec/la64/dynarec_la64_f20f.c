@@ -154,6 +154,33 @@ uintptr_t dynarec64_F20F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 }
             }
             break;
+        case 0x38: // these are some more SSSE4.2+ opcodes
+            opcode = F8;
+            switch (opcode) {
+                case 0xF0:
+                    INST_NAME("CRC32 Gd, Eb");
+                    nextop = F8;
+                    GETEB(x1, 0);
+                    GETGD;
+                    CRCC_W_B_W(gd, ed, gd);
+                    ZEROUP(gd);
+                    break;
+                case 0xF1:
+                    INST_NAME("CRC32 Gd, Ed");
+                    nextop = F8;
+                    GETGD;
+                    GETED(0);
+                    if (rex.w) {
+                        CRCC_W_D_W(gd, ed, gd);
+                    } else {
+                        CRCC_W_W_W(gd, ed, gd);
+                    }
+                    ZEROUP(gd);
+                    break;
+                default:
+                    DEFAULT;
+            }
+            break;
         case 0x51:
             INST_NAME("SQRTSD Gx, Ex");
             nextop = F8;
@@ -12,6 +12,8 @@ typedef struct dynarec_la64_s dynarec_la64_t;
 int fpu_get_scratch(dynarec_la64_t* dyn);
 // Reset scratch regs counter
 void fpu_reset_scratch(dynarec_la64_t* dyn);
+// Get an x87 double reg
+int fpu_get_reg_x87(dynarec_la64_t* dyn, int t, int n);
 // Get an XMM quad reg
 int fpu_get_reg_xmm(dynarec_la64_t* dyn, int t, int xmm);
 // Free a FPU/MMX/XMM reg
@@ -19,6 +21,11 @@ void fpu_free_reg(dynarec_la64_t* dyn, int reg);
 // Reset fpu regs counter
 void fpu_reset_reg(dynarec_la64_t* dyn);
 
+// Get type for STx
+int lsxcache_get_st(dynarec_la64_t* dyn, int ninst, int a);
+// Get if STx is FLOAT or DOUBLE
+int lsxcache_get_current_st(dynarec_la64_t* dyn, int ninst, int a);
+
 // FPU Cache transformation (for loops) // Specific, need to be written by backend
 int fpuCacheNeedsTransform(dynarec_la64_t* dyn, int ninst);
 
@@ -33,5 +40,7 @@ void print_opcode(dynarec_native_t* dyn, int ninst, uint32_t opcode);
 // reset the cache
 void fpu_reset(dynarec_native_t* dyn);
 void fpu_reset_ninst(dynarec_native_t* dyn, int ninst);
+// is st freed
+int fpu_is_st_freed(dynarec_native_t* dyn, int ninst, int st);
 
 #endif //__DYNAREC_LA64_FUNCTIONS_H__
@@ -37,6 +37,8 @@ uintptr_t geted(dynarec_la64_t* dyn, uintptr_t addr, int ninst, uint8_t nextop,
     MAYUSE(ninst);
     MAYUSE(delta);
 
+    smclassify_ed(dyn, addr, ninst, nextop, rex);
+
     if (rex.is32bits)
         return geted_32(dyn, addr, ninst, nextop, ed, hint, scratch, fixaddress, l, i12);
 
@@ -331,6 +333,8 @@ uintptr_t geted32(dynarec_la64_t* dyn, uintptr_t addr, int ninst, uint8_t nextop
     MAYUSE(ninst);
     MAYUSE(delta);
 
+    smclassify_ed(dyn, addr, ninst, nextop, rex);
+
     int lock = l ? ((l == LOCK_LOCK) ? 1 : 2) : 0;
     if (lock == 2)
         *l = 0;
@@ -701,6 +705,7 @@ void grab_segdata(dynarec_la64_t* dyn, uintptr_t addr, int ninst, int reg, int s
     (void)addr;
     int64_t j64;
     MAYUSE(j64);
+    dyn->insts[ninst].x64.mem_tls = 1;   // segment based access are thread local
     MESSAGE(LOG_DUMP, "Get %s Offset\n", (segment == _FS) ? "FS" : "GS");
     int t1 = x1, t2 = x4;
     if (reg == t1) ++t1;
@@ -722,9 +727,528 @@ void grab_segdata(dynarec_la64_t* dyn, uintptr_t addr, int ninst, int reg, int s
 }
 
 
+// x87 stuffs
+int x87_stackcount(dynarec_la64_t* dyn, int ninst, int scratch)
+{
+    MAYUSE(scratch);
+    if (!dyn->lsx.x87stack)
+        return 0;
+    MESSAGE(LOG_DUMP, "\tSynch x87 Stackcount (%d)\n", dyn->lsx.x87stack);
+    int a = dyn->lsx.x87stack;
+    // Add x87stack to emu fpu_stack
+    LD_W(scratch, xEmu, offsetof(x64emu_t, fpu_stack));
+    ADDI_D(scratch, scratch, a);
+    ST_W(scratch, xEmu, offsetof(x64emu_t, fpu_stack));
+    // Sub x87stack to top, with and 7
+    LD_W(scratch, xEmu, offsetof(x64emu_t, top));
+    ADDI_D(scratch, scratch, -a);
+    ANDI(scratch, scratch, 7);
+    ST_W(scratch, xEmu, offsetof(x64emu_t, top));
+    // reset x87stack, but not the stack count of lsxcache
+    dyn->lsx.x87stack = 0;
+    dyn->lsx.stack_next -= dyn->lsx.stack;
+    int ret = dyn->lsx.stack;
+    dyn->lsx.stack = 0;
+    MESSAGE(LOG_DUMP, "\t------x87 Stackcount\n");
+    return ret;
+}
+
+void x87_unstackcount(dynarec_la64_t* dyn, int ninst, int scratch, int count)
+{
+    MAYUSE(scratch);
+    if (!count)
+        return;
+    MESSAGE(LOG_DUMP, "\tSynch x87 Unstackcount (%d)\n", count);
+    int a = -count;
+    // Add x87stack to emu fpu_stack
+    LD_W(scratch, xEmu, offsetof(x64emu_t, fpu_stack));
+    ADDI_D(scratch, scratch, a);
+    ST_W(scratch, xEmu, offsetof(x64emu_t, fpu_stack));
+    // Sub x87stack to top, with and 7
+    LD_W(scratch, xEmu, offsetof(x64emu_t, top));
+    ADDI_D(scratch, scratch, -a);
+    ANDI(scratch, scratch, 7);
+    ST_W(scratch, xEmu, offsetof(x64emu_t, top));
+    // reset x87stack, but not the stack count of lsxcache
+    dyn->lsx.x87stack = count;
+    dyn->lsx.stack = count;
+    dyn->lsx.stack_next += dyn->lsx.stack;
+    MESSAGE(LOG_DUMP, "\t------x87 Unstackcount\n");
+}
+
+int x87_do_push(dynarec_la64_t* dyn, int ninst, int s1, int t)
+{
+    dyn->lsx.x87stack += 1;
+    dyn->lsx.stack += 1;
+    dyn->lsx.stack_next += 1;
+    dyn->lsx.stack_push += 1;
+    ++dyn->lsx.pushed;
+    if (dyn->lsx.poped)
+        --dyn->lsx.poped;
+    // move all regs in cache, and find a free one
+    for (int j = 0; j < 24; ++j)
+        if ((dyn->lsx.lsxcache[j].t == LSX_CACHE_ST_D)
+            || (dyn->lsx.lsxcache[j].t == LSX_CACHE_ST_F)
+            || (dyn->lsx.lsxcache[j].t == LSX_CACHE_ST_I64))
+            ++dyn->lsx.lsxcache[j].n;
+    int ret = -1;
+    dyn->lsx.tags <<= 2;
+    for (int i = 0; i < 8; ++i)
+        if (dyn->lsx.x87cache[i] != -1)
+            ++dyn->lsx.x87cache[i];
+        else if (ret == -1) {
+            dyn->lsx.x87cache[i] = 0;
+            ret = dyn->lsx.x87reg[i] = fpu_get_reg_x87(dyn, t, 0);
+            dyn->lsx.lsxcache[ret].t = X87_ST0;
+        }
+    if (ret == -1) {
+        MESSAGE(LOG_DUMP, "Incoherent x87 stack cache, aborting\n");
+        dyn->abort = 1;
+    }
+    return ret;
+}
+
+void x87_do_push_empty(dynarec_la64_t* dyn, int ninst, int s1)
+{
+    dyn->lsx.x87stack += 1;
+    dyn->lsx.stack += 1;
+    dyn->lsx.stack_next += 1;
+    dyn->lsx.stack_push += 1;
+    ++dyn->lsx.pushed;
+    if (dyn->lsx.poped)
+        --dyn->lsx.poped;
+    // move all regs in cache
+    for (int j = 0; j < 24; ++j)
+        if ((dyn->lsx.lsxcache[j].t == LSX_CACHE_ST_D)
+            || (dyn->lsx.lsxcache[j].t == LSX_CACHE_ST_F)
+            || (dyn->lsx.lsxcache[j].t == LSX_CACHE_ST_I64))
+            ++dyn->lsx.lsxcache[j].n;
+    int ret = -1;
+    dyn->lsx.tags <<= 2;
+    for (int i = 0; i < 8; ++i)
+        if (dyn->lsx.x87cache[i] != -1)
+            ++dyn->lsx.x87cache[i];
+        else if (ret == -1)
+            ret = i;
+    if (ret == -1) {
+        MESSAGE(LOG_DUMP, "Incoherent x87 stack cache, aborting\n");
+        dyn->abort = 1;
+    }
+    if (s1)
+        x87_stackcount(dyn, ninst, s1);
+}
+
+static void internal_x87_dopop(dynarec_la64_t* dyn)
+{
+    for (int i = 0; i < 8; ++i)
+        if (dyn->lsx.x87cache[i] != -1) {
+            --dyn->lsx.x87cache[i];
+            if (dyn->lsx.x87cache[i] == -1) {
+                fpu_free_reg(dyn, dyn->lsx.x87reg[i]);
+                dyn->lsx.x87reg[i] = -1;
+            }
+        }
+}
+
+static int internal_x87_dofree(dynarec_la64_t* dyn)
+{
+    if (dyn->lsx.tags & 0b11) {
+        MESSAGE(LOG_DUMP, "\t--------x87 FREED ST0, poping 1 more\n");
+        return 1;
+    }
+    return 0;
+}
+
+void x87_do_pop(dynarec_la64_t* dyn, int ninst, int s1)
+{
+    do {
+        dyn->lsx.x87stack -= 1;
+        dyn->lsx.stack_next -= 1;
+        dyn->lsx.stack_pop += 1;
+        dyn->lsx.tags >>= 2;
+        ++dyn->lsx.poped;
+        if (dyn->lsx.pushed)
+            --dyn->lsx.pushed;
+        // move all regs in cache, poping ST0
+        internal_x87_dopop(dyn);
+    } while (internal_x87_dofree(dyn));
+}
+
+void x87_purgecache(dynarec_la64_t* dyn, int ninst, int next, int s1, int s2, int s3)
+{
+    int ret = 0;
+    for (int i = 0; i < 8 && !ret; ++i)
+        if (dyn->lsx.x87cache[i] != -1)
+            ret = 1;
+    if (!ret && !dyn->lsx.x87stack) // nothing to do
+        return;
+    MESSAGE(LOG_DUMP, "\tPurge %sx87 Cache and Synch Stackcount (%+d)---\n", next ? "locally " : "", dyn->lsx.x87stack);
+    int a = dyn->lsx.x87stack;
+    if (a != 0) {
+        // reset x87stack
+        if (!next)
+            dyn->lsx.x87stack = 0;
+        // Add x87stack to emu fpu_stack
+        LD_W(s2, xEmu, offsetof(x64emu_t, fpu_stack));
+        ADDI_D(s2, s2, a);
+        ST_W(s2, xEmu, offsetof(x64emu_t, fpu_stack));
+        // Sub x87stack to top, with and 7
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+        ADDI_D(s2, s2, -a);
+        ANDI(s2, s2, 7);
+        ST_W(s2, xEmu, offsetof(x64emu_t, top));
+        // update tags (and top at the same time)
+        LD_HU(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+        if (a > 0) {
+            SLLI_D(s1, s1, a * 2);
+        } else {
+            LU12I_W(s3, 0xffff0); // 0xffff0000
+            OR(s1, s1, s3);
+            SRLI_D(s1, s1, -a * 2);
+        }
+        ST_H(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+    } else {
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+    }
+    // check if free is used
+    if (dyn->lsx.tags) {
+        LD_H(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+        MOV32w(s3, dyn->lsx.tags);
+        OR(s1, s1, s3);
+        ST_H(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+    }
+    if (ret != 0) {
+        // --- set values
+        // loop all cache entries
+        for (int i = 0; i < 8; ++i)
+            if (dyn->lsx.x87cache[i] != -1) {
+                ADDI_D(s3, s2, dyn->lsx.x87cache[i]); // unadjusted count, as it's relative to real top
+                ANDI(s3, s3, 7);                       // (emu->top + st)&7
+                ALSL_D(s1, s3, xEmu, 3);
+                FST_D(dyn->lsx.x87reg[i], s1, offsetof(x64emu_t, x87)); // save the value
+                if (!next) {
+                    fpu_free_reg(dyn, dyn->lsx.x87reg[i]);
+                    dyn->lsx.x87reg[i] = -1;
+                    dyn->lsx.x87cache[i] = -1;
+                    // dyn->lsx.stack_pop+=1; //no pop, but the purge because of barrier will have the n.barrier flags set
+                }
+            }
+    }
+    if (!next) {
+        dyn->lsx.stack_next = 0;
+        dyn->lsx.tags = 0;
+#if STEP < 2
+        // refresh the cached valued, in case it's a purge outside a instruction
+        dyn->insts[ninst].lsx.barrier = 1;
+        dyn->lsx.pushed = 0;
+        dyn->lsx.poped = 0;
+#endif
+    }
+    MESSAGE(LOG_DUMP, "\t---Purge x87 Cache and Synch Stackcount\n");
+}
+
+static void x87_reflectcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3)
+{
+    // Sync top and stack count
+    int a = dyn->lsx.x87stack;
+    if (a) {
+        // Add x87stack to emu fpu_stack
+        LD_W(s2, xEmu, offsetof(x64emu_t, fpu_stack));
+        ADDI_D(s2, s2, a);
+        ST_W(s2, xEmu, offsetof(x64emu_t, fpu_stack));
+        // Sub x87stack to top, with and 7
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+        ADDI_D(s2, s2, -a);
+        ANDI(s2, s2, 7);
+        ST_W(s2, xEmu, offsetof(x64emu_t, top));
+        // update tags (and top at the same time)
+        LD_HU(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+        if (a > 0) {
+            SLLI_D(s1, s1, a * 2);
+        } else {
+            LU12I_W(s3, 0xffff0); // 0xffff0000
+            OR(s1, s1, s3);
+            SRLI_D(s1, s1, -a * 2);
+        }
+        ST_H(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+    }
+    int ret = 0;
+    for (int i = 0; (i < 8) && (!ret); ++i)
+        if (dyn->lsx.x87cache[i] != -1)
+            ret = 1;
+    if (!ret) // nothing to do
+        return;
+    // prepare offset to fpu => s1
+    // Get top
+    if (!a) {
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+    }
+    // loop all cache entries
+    for (int i = 0; i < 8; ++i)
+        if (dyn->lsx.x87cache[i] != -1) {
+            ADDI_D(s3, s2, dyn->lsx.x87cache[i]);
+            ANDI(s3, s3, 7); // (emu->top + i)&7
+            ALSL_D(s1, s3, xEmu, 3);
+            FST_D(dyn->lsx.x87reg[i], s1, offsetof(x64emu_t, x87));
+        }
+}
+
+static void x87_unreflectcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3)
+{
+    // revert top and stack count
+    int a = dyn->lsx.x87stack;
+    if (a) {
+        // Sub x87stack to emu fpu_stack
+        LD_W(s2, xEmu, offsetof(x64emu_t, fpu_stack));
+        ADDI_D(s2, s2, -a);
+        ST_W(s2, xEmu, offsetof(x64emu_t, fpu_stack));
+        // Add x87stack to top, with and 7
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+        ADDI_D(s2, s2, a);
+        ANDI(s2, s2, 7);
+        ST_W(s2, xEmu, offsetof(x64emu_t, top));
+        // revert tags
+        LD_HU(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+        if (a > 0) {
+            LU12I_W(s3, 0xffff0); // 0xffff0000
+            OR(s1, s1, s3);
+            SRLI_D(s1, s1, a * 2);
+        } else {
+            SLLI_D(s1, s1, -a * 2);
+        }
+        ST_H(s1, xEmu, offsetof(x64emu_t, fpu_tags));
+    }
+}
+
+int x87_get_current_cache(dynarec_la64_t* dyn, int ninst, int st, int t)
+{
+    // search in cache first
+    for (int i = 0; i < 8; ++i) {
+        if (dyn->lsx.x87cache[i] == st)
+            return i;
+        assert(dyn->lsx.x87cache[i] < 8);
+    }
+    return -1;
+}
+
+int x87_get_cache(dynarec_la64_t* dyn, int ninst, int populate, int s1, int s2, int st, int t)
+{
+    int ret = x87_get_current_cache(dyn, ninst, st, t);
+    if (ret != -1)
+        return ret;
+    MESSAGE(LOG_DUMP, "\tCreate %sx87 Cache for ST%d\n", populate ? "and populate " : "", st);
+    // get a free spot
+    for (int i = 0; (i < 8) && (ret == -1); ++i)
+        if (dyn->lsx.x87cache[i] == -1)
+            ret = i;
+    // found, setup and grab the value
+    dyn->lsx.x87cache[ret] = st;
+    dyn->lsx.x87reg[ret] = fpu_get_reg_x87(dyn, LSX_CACHE_ST_D, st);
+    if (populate) {
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+        int a = st - dyn->lsx.x87stack;
+        if (a) {
+            ADDI_D(s2, s2, a);
+            ANDI(s2, s2, 7);
+        }
+        ALSL_D(s1, s2, xEmu, 3);
+        FLD_D(dyn->lsx.x87reg[ret], s1, offsetof(x64emu_t, x87));
+    }
+    MESSAGE(LOG_DUMP, "\t-------x87 Cache for ST%d\n", st);
+
+    return ret;
+}
+
+int x87_get_lsxcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st)
+{
+    for (int ii = 0; ii < 24; ++ii)
+        if ((dyn->lsx.lsxcache[ii].t == LSX_CACHE_ST_F
+                || dyn->lsx.lsxcache[ii].t == LSX_CACHE_ST_D
+                || dyn->lsx.lsxcache[ii].t == LSX_CACHE_ST_I64)
+            && dyn->lsx.lsxcache[ii].n == st)
+            return ii;
+    assert(0);
+    return -1;
+}
+
+int x87_get_st(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a, int t)
+{
+    return dyn->lsx.x87reg[x87_get_cache(dyn, ninst, 1, s1, s2, a, t)];
+}
+
+int x87_get_st_empty(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a, int t)
+{
+    return dyn->lsx.x87reg[x87_get_cache(dyn, ninst, 0, s1, s2, a, t)];
+}
+
+void x87_refresh(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st)
+{
+    int ret = -1;
+    for (int i = 0; (i < 8) && (ret == -1); ++i)
+        if (dyn->lsx.x87cache[i] == st)
+            ret = i;
+    if (ret == -1) // nothing to do
+        return;
+    MESSAGE(LOG_DUMP, "\tRefresh x87 Cache for ST%d\n", st);
+    const int reg = dyn->lsx.x87reg[ret];
+    // prepare offset to fpu => s1
+    // Get top
+    LD_W(s2, xEmu, offsetof(x64emu_t, top));
+    // Update
+    int a = st - dyn->lsx.x87stack;
+    if (a) {
+        ADDI_D(s2, s2, a);
+        ANDI(s2, s2, 7); // (emu->top + i)&7
+    }
+    ALSL_D(s1, s2, xEmu, 3);
+    FST_D(reg, s1, offsetof(x64emu_t, x87));
+    MESSAGE(LOG_DUMP, "\t--------x87 Cache for ST%d\n", st);
+}
+
 void x87_forget(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st)
 {
-    // TODO
+    int ret = -1;
+    for (int i = 0; (i < 8) && (ret == -1); ++i)
+        if (dyn->lsx.x87cache[i] == st)
+            ret = i;
+    if (ret == -1) // nothing to do
+        return;
+    MESSAGE(LOG_DUMP, "\tForget x87 Cache for ST%d\n", st);
+    const int reg = dyn->lsx.x87reg[ret];
+    // prepare offset to fpu => s1
+    // Get top
+    LD_W(s2, xEmu, offsetof(x64emu_t, top));
+    // Update
+    int a = st - dyn->lsx.x87stack;
+    if (a) {
+        ADDI_D(s2, s2, a);
+        ANDI(s2, s2, 7); // (emu->top + i)&7
+    }
+    ALSL_D(s1, s2, xEmu, 3);
+    FST_D(reg, s1, offsetof(x64emu_t, x87));
+    MESSAGE(LOG_DUMP, "\t--------x87 Cache for ST%d\n", st);
+    // and forget that cache
+    fpu_free_reg(dyn, reg);
+    dyn->lsx.lsxcache[reg].v = 0;
+    dyn->lsx.x87cache[ret] = -1;
+    dyn->lsx.x87reg[ret] = -1;
+}
+
+void x87_reget_st(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st)
+{
+    // search in cache first
+    for (int i = 0; i < 8; ++i)
+        if (dyn->lsx.x87cache[i] == st) {
+            // refresh the value
+            MESSAGE(LOG_DUMP, "\tRefresh x87 Cache for ST%d\n", st);
+            LD_W(s2, xEmu, offsetof(x64emu_t, top));
+            int a = st - dyn->lsx.x87stack;
+            if (a) {
+                ADDI_D(s2, s2, a);
+                ANDI(s2, s2, 7);
+            }
+            ALSL_D(s1, s2, xEmu, 3);
+            FLD_D(dyn->lsx.x87reg[i], s1, offsetof(x64emu_t, x87));
+            MESSAGE(LOG_DUMP, "\t-------x87 Cache for ST%d\n", st);
+            // ok
+            return;
+        }
+    // Was not in the cache? creating it....
+    MESSAGE(LOG_DUMP, "\tCreate x87 Cache for ST%d\n", st);
+    // get a free spot
+    int ret = -1;
+    for (int i = 0; (i < 8) && (ret == -1); ++i)
+        if (dyn->lsx.x87cache[i] == -1)
+            ret = i;
+    // found, setup and grab the value
+    dyn->lsx.x87cache[ret] = st;
+    dyn->lsx.x87reg[ret] = fpu_get_reg_x87(dyn, LSX_CACHE_ST_D, st);
+    LD_W(s2, xEmu, offsetof(x64emu_t, top));
+    int a = st - dyn->lsx.x87stack;
+    ADDI_D(s2, s2, a);
+    ANDI(s2, s2, 7); // (emu->top + i)&7
+    ALSL_D(s1, s2, xEmu, 3);
+    FLD_D(dyn->lsx.x87reg[ret], s1, offsetof(x64emu_t, x87));
+    MESSAGE(LOG_DUMP, "\t-------x87 Cache for ST%d\n", st);
+}
+
+void x87_free(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3, int st)
+{
+    int ret = -1;
+    for (int i = 0; (i < 8) && (ret == -1); ++i)
+        if (dyn->lsx.x87cache[i] == st)
+            ret = i;
+    MESSAGE(LOG_DUMP, "\tFFREE%s x87 Cache for ST%d\n", (ret != -1) ? " (and Forget)" : "", st);
+    if (ret != -1) {
+        const int reg = dyn->lsx.x87reg[ret];
+        // Get top
+        LD_W(s2, xEmu, offsetof(x64emu_t, top));
+        // Update
+        int ast = st - dyn->lsx.x87stack;
+        if (ast) {
+            ADDI_D(s2, s2, ast);
+            ANDI(s2, s2, 7); // (emu->top + i)&7
+        }
+        ALSL_D(s1, s2, xEmu, 3);
+        FST_D(reg, s1, offsetof(x64emu_t, x87));
+        // and forget that cache
+        fpu_free_reg(dyn, reg);
+        dyn->lsx.lsxcache[reg].v = 0;
+        dyn->lsx.x87cache[ret] = -1;
+        dyn->lsx.x87reg[ret] = -1;
+    }
+    // add mark in the freed array
+    dyn->lsx.tags |= 0b11 << (st * 2);
+    MESSAGE(LOG_DUMP, "\t--------x87 FFREE for ST%d\n", st);
+}
+
+void x87_swapreg(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a, int b)
+{
+    int i1, i2, i3;
+    i1 = x87_get_cache(dyn, ninst, 1, s1, s2, b, X87_ST(b));
+    i2 = x87_get_cache(dyn, ninst, 1, s1, s2, a, X87_ST(a));
+    i3 = dyn->lsx.x87cache[i1];
+    dyn->lsx.x87cache[i1] = dyn->lsx.x87cache[i2];
+    dyn->lsx.x87cache[i2] = i3;
+    // swap those too
+    int j1, j2, j3;
+    j1 = x87_get_lsxcache(dyn, ninst, s1, s2, b);
+    j2 = x87_get_lsxcache(dyn, ninst, s1, s2, a);
+    j3 = dyn->lsx.lsxcache[j1].n;
+    dyn->lsx.lsxcache[j1].n = dyn->lsx.lsxcache[j2].n;
+    dyn->lsx.lsxcache[j2].n = j3;
+    // mark as swapped
+    dyn->lsx.swapped = 1;
+    dyn->lsx.combined1 = a;
+    dyn->lsx.combined2 = b;
+}
+
+// Set rounding according to cw flags, return reg to restore flags
+int x87_setround(dynarec_la64_t* dyn, int ninst, int s1, int s2)
+{
+    MAYUSE(dyn);
+    MAYUSE(ninst);
+    MAYUSE(s1);
+    MAYUSE(s2);
+    LD_HU(s1, xEmu, offsetof(x64emu_t, cw));
+    SRLI_D(s1, s1, 10);
+    ANDI(s1, s1, 0b11);
+    // MMX/x87 Round mode: 0..3: Nearest, Down, Up, Chop
+    // LA64: 0..3: Nearest, TowardZero, TowardsPositive, TowardsNegative
+    // 0->0, 1->3, 2->2, 3->1
+    BEQ(s1, xZR, 32);
+    ADDI_D(s2, xZR, 2);
+    BEQ(s1, s2, 24);
+    ADDI_D(s2, xZR, 3);
+    BEQ(s1, s2, 12);
+    ADDI_D(s1, xZR, 3);
+    B(8);
+    ADDI_D(s1, xZR, 1);
+    // done
+    SLLI_D(s1, s1, 8);
+    MOVFCSR2GR(s2, FCSR3);
+    MOVGR2FCSR(FCSR3, s1); // exange RM with current
+    return s2;
 }
 
 // Set rounding according to mxcsr flags, return reg to restore flags
@@ -769,6 +1293,14 @@ void x87_restoreround(dynarec_la64_t* dyn, int ninst, int s1)
 int sse_get_reg(dynarec_la64_t* dyn, int ninst, int s1, int a, int forwrite)
 {
     if (dyn->lsx.ssecache[a].v != -1) {
+        int reg = dyn->lsx.ssecache[a].reg;
+        if (dyn->lsx.lsxcache[reg].t == LSX_CACHE_YMMW || dyn->lsx.lsxcache[reg].t == LSX_CACHE_YMMR) {
+            // legacy SSE opcode on a full YMM: flush the upper part, only the lower 128bits stay cached
+            if (dyn->lsx.lsxcache[reg].t == LSX_CACHE_YMMW) {
+                YMM_STORE_HI(reg, a);
+            }
+            dyn->lsx.lsxcache[reg].t = dyn->lsx.ssecache[a].write ? LSX_CACHE_XMMW : LSX_CACHE_XMMR;
+        }
         if (forwrite) {
             dyn->lsx.ssecache[a].write = 1; // update only if forwrite
             dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t = LSX_CACHE_XMMW;
@@ -786,6 +1318,9 @@ int sse_get_reg(dynarec_la64_t* dyn, int ninst, int s1, int a, int forwrite)
 int sse_get_reg_empty(dynarec_la64_t* dyn, int ninst, int s1, int a)
 {
     if (dyn->lsx.ssecache[a].v != -1) {
+        if (dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t == LSX_CACHE_YMMW) {
+            YMM_STORE_HI(dyn->lsx.ssecache[a].reg, a);
+        }
         dyn->lsx.ssecache[a].write = 1;
         dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t = LSX_CACHE_XMMW;
         return dyn->lsx.ssecache[a].reg;
@@ -801,6 +1336,9 @@ void sse_forget_reg(dynarec_la64_t* dyn, int ninst, int a)
         return;
     if (dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t == LSX_CACHE_XMMW) {
         VST(dyn->lsx.ssecache[a].reg, xEmu, offsetof(x64emu_t, xmm[a]));
+    } else if (dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t == LSX_CACHE_YMMW) {
+        VST(dyn->lsx.ssecache[a].reg, xEmu, offsetof(x64emu_t, xmm[a]));
+        YMM_STORE_HI(dyn->lsx.ssecache[a].reg, a);
     }
     fpu_free_reg(dyn, dyn->lsx.ssecache[a].reg);
     dyn->lsx.ssecache[a].v = -1;
@@ -813,7 +1351,66 @@ void sse_reflect_reg(dynarec_la64_t* dyn, int ninst, int a)
         return;
     if (dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t == LSX_CACHE_XMMW) {
         VST(dyn->lsx.ssecache[a].reg, xEmu, offsetof(x64emu_t, xmm[a]));
+    } else if (dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t == LSX_CACHE_YMMW) {
+        VST(dyn->lsx.ssecache[a].reg, xEmu, offsetof(x64emu_t, xmm[a]));
+        YMM_STORE_HI(dyn->lsx.ssecache[a].reg, a);
+    }
+}
+
+// AVX helpers
+// get lasx register for a YMM reg, create the entry if needed (the full 256bits are cached)
+int avx_get_reg(dynarec_la64_t* dyn, int ninst, int s1, int a, int forwrite)
+{
+    if (dyn->lsx.ssecache[a].v != -1) {
+        int reg = dyn->lsx.ssecache[a].reg;
+        if (dyn->lsx.lsxcache[reg].t == LSX_CACHE_XMMW || dyn->lsx.lsxcache[reg].t == LSX_CACHE_XMMR) {
+            // only the lower part is there, fetch the upper part
+            YMM_LOAD_HI(reg, a, s1);
+        }
+        if (forwrite)
+            dyn->lsx.ssecache[a].write = 1;
+        dyn->lsx.lsxcache[reg].t = dyn->lsx.ssecache[a].write ? LSX_CACHE_YMMW : LSX_CACHE_YMMR;
+        return reg;
+    }
+    dyn->lsx.ssecache[a].reg = fpu_get_reg_xmm(dyn, forwrite ? LSX_CACHE_YMMW : LSX_CACHE_YMMR, a);
+    int ret = dyn->lsx.ssecache[a].reg;
+    dyn->lsx.ssecache[a].write = forwrite;
+    VLD(ret, xEmu, offsetof(x64emu_t, xmm[a]));
+    YMM_LOAD_HI(ret, a, s1);
+    return ret;
+}
+
+// get lasx register for a YMM reg, but don't try to synch it if it needed to be created
+int avx_get_reg_empty(dynarec_la64_t* dyn, int ninst, int s1, int a)
+{
+    if (dyn->lsx.ssecache[a].v != -1) {
+        dyn->lsx.ssecache[a].write = 1;
+        dyn->lsx.lsxcache[dyn->lsx.ssecache[a].reg].t = LSX_CACHE_YMMW;
+        return dyn->lsx.ssecache[a].reg;
+    }
+    dyn->lsx.ssecache[a].reg = fpu_get_reg_xmm(dyn, LSX_CACHE_YMMW, a);
+    dyn->lsx.ssecache[a].write = 1; // it will be write...
+    return dyn->lsx.ssecache[a].reg;
+}
+
+// zero the upper 128bits of a YMM register (VEX.128 encoded opcodes)
+void avx_zero_upper(dynarec_la64_t* dyn, int ninst, int reg)
+{
+    int q0 = fpu_get_scratch(dyn);
+    XVXOR_V(q0, q0, q0);
+    XVPERMI_Q(reg, q0, 0b00000010);
+}
+
+// zero the upper 128bits of YMM reg a, keeping the lower part cached (VZEROUPPER)
+void avx_forget_upper(dynarec_la64_t* dyn, int ninst, int a)
+{
+    if (dyn->lsx.ssecache[a].v != -1) {
+        int reg = dyn->lsx.ssecache[a].reg;
+        if (dyn->lsx.lsxcache[reg].t == LSX_CACHE_YMMW || dyn->lsx.lsxcache[reg].t == LSX_CACHE_YMMR)
+            dyn->lsx.lsxcache[reg].t = dyn->lsx.ssecache[a].write ? LSX_CACHE_XMMW : LSX_CACHE_XMMR;
     }
+    ST_D(xZR, xEmu, offsetof(x64emu_t, ymm[a]));
+    ST_D(xZR, xEmu, offsetof(x64emu_t, ymm[a]) + 8);
 }
 
 // purge the SSE cache for XMM0..XMM7 (to use before function native call)
@@ -828,6 +1425,9 @@ void sse_purge07cache(dynarec_la64_t* dyn, int ninst, int s1)
             }
             if (dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_XMMW) {
                 VST(dyn->lsx.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
+            } else if (dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_YMMW) {
+                VST(dyn->lsx.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
+                YMM_STORE_HI(dyn->lsx.ssecache[i].reg, i);
             }
             fpu_free_reg(dyn, dyn->lsx.ssecache[i].reg);
             dyn->lsx.ssecache[i].v = -1;
@@ -849,6 +1449,9 @@ static void sse_purgecache(dynarec_la64_t* dyn, int ninst, int next, int s1)
                     ++old;
                 }
                 VST(dyn->lsx.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
+                if (dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_YMMW) {
+                    YMM_STORE_HI(dyn->lsx.ssecache[i].reg, i);
+                }
             }
             if (!next) {
                 fpu_free_reg(dyn, dyn->lsx.ssecache[i].reg);
@@ -865,6 +1468,9 @@ static void sse_reflectcache(dynarec_la64_t* dyn, int ninst, int s1)
     for (int i=0; i<16; ++i)
         if(dyn->lsx.ssecache[i].v!=-1 && dyn->lsx.ssecache[i].write) {
             VST(dyn->lsx.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
+            if (dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_YMMW) {
+                YMM_STORE_HI(dyn->lsx.ssecache[i].reg, i);
+            }
         }
 }
 
@@ -882,6 +1488,9 @@ void fpu_pushcache(dynarec_la64_t* dyn, int ninst, int s1, int not07)
     for (int i = start; i < 16; ++i)
         if ((dyn->lsx.ssecache[i].v != -1) && (dyn->lsx.ssecache[i].write)) {
             VST(dyn->lsx.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
+            if (dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_YMMW) {
+                YMM_STORE_HI(dyn->lsx.ssecache[i].reg, i);
+            }
         }
     MESSAGE(LOG_DUMP, "\t------- Push XMM Cache (%d)\n", n);
 }
@@ -900,13 +1509,16 @@ void fpu_popcache(dynarec_la64_t* dyn, int ninst, int s1, int not07)
     for (int i = start; i < 16; ++i)
         if (dyn->lsx.ssecache[i].v != -1) {
             VLD(dyn->lsx.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
+            if (dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_YMMW || dyn->lsx.lsxcache[dyn->lsx.ssecache[i].reg].t == LSX_CACHE_YMMR) {
+                YMM_LOAD_HI(dyn->lsx.ssecache[i].reg, i, s1);
+            }
         }
     MESSAGE(LOG_DUMP, "\t------- Pop XMM Cache (%d)\n", n);
 }
 
 void fpu_purgecache(dynarec_la64_t* dyn, int ninst, int next, int s1, int s2, int s3)
 {
-    // TODO: x87_purgecache(dyn, ninst, next, s1, s2, s3);
+    x87_purgecache(dyn, ninst, next, s1, s2, s3);
     // TODO: mmx_purgecache(dyn, ninst, next, s1);
 
     sse_purgecache(dyn, ninst, next, s1);
@@ -916,14 +1528,15 @@ void fpu_purgecache(dynarec_la64_t* dyn, int ninst, int next, int s1, int s2, in
 
 void fpu_reflectcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3)
 {
-    // TODO: x87_reflectcache(dyn, ninst, s1, s2, s3);
+    x87_reflectcache(dyn, ninst, s1, s2, s3);
     // TODO: mmx_reflectcache(dyn, ninst, s1);
     sse_reflectcache(dyn, ninst, s1);
 }
 
 void fpu_unreflectcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3)
 {
-    // TODO
+    // TODO: mmx_unreflectcache(dyn, ninst, s1);
+    x87_unreflectcache(dyn, ninst, s1, s2, s3);
 }
 
 void emit_pf(dynarec_la64_t* dyn, int ninst, int s1, int s3, int s4)
@@ -1010,11 +1623,10 @@ static int findCacheSlot(dynarec_la64_t* dyn, int ninst, int t, int n, lsxcache_
                         return i;
                     break;
                 case LSX_CACHE_XMMR:
-                    if (t == LSX_CACHE_XMMW)
-                        return i;
-                    break;
                 case LSX_CACHE_XMMW:
-                    if (t == LSX_CACHE_XMMR)
+                case LSX_CACHE_YMMR:
+                case LSX_CACHE_YMMW:
+                    if (t == LSX_CACHE_XMMR || t == LSX_CACHE_XMMW || t == LSX_CACHE_YMMR || t == LSX_CACHE_YMMW)
                         return i;
                     break;
             }
@@ -1032,11 +1644,17 @@ static void swapCache(dynarec_la64_t* dyn, int ninst, int i, int j, lsxcache_t*
         quad = 1;
     if (cache->lsxcache[j].t == LSX_CACHE_XMMR || cache->lsxcache[j].t == LSX_CACHE_XMMW)
         quad = 1;
+    if (cache->lsxcache[i].t == LSX_CACHE_YMMR || cache->lsxcache[i].t == LSX_CACHE_YMMW)
+        quad = 2;
+    if (cache->lsxcache[j].t == LSX_CACHE_YMMR || cache->lsxcache[j].t == LSX_CACHE_YMMW)
+        quad = 2;
 
     if (!cache->lsxcache[i].v) {
         // a mov is enough, no need to swap
         MESSAGE(LOG_DUMP, "\t  - Moving %d <- %d\n", i, j);
-        if (quad) {
+        if (quad == 2) {
+            XVOR_V(i, j, j);
+        } else if (quad) {
             VOR_V(i, j, j);
         } else {
             VXOR_V(i, i, i);
@@ -1051,7 +1669,11 @@ static void swapCache(dynarec_la64_t* dyn, int ninst, int i, int j, lsxcache_t*
     MESSAGE(LOG_DUMP, "\t  - Swapping %d <-> %d\n", i, j);
     // There is no VSWP in Arm64 NEON to swap 2 register contents!
     // so use a scratch...
-    if (quad) {
+    if (quad == 2) {
+        XVOR_V(SCRATCH, i, i);
+        XVOR_V(i, j, j);
+        XVOR_V(j, SCRATCH, SCRATCH);
+    } else if (quad) {
         VOR_V(SCRATCH, i, i);
         VOR_V(i, j, j);
         VOR_V(j, SCRATCH, SCRATCH);
@@ -1076,11 +1698,15 @@ static void loadCache(dynarec_la64_t* dyn, int ninst, int stack_cnt, int s1, int
             quad = 1;
         if (cache->lsxcache[i].t == LSX_CACHE_XMMR || cache->lsxcache[i].t == LSX_CACHE_XMMW)
             quad = 1;
+        if (cache->lsxcache[i].t == LSX_CACHE_YMMR || cache->lsxcache[i].t == LSX_CACHE_YMMW)
+            quad = 2;
         int j = i + 1;
         while (cache->lsxcache[j].v)
             ++j;
         MESSAGE(LOG_DUMP, "\t  - Moving away %d\n", i);
-        if (quad) {
+        if (quad == 2) {
+            XVOR_V(j, i, i);
+        } else if (quad) {
             VOR_V(j, i, i);
         } else {
             VXOR_V(j, j, j);
@@ -1094,6 +1720,13 @@ static void loadCache(dynarec_la64_t* dyn, int ninst, int stack_cnt, int s1, int
             MESSAGE(LOG_DUMP, "\t  - Loading %s\n", getCacheName(t, n));
             VLD(i, xEmu, offsetof(x64emu_t, xmm[n]));
             break;
+        case LSX_CACHE_YMMR:
+        case LSX_CACHE_YMMW:
+            MESSAGE(LOG_DUMP, "\t  - Loading %s\n", getCacheName(t, n));
+            VLD(i, xEmu, offsetof(x64emu_t, xmm[n]));
+            YMM_LOAD_HI(i, n, s1);
+            *s1_val = 0;
+            break;
         case LSX_CACHE_MM:
             MESSAGE(LOG_DUMP, "\t  - Loading %s\n", getCacheName(t, n));
             FLD_D(SCRATCH, xEmu, offsetof(x64emu_t, mmx[n]));
@@ -1104,7 +1737,25 @@ static void loadCache(dynarec_la64_t* dyn, int ninst, int stack_cnt, int s1, int
         case LSX_CACHE_ST_F:
         case LSX_CACHE_ST_I64:
             MESSAGE(LOG_DUMP, "\t  - Loading %s\n", getCacheName(t, n));
-            // TODO: x87
+            if ((*s3_top) == 0xffff) {
+                LD_W(s3, xEmu, offsetof(x64emu_t, top));
+                *s3_top = 0;
+            }
+            int a = n - (*s3_top) - stack_cnt;
+            if (a) {
+                ADDI_D(s3, s3, a);
+                ANDI(s3, s3, 7); // (emu->top + i)&7
+            }
+            *s3_top += a;
+            *s2_val = 0;
+            ALSL_D(s2, s3, xEmu, 3);
+            FLD_D(i, s2, offsetof(x64emu_t, x87));
+            if (t == LSX_CACHE_ST_F) {
+                FCVT_S_D(i, i);
+            }
+            if (t == LSX_CACHE_ST_I64) {
+                FTINTRZ_L_D(i, i);
+            }
             break;
         case LSX_CACHE_NONE:
         case LSX_CACHE_SCR:
@@ -1120,12 +1771,18 @@ static void unloadCache(dynarec_la64_t* dyn, int ninst, int stack_cnt, int s1, i
 {
     switch (t) {
         case LSX_CACHE_XMMR:
+        case LSX_CACHE_YMMR:
             MESSAGE(LOG_DUMP, "\t  - ignoring %s\n", getCacheName(t, n));
             break;
         case LSX_CACHE_XMMW:
             MESSAGE(LOG_DUMP, "\t  - Unloading %s\n", getCacheName(t, n));
             VST(i, xEmu, offsetof(x64emu_t, xmm[n]));
             break;
+        case LSX_CACHE_YMMW:
+            MESSAGE(LOG_DUMP, "\t  - Unloading %s\n", getCacheName(t, n));
+            VST(i, xEmu, offsetof(x64emu_t, xmm[n]));
+            YMM_STORE_HI(i, n);
+            break;
         case LSX_CACHE_MM:
             MESSAGE(LOG_DUMP, "\t  - Unloading %s\n", getCacheName(t, n));
             FST_D(i, xEmu, offsetof(x64emu_t, mmx[n]));
@@ -1134,7 +1791,25 @@ static void unloadCache(dynarec_la64_t* dyn, int ninst, int stack_cnt, int s1, i
         case LSX_CACHE_ST_F:
         case LSX_CACHE_ST_I64:
             MESSAGE(LOG_DUMP, "\t  - Unloading %s\n", getCacheName(t, n));
-            // TODO: x87
+            if ((*s3_top) == 0xffff) {
+                LD_W(s3, xEmu, offsetof(x64emu_t, top));
+                *s3_top = 0;
+            }
+            int a = n - (*s3_top) - stack_cnt;
+            if (a) {
+                ADDI_D(s3, s3, a);
+                ANDI(s3, s3, 7);
+            }
+            *s3_top += a;
+            ALSL_D(s2, s3, xEmu, 3);
+            *s2_val = 0;
+            if (t == LSX_CACHE_ST_F) {
+                FCVT_D_S(i, i);
+            }
+            if (t == LSX_CACHE_ST_I64) {
+                FFINT_D_L(i, i);
+            }
+            FST_D(i, s2, offsetof(x64emu_t, x87));
             break;
         case LSX_CACHE_NONE:
         case LSX_CACHE_SCR:
@@ -1186,7 +1861,25 @@ static void fpuCacheTransform(dynarec_la64_t* dyn, int ninst, int s1, int s2, in
     if (stack_cnt != cache_i2.stack) {
         MESSAGE(LOG_DUMP, "\t    - adjust stack count %d -> %d -\n", stack_cnt, cache_i2.stack);
         int a = stack_cnt - cache_i2.stack;
-        // TODO: x87
+        // Add x87stack to emu fpu_stack
+        LD_W(s3, xEmu, offsetof(x64emu_t, fpu_stack));
+        ADDI_D(s3, s3, a);
+        ST_W(s3, xEmu, offsetof(x64emu_t, fpu_stack));
+        // Sub x87stack to top, with and 7
+        LD_W(s3, xEmu, offsetof(x64emu_t, top));
+        ADDI_D(s3, s3, -a);
+        ANDI(s3, s3, 7);
+        ST_W(s3, xEmu, offsetof(x64emu_t, top));
+        // update tags
+        LD_HU(s2, xEmu, offsetof(x64emu_t, fpu_tags));
+        if (a > 0) {
+            SLLI_D(s2, s2, a * 2);
+        } else {
+            LU12I_W(s1, 0xffff0); // 0xffff0000
+            OR(s2, s2, s1);
+            SRLI_D(s2, s2, -a * 2);
+        }
+        ST_H(s2, xEmu, offsetof(x64emu_t, fpu_tags));
         s3_top = 0;
         stack_cnt = cache_i2.stack;
     }
@@ -1255,6 +1948,24 @@ static void fpuCacheTransform(dynarec_la64_t* dyn, int ninst, int s1, int s2, in
                     MESSAGE(LOG_DUMP, "\t  - Refreh %s\n", getCacheName(cache.lsxcache[i].t, cache.lsxcache[i].n));
                     VST(i, xEmu, offsetof(x64emu_t, xmm[cache.lsxcache[i].n]));
                     cache.lsxcache[i].t = LSX_CACHE_XMMR;
+                } else if (cache.lsxcache[i].t == LSX_CACHE_YMMR || cache.lsxcache[i].t == LSX_CACHE_YMMW
+                    || cache_i2.lsxcache[i].t == LSX_CACHE_YMMR || cache_i2.lsxcache[i].t == LSX_CACHE_YMMW) {
+                    // switch between XMM and YMM view of the same register
+                    int n = cache.lsxcache[i].n;
+                    int from_y = (cache.lsxcache[i].t == LSX_CACHE_YMMR || cache.lsxcache[i].t == LSX_CACHE_YMMW);
+                    int to_y = (cache_i2.lsxcache[i].t == LSX_CACHE_YMMR || cache_i2.lsxcache[i].t == LSX_CACHE_YMMW);
+                    int from_w = (cache.lsxcache[i].t == LSX_CACHE_XMMW || cache.lsxcache[i].t == LSX_CACHE_YMMW);
+                    int to_w = (cache_i2.lsxcache[i].t == LSX_CACHE_XMMW || cache_i2.lsxcache[i].t == LSX_CACHE_YMMW);
+                    MESSAGE(LOG_DUMP, "\t  - Convert %s\n", getCacheName(cache.lsxcache[i].t, n));
+                    if (cache.lsxcache[i].t == LSX_CACHE_YMMW && (!to_y || !to_w))
+                        YMM_STORE_HI(i, n);
+                    if (!from_y && to_y) {
+                        YMM_LOAD_HI(i, n, s1);
+                        s1_val = 0;
+                    }
+                    if (from_w && !to_w)
+                        VST(i, xEmu, offsetof(x64emu_t, xmm[n]));
+                    cache.lsxcache[i].t = cache_i2.lsxcache[i].t;
                 }
             }
         }
@@ -35,31 +35,34 @@
 // Strong mem emulation helpers
 #define SMREAD_MIN  2
 #define SMWRITE_MIN 1
+// Opcode only access the stack or thread local storage, so no barrier is needed
+#define SMLOCAL() (box64_dynarec_strongmem_local && (dyn->insts[ninst].x64.mem_tls || (dyn->insts[ninst].x64.mem_local && !dyn->insts[ninst].x64.mem_shared)))
 // Sequence of Read will trigger a DMB on "first" read if strongmem is >= SMREAD_MIN
 // Sequence of Write will trigger a DMB on "last" write if strongmem is >= 1
 // All Write operation that might use a lock all have a memory barrier if strongmem is >= SMWRITE_MIN
 // Opcode will read
-#define SMREAD()                                                        \
-    if ((dyn->smread == 0) && (box64_dynarec_strongmem > SMREAD_MIN)) { \
-        SMDMB();                                                        \
-    } else                                                              \
+#define SMREAD()                                                                       \
+    if ((dyn->smread == 0) && (box64_dynarec_strongmem > SMREAD_MIN) && !SMLOCAL()) { \
+        SMDMB();                                                                       \
+    } else                                                                             \
         dyn->smread = 1
 // Opcode will read with option forced lock
 #define SMREADLOCK(lock) \
-    if ((lock) || ((dyn->smread == 0) && (box64_dynarec_strongmem > SMREAD_MIN))) { SMDMB(); }
+    if ((lock) || ((dyn->smread == 0) && (box64_dynarec_strongmem > SMREAD_MIN) && !SMLOCAL())) { SMDMB(); }
 // Opcode might read (depend on nextop)
 #define SMMIGHTREAD() \
     if (!MODREG) { SMREAD(); }
 // Opcode has wrote
-#define SMWRITE() dyn->smwrite = 1
+#define SMWRITE() \
+    if (!SMLOCAL()) dyn->smwrite = 1
 // Opcode has wrote (strongmem>1 only)
 #define SMWRITE2() \
-    if (box64_dynarec_strongmem > SMREAD_MIN) dyn->smwrite = 1
+    if (box64_dynarec_strongmem > SMREAD_MIN && !SMLOCAL()) dyn->smwrite = 1
 // Opcode has wrote with option forced lock
-#define SMWRITELOCK(lock)                                  \
-    if (lock || (box64_dynarec_strongmem > SMWRITE_MIN)) { \
-        SMDMB();                                           \
-    } else                                                 \
+#define SMWRITELOCK(lock)                                                   \
+    if (lock || ((box64_dynarec_strongmem > SMWRITE_MIN) && !SMLOCAL())) { \
+        SMDMB();                                                            \
+    } else if (!SMLOCAL())                                                  \
         dyn->smwrite = 1
 // Opcode might have wrote (depend on nextop)
 #define SMMIGHTWRITE() \
@@ -342,6 +345,55 @@
         VLD(a, ed, fixedaddress);                                                            \
     }
 
+// Store/Load the upper 128bits of a lasx register in/from emu->ymm[a]
+#define YMM_STORE_HI(reg, a)                            \
+    XVPERMI_Q(reg, reg, 0b00000001);                    \
+    VST(reg, xEmu, offsetof(x64emu_t, ymm[a]));         \
+    XVPERMI_Q(reg, reg, 0b00000001)
+#define YMM_LOAD_HI(reg, a, s)                          \
+    LD_D(s, xEmu, offsetof(x64emu_t, ymm[a]));          \
+    XVINSGR2VR_D(reg, s, 2);                            \
+    LD_D(s, xEmu, offsetof(x64emu_t, ymm[a]) + 8);      \
+    XVINSGR2VR_D(reg, s, 3)
+
+// Get GY as a full 256bits register (might use x1)
+#define GETGY(a, w)                             \
+    gd = ((nextop & 0x38) >> 3) + (rex.r << 3); \
+    a = avx_get_reg(dyn, ninst, x1, gd, w)
+
+#define GETGY_empty(a)                          \
+    gd = ((nextop & 0x38) >> 3) + (rex.r << 3); \
+    a = avx_get_reg_empty(dyn, ninst, x1, gd)
+
+// Get VY (the vex.v register) as a full 256bits register (might use x1)
+#define GETVY(a, w) \
+    a = avx_get_reg(dyn, ninst, x1, vex.v, w)
+
+// Get EY, 128 or 256bits depending on vex.l (x1 is used)
+#define GETEY(a, w, D)                                                                       \
+    if (MODREG) {                                                                            \
+        a = avx_get_reg(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), w);                     \
+    } else {                                                                                 \
+        SMREAD();                                                                            \
+        addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, D); \
+        a = fpu_get_scratch(dyn);                                                            \
+        if (vex.l) {                                                                         \
+            XVLD(a, ed, fixedaddress);                                                       \
+        } else {                                                                             \
+            VLD(a, ed, fixedaddress);                                                        \
+        }                                                                                    \
+    }
+
+// Get GY (empty) from VY and EY, in this order so a GY that is also a source gets loaded first
+#define GETGY_empty_VYEY(gy, vy, ey) \
+    GETVY(vy, 0);                    \
+    GETEY(ey, 0, 0);                 \
+    GETGY_empty(gy)
+
+// VEX.128 encoded opcodes zero the upper part of the destination
+#define YMM0(a) \
+    if (!vex.l) avx_zero_upper(dyn, ninst, a)
+
 // Put Back EX if it was a memory and not an emm register
 #define PUTEX(a)                  \
     if (!MODREG) {                \
@@ -405,7 +457,7 @@
 // R0 will not be pushed/popd if ret is -2. Flags are not save/restored
 #define CALL_S(F, ret) call_c(dyn, ninst, F, x6, ret, 0, 0)
 
-#define MARKi(i)    dyn->insts[ninst].mark[i] = dyn->native_size
+#define MARKi(i)    SETMARK(dyn->insts[ninst].mark[i])
 #define GETMARKi(i) dyn->insts[ninst].mark[i]
 #define MARK        MARKi(0)
 #define GETMARK     GETMARKi(0)
@@ -414,16 +466,16 @@
 #define MARK3       MARKi(2)
 #define GETMARK3    GETMARKi(2)
 
-#define MARKFi(i)    dyn->insts[ninst].markf[i] = dyn->native_size
+#define MARKFi(i)    SETMARK(dyn->insts[ninst].markf[i])
 #define GETMARKFi(i) dyn->insts[ninst].markf[i]
 #define MARKF        MARKFi(0)
 #define GETMARKF     GETMARKFi(0)
 #define MARKF2       MARKFi(1)
 #define GETMARKF2    GETMARKFi(1)
 
-#define MARKSEG     dyn->insts[ninst].markseg = dyn->native_size
+#define MARKSEG     SETMARK(dyn->insts[ninst].markseg)
 #define GETMARKSEG  dyn->insts[ninst].markseg
-#define MARKLOCK    dyn->insts[ninst].marklock = dyn->native_size
+#define MARKLOCK    SETMARK(dyn->insts[ninst].marklock)
 #define GETMARKLOCK dyn->insts[ninst].marklock
 
 #define Bxx_gen(OP, M, reg1, reg2)   \
@@ -459,6 +511,8 @@
 #define BEQZ_MARK(reg) BxxZ_gen(EQ, MARK, reg)
 // Branch to MARK2 if reg1==0 (use j64)
 #define BEQZ_MARK2(reg) BxxZ_gen(EQ, MARK2, reg)
+// Branch to MARK3 if reg1==0 (use j64)
+#define BEQZ_MARK3(reg) BxxZ_gen(EQ, MARK3, reg)
 // Branch to MARKLOCK if reg1==0 (use j64)
 #define BEQZ_MARKLOCK(reg) BxxZ_gen(EQ, MARKLOCK, reg)
 
@@ -496,6 +550,10 @@
 // Branch to MARK if reg1>=reg2 (use j64)
 #define BGE_MARK(reg1, reg2) Bxx_gen(GE, MARK, reg1, reg2)
 
+// Branch to MARKF if reg1!=0 (use j64)
+#define BNEZ_MARKF(reg) BxxZ_gen(NE, MARKF, reg)
+// Branch to MARKF instruction unconditionnal (use j64)
+#define B_MARKF_nocond Bxx_gen(__, MARKF, 0, 0)
 // Branch to MARK instruction unconditionnal (use j64)
 #define B_MARK_nocond Bxx_gen(__, MARK, 0, 0)
 // Branch to MARK2 instruction unconditionnal (use j64)
@@ -709,9 +767,13 @@
 #define TABLE64(A, V)
 #endif
 
+// no specialized entry of the blocks (BOX64_DYNAREC_LINKSTATE) on this architecture
+#define LINKSTATE_ENTRY(A)
+#define LINKSTATE_FALLBACK(A)
+
 #define ARCH_INIT()
 
-#if STEP < 2
+#if STEP == 0
 #define GETIP(A) TABLE64(0, 0)
 #define GETIP_(A) TABLE64(0, 0)
 #else
@@ -743,9 +805,9 @@
 #endif
 #define CLEARIP() dyn->last_ip = 0
 
-#if STEP < 2
+#if STEP == 0
 #define PASS2IF(A, B) if (A)
-#elif STEP == 2
+#elif STEP < 3
 #define PASS2IF(A, B)                         \
     if (A) dyn->insts[ninst].pass2choice = B; \
     if (dyn->insts[ninst].pass2choice == B)
@@ -777,6 +839,22 @@ void* la64_next(x64emu_t* emu, uintptr_t addr);
 #define dynarec64_660F STEPNAME(dynarec64_660F)
 #define dynarec64_F0   STEPNAME(dynarec64_F0)
 #define dynarec64_F20F STEPNAME(dynarec64_F20F)
+#define dynarec64_66F20F STEPNAME(dynarec64_66F20F)
+#define dynarec64_D8   STEPNAME(dynarec64_D8)
+#define dynarec64_D9   STEPNAME(dynarec64_D9)
+#define dynarec64_DA   STEPNAME(dynarec64_DA)
+#define dynarec64_DB   STEPNAME(dynarec64_DB)
+#define dynarec64_DC   STEPNAME(dynarec64_DC)
+#define dynarec64_DD   STEPNAME(dynarec64_DD)
+#define dynarec64_DE   STEPNAME(dynarec64_DE)
+#define dynarec64_DF   STEPNAME(dynarec64_DF)
+
+#define dynarec64_AVX         STEPNAME(dynarec64_AVX)
+#define dynarec64_AVX_0F      STEPNAME(dynarec64_AVX_0F)
+#define dynarec64_AVX_66_0F   STEPNAME(dynarec64_AVX_66_0F)
+#define dynarec64_AVX_F3_0F   STEPNAME(dynarec64_AVX_F3_0F)
+#define dynarec64_AVX_66_0F38 STEPNAME(dynarec64_AVX_66_0F38)
+#define dynarec64_AVX_66_0F3A STEPNAME(dynarec64_AVX_66_0F3A)
 
 #define geted               STEPNAME(geted)
 #define geted32             STEPNAME(geted32)
@@ -853,14 +931,34 @@ void* la64_next(x64emu_t* emu, uintptr_t addr);
 
 #define emit_pf STEPNAME(emit_pf)
 
-#define x87_restoreround  STEPNAME(x87_restoreround)
+#define x87_do_push           STEPNAME(x87_do_push)
+#define x87_do_push_empty     STEPNAME(x87_do_push_empty)
+#define x87_do_pop            STEPNAME(x87_do_pop)
+#define x87_get_current_cache STEPNAME(x87_get_current_cache)
+#define x87_get_cache         STEPNAME(x87_get_cache)
+#define x87_get_lsxcache      STEPNAME(x87_get_lsxcache)
+#define x87_get_st            STEPNAME(x87_get_st)
+#define x87_get_st_empty      STEPNAME(x87_get_st)
+#define x87_free              STEPNAME(x87_free)
+#define x87_refresh           STEPNAME(x87_refresh)
+#define x87_forget            STEPNAME(x87_forget)
+#define x87_reget_st          STEPNAME(x87_reget_st)
+#define x87_stackcount        STEPNAME(x87_stackcount)
+#define x87_unstackcount      STEPNAME(x87_unstackcount)
+#define x87_swapreg           STEPNAME(x87_swapreg)
+#define x87_setround          STEPNAME(x87_setround)
+#define x87_restoreround      STEPNAME(x87_restoreround)
+#define x87_purgecache        STEPNAME(x87_purgecache)
 #define sse_setround      STEPNAME(sse_setround)
-#define x87_forget       STEPNAME(x87_forget)
 #define sse_purge07cache STEPNAME(sse_purge07cache)
 #define sse_get_reg       STEPNAME(sse_get_reg)
 #define sse_get_reg_empty STEPNAME(sse_get_reg_empty)
 #define sse_forget_reg    STEPNAME(sse_forget_reg)
 #define sse_reflect_reg   STEPNAME(sse_reflect_reg)
+#define avx_get_reg       STEPNAME(avx_get_reg)
+#define avx_get_reg_empty STEPNAME(avx_get_reg_empty)
+#define avx_zero_upper    STEPNAME(avx_zero_upper)
+#define avx_forget_upper  STEPNAME(avx_forget_upper)
 
 #define fpu_pushcache       STEPNAME(fpu_pushcache)
 #define fpu_popcache        STEPNAME(fpu_popcache)
@@ -965,12 +1063,46 @@ void fpu_reflectcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3);
 void fpu_unreflectcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3);
 void fpu_pushcache(dynarec_la64_t* dyn, int ninst, int s1, int not07);
 void fpu_popcache(dynarec_la64_t* dyn, int ninst, int s1, int not07);
+// purge x87 cache
+void x87_purgecache(dynarec_la64_t* dyn, int ninst, int next, int s1, int s2, int s3);
+
+// x87 helper
+// cache of the local stack counter, to avoid update at every call
+int x87_stackcount(dynarec_la64_t* dyn, int ninst, int scratch);
+// restore local stack counter
+void x87_unstackcount(dynarec_la64_t* dyn, int ninst, int scratch, int count);
+// fpu push. Return the Dd value to be used
+int x87_do_push(dynarec_la64_t* dyn, int ninst, int s1, int t);
+// fpu push. Do not allocate a cache register. Needs a scratch register to do x87stack synch (or 0 to not do it)
+void x87_do_push_empty(dynarec_la64_t* dyn, int ninst, int s1);
+// fpu pop. All previous returned Dd should be considered invalid
+void x87_do_pop(dynarec_la64_t* dyn, int ninst, int s1);
+// get cache index for a x87 reg, return -1 if cache doesn't exist
+int x87_get_current_cache(dynarec_la64_t* dyn, int ninst, int st, int t);
+// get cache index for a x87 reg, create the entry if needed
+int x87_get_cache(dynarec_la64_t* dyn, int ninst, int populate, int s1, int s2, int a, int t);
+// get lsxcache index for a x87 reg
+int x87_get_lsxcache(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a);
+// get vfpu register for a x87 reg, create the entry if needed
+int x87_get_st(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a, int t);
+// get vfpu register for a x87 reg, create the entry if needed. Do not fetch the Stx if not already in cache
+int x87_get_st_empty(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a, int t);
+// Free st, using the FFREE opcode (so it's freed but stack is not moved)
+void x87_free(dynarec_la64_t* dyn, int ninst, int s1, int s2, int s3, int st);
+// refresh a value from the cache ->emu (nothing done if value is not cached)
+void x87_refresh(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st);
+// refresh a value from the cache ->emu and then forget the cache (nothing done if value is not cached)
+void x87_forget(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st);
+// refresh the cache value from emu
+void x87_reget_st(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st);
+// swap 2 x87 regs
+void x87_swapreg(dynarec_la64_t* dyn, int ninst, int s1, int s2, int a, int b);
+// Set rounding according to cw flags, return reg to restore flags
+int x87_setround(dynarec_la64_t* dyn, int ninst, int s1, int s2);
 // Restore round flag
 void x87_restoreround(dynarec_la64_t* dyn, int ninst, int s1);
 // Set rounding according to mxcsr flags, return reg to restore flags
 int sse_setround(dynarec_la64_t* dyn, int ninst, int s1, int s2);
-// refresh a value from the cache ->emu and then forget the cache (nothing done if value is not cached)
-void x87_forget(dynarec_la64_t* dyn, int ninst, int s1, int s2, int st);
 
 // SSE/SSE2 helpers
 // purge the XMM0..XMM7 cache (before function call)
@@ -984,6 +1116,16 @@ void sse_forget_reg(dynarec_la64_t* dyn, int ninst, int a);
 // Push current value to the cache
 void sse_reflect_reg(dynarec_la64_t* dyn, int ninst, int a);
 
+// AVX helpers
+// get lasx register for a YMM reg, create the entry if needed
+int avx_get_reg(dynarec_la64_t* dyn, int ninst, int s1, int a, int forwrite);
+// get lasx register for a YMM reg, but don't try to synch it if it needed to be created
+int avx_get_reg_empty(dynarec_la64_t* dyn, int ninst, int s1, int a);
+// zero the upper 128bits of a lasx register
+void avx_zero_upper(dynarec_la64_t* dyn, int ninst, int reg);
+// zero the upper 128bits of a YMM reg, keeping the lower part cached
+void avx_forget_upper(dynarec_la64_t* dyn, int ninst, int a);
+
 void CacheTransform(dynarec_la64_t* dyn, int ninst, int cacheupd, int s1, int s2, int s3);
 
 void la64_move64(dynarec_la64_t* dyn, int ninst, int reg, int64_t val);
@@ -995,6 +1137,79 @@ void la64_move32(dynarec_la64_t* dyn, int ninst, int reg, int32_t val, int zerou
 #define CHECK_CACHE() (cacheupd = CacheNeedsTransform(dyn, ninst))
 #endif
 
+#if STEP == 0
+#define X87_PUSH_OR_FAIL(var, dyn, ninst, scratch, t) var = x87_do_push(dyn, ninst, scratch, t)
+#define X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, scratch)   x87_do_push_empty(dyn, ninst, scratch)
+#define X87_POP_OR_FAIL(dyn, ninst, scratch)          x87_do_pop(dyn, ninst, scratch)
+#else
+#define X87_PUSH_OR_FAIL(var, dyn, ninst, scratch, t)                                                                                            \
+    if ((dyn->lsx.x87stack == 8) || (dyn->lsx.pushed == 8)) {                                                                                    \
+        if (box64_dynarec_dump) dynarec_log(LOG_NONE, " Warning, suspicious x87 Push, stack=%d/%d on inst %d\n", dyn->lsx.x87stack, dyn->lsx.pushed, ninst); \
+        dyn->abort = 1;                                                                                                                          \
+        return addr;                                                                                                                             \
+    }                                                                                                                                            \
+    var = x87_do_push(dyn, ninst, scratch, t);
+
+#define X87_PUSH_EMPTY_OR_FAIL(dyn, ninst, scratch)                                                                                              \
+    if ((dyn->lsx.x87stack == 8) || (dyn->lsx.pushed == 8)) {                                                                                    \
+        if (box64_dynarec_dump) dynarec_log(LOG_NONE, " Warning, suspicious x87 Push, stack=%d/%d on inst %d\n", dyn->lsx.x87stack, dyn->lsx.pushed, ninst); \
+        dyn->abort = 1;                                                                                                                          \
+        return addr;                                                                                                                             \
+    }                                                                                                                                            \
+    x87_do_push_empty(dyn, ninst, scratch);
+
+#define X87_POP_OR_FAIL(dyn, ninst, scratch)                                                                                                     \
+    if ((dyn->lsx.x87stack == -8) || (dyn->lsx.poped == 8)) {                                                                                    \
+        if (box64_dynarec_dump) dynarec_log(LOG_NONE, " Warning, suspicious x87 Pop, stack=%d/%d on inst %d\n", dyn->lsx.x87stack, dyn->lsx.poped, ninst); \
+        dyn->abort = 1;                                                                                                                          \
+        return addr;                                                                                                                             \
+    }                                                                                                                                            \
+    x87_do_pop(dyn, ninst, scratch);
+#endif
+
+// x87 registers are always cached as double on LA64 (no float / int64 narrowing of ST regs),
+// which is what BOX64_DYNAREC_X87DOUBLE=1 asks for on the other backends
+#define X87_COMBINE(A, B) LSX_CACHE_ST_D
+#define X87_ST0           LSX_CACHE_ST_D
+#define X87_ST(A)         LSX_CACHE_ST_D
+
+// Set C0/C2/C3 of x87 status word from the comparison of v1 and v2
+#define FCOM(v1, v2, s1, s2, s3)                                 \
+    LD_HU(s3, xEmu, offsetof(x64emu_t, sw));                     \
+    MOV32w(s1, 0b1011100011111111); /* mask off c0,c1,c2,c3 */   \
+    AND(s3, s3, s1);                                             \
+    FCMP_D(fcc0, v1, v2, cULT); /* less or unordered: C0 */      \
+    MOVCF2GR(s1, fcc0);                                          \
+    SLLI_D(s1, s1, 8);                                           \
+    OR(s3, s3, s1);                                              \
+    FCMP_D(fcc1, v1, v2, cUN); /* unordered: C2 */               \
+    MOVCF2GR(s2, fcc1);                                          \
+    SLLI_D(s2, s2, 10);                                          \
+    OR(s3, s3, s2);                                              \
+    FCMP_D(fcc2, v1, v2, cUEQ); /* equal or unordered: C3 */     \
+    MOVCF2GR(s1, fcc2);                                          \
+    SLLI_D(s1, s1, 14);                                          \
+    OR(s3, s3, s1);                                              \
+    ST_H(s3, xEmu, offsetof(x64emu_t, sw));
+
+// Set CF/PF/ZF from the comparison of v1 and v2, clear OF/AF/SF
+#define FCOMI(v1, v2, s1, s2, s3)                  \
+    CLEAR_FLAGS(s3);                               \
+    IFX (X_CF | X_PF | X_ZF | X_PEND) {            \
+        FCMP_D(fcc0, v1, v2, cULT);                \
+        MOVCF2GR(s1, fcc0);                        \
+        OR(xFlags, xFlags, s1); /* CF */           \
+        FCMP_D(fcc1, v1, v2, cUN);                 \
+        MOVCF2GR(s2, fcc1);                        \
+        SLLI_D(s2, s2, F_PF);                      \
+        OR(xFlags, xFlags, s2);                    \
+        FCMP_D(fcc2, v1, v2, cUEQ);                \
+        MOVCF2GR(s1, fcc2);                        \
+        SLLI_D(s1, s1, F_ZF);                      \
+        OR(xFlags, xFlags, s1);                    \
+    }                                              \
+    SPILL_EFLAGS();
+
 uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
 uintptr_t dynarec64_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 uintptr_t dynarec64_F30F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
@@ -1005,6 +1220,22 @@ uintptr_t dynarec64_67(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
 uintptr_t dynarec64_660F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 uintptr_t dynarec64_F0(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
 uintptr_t dynarec64_F20F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
+uintptr_t dynarec64_66F20F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
+uintptr_t dynarec64_D8(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_D9(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_DA(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_DB(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_DC(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_DD(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_DE(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+uintptr_t dynarec64_DF(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int rep, int* ok, int* need_epilog);
+
+uintptr_t dynarec64_AVX(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_66_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_F3_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_66_0F38(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_66_0F3A(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
 
 #if STEP < 3
 #define PASS3(A)
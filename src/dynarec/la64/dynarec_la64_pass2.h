@@ -11,6 +11,7 @@
         dyn->insts[ninst].size += 4; \
         dyn->native_size += 4;       \
     } while (0)
+#define SETMARK(A) A = dyn->native_size
 #define NEW_INST                                                                                                                                                               \
     if (ninst) {                                                                                                                                                               \
         dyn->insts[ninst].address = (dyn->insts[ninst - 1].address + dyn->insts[ninst - 1].size);                                                                              \
@@ -17,6 +17,8 @@ typedef struct instsize_s instsize_t;
 #define LSX_CACHE_XMMW   5
 #define LSX_CACHE_XMMR   6
 #define LSX_CACHE_SCR    7
+#define LSX_CACHE_YMMW   8
+#define LSX_CACHE_YMMR   9
 
 typedef union lsx_cache_s {
     int8_t v;
@@ -45,11 +47,13 @@ typedef struct lsxcache_s {
     uint8_t         combined2;
     uint8_t         swapped;        // the combined reg were swapped
     uint8_t         barrier;        // is there a barrier at instruction epilog?
+    uint8_t         pushed;         // positive pushed value (to check for overflow)
+    uint8_t         poped;          // positive poped value (to check for underflow)
     uint32_t        news;           // bitmask, wich neoncache are new for this opcode
     // fpu cache
     int8_t          x87cache[8];    // cache status for the 8 x87 register behind the fpu stack
     int8_t          x87reg[8];      // reg used for x87cache entry
-    int8_t          freed[8];       // set when FFREE is used, -1 else
+    int16_t         tags;           // similar to fpu_tags
     int8_t          mmxcache[8];    // cache status for the 8 MMX registers
     sse_cache_t     ssecache[16];   // cache status for the 16 SSE(2) registers
     int8_t          fpuused[24];    // all 0..24 double reg from fpu, used by x87, sse and mmx
@@ -122,6 +126,7 @@ typedef struct dynarec_la64_s {
     dynablock_t*         dynablock;
     instsize_t*          instsize;
     size_t               insts_size; // size of the instruction size array (calculated)
+    size_t               insts_cap;  // size allocated for the instruction size array in pass3
     uintptr_t            forward;    // address of the last end of code while testing forward
     uintptr_t            forward_to; // address of the next jump to (to check if everything is ok)
     int32_t              forward_size;   // size at the forward point
@@ -130,6 +135,8 @@ typedef struct dynarec_la64_s {
     uint8_t              smread;    // for strongmem model emulation
     uint8_t              smwrite;    // for strongmem model emulation
     uint8_t              always_test;
+    uint8_t              fastpass;   // pass3 is emitted with the layout computed in pass1
+    uint8_t              layout_diff;// pass3 layout doesn't match the computed one
     uint8_t              abort;
 } dynarec_la64_t;
 
@@ -177,6 +177,7 @@ f24-f31  fs0-fs7   Static registers                Callee
 
 // Made-up formats not found in the spec.
 #define type_1RI13(opc, imm13, rd)       ((opc) << 18 | ((imm13) & 0x1FFFF) << 5 | (rd))
+#define type_2RI2(opc, imm2, rj, rd)     ((opc) << 12 | ((imm2)  & 0x3 )  << 10 | (rj) << 5 | (rd))
 #define type_2RI3(opc, imm3, rj, rd)     ((opc) << 13 | ((imm3)  & 0x7 )  << 10 | (rj) << 5 | (rd))
 #define type_2RI4(opc, imm4, rj, rd)     ((opc) << 14 | ((imm4)  & 0xF )  << 10 | (rj) << 5 | (rd))
 #define type_2RI5(opc, imm5, rj, rd)     ((opc) << 15 | ((imm5)  & 0x1F)  << 10 | (rj) << 5 | (rd))
@@ -469,6 +470,18 @@ f24-f31  fs0-fs7   Static registers                Callee
 // GR[rd] = unsigned(GR[rj] [63:0]) % unsigned(GR[rk] [63:0])
 #define MOD_DU(rd, rj, rk) EMIT(type_3R(0b00000000001000111, rk, rj, rd))
 
+// GR[rd] = SignExtend(CRC32(GR[rk][31:0], GR[rj][width-1:0], width), GRLEN), with the 0xEDB88320 polynomial (reflected)
+#define CRC_W_B_W(rd, rj, rk) EMIT(type_3R(0b00000000001001000, rk, rj, rd))
+#define CRC_W_H_W(rd, rj, rk) EMIT(type_3R(0b00000000001001001, rk, rj, rd))
+#define CRC_W_W_W(rd, rj, rk) EMIT(type_3R(0b00000000001001010, rk, rj, rd))
+#define CRC_W_D_W(rd, rj, rk) EMIT(type_3R(0b00000000001001011, rk, rj, rd))
+
+// same as CRC_W_x_W but with the 0x82F63B78 polynomial (Castagnoli, reflected), as x86 CRC32
+#define CRCC_W_B_W(rd, rj, rk) EMIT(type_3R(0b00000000001001100, rk, rj, rd))
+#define CRCC_W_H_W(rd, rj, rk) EMIT(type_3R(0b00000000001001101, rk, rj, rd))
+#define CRCC_W_W_W(rd, rj, rk) EMIT(type_3R(0b00000000001001110, rk, rj, rd))
+#define CRCC_W_D_W(rd, rj, rk) EMIT(type_3R(0b00000000001001111, rk, rj, rd))
+
 #define MULxw(rd, rj, rk)      \
     do {                       \
         if (rex.w) {           \
@@ -1420,6 +1433,16 @@ LSX instruction starts with V, LASX instruction starts with XV.
 #define VEXTRINS_B(vd, vj, imm8)    EMIT(type_2RI8(0b01110011100011, imm8, vj, vd))
 #define VLD(vd, rj, imm12)          EMIT(type_2RI12(0b0010110000, imm12, rj, vd))
 #define VST(vd, rj, imm12)          EMIT(type_2RI12(0b0010110001, imm12, rj, vd))
+#define VREPLGR2VR_B(vd, rj)        EMIT(type_2R(0b0111001010011111000000, rj, vd))
+#define VREPLGR2VR_H(vd, rj)        EMIT(type_2R(0b0111001010011111000001, rj, vd))
+#define VREPLGR2VR_W(vd, rj)        EMIT(type_2R(0b0111001010011111000010, rj, vd))
+#define VREPLGR2VR_D(vd, rj)        EMIT(type_2R(0b0111001010011111000011, rj, vd))
+// fcc = all 128bits of vj are zero
+#define VSETEQZ_V(cd, vj)           EMIT(type_2R(0b0111001010011100100110, vj, cd))
+// fcc = any bit of vj is not zero
+#define VSETNEZ_V(cd, vj)           EMIT(type_2R(0b0111001010011100100111, vj, cd))
+// fcc = any byte of vj is zero
+#define VSETANYEQZ_B(cd, vj)        EMIT(type_2R(0b0111001010011100101000, vj, cd))
 
 #define VFCMP_S(vd, vj, vk, cond)   EMIT(type_4R(0b000011000101, cond, vk, vj, vd))
 #define VFCMP_D(vd, vj, vk, cond)   EMIT(type_4R(0b000011000110, cond, vk, vj, vd))
@@ -1800,6 +1823,29 @@ LSX instruction starts with V, LASX instruction starts with XV.
 #define XVPERMI_D(vd, vj, imm8)      EMIT(type_2RI8(0b01110111111010, imm8, vj, vd))
 #define XVPERMI_Q(vd, vj, imm8)      EMIT(type_2RI8(0b01110111111011, imm8, vj, vd))
 
+#define XVLD(vd, rj, imm12)          EMIT(type_2RI12(0b0010110010, imm12, rj, vd))
+#define XVST(vd, rj, imm12)          EMIT(type_2RI12(0b0010110011, imm12, rj, vd))
+
+#define XVINSGR2VR_W(vd, rj, imm3)   EMIT(type_2RI3(0b0111011011101011110, imm3, rj, vd))
+#define XVINSGR2VR_D(vd, rj, imm2)   EMIT(type_2RI2(0b01110110111010111110, imm2, rj, vd))
+#define XVPICKVE2GR_W(rd, vj, imm3)  EMIT(type_2RI3(0b0111011011101111110, imm3, vj, rd))
+#define XVPICKVE2GR_D(rd, vj, imm2)  EMIT(type_2RI2(0b01110110111011111110, imm2, vj, rd))
+#define XVREPLGR2VR_B(vd, rj)        EMIT(type_2R(0b0111011010011111000000, rj, vd))
+#define XVREPLGR2VR_H(vd, rj)        EMIT(type_2R(0b0111011010011111000001, rj, vd))
+#define XVREPLGR2VR_W(vd, rj)        EMIT(type_2R(0b0111011010011111000010, rj, vd))
+#define XVREPLGR2VR_D(vd, rj)        EMIT(type_2R(0b0111011010011111000011, rj, vd))
+#define XVREPLVE0_B(vd, vj)          EMIT(type_2R(0b0111011100000111000000, vj, vd))
+#define XVREPLVE0_H(vd, vj)          EMIT(type_2R(0b0111011100000111100000, vj, vd))
+#define XVREPLVE0_W(vd, vj)          EMIT(type_2R(0b0111011100000111110000, vj, vd))
+#define XVREPLVE0_D(vd, vj)          EMIT(type_2R(0b0111011100000111111000, vj, vd))
+#define XVREPLVE0_Q(vd, vj)          EMIT(type_2R(0b0111011100000111111100, vj, vd))
+
+#define XVFSQRT_S(vd, vj)            EMIT(type_2R(0b0111011010011100111001, vj, vd))
+#define XVFSQRT_D(vd, vj)            EMIT(type_2R(0b0111011010011100111010, vj, vd))
+#define XVFCMP_S(vd, vj, vk, cond)   EMIT(type_4R(0b000011001001, cond, vk, vj, vd))
+#define XVFCMP_D(vd, vj, vk, cond)   EMIT(type_4R(0b000011001010, cond, vk, vj, vd))
+#define XVBITSEL_V(vd, vj, vk, va)   EMIT(type_4R(0b000011010010, va, vk, vj, vd))
+
 #define VEXT2XV_H_B(vd, vj)          EMIT(type_2R(0b0111011010011111000100, vj, vd))
 #define VEXT2XV_W_B(vd, vj)          EMIT(type_2R(0b0111011010011111000101, vj, vd))
 #define VEXT2XV_D_B(vd, vj)          EMIT(type_2R(0b0111011010011111000110, vj, vd))
@@ -32,6 +32,8 @@
 #define native_lock_get_b(A)                arm64_lock_get_b(A)
 #define native_lock_get_d(A)                arm64_lock_get_d(A)
 #define native_lock_get_dd(A)               arm64_lock_get_dd(A)
+#define native_lock_cas_d(A, B, C)          arm64_lock_cas_d(A, B, C)
+#define native_lock_cas_dd(A, B, C)         arm64_lock_cas_dd(A, B, C)
 
 #elif defined(RV64)
 #include "rv64/rv64_lock.h"
@@ -587,6 +587,31 @@ uintptr_t dynarec64_00_2(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 CBZ_NEXT(xRCX);
                 ANDI(x1, xFlags, 1<<F_DF);
                 BNEZ_MARK2(x1);
+                // 8 bytes at a time when RSI and RDI have the same alignment, unless RDI is less than 8 bytes after RSI
+                SUB(x1, xRDI, xRSI);
+                ADDI(x2, xZR, 8);
+                BLTU_MARK(x1, x2);
+                ANDI(x1, x1, 7);
+                BNEZ_MARK(x1);
+                MARK3;  // bytes until RDI is aligned
+                ANDI(x1, xRDI, 7);
+                BEQZ_MARKF(x1);
+                LBU(x1, xRSI, 0);
+                SB(x1, xRDI, 0);
+                ADDI(xRSI, xRSI, 1);
+                ADDI(xRDI, xRDI, 1);
+                SUBI(xRCX, xRCX, 1);
+                BNEZ_MARK3(xRCX);
+                B_NEXT_nocond;
+                MARKF;
+                BLTU_MARK(xRCX, x2);
+                LD(x1, xRSI, 0);
+                SD(x1, xRDI, 0);
+                ADDI(xRSI, xRSI, 8);
+                ADDI(xRDI, xRDI, 8);
+                SUBI(xRCX, xRCX, 8);
+                BNEZ_MARKF(xRCX);
+                B_NEXT_nocond;
                 MARK;   // Part with DF==0
                 LBU(x1, xRSI, 0);
                 SB(x1, xRDI, 0);
@@ -748,6 +773,26 @@ uintptr_t dynarec64_00_2(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 CBZ_NEXT(xRCX);
                 ANDI(x1, xFlags, 1<<F_DF);
                 BNEZ_MARK2(x1);
+                // 8 bytes at a time once RDI is aligned
+                ANDI(x2, xRAX, 0xff);
+                MOV64x(x3, 0x0101010101010101ULL);
+                MUL(x2, x2, x3);
+                ADDI(x3, xZR, 8);
+                MARK3;  // bytes until RDI is aligned
+                ANDI(x1, xRDI, 7);
+                BEQZ_MARKF(x1);
+                SB(xRAX, xRDI, 0);
+                ADDI(xRDI, xRDI, 1);
+                ADDI(xRCX, xRCX, -1);
+                BNEZ_MARK3(xRCX);
+                B_NEXT_nocond;
+                MARKF;
+                BLTU_MARK(xRCX, x3);
+                SD(x2, xRDI, 0);
+                ADDI(xRDI, xRDI, 8);
+                ADDI(xRCX, xRCX, -8);
+                BNEZ_MARKF(xRCX);
+                B_NEXT_nocond;
                 MARK;   // Part with DF==0
                 SB(xRAX, xRDI, 0);
                 ADDI(xRDI, xRDI, 1);
@@ -825,13 +870,46 @@ uintptr_t dynarec64_00_2(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 ANDI(x1, xRAX, 0xff);
                 ANDI(x2, xFlags, 1<<F_DF);
                 BNEZ_MARK2(x2);
+                if (rep==2 || rv64_zbb) {
+                    // 8 bytes at a time once RDI is aligned, so nothing after the stopping byte can fault.
+                    // The bytewise loop finds the exact stop
+                    MOV64x(x4, 0x0101010101010101ULL);
+                    MUL(x4, x4, x1);
+                    ADDI(x5, xZR, 8);
+                    ANDI(x2, xRDI, 7);
+                    BNEZ_MARK(x2);
+                    MARKF;
+                    BLTU_MARK(xRCX, x5);
+                    LD(x2, xRDI, 0);
+                    XOR(x2, x2, x4);
+                    if (rep==1) {
+                        // a zero byte is a match
+                        ORCB(x2, x2);
+                        ADDI(x3, xZR, -1);
+                        BNE_MARK(x2, x3);
+                    } else {
+                        BNEZ_MARK(x2);
+                    }
+                    ADDI(xRDI, xRDI, 8);
+                    SUBI(xRCX, xRCX, 8);
+                    BNEZ_MARKF(xRCX);
+                    LBU(x2, xRDI, -1);
+                    B_MARK3_nocond;
+                }
                 MARK;   // Part with DF==0
                 LBU(x2, xRDI, 0);
                 ADDI(xRDI, xRDI, 1);
                 SUBI(xRCX, xRCX, 1);
                 if (rep==1) {BEQ_MARK3(x1, x2);} else {BNE_MARK3(x1, x2);}
-                BNE_MARK(xRCX, xZR);
-                B_MARK3_nocond;
+                if (rep==2 || rv64_zbb) {
+                    BEQZ_MARK3(xRCX);
+                    ANDI(x3, xRDI, 7);
+                    BNEZ_MARK(x3);
+                    B_MARKF_nocond;
+                } else {
+                    BNE_MARK(xRCX, xZR);
+                    B_MARK3_nocond;
+                }
                 MARK2;  // Part with DF==1
                 LBU(x2, xRDI, 0);
                 SUBI(xRDI, xRDI, 1);
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+#include "bitutils.h"
+#include "rv64_printer.h"
+#include "dynarec_rv64_private.h"
+#include "dynarec_rv64_functions.h"
+#include "dynarec_rv64_helper.h"
+
+uintptr_t dynarec64_0F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+    uint8_t opcode = F8;
+    uint8_t nextop, u8, s8;
+    int32_t i32;
+    uint8_t gd, ed;
+    uint8_t wback, wb1, wb2, gback;
+    uint8_t eb1, eb2;
+    int64_t j64;
+    uint64_t tmp64u, tmp64u2;
+    int v0, v1;
+    int q0, q1;
+    int d0, d1, d2;
+    int64_t fixedaddress, gdoffset;
+    int unscaled;
+    MAYUSE(d0);
+    MAYUSE(d1);
+    MAYUSE(q0);
+    MAYUSE(q1);
+    MAYUSE(eb1);
+    MAYUSE(eb2);
+    MAYUSE(j64);
+    switch (opcode) {
+        case 0x10:
+            INST_NAME("MOVUPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            if (MODREG) {
+                q1 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGX_empty_vector(q0);
+                VMV_V_V(q0, q1);
+            } else {
+                GETGX_empty_vector(q0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VLE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            }
+            break;
+        case 0x11:
+            INST_NAME("MOVUPS Ex, Gx");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 0);
+            if (MODREG) {
+                q1 = sse_get_reg_empty_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                VMV_V_V(q1, q0);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VSE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                SMWRITE2();
+            }
+            break;
+        case 0x28:
+            INST_NAME("MOVAPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            if (MODREG) {
+                q1 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGX_empty_vector(q0);
+                VMV_V_V(q0, q1);
+            } else {
+                GETGX_empty_vector(q0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VLE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            }
+            break;
+        case 0x29:
+            INST_NAME("MOVAPS Ex, Gx");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 0);
+            if (MODREG) {
+                q1 = sse_get_reg_empty_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                VMV_V_V(q1, q0);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VSE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                SMWRITE2();
+            }
+            break;
+        case 0x51:
+            INST_NAME("SQRTPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETEX_vector(q1, 0, 0);
+            GETGX_empty_vector(q0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q1, q1, VECTOR_UNMASKED);
+            }
+            VFSQRT_V(q0, q1, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x54:
+            INST_NAME("ANDPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x55:
+            INST_NAME("ANDNPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VXOR_VI(q0, 0b11111, q0, VECTOR_UNMASKED);
+            VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x56:
+            INST_NAME("ORPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VOR_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x57:
+            INST_NAME("XORPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETG;
+            if (MODREG && gd == (nextop & 7) + (rex.b << 3)) {
+                // special case
+                q0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+                VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            } else {
+                q0 = sse_get_reg_vector(dyn, ninst, x1, gd, 1);
+                GETEX_vector(q1, 0, 0);
+                VXOR_VV(q0, q0, q1, VECTOR_UNMASKED);
+            }
+            break;
+        case 0x58:
+            INST_NAME("ADDPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x59:
+            INST_NAME("MULPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFMUL_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x5C:
+            INST_NAME("SUBPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x5E:
+            INST_NAME("DIVPS Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFDIV_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        default:
+            // fallback to the scalar version
+            return 0;
+    }
+    return addr;
+}
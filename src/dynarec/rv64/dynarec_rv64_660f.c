@@ -927,7 +927,7 @@ uintptr_t dynarec64_660F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                         sse_reflect_reg(dyn, ninst, x6, ed);
                         ADDI(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
                     } else {
-                        addr = geted(dyn, addr, ninst, nextop, &wback, x1, x2, &fixedaddress, rex, NULL, 0, 1);
+                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 1);
                         if (ed != x1) {
                             MV(x1, ed);
                         }
@@ -948,7 +948,8 @@ uintptr_t dynarec64_660F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                         ADDI(x2, xZR, 31);
                         SUB(xRCX, x2, xRCX);
                     } else {
-                        CTZxw(xRCX, xRCX, 0, x1, x2);
+                        ed = x1;
+                        CTZxw(xRCX, ed, 0, x2, x3);
                     }
                     break;
                 case 0xDB:
@@ -1332,24 +1333,36 @@ uintptr_t dynarec64_660F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 case 0x44:
                     INST_NAME("PCLMULQDQ Gx, Ex, Ib");
                     nextop = F8;
-                    GETG;
-                    sse_forget_reg(dyn, ninst, x6, gd);
-                    MOV32w(x1, gd); // gx
-                    if (MODREG) {
-                        ed = (nextop & 7) + (rex.b << 3);
-                        sse_forget_reg(dyn, ninst, x6, ed);
-                        MOV32w(x2, ed);
-                        MOV32w(x3, 0); // p = NULL
+                    if (rv64_zbc) {
+                        GETGX();
+                        GETEX(x2, 1);
+                        u8 = F8;
+                        LD(x4, gback, gdoffset + ((u8 & 1) ? 8 : 0));
+                        LD(x5, wback, fixedaddress + ((u8 & 0x10) ? 8 : 0));
+                        CLMUL(x6, x4, x5);
+                        CLMULH(x4, x4, x5);
+                        SD(x6, gback, gdoffset + 0);
+                        SD(x4, gback, gdoffset + 8);
                     } else {
-                        MOV32w(x2, 0);
-                        addr = geted(dyn, addr, ninst, nextop, &ed, x3, x5, &fixedaddress, rex, NULL, 0, 1);
-                        if (ed != x3) {
-                            MV(x3, ed);
+                        GETG;
+                        sse_forget_reg(dyn, ninst, x6, gd);
+                        MOV32w(x1, gd); // gx
+                        if (MODREG) {
+                            ed = (nextop & 7) + (rex.b << 3);
+                            sse_forget_reg(dyn, ninst, x6, ed);
+                            MOV32w(x2, ed);
+                            MOV32w(x3, 0); // p = NULL
+                        } else {
+                            MOV32w(x2, 0);
+                            addr = geted(dyn, addr, ninst, nextop, &ed, x3, x5, &fixedaddress, rex, NULL, 0, 1);
+                            if (ed != x3) {
+                                MV(x3, ed);
+                            }
                         }
+                        u8 = F8;
+                        MOV32w(x4, u8);
+                        CALL(native_pclmul, -1);
                     }
-                    u8 = F8;
-                    MOV32w(x4, u8);
-                    CALL(native_pclmul, -1);
                     break;
                 case 0xDF:
                     INST_NAME("AESKEYGENASSIST Gx, Ex, Ib"); // AES-NI
@@ -45,12 +45,622 @@ uintptr_t dynarec64_660F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t i
     MAYUSE(eb2);
     MAYUSE(j64);
     switch (opcode) {
+        case 0x10:
+            INST_NAME("MOVUPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            if (MODREG) {
+                q1 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGX_empty_vector(q0);
+                VMV_V_V(q0, q1);
+            } else {
+                GETGX_empty_vector(q0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VLE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            }
+            break;
+        case 0x11:
+            INST_NAME("MOVUPD Ex, Gx");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 0);
+            if (MODREG) {
+                q1 = sse_get_reg_empty_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                VMV_V_V(q1, q0);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VSE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                SMWRITE2();
+            }
+            break;
+        case 0x28:
+            INST_NAME("MOVAPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            if (MODREG) {
+                q1 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGX_empty_vector(q0);
+                VMV_V_V(q0, q1);
+            } else {
+                GETGX_empty_vector(q0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VLE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            }
+            break;
+        case 0x29:
+            INST_NAME("MOVAPD Ex, Gx");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 0);
+            if (MODREG) {
+                q1 = sse_get_reg_empty_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                VMV_V_V(q1, q0);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VSE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                SMWRITE2();
+            }
+            break;
+        case 0x3A: // these are some more SSSE3+ opcodes
+            opcode = F8;
+            switch (opcode) {
+                case 0x60:
+                case 0x61:
+                case 0x62:
+                case 0x63:
+                    switch (opcode) {
+                        case 0x60: INST_NAME("PCMPESTRM Gx, Ex, Ib"); break;
+                        case 0x61: INST_NAME("PCMPESTRI Gx, Ex, Ib"); break;
+                        case 0x62: INST_NAME("PCMPISTRM Gx, Ex, Ib"); break;
+                        case 0x63: INST_NAME("PCMPISTRI Gx, Ex, Ib"); break;
+                    }
+                    SETFLAGS(X_ALL, SF_SET);
+                    nextop = F8;
+                    // memory operand doesn't need to be aligned, load it as bytes
+                    vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+                    GETGX_vector(q0, 0);
+                    GETEX_vector(q1, 0, 1);
+                    u8 = F8;
+                    emit_pcmpstr(dyn, ninst, rex, q0, q1, u8, !(opcode & 2), x1, x2, x3, x4);
+                    if (opcode & 1) {
+                        // PCMPxSTRI: index in ECX
+                        if (u8 & 0b1000000) {
+                            BNEZ_MARK(x1);
+                            MOV32w(xRCX, (u8 & 1) ? 8 : 16);
+                            B_NEXT_nocond;
+                            MARK;
+                            if (rv64_zbb) {
+                                CLZW(xRCX, x1);
+                                ADDI(x2, xZR, 31);
+                                SUB(xRCX, x2, xRCX);
+                            } else {
+                                ADDI(xRCX, xZR, 15);
+                                SRL(x2, x1, xRCX);
+                                ANDI(x2, x2, 1);
+                                BNEZ(x2, 4 + 4 + 4);
+                                ADDI(xRCX, xRCX, -1);
+                                J(-4 * 4);
+                            }
+                        } else {
+                            MOV32w(x2, 1 << ((u8 & 1) ? 8 : 16));
+                            OR(x2, x1, x2);
+                            if (rv64_zbb) {
+                                CTZW(xRCX, x2);
+                            } else {
+                                MV(xRCX, xZR);
+                                ANDI(x3, x2, 1);
+                                BNEZ(x3, 4 * 4);
+                                SRLI(x2, x2, 1);
+                                ADDI(xRCX, xRCX, 1);
+                                J(-4 * 4);
+                            }
+                        }
+                    } else {
+                        // PCMPxSTRM: mask in XMM0
+                        q0 = sse_get_reg_empty_vector(dyn, ninst, x2, 0);
+                        if (u8 & 0b1000000) {
+                            vector_vsetvl_emul1(dyn, ninst, x2, (u8 & 1) ? VECTOR_SEW16 : VECTOR_SEW8);
+                            VMV_V_I(q0, 0);
+                            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+                        } else {
+                            VMV_V_I(q0, 0);
+                            VMV_S_X(q0, x1);
+                        }
+                    }
+                    break;
+                default:
+                    return 0;
+            }
+            break;
+        case 0x51:
+            INST_NAME("SQRTPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETEX_vector(q1, 0, 0);
+            GETGX_empty_vector(q0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q1, q1, VECTOR_UNMASKED);
+            }
+            VFSQRT_V(q0, q1, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x54:
+            INST_NAME("ANDPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x55:
+            INST_NAME("ANDNPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VXOR_VI(q0, 0b11111, q0, VECTOR_UNMASKED);
+            VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x56:
+            INST_NAME("ORPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VOR_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x57:
+            INST_NAME("XORPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VXOR_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0x58:
+            INST_NAME("ADDPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x59:
+            INST_NAME("MULPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFMUL_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x5C:
+            INST_NAME("SUBPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x5E:
+            INST_NAME("DIVPD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            if (!box64_dynarec_fastnan) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                VMFEQ_VV(d0, q0, q0, VECTOR_UNMASKED);
+                VMFEQ_VV(d1, q1, q1, VECTOR_UNMASKED);
+                VMAND_MM(d0, d0, d1);
+            }
+            VFDIV_VV(q0, q1, q0, VECTOR_UNMASKED);
+            if (!box64_dynarec_fastnan) {
+                VMFEQ_VV(d1, q0, q0, VECTOR_UNMASKED);
+                VMANDN_MM(VMASK, d1, d0);
+                VFSGNJN_VV(q0, q0, q0, VECTOR_MASKED);
+            }
+            break;
+        case 0x64:
+            INST_NAME("PCMPGTB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMSLT_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+            break;
+        case 0x65:
+            INST_NAME("PCMPGTW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMSLT_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+            break;
+        case 0x66:
+            INST_NAME("PCMPGTD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMSLT_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+            break;
+        case 0x6F:
+            INST_NAME("MOVDQA Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            if (MODREG) {
+                q1 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0);
+                GETGX_empty_vector(q0);
+                VMV_V_V(q0, q1);
+            } else {
+                GETGX_empty_vector(q0);
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VLE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            }
+            break;
+        case 0x71:
+            nextop = F8;
+            u8 = (nextop >> 3) & 7;
+            if (!MODREG || (u8 != 2 && u8 != 4 && u8 != 6)) return 0;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            q0 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 1);
+            switch (u8) {
+                case 2:
+                    INST_NAME("PSRLW Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 15) {
+                        VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    } else if (u8) {
+                        VSRL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+                case 4:
+                    INST_NAME("PSRAW Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 15) u8 = 15;
+                    if (u8) {
+                        VSRA_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+                case 6:
+                    INST_NAME("PSLLW Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 15) {
+                        VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    } else if (u8) {
+                        VSLL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+            }
+            break;
+        case 0x72:
+            nextop = F8;
+            u8 = (nextop >> 3) & 7;
+            if (!MODREG || (u8 != 2 && u8 != 4 && u8 != 6)) return 0;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            q0 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 1);
+            switch (u8) {
+                case 2:
+                    INST_NAME("PSRLD Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 31) {
+                        VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    } else if (u8) {
+                        VSRL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+                case 4:
+                    INST_NAME("PSRAD Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 31) u8 = 31;
+                    if (u8) {
+                        VSRA_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+                case 6:
+                    INST_NAME("PSLLD Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 31) {
+                        VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    } else if (u8) {
+                        VSLL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+            }
+            break;
+        case 0x73:
+            nextop = F8;
+            u8 = (nextop >> 3) & 7;
+            // PSRLDQ / PSLLDQ are left to the scalar version
+            if (!MODREG || (u8 != 2 && u8 != 6)) return 0;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            q0 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 1);
+            switch (u8) {
+                case 2:
+                    INST_NAME("PSRLQ Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 63) {
+                        VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    } else if (u8 > 31) {
+                        MOV32w(x4, u8);
+                        VSRL_VX(q0, x4, q0, VECTOR_UNMASKED);
+                    } else if (u8) {
+                        VSRL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+                case 6:
+                    INST_NAME("PSLLQ Ex, Ib");
+                    u8 = F8;
+                    if (u8 > 63) {
+                        VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+                    } else if (u8 > 31) {
+                        MOV32w(x4, u8);
+                        VSLL_VX(q0, x4, q0, VECTOR_UNMASKED);
+                    } else if (u8) {
+                        VSLL_VI(q0, u8, q0, VECTOR_UNMASKED);
+                    }
+                    break;
+            }
+            break;
+        case 0x74:
+            INST_NAME("PCMPEQB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMSEQ_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+            break;
+        case 0x75:
+            INST_NAME("PCMPEQW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMSEQ_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+            break;
+        case 0x76:
+            INST_NAME("PCMPEQD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMSEQ_VV(VMASK, q0, q1, VECTOR_UNMASKED);
+            VXOR_VV(q0, q0, q0, VECTOR_UNMASKED);
+            VMERGE_VIM(q0, 0b11111, q0); // implies VMASK
+            break;
+        case 0x7F:
+            INST_NAME("MOVDQA Ex, Gx");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 0);
+            if (MODREG) {
+                q1 = sse_get_reg_empty_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3));
+                VMV_V_V(q1, q0);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                ADDI(x2, ed, fixedaddress);
+                VSE_V(q0, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                SMWRITE2();
+            }
+            break;
+        case 0xD4:
+            INST_NAME("PADDQ Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xD5:
+            INST_NAME("PMULLW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMUL_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xD8:
+            INST_NAME("PSUBUSB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSSUBU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xD9:
+            INST_NAME("PSUBUSW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSSUBU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xDA:
+            INST_NAME("PMINUB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMINU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xDB:
+            INST_NAME("PAND Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0xDC:
+            INST_NAME("PADDUSB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSADDU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xDD:
+            INST_NAME("PADDUSW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSADDU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xDE:
+            INST_NAME("PMAXUB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMAXU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xDF:
+            INST_NAME("PANDN Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VXOR_VI(q0, 0b11111, q0, VECTOR_UNMASKED);
+            VAND_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0xE4:
+            INST_NAME("PMULHUW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMULHU_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xE5:
+            INST_NAME("PMULHW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMULH_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xE8:
+            INST_NAME("PSUBSB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xE9:
+            INST_NAME("PSUBSW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xEA:
+            INST_NAME("PMINSW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMIN_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xEB:
+            INST_NAME("POR Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VOR_VV(q0, q0, q1, VECTOR_UNMASKED);
+            break;
+        case 0xEC:
+            INST_NAME("PADDSB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xED:
+            INST_NAME("PADDSW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xEE:
+            INST_NAME("PMAXSW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VMAX_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
         case 0xEF:
             INST_NAME("PXOR Gx, Ex");
             nextop = F8;
-            // FIXME: we should try to minimize vsetvl usage as it may hurts performance a lot.
-            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
-
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
             GETG;
             if (MODREG && gd == (nextop & 7) + (rex.b << 3)) {
                 // special case
@@ -62,6 +672,62 @@ uintptr_t dynarec64_660F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t i
                 VXOR_VV(q0, q0, q1, VECTOR_UNMASKED);
             }
             break;
+        case 0xF8:
+            INST_NAME("PSUBB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xF9:
+            INST_NAME("PSUBW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xFA:
+            INST_NAME("PSUBD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xFB:
+            INST_NAME("PSUBQ Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW64);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VSUB_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xFC:
+            INST_NAME("PADDB Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW8);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xFD:
+            INST_NAME("PADDW Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW16);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
+        case 0xFE:
+            INST_NAME("PADDD Gx, Ex");
+            nextop = F8;
+            vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEW32);
+            GETGX_vector(q0, 1);
+            GETEX_vector(q1, 0, 0);
+            VADD_VV(q0, q1, q0, VECTOR_UNMASKED);
+            break;
         default:
             // fallback to the scalar version
             return 0;
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "x64run.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "rv64_printer.h"
+#include "dynarec_rv64_private.h"
+#include "dynarec_rv64_functions.h"
+#include "dynarec_rv64_helper.h"
+
+// get |rs| clamped to n in rd (explicit length of PCMPESTRx), using s as scratch
+static void emit_pcmpstr_explicit_len(dynarec_rv64_t* dyn, int ninst, rex_t rex, int rd, int rs, int n, int s)
+{
+    if (rex.w)
+        MV(rd, rs);
+    else
+        ADDIW(rd, rs, 0);
+    BGE(rd, xZR, 8);
+    NEG(rd, rd);
+    ADDI(s, xZR, n);
+    BLT(rd, s, 8);
+    MV(rd, s);
+}
+
+// get the index of the first 0 element of v in rd, or n if there is none (implicit length of PCMPISTRx), m is a scratch vector
+static void emit_pcmpstr_implicit_len(dynarec_rv64_t* dyn, int ninst, int rd, int v, int n, int m)
+{
+    VMSEQ_VI(m, 0, v, VECTOR_UNMASKED);
+    VFIRST_M(rd, m, VECTOR_UNMASKED);
+    BGE(rd, xZR, 8);
+    ADDI(rd, xZR, n);
+}
+
+// emit PCMPxSTRx string compare of v0 (Gx, the "reg" operand) and v1 (Ex, the "mem" operand) with control imm8, using RVV
+// explicit length are taken from RAX/RDX if expl is set. IntRes2 is left as a mask in VMASK and as a bitmask in s1, flags are set
+// s2 and s3 are the (clamped) length of reg and mem on exit
+void emit_pcmpstr(dynarec_rv64_t* dyn, int ninst, rex_t rex, int v0, int v1, uint8_t imm8, int expl, int s1, int s2, int s3, int s4)
+{
+    int word = imm8 & 1;
+    int n = word ? 8 : 16;
+    int vi = fpu_get_scratch(dyn);
+    int vr = fpu_get_scratch(dyn); // valid elements of reg
+    int vm = fpu_get_scratch(dyn); // valid elements of mem
+    int t = fpu_get_scratch(dyn);
+    int t2 = fpu_get_scratch(dyn);
+    int m = fpu_get_scratch(dyn);
+    int64_t j64;
+    MAYUSE(j64);
+    vector_vsetvl_emul1(dyn, ninst, s1, word ? VECTOR_SEW16 : VECTOR_SEW8);
+    if (expl) {
+        emit_pcmpstr_explicit_len(dyn, ninst, rex, s2, xRAX, n, s4);
+        emit_pcmpstr_explicit_len(dyn, ninst, rex, s3, xRDX, n, s4);
+    } else {
+        emit_pcmpstr_implicit_len(dyn, ninst, s2, v0, n, m);
+        emit_pcmpstr_implicit_len(dyn, ninst, s3, v1, n, m);
+    }
+    VID_V(vi, VECTOR_UNMASKED);
+    VMSLTU_VX(vm, s3, vi, VECTOR_UNMASKED);
+    // aggregate to IntRes1
+    // reg elements are walked in order, and the loop is exited at the first invalid one
+    switch ((imm8 >> 2) & 3) {
+        case 0b00: // equal any
+            VMXOR_MM(VMASK, VMASK, VMASK);
+            for (int i = 0; i < n; ++i) {
+                if (i) ADDI(s4, xZR, i);
+                BGE_MARK3(i ? s4 : xZR, s2);
+                VRGATHER_VI(t, i, v0, VECTOR_UNMASKED);
+                VMSEQ_VV(m, t, v1, VECTOR_UNMASKED);
+                VMOR_MM(VMASK, VMASK, m);
+            }
+            MARK3;
+            VMAND_MM(VMASK, VMASK, vm);
+            break;
+        case 0b01: // ranges
+            VMXOR_MM(VMASK, VMASK, VMASK);
+            for (int i = 0; i < n; i += 2) {
+                ADDI(s4, xZR, i + 1);
+                BGE_MARK3(s4, s2);
+                VRGATHER_VI(t, i, v0, VECTOR_UNMASKED);
+                VRGATHER_VI(t2, i + 1, v0, VECTOR_UNMASKED);
+                if (imm8 & 2) {
+                    VMSLE_VV(m, v1, t, VECTOR_UNMASKED);  // reg[i] <= mem[j]
+                    VMSLE_VV(t, t2, v1, VECTOR_UNMASKED); // mem[j] <= reg[i+1]
+                } else {
+                    VMSLEU_VV(m, v1, t, VECTOR_UNMASKED);
+                    VMSLEU_VV(t, t2, v1, VECTOR_UNMASKED);
+                }
+                VMAND_MM(m, m, t);
+                VMOR_MM(VMASK, VMASK, m);
+            }
+            MARK3;
+            VMAND_MM(VMASK, VMASK, vm);
+            break;
+        case 0b10: // equal each
+            VMSLTU_VX(vr, s2, vi, VECTOR_UNMASKED);
+            VMSEQ_VV(m, v0, v1, VECTOR_UNMASKED);
+            VMAND_MM(m, m, vr);
+            VMAND_MM(m, m, vm);
+            // both invalid is a match
+            VMNOR_MM(t, vr, vm);
+            VMOR_MM(VMASK, m, t);
+            break;
+        case 0b11: // equal ordered
+            VMSEQ_VV(VMASK, vi, vi, VECTOR_UNMASKED);
+            for (int i = 0; i < n; ++i) {
+                if (i) ADDI(s4, xZR, i);
+                BGE_MARK3(i ? s4 : xZR, s2);
+                VRGATHER_VI(t2, i, v0, VECTOR_UNMASKED);
+                if (i) {
+                    VSLIDEDOWN_VI(t, i, v1, VECTOR_UNMASKED);
+                    VMSEQ_VV(m, t2, t, VECTOR_UNMASKED);
+                } else {
+                    VMSEQ_VV(m, t2, v1, VECTOR_UNMASKED);
+                }
+                // mem[i+j] must be valid...
+                ADDI(s4, s3, -i);
+                VMSLT_VX(t, s4, vi, VECTOR_UNMASKED);
+                VMAND_MM(m, m, t);
+                // ...unless it's past the end of mem
+                if (i) {
+                    VMSGTU_VI(t, n - i - 1, vi, VECTOR_UNMASKED);
+                    VMOR_MM(m, m, t);
+                }
+                VMAND_MM(VMASK, VMASK, m);
+            }
+            MARK3;
+            break;
+    }
+    // polarity, to IntRes2
+    switch ((imm8 >> 4) & 3) {
+        case 0b01:
+            VMNAND_MM(VMASK, VMASK, VMASK);
+            break;
+        case 0b11:
+            VMXOR_MM(VMASK, VMASK, vm);
+            break;
+    }
+    // IntRes2 as a bitmask in s1
+    vector_vsetvl_emul1(dyn, ninst, s4, VECTOR_SEW16);
+    VMV_X_S(s1, VMASK);
+    if (word) {
+        ANDI(s1, s1, 0xff);
+    } else {
+        ZEXTH(s1, s1);
+    }
+    // flags
+    CLEAR_FLAGS();
+    IFX(X_ALL) {
+        SET_DFNONE();
+    }
+    IFX(X_CF) {
+        BEQZ(s1, 8);
+        ORI(xFlags, xFlags, 1 << F_CF);
+    }
+    IFX(X_ZF | X_SF) {
+        ADDI(s4, xZR, n);
+        IFX(X_ZF) {
+            BGE(s3, s4, 8);
+            ORI(xFlags, xFlags, 1 << F_ZF);
+        }
+        IFX(X_SF) {
+            BGE(s2, s4, 8);
+            ORI(xFlags, xFlags, 1 << F_SF);
+        }
+    }
+    IFX(X_OF) {
+        ANDI(s4, s1, 1);
+        BEQZ(s4, 8);
+        ORI(xFlags, xFlags, 1 << F_OF2);
+    }
+}
@@ -152,32 +152,14 @@ uintptr_t dynarec64_F20F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                     nextop = F8;
                     GETEB(x1, 0);
                     GETGD;
-                    XOR(gd, gd, ed);
-                    MOV32w(x2, 0x82f63b78);
-                    for (int i = 0; i < 8; i++) {
-                        SRLI((i&1)?gd:x4, (i&1)?x4:gd, 1);
-                        ANDI(x6, (i&1)?x4:gd, 1);
-                        BEQZ(x6, 4+4);
-                        XOR((i&1)?gd:x4, (i&1)?gd:x4, x2);
-                    }
+                    emit_crc32c(dyn, ninst, gd, ed, 1, x3, x4, x5);
                     break;
                 case 0xF1:  // CRC32 Gd, Ed
                     INST_NAME("CRC32 Gd, Ed");
                     nextop = F8;
                     GETGD;
                     GETED(0);
-                    MOV32w(x2, 0x82f63b78);
-                    for(int j=0; j<4*(rex.w+1); ++j) {
-                        SRLI(x5, ed, 8*j);
-                        ANDI(x3, x5, 0xFF);
-                        XOR(gd, gd, x3);
-                        for (int i = 0; i < 8; i++) {
-                            SRLI((i&1)?gd:x4, (i&1)?x4:gd, 1);
-                            ANDI(x6, (i&1)?x4:gd, 1);
-                            BEQZ(x6, 4+4);
-                            XOR((i&1)?gd:x4, (i&1)?gd:x4, x2);
-                        }
-                    }
+                    emit_crc32c(dyn, ninst, gd, ed, rex.w ? 8 : 4, x3, x4, x5);
                     break;
                 default:
                     DEFAULT;
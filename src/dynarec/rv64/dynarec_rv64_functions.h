@@ -7,6 +7,8 @@ typedef struct x64emu_s x64emu_t;
 typedef struct dynarec_rv64_s dynarec_rv64_t;
 
 #define SCRATCH0    2
+// vector register used as mask by the masked RVV instructions
+#define VMASK       0
 
 // Get an FPU scratch reg
 int fpu_get_scratch(dynarec_rv64_t* dyn);
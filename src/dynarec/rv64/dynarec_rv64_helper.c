@@ -33,6 +33,8 @@ uintptr_t geted(dynarec_rv64_t* dyn, uintptr_t addr, int ninst, uint8_t nextop,
 {
     MAYUSE(dyn); MAYUSE(ninst); MAYUSE(delta);
 
+    smclassify_ed(dyn, addr, ninst, nextop, rex);
+
     if(rex.is32bits)
         return geted_32(dyn, addr, ninst, nextop, ed, hint, scratch, fixaddress, l, i12);
 
@@ -306,6 +308,8 @@ uintptr_t geted32(dynarec_rv64_t* dyn, uintptr_t addr, int ninst, uint8_t nextop
 {
     MAYUSE(dyn); MAYUSE(ninst); MAYUSE(delta);
 
+    smclassify_ed(dyn, addr, ninst, nextop, rex);
+
     int lock = l?((l==LOCK_LOCK)?1:2):0;
     if(lock==2)
         *l = 0;
@@ -730,6 +734,8 @@ void call_c(dynarec_rv64_t* dyn, int ninst, void* fnc, int reg, int ret, int sav
     // regenerate mask
     XORI(xMASK, xZR, -1);
     SRLI(xMASK, xMASK, 32);
+    // the called function may have changed the vector config
+    dyn->vector_sew = VECTOR_SEWNA;
 
     fpu_popcache(dyn, ninst, reg, 0);
     if(saveflags) {
@@ -794,6 +800,8 @@ void call_n(dynarec_rv64_t* dyn, int ninst, void* fnc, int w)
     // regenerate mask
     XORI(xMASK, xZR, -1);
     SRLI(xMASK, xMASK, 32);
+    // the called function may have changed the vector config
+    dyn->vector_sew = VECTOR_SEWNA;
 
     fpu_popcache(dyn, ninst, x3, 1);
     LD(xFlags, xEmu, offsetof(x64emu_t, eflags));
@@ -806,6 +814,7 @@ void grab_segdata(dynarec_rv64_t* dyn, uintptr_t addr, int ninst, int reg, int s
     (void)addr;
     int64_t j64;
     MAYUSE(j64);
+    dyn->insts[ninst].x64.mem_tls = 1;   // segment based access are thread local
     MESSAGE(LOG_DUMP, "Get %s Offset\n", (segment==_FS)?"FS":"GS");
     int t1 = x1, t2 = x4;
     if(reg==t1) ++t1;
@@ -1672,8 +1681,9 @@ int sse_get_reg_vector(dynarec_rv64_t* dyn, int ninst, int s1, int a, int forwri
     dyn->e.ssecache[a].write = forwrite;
     dyn->e.ssecache[a].vector = 1;
     dyn->e.ssecache[a].single = 0; // just to be clean
+    vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
     ADDI(s1, xEmu, offsetof(x64emu_t, xmm[a]));
-    VLE8_V(ret, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+    VLE_V(ret, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
     return ret;
 }
 
@@ -1707,8 +1717,11 @@ void sse_forget_reg_vector(dynarec_rv64_t* dyn, int ninst, int s1, int a)
     if (dyn->e.ssecache[a].vector == 0)
         return sse_forget_reg(dyn, ninst, s1, a);
     if (dyn->e.extcache[EXTIDX(dyn->e.ssecache[a].reg)].t == EXT_CACHE_XMMW) {
+        int old_sew = dyn->vector_sew;
+        vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
         ADDI(s1, xEmu, offsetof(x64emu_t, xmm[a]));
-        VSE8_V(dyn->e.ssecache[a].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+        VSE_V(dyn->e.ssecache[a].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+        dyn->vector_sew = old_sew;
     }
     fpu_free_reg(dyn, dyn->e.ssecache[a].reg);
     dyn->e.ssecache[a].v = -1;
@@ -1719,6 +1732,7 @@ void sse_forget_reg_vector(dynarec_rv64_t* dyn, int ninst, int s1, int a)
 void sse_purge07cache(dynarec_rv64_t* dyn, int ninst, int s1)
 {
     int old = -1;
+    int old_sew = dyn->vector_sew;
     for (int i = 0; i < 8; ++i)
         if (dyn->e.ssecache[i].v != -1) {
             if (old == -1) {
@@ -1726,8 +1740,9 @@ void sse_purge07cache(dynarec_rv64_t* dyn, int ninst, int s1)
                 ++old;
             }
             if (dyn->e.ssecache[i].vector) {
+                vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
                 ADDI(s1, xEmu, offsetof(x64emu_t, xmm[i]));
-                VSE8_V(dyn->e.ssecache[i].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                VSE_V(dyn->e.ssecache[i].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
             } else if (dyn->e.ssecache[i].single)
                 FSW(dyn->e.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
             else
@@ -1735,6 +1750,7 @@ void sse_purge07cache(dynarec_rv64_t* dyn, int ninst, int s1)
             fpu_free_reg(dyn, dyn->e.ssecache[i].reg);
             dyn->e.ssecache[i].v = -1;
         }
+    dyn->vector_sew = old_sew;
     if (old != -1) {
         MESSAGE(LOG_DUMP, "\t------ Purge XMM0..7 Cache\n");
     }
@@ -1751,8 +1767,9 @@ static void sse_purgecache(dynarec_rv64_t* dyn, int ninst, int next, int s1)
                 ++old;
             }
             if (dyn->e.ssecache[i].vector) {
+                vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
                 ADDI(s1, xEmu, offsetof(x64emu_t, xmm[i]));
-                VSE8_V(dyn->e.ssecache[i].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                VSE_V(dyn->e.ssecache[i].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
             } else if (dyn->e.ssecache[i].single)
                 FSW(dyn->e.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
             else
@@ -1781,8 +1798,9 @@ static void sse_reflectcache(dynarec_rv64_t* dyn, int ninst, int s1)
     for (int i = 0; i < 16; ++i)
         if (dyn->e.ssecache[i].v != -1) {
             if (dyn->e.ssecache[i].vector) {
+                vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
                 ADDI(s1, xEmu, offsetof(x64emu_t, xmm[i]));
-                VSE8_V(dyn->e.ssecache[i].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                VSE_V(dyn->e.ssecache[i].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
             } else if (dyn->e.ssecache[i].single)
                 FSW(dyn->e.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
             else
@@ -1795,8 +1813,11 @@ void sse_reflect_reg(dynarec_rv64_t* dyn, int ninst, int s1, int a)
     if (dyn->e.ssecache[a].v == -1)
         return;
     if (dyn->e.ssecache[a].vector) {
+        int old_sew = dyn->vector_sew;
+        vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
         ADDI(s1, xEmu, offsetof(x64emu_t, xmm[a]));
-        VSE8_V(dyn->e.ssecache[a].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+        VSE_V(dyn->e.ssecache[a].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+        dyn->vector_sew = old_sew;
     } else if (dyn->e.ssecache[a].single)
         FSW(dyn->e.ssecache[a].reg, xEmu, offsetof(x64emu_t, xmm[a]));
     else
@@ -1810,6 +1831,7 @@ void fpu_pushcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
     int start = not07?8:0;
     // only SSE regs needs to be push back to xEmu (needs to be "write")
     int n=0;
+    int old_sew = dyn->vector_sew;
     for (int i=start; i<8; i++)
         if(dyn->e.ssecache[i].v!=-1)
             ++n;
@@ -1818,8 +1840,9 @@ void fpu_pushcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
         for (int i=start; i<8; ++i)
             if(dyn->e.ssecache[i].v!=-1) {
                 if (dyn->e.ssecache[i].vector) {
+                    vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
                     ADDI(s1, xEmu, offsetof(x64emu_t, xmm[i]));
-                    VSE8_V(dyn->e.ssecache[i].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                    VSE_V(dyn->e.ssecache[i].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
                 } else if (dyn->e.ssecache[i].single)
                     FSW(dyn->e.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
                 else
@@ -1827,6 +1850,7 @@ void fpu_pushcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
             }
         MESSAGE(LOG_DUMP, "\t------- Push XMM Cache (%d)\n", n);
     }
+    dyn->vector_sew = old_sew;
     n = 0;
     for(int i=17; i<24; ++i)
         if(dyn->e.extcache[i].v!=0)
@@ -1856,6 +1880,7 @@ void fpu_popcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
     int start = not07?8:0;
     // only SSE regs needs to be pop back from xEmu (don't need to be "write" this time)
     int n=0;
+    int old_sew = dyn->vector_sew;
     for (int i=start; i<8; i++)
         if(dyn->e.ssecache[i].v!=-1)
             ++n;
@@ -1864,8 +1889,9 @@ void fpu_popcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
         for (int i=start; i<8; ++i)
             if(dyn->e.ssecache[i].v!=-1) {
                 if (dyn->e.ssecache[i].vector) {
+                    vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
                     ADDI(s1, xEmu, offsetof(x64emu_t, xmm[i]));
-                    VLE8_V(dyn->e.ssecache[i].reg, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                    VLE_V(dyn->e.ssecache[i].reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
                 } else if (dyn->e.ssecache[i].single)
                     FLW(dyn->e.ssecache[i].reg, xEmu, offsetof(x64emu_t, xmm[i]));
                 else
@@ -1873,6 +1899,7 @@ void fpu_popcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
             }
         MESSAGE(LOG_DUMP, "\t------- Pop XMM Cache (%d)\n", n);
     }
+    dyn->vector_sew = old_sew;
     n = 0;
     for(int i=17; i<24; ++i)
         if(dyn->e.extcache[i].v!=0)
@@ -1900,9 +1927,12 @@ void fpu_popcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
 
 void fpu_purgecache(dynarec_rv64_t* dyn, int ninst, int next, int s1, int s2, int s3)
 {
+    // purge can be in a conditional path, so don't assume an element width was set after it
+    int old_sew = dyn->vector_sew;
     x87_purgecache(dyn, ninst, next, s1, s2, s3);
     mmx_purgecache(dyn, ninst, next, s1);
     sse_purgecache(dyn, ninst, next, s1);
+    dyn->vector_sew = old_sew;
     if(!next)
         fpu_reset_reg(dyn);
 }
@@ -1954,10 +1984,11 @@ static void swapCache(dynarec_rv64_t* dyn, int ninst, int i, int j, extcache_t *
     if (i == j) return;
 
     if (cache->extcache[i].t == EXT_CACHE_XMMR || cache->extcache[i].t == EXT_CACHE_XMMW || cache->extcache[j].t == EXT_CACHE_XMMR || cache->extcache[j].t == EXT_CACHE_XMMW) {
+        vector_vsetvl_emul1(dyn, ninst, x1, VECTOR_SEWANY);
         if (!cache->extcache[i].v) {
             // a mov is enough, no need to swap
             MESSAGE(LOG_DUMP, "\t  - Moving %d <- %d\n", i, j);
-            VOR_VV(i, j, j, VECTOR_UNMASKED);
+            VMV_V_V(EXTREG(i), EXTREG(j));
             cache->extcache[i].v = cache->extcache[j].v;
             cache->extcache[j].v = 0;
             return;
@@ -1965,9 +1996,9 @@ static void swapCache(dynarec_rv64_t* dyn, int ninst, int i, int j, extcache_t *
         // SWAP
         ext_cache_t tmp;
         MESSAGE(LOG_DUMP, "\t  - Swapping %d <-> %d\n", i, j);
-        VXOR_VV(i, i, j, VECTOR_UNMASKED);
-        VXOR_VV(j, i, j, VECTOR_UNMASKED);
-        VXOR_VV(i, i, j, VECTOR_UNMASKED);
+        VXOR_VV(EXTREG(i), EXTREG(i), EXTREG(j), VECTOR_UNMASKED);
+        VXOR_VV(EXTREG(j), EXTREG(i), EXTREG(j), VECTOR_UNMASKED);
+        VXOR_VV(EXTREG(i), EXTREG(i), EXTREG(j), VECTOR_UNMASKED);
         tmp.v = cache->extcache[i].v;
         cache->extcache[i].v = cache->extcache[j].v;
         cache->extcache[j].v = tmp.v;
@@ -2022,7 +2053,8 @@ static void loadCache(dynarec_rv64_t* dyn, int ninst, int stack_cnt, int s1, int
         int j = i + 1;
         while (cache->extcache[j].v) ++j;
         MESSAGE(LOG_DUMP, "\t  - Moving away %d\n", i);
-        VOR_VV(j, i, i, VECTOR_UNMASKED);
+        vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
+        VMV_V_V(EXTREG(j), reg);
         cache->extcache[j].v = cache->extcache[i].v;
     } else if (cache->extcache[i].v) {
         int single = 0;
@@ -2044,8 +2076,9 @@ static void loadCache(dynarec_rv64_t* dyn, int ninst, int stack_cnt, int s1, int
         case EXT_CACHE_XMMR:
         case EXT_CACHE_XMMW:
             MESSAGE(LOG_DUMP, "\t  - Loading %s\n", getCacheName(t, n));
+            vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
             ADDI(s1, xEmu, offsetof(x64emu_t, xmm[n]));
-            VLE8_V(i, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            VLE_V(reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
             break;
         case EXT_CACHE_SS:
             MESSAGE(LOG_DUMP, "\t  - Loading %s\n", getCacheName(t, n));
@@ -2103,8 +2136,9 @@ static void unloadCache(dynarec_rv64_t* dyn, int ninst, int stack_cnt, int s1, i
             break;
         case EXT_CACHE_XMMW:
             MESSAGE(LOG_DUMP, "\t  - Unloading %s\n", getCacheName(t, n));
+            vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
             ADDI(s1, xEmu, offsetof(x64emu_t, xmm[n]));
-            VSE8_V(i, s1, VECTOR_UNMASKED, VECTOR_NFIELD1);
+            VSE_V(reg, s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
             break;
         case EXT_CACHE_SS:
             MESSAGE(LOG_DUMP, "\t  - Unloading %s\n", getCacheName(t, n));
@@ -2195,7 +2229,7 @@ static void fpuCacheTransform(dynarec_rv64_t* dyn, int ninst, int s1, int s2, in
     int s2_val = 0;
     // unload every uneeded cache
     // check SSE first, than MMX, in order, for optimisation issue
-    if (rv64_vector) vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEW8);
+    int old_sew = dyn->vector_sew;
     for (int i = 0; i < 16; ++i) {
         int j = findCacheSlot(dyn, ninst, EXT_CACHE_SS, i, &cache);
         if (j >= 0 && findCacheSlot(dyn, ninst, EXT_CACHE_SS, i, &cache_i2) == -1)
@@ -2259,6 +2293,15 @@ static void fpuCacheTransform(dynarec_rv64_t* dyn, int ninst, int s1, int s2, in
                     FMVXD(s1, EXTREG(i));
                     FCVTDL(EXTREG(i), s1, RD_RTZ);
                     cache.extcache[i].t = EXT_CACHE_ST_D;
+                } else if (cache.extcache[i].t == EXT_CACHE_XMMR && cache_i2.extcache[i].t == EXT_CACHE_XMMW) {
+                    cache.extcache[i].t = EXT_CACHE_XMMW;
+                } else if (cache.extcache[i].t == EXT_CACHE_XMMW && cache_i2.extcache[i].t == EXT_CACHE_XMMR) {
+                    // refresh cache...
+                    MESSAGE(LOG_DUMP, "\t  - Refresh %s\n", getCacheName(cache.extcache[i].t, cache.extcache[i].n));
+                    vector_vsetvl_emul1(dyn, ninst, s1, VECTOR_SEWANY);
+                    ADDI(s1, xEmu, offsetof(x64emu_t, xmm[cache.extcache[i].n]));
+                    VSE_V(EXTREG(i), s1, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+                    cache.extcache[i].t = EXT_CACHE_XMMR;
                 }
             }
         }
@@ -2288,6 +2331,8 @@ static void fpuCacheTransform(dynarec_rv64_t* dyn, int ninst, int s1, int s2, in
         s3_top = 0;
         stack_cnt = cache_i2.stack;
     }
+    // the transform is not always executed, so the element width is only known if it was before
+    dyn->vector_sew = old_sew;
     MESSAGE(LOG_DUMP, "\t---- Cache Transform\n");
 #endif
 }
@@ -2389,9 +2434,11 @@ void rv64_move64(dynarec_rv64_t* dyn, int ninst, int reg, int64_t val)
 
 void fpu_reflectcache(dynarec_rv64_t* dyn, int ninst, int s1, int s2, int s3)
 {
+    int old_sew = dyn->vector_sew;
     x87_reflectcache(dyn, ninst, s1, s2, s3);
     mmx_reflectcache(dyn, ninst, s1);
     sse_reflectcache(dyn, ninst, s1);
+    dyn->vector_sew = old_sew;
 }
 
 void fpu_unreflectcache(dynarec_rv64_t* dyn, int ninst, int s1, int s2, int s3)
@@ -2420,6 +2467,55 @@ void emit_pf(dynarec_rv64_t* dyn, int ninst, int s1, int s3, int s4)
     OR(xFlags, xFlags, s3);
 }
 
+// gd = CRC32C of the size (1, 2, 4 or 8) low bytes of ed, starting from gd (32bits), zero extended. ed is unchanged
+void emit_crc32c(dynarec_rv64_t* dyn, int ninst, int gd, int ed, int size, int s1, int s2, int s3)
+{
+    MAYUSE(dyn);
+    MAYUSE(ninst);
+
+    if (rv64_zbc) {
+        // Barrett reduction of crc^data, aligned on the top of 64bits, using the bit-reflected quotient x^95/P
+        int bits = size * 8;
+        if (size == 8) {
+            AND(s1, gd, xMASK);
+            XOR(s1, s1, ed);
+        } else {
+            SLLI(s1, ed, 64 - bits);
+            SLLI(s2, gd, 64 - bits);
+            XOR(s1, s1, s2);
+            if (size < 4) SRLIW(s3, gd, bits); // the part of the crc not covered by the data
+        }
+        TABLE64(s2, 0xa434f61c6f5389f8LL);
+        CLMUL(s2, s1, s2);
+        SLLI(s2, s2, 1);
+        XOR(s1, s2, s1);
+        TABLE64(s2, 0x82f63b78LL << 32);
+        CLMULR(s1, s1, s2);
+        SRLI(gd, s1, 32);
+        if (size < 4) XOR(gd, gd, s3);
+        return;
+    }
+    // table driven, one byte at a time
+    if (gd == ed) {
+        MV(s1, ed);
+        ed = s1;
+    }
+    ZEROUP(gd);
+    TABLE64(s2, (uintptr_t)native_crc32c_table);
+    for (int i = 0; i < size; ++i) {
+        if (i) {
+            SRLI(s3, ed, 8 * i);
+            XOR(s3, s3, gd);
+        } else
+            XOR(s3, ed, gd);
+        ANDI(s3, s3, 0xff);
+        ADDSL(s3, s2, s3, 2, s3);
+        LWU(s3, s3, 0);
+        SRLI(gd, gd, 8);
+        XOR(gd, gd, s3);
+    }
+}
+
 void fpu_reset_cache(dynarec_rv64_t* dyn, int ninst, int reset_n)
 {
     MESSAGE(LOG_DEBUG, "Reset Caches with %d\n",reset_n);
@@ -2487,9 +2583,18 @@ void fpu_propagate_stack(dynarec_rv64_t* dyn, int ninst)
 }
 
 // Use vector extension as like SIMD for now, this function sets the specified element width,
-// other configs are set automatically.
+// other configs are set automatically. Nothing is emitted if the element width is already the right one,
+// VECTOR_SEWANY only makes sure some element width is set.
 void vector_vsetvl_emul1(dynarec_rv64_t* dyn, int ninst, int s1, int sew)
 {
+    if (sew == VECTOR_SEWANY) {
+        if (dyn->vector_sew != VECTOR_SEWNA)
+            return;
+        sew = VECTOR_SEW8;
+    }
+    if (dyn->vector_sew == sew)
+        return;
+    dyn->vector_sew = sew;
     /* mu:   mask undisturbed
      * tu:   tail undisturbed
      * sew:  selected element width
@@ -36,21 +36,23 @@
 // Strong mem emulation helpers
 #define SMREAD_MIN  2
 #define SMWRITE_MIN 1
+// Opcode only access the stack or thread local storage, so no barrier is needed
+#define SMLOCAL()   (box64_dynarec_strongmem_local && (dyn->insts[ninst].x64.mem_tls || (dyn->insts[ninst].x64.mem_local && !dyn->insts[ninst].x64.mem_shared)))
 // Sequence of Read will trigger a DMB on "first" read if strongmem is >= SMREAD_MIN
 // Sequence of Write will trigger a DMB on "last" write if strongmem is >= 1
 // All Write operation that might use a lock all have a memory barrier if strongmem is >= SMWRITE_MIN
 // Opcode will read
-#define SMREAD() if((dyn->smread==0) && (box64_dynarec_strongmem>SMREAD_MIN)) {SMDMB();} else dyn->smread=1
+#define SMREAD() if((dyn->smread==0) && (box64_dynarec_strongmem>SMREAD_MIN) && !SMLOCAL()) {SMDMB();} else dyn->smread=1
 // Opcode will read with option forced lock
-#define SMREADLOCK(lock)    if((lock) || ((dyn->smread==0) && (box64_dynarec_strongmem>SMREAD_MIN))) {SMDMB();}
+#define SMREADLOCK(lock)    if((lock) || ((dyn->smread==0) && (box64_dynarec_strongmem>SMREAD_MIN) && !SMLOCAL())) {SMDMB();}
 // Opcode might read (depend on nextop)
 #define SMMIGHTREAD()   if(!MODREG) {SMREAD();}
 // Opcode has wrote
-#define SMWRITE()   dyn->smwrite=1
+#define SMWRITE()   if(!SMLOCAL()) dyn->smwrite=1
 // Opcode has wrote (strongmem>1 only)
-#define SMWRITE2()   if(box64_dynarec_strongmem>SMREAD_MIN) dyn->smwrite=1
+#define SMWRITE2()   if(box64_dynarec_strongmem>SMREAD_MIN && !SMLOCAL()) dyn->smwrite=1
 // Opcode has wrote with option forced lock
-#define SMWRITELOCK(lock)   if(lock || (box64_dynarec_strongmem>SMWRITE_MIN)) {SMDMB();} else dyn->smwrite=1
+#define SMWRITELOCK(lock)   if(lock || ((box64_dynarec_strongmem>SMWRITE_MIN) && !SMLOCAL())) {SMDMB();} else if(!SMLOCAL()) dyn->smwrite=1
 // Opcode might have wrote (depend on nextop)
 #define SMMIGHTWRITE()   if(!MODREG) {SMWRITE();}
 // Start of sequence
@@ -503,9 +505,19 @@
         addr = geted(dyn, addr, ninst, nextop, &ed, x3, x2, &fixedaddress, rex, NULL, 1, D); \
         a = fpu_get_scratch(dyn);                                                            \
         ADDI(x2, ed, fixedaddress);                                                          \
-        VLE8_V(a, x2, VECTOR_UNMASKED, VECTOR_NFIELD1);                                      \
+        VLE_V(a, x2, dyn->vector_sew, VECTOR_UNMASKED, VECTOR_NFIELD1);                      \
     }
 
+// Get GX as a vector register (sew must already be set)
+#define GETGX_vector(a, w)                    \
+    gd = ((nextop & 0x38) >> 3) + (rex.r << 3); \
+    a = sse_get_reg_vector(dyn, ninst, x1, gd, w)
+
+// Get GX as a vector register for writing only
+#define GETGX_empty_vector(a)                 \
+    gd = ((nextop & 0x38) >> 3) + (rex.r << 3); \
+    a = sse_get_reg_empty_vector(dyn, ninst, x1, gd)
+
 #define GETGM()                     \
     gd = ((nextop & 0x38) >> 3);    \
     mmx_forget_reg(dyn, ninst, gd); \
@@ -665,7 +677,7 @@
 // R0 will not be pushed/popd if ret is -2. Flags are not save/restored
 #define CALL_S(F, ret) call_c(dyn, ninst, F, x6, ret, 0, 0)
 
-#define MARKi(i)    dyn->insts[ninst].mark[i] = dyn->native_size
+#define MARKi(i)    SETMARK(dyn->insts[ninst].mark[i])
 #define GETMARKi(i) dyn->insts[ninst].mark[i]
 #define MARK        MARKi(0)
 #define GETMARK     GETMARKi(0)
@@ -674,16 +686,16 @@
 #define MARK3       MARKi(2)
 #define GETMARK3    GETMARKi(2)
 
-#define MARKFi(i)    dyn->insts[ninst].markf[i] = dyn->native_size
+#define MARKFi(i)    SETMARK(dyn->insts[ninst].markf[i])
 #define GETMARKFi(i) dyn->insts[ninst].markf[i]
 #define MARKF        MARKFi(0)
 #define GETMARKF     GETMARKFi(0)
 #define MARKF2       MARKFi(1)
 #define GETMARKF2    GETMARKFi(1)
 
-#define MARKSEG     dyn->insts[ninst].markseg = dyn->native_size
+#define MARKSEG     SETMARK(dyn->insts[ninst].markseg)
 #define GETMARKSEG  dyn->insts[ninst].markseg
-#define MARKLOCK    dyn->insts[ninst].marklock = dyn->native_size
+#define MARKLOCK    SETMARK(dyn->insts[ninst].marklock)
 #define GETMARKLOCK dyn->insts[ninst].marklock
 
 #define Bxx_gen(OP, M, reg1, reg2)   \
@@ -740,6 +752,12 @@
 #define BEQZ_MARK3(reg) BEQ_MARK3(reg, xZR)
 // Branch to MARK3 instruction unconditionnal (use j64)
 #define B_MARK3_nocond Bxx_gen(__, MARK3, 0, 0)
+// Branch to MARKF if reg1==0 (use j64)
+#define BEQZ_MARKF(reg) Bxx_gen(EQ, MARKF, reg, xZR)
+// Branch to MARKF if reg1!=0 (use j64)
+#define BNEZ_MARKF(reg) Bxx_gen(NE, MARKF, reg, xZR)
+// Branch to MARKF instruction unconditionnal (use j64)
+#define B_MARKF_nocond Bxx_gen(__, MARKF, 0, 0)
 // Branch to MARKLOCK if reg1!=reg2 (use j64)
 #define BNE_MARKLOCK(reg1, reg2) Bxx_gen(NE, MARKLOCK, reg1, reg2)
 // Branch to MARKLOCK if reg1!=0 (use j64)
@@ -1018,10 +1036,20 @@
 #define FTABLE64(A, V)
 #endif
 
-#define ARCH_INIT()
+// no specialized entry of the blocks (BOX64_DYNAREC_LINKSTATE) on this architecture
+#define LINKSTATE_ENTRY(A)
+#define LINKSTATE_FALLBACK(A)
 
+#define ARCH_INIT() dyn->vector_sew = VECTOR_SEWNA
 
-#if STEP < 2
+// the vector config is unknown when an instruction can be reached from a jump or a return
+#define VECTOR_NEWINST()                                                                         \
+    if (ninst && (dyn->insts[ninst].pred_sz != 1 || dyn->insts[ninst].pred[0] != ninst - 1       \
+                     || dyn->insts[ninst - 1].x64.has_callret))                                \
+    dyn->vector_sew = VECTOR_SEWNA
+
+
+#if STEP == 0
 #define GETIP(A) TABLE64(0, 0)
 #define GETIP_(A) TABLE64(0, 0)
 #else
@@ -1053,9 +1081,9 @@
 #endif
 #define CLEARIP() dyn->last_ip = 0
 
-#if STEP < 2
+#if STEP == 0
 #define PASS2IF(A, B) if (A)
-#elif STEP == 2
+#elif STEP < 3
 #define PASS2IF(A, B)                         \
     if (A) dyn->insts[ninst].pass2choice = B; \
     if (dyn->insts[ninst].pass2choice == B)
@@ -1105,7 +1133,9 @@ void* rv64_next(x64emu_t* emu, uintptr_t addr);
 #define dynarec64_F20F   STEPNAME(dynarec64_F20F)
 #define dynarec64_F30F   STEPNAME(dynarec64_F30F)
 
+#define dynarec64_0F_vector   STEPNAME(dynarec64_0F_vector)
 #define dynarec64_660F_vector STEPNAME(dynarec64_660F_vector)
+#define dynarec64_F30F_vector STEPNAME(dynarec64_F30F_vector)
 
 #define geted               STEPNAME(geted)
 #define geted32             STEPNAME(geted32)
@@ -1209,6 +1239,8 @@ void* rv64_next(x64emu_t* emu, uintptr_t addr);
 #define emit_shrd16c        STEPNAME(emit_shrd16c)
 
 #define emit_pf STEPNAME(emit_pf)
+#define emit_crc32c STEPNAME(emit_crc32c)
+#define emit_pcmpstr STEPNAME(emit_pcmpstr)
 
 #define x87_do_push           STEPNAME(x87_do_push)
 #define x87_do_push_empty     STEPNAME(x87_do_push_empty)
@@ -1368,6 +1400,9 @@ void emit_shrd16c(dynarec_rv64_t* dyn, int ninst, rex_t rex, int s1, int s2, uin
 void emit_shld16c(dynarec_rv64_t* dyn, int ninst, rex_t rex, int s1, int s2, uint32_t c, int s3, int s4, int s5);
 
 void emit_pf(dynarec_rv64_t* dyn, int ninst, int s1, int s3, int s4);
+void emit_crc32c(dynarec_rv64_t* dyn, int ninst, int gd, int ed, int size, int s1, int s2, int s3);
+
+void emit_pcmpstr(dynarec_rv64_t* dyn, int ninst, rex_t rex, int v0, int v1, uint8_t imm8, int expl, int s1, int s2, int s3, int s4);
 
 // x87 helper
 // cache of the local stack counter, to avoid upadte at every call
@@ -1517,7 +1552,9 @@ uintptr_t dynarec64_66F0(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
 uintptr_t dynarec64_F20F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 uintptr_t dynarec64_F30F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 
+uintptr_t dynarec64_0F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 uintptr_t dynarec64_660F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
+uintptr_t dynarec64_F30F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, rex_t rex, int* ok, int* need_epilog);
 
 #if STEP < 2
 #define PASS2(A)
@@ -1,24 +1,34 @@
 #define INIT
 #define FINI        \
     if(ninst)       \
-        addInst(dyn->instsize, &dyn->insts_size, dyn->insts[ninst].x64.size, dyn->insts[ninst].size/4); \
-    addInst(dyn->instsize, &dyn->insts_size, 0, 0);
+        if(!addInst(dyn->instsize, &dyn->insts_size, dyn->insts_cap, dyn->insts[ninst].x64.size, dyn->insts[ninst].size/4)) dyn->layout_diff = 1; \
+    if(!addInst(dyn->instsize, &dyn->insts_size, dyn->insts_cap, 0, 0)) dyn->layout_diff = 1;
 #define EMIT(A)     \
     do {                                                \
         if(box64_dynarec_dump) print_opcode(dyn, ninst, (uint32_t)A); \
-        *(uint32_t*)(dyn->block) = (uint32_t)(A);       \
+        if((uintptr_t)dyn->block<dyn->tablestart)       \
+            *(uint32_t*)(dyn->block) = (uint32_t)(A);   \
+        else                                            \
+            dyn->layout_diff = 1;                       \
         dyn->block += 4; dyn->native_size += 4;         \
         dyn->insts[ninst].size2 += 4;                   \
     }while(0)
 
+#define SETMARK(A)                                      \
+    do {                                                \
+        if((A)!=dyn->native_size) dyn->layout_diff = 1; \
+        A = dyn->native_size;                           \
+    }while(0)
+
 #define MESSAGE(A, ...)  if(box64_dynarec_dump) dynarec_log(LOG_NONE, __VA_ARGS__)
 #define NEW_INST        \
     if(box64_dynarec_dump) print_newinst(dyn, ninst);   \
     if(ninst) {                                         \
-        addInst(dyn->instsize, &dyn->insts_size, dyn->insts[ninst-1].x64.size, dyn->insts[ninst-1].size/4); \
+        if(!addInst(dyn->instsize, &dyn->insts_size, dyn->insts_cap, dyn->insts[ninst-1].x64.size, dyn->insts[ninst-1].size/4)) dyn->layout_diff = 1; \
         dyn->insts[ninst].ymm0_pass3 = dyn->ymm_zero;   \
-    }
-#define INST_EPILOG
+    }                                                   \
+    VECTOR_NEWINST()
+#define INST_EPILOG     if(dyn->insts[ninst].epilog!=dyn->native_size) dyn->layout_diff = 1
 #define INST_NAME(name) inst_name_pass3(dyn, ninst, name, rex)
 
 #define TABLE64(A, V)   {int val64offset = Table64(dyn, (V), 3); MESSAGE(LOG_DUMP, "  Table64: 0x%lx\n", (V)); AUIPC(A, SPLIT20(val64offset)); LD(A, A, SPLIT12(val64offset));}
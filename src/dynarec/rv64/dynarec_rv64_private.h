@@ -139,6 +139,7 @@ typedef struct dynarec_rv64_s {
     dynablock_t*        dynablock;
     instsize_t*         instsize;
     size_t              insts_size; // size of the instruction size array (calculated)
+    size_t              insts_cap;  // size allocated for the instruction size array in pass3
     uint8_t             smread;    // for strongmem model emulation
     uint8_t             smwrite;    // for strongmem model emulation
     uintptr_t           forward;    // address of the last end of code while testing forward
@@ -146,7 +147,10 @@ typedef struct dynarec_rv64_s {
     int32_t             forward_size;   // size at the forward point
     int                 forward_ninst;  // ninst at the forward point
     uint16_t            ymm_zero;   // bitmap of ymm to zero at purge
+    uint8_t             vector_sew; // current element width set by vsetvl (VECTOR_SEWNA if unknown)
     uint8_t             always_test;
+    uint8_t             fastpass;   // pass3 is emitted with the layout computed in pass1
+    uint8_t             layout_diff;// pass3 layout doesn't match the computed one
     uint8_t             abort;
 } dynarec_rv64_t;
 
@@ -1166,6 +1166,15 @@ const char* rv64_print(uint32_t data, uintptr_t addr)
             break;
             case 0x5: {
                 switch (funct3) {
+                case 0x1:
+                    insn.name = "clmul";
+                    break;
+                case 0x2:
+                    insn.name = "clmulr";
+                    break;
+                case 0x3:
+                    insn.name = "clmulh";
+                    break;
                 case 0x4:
                     insn.name = "min";
                     break;
@@ -0,0 +1,139 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+
+#include "custommem.h"
+#include "elfloader.h"
+#include "debug.h"
+#include "elfloader_private.h"
+
+// Images of elfs, with the PT_LOAD segments at their place in memory (so the file is just the elf memory
+// image with bss and holes zero'd). Such a file can be mmaped as a whole with any host page size, and
+// because it's a regular file, the pages are shared between all the processes using it. The mapping is
+// private, so the relocated pages are copied on write, only in the process that writes them.
+
+#define CACHE_COPY_SIZE (64*1024)
+
+// return 1 if some PT_LOAD of the elf cannot be mmaped directly from the elf file
+int ElfImageCacheNeeded(elfheader_t* head)
+{
+    for (size_t i=0; i<head->numPHEntries; ++i) {
+        Elf64_Phdr * e = &head->PHEntries[i];
+        if(e->p_type == PT_LOAD && e->p_flags) {
+            if(e->p_offset&(box64_pagesize-1))
+                return 1;
+            if(e->p_align<box64_pagesize)
+                return 1;
+            if(!e->p_filesz || ALIGN(e->p_memsz)!=ALIGN(e->p_filesz))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+static int GetCacheFolder(char* folder, size_t sz)
+{
+    const char* p = getenv("XDG_CACHE_HOME");
+    if(p && *p) {
+        snprintf(folder, sz, "%s", p);
+    } else {
+        p = getenv("HOME");
+        if(!p || !*p)
+            return 1;
+        snprintf(folder, sz, "%s/.cache", p);
+        mkdir(folder, 0755);
+    }
+    strncat(folder, "/box64", sz-strlen(folder)-1);
+    if(mkdir(folder, 0755) && errno!=EEXIST)
+        return 1;
+    return 0;
+}
+
+static uint64_t HashElfFile(elfheader_t* head, struct stat* st)
+{
+    // FNV-1a of the identity of the elf file, so any change of the file gives a new image
+    uint64_t h = 0xcbf29ce484222325ULL;
+    uint64_t v[] = { st->st_dev, st->st_ino, st->st_size, st->st_mtim.tv_sec, st->st_mtim.tv_nsec, box64_pagesize };
+    const uint8_t* p = (const uint8_t*)v;
+    for(size_t i=0; i<sizeof(v); ++i)
+        h = (h^p[i])*0x100000001b3ULL;
+    for(const char* s = head->path; s && *s; ++s)
+        h = (h^(uint8_t)*s)*0x100000001b3ULL;
+    return h;
+}
+
+static int CreateImageCache(elfheader_t* head, const char* name)
+{
+    char tmp[PATH_MAX];
+    snprintf(tmp, sizeof(tmp), "%s.XXXXXX", name);
+    int fd = mkstemp(tmp);
+    if(fd<0)
+        return 1;
+    int ret = 0;
+    if(ftruncate(fd, ALIGN(head->memsz)))
+        ret = 1;
+    char* buff = (char*)box_malloc(CACHE_COPY_SIZE);
+    for (size_t i=0; i<head->numPHEntries && !ret; ++i) {
+        Elf64_Phdr * e = &head->PHEntries[i];
+        if(e->p_type != PT_LOAD || !e->p_flags)
+            continue;
+        size_t done = 0;
+        while(done<e->p_filesz && !ret) {
+            size_t sz = e->p_filesz-done;
+            if(sz>CACHE_COPY_SIZE) sz = CACHE_COPY_SIZE;
+            if(pread(head->fileno, buff, sz, e->p_offset+done)!=(ssize_t)sz)
+                ret = 1;
+            else if(pwrite(fd, buff, sz, e->p_paddr-head->vaddr+done)!=(ssize_t)sz)
+                ret = 1;
+            done += sz;
+        }
+    }
+    box_free(buff);
+    close(fd);
+    // rename is atomic, so other processes will either see a complete image or no image
+    if(ret || rename(tmp, name)) {
+        unlink(tmp);
+        return 1;
+    }
+    return 0;
+}
+
+// return a read-only fd on the image of the elf, creating it if needed, or -1
+int OpenElfImageCache(elfheader_t* head)
+{
+    struct stat st;
+    if(head->fileno<0 || fstat(head->fileno, &st))
+        return -1;
+    char name[PATH_MAX];
+    if(GetCacheFolder(name, sizeof(name)))
+        return -1;
+    const char* base = strrchr(head->path, '/');
+    base = base?(base+1):head->path;
+    size_t l = strlen(name);
+    snprintf(name+l, sizeof(name)-l, "/%s-%016lx.img", base, (unsigned long)HashElfFile(head, &st));
+    int fd = open(name, O_RDONLY|O_CLOEXEC);
+    if(fd<0) {
+        printf_log(LOG_DEBUG, "Creating image cache \"%s\" for elf \"%s\"\n", name, head->name);
+        if(CreateImageCache(head, name))
+            printf_log(LOG_INFO, "Warning, cannot create image cache \"%s\" for elf \"%s\"\n", name, head->name);
+        fd = open(name, O_RDONLY|O_CLOEXEC);
+    }
+    if(fd>=0) {
+        if(fstat(fd, &st) || (size_t)st.st_size!=ALIGN(head->memsz)) {
+            printf_log(LOG_INFO, "Warning, image cache \"%s\" for elf \"%s\" has the wrong size, ignoring\n", name, head->name);
+            close(fd);
+            return -1;
+        }
+        printf_log(LOG_DEBUG, "Using image cache \"%s\" for elf \"%s\"\n", name, head->name);
+    }
+    return fd;
+}
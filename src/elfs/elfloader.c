@@ -10,6 +10,7 @@
 #include <link.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sched.h>
 #ifndef _DLFCN_H
 #include <dlfcn.h>
 #endif
@@ -40,6 +41,7 @@
 #include "../emu/x64run_private.h"
 #include "../tools/bridge_private.h"
 #include "x64tls.h"
+#include "startprof.h"
 
 void* my__IO_2_1_stderr_ = NULL;
 void* my__IO_2_1_stdin_  = NULL;
@@ -72,6 +74,8 @@ elfheader_t* LoadAndCheckElfHeader(FILE* f, const char* name, int exec)
     return h;
 }
 
+static void FreeElfSymIndex(elfheader_t* h);
+
 void FreeElfHeader(elfheader_t** head)
 {
     if(!head || !*head)
@@ -88,6 +92,7 @@ void FreeElfHeader(elfheader_t** head)
     box_free(h->DynStr);
     box_free(h->SymTab);
     box_free(h->DynSym);
+    FreeElfSymIndex(h);
 
     FreeElfMemory(h);
 
@@ -226,6 +231,22 @@ int AllocLoadElfMemory(box64context_t* context, elfheader_t* head, int mainbin)
 
     head->multiblocks = (multiblock_t*)box_calloc(head->multiblock_n, sizeof(multiblock_t));
     head->tlsbase = AddTLSPartition(context, head->tlssize);
+    // use a shareable image of the elf when the segments cannot be mmaped from the elf itself
+    int cached = 0;
+    if(box64_elfcache && (box64_elfcache==2 || ElfImageCacheNeeded(head))) {
+        int fd = OpenElfImageCache(head);
+        if(fd>=0) {
+            void* p = mmap64(image, ALIGN(head->memsz), 0, MAP_PRIVATE|MAP_FIXED, fd, 0);
+            close(fd);
+            if(p==image) {
+                printf_dump(log_level, "Mmaping image cache of 0x%zx bytes @%p for Elf \"%s\"\n", ALIGN(head->memsz), image, head->name);
+                cached = 1;
+            } else {
+                // put back the reservation
+                mmap64(image, ALIGN(head->memsz), 0, MAP_ANONYMOUS|MAP_PRIVATE|MAP_NORESERVE|MAP_FIXED, -1, 0);
+            }
+        }
+    }
     // and now, create all individual blocks
     head->memory = (char*)0xffffffffffffffff;
     int n = 0;
@@ -254,7 +275,22 @@ int AllocLoadElfMemory(box64context_t* context, elfheader_t* head, int mainbin)
                 try_mmap = 0;
             if(e->p_align<box64_pagesize)
                 try_mmap = 0;
-            if(try_mmap) {
+            if(cached) {
+                // already mapped, only the protection needs to be set. The 1st host page can be shared with the previous segment
+                uintptr_t paddr = head->multiblocks[n].paddr&~balign;
+                size_t asize = head->multiblocks[n].asize;
+                uintptr_t start = paddr&~(box64_pagesize-1);
+                uintptr_t end = ALIGN(paddr+asize);
+                if(end>(uintptr_t)image+ALIGN(head->memsz))
+                    end = (uintptr_t)image+ALIGN(head->memsz);
+                uint8_t hprot = prot;
+                if(start!=paddr)
+                    hprot |= getProtection(start)&(PROT_READ|PROT_WRITE|PROT_EXEC);
+                mprotect((void*)start, end-start, hprot);
+                setProtection_elf(paddr, asize, prot);
+                head->multiblocks[n].p = (void*)paddr;
+            }
+            if(try_mmap && !cached) {
                 printf_dump(log_level, "Mmaping 0x%lx(0x%lx) bytes @%p for Elf \"%s\"\n", head->multiblocks[n].size, head->multiblocks[n].asize, (void*)head->multiblocks[n].paddr, head->name);
                 void* p = mmap64(
                     (void*)head->multiblocks[n].paddr, 
@@ -275,7 +311,7 @@ int AllocLoadElfMemory(box64context_t* context, elfheader_t* head, int mainbin)
 
                 }
             }
-            if(!try_mmap) {
+            if(!try_mmap && !cached) {
                 uintptr_t paddr = head->multiblocks[n].paddr&~balign;
                 size_t asize = head->multiblocks[n].asize+(head->multiblocks[n].paddr-paddr);
                 void* p = MAP_FAILED;
@@ -372,6 +408,8 @@ int AllocLoadElfMemory(box64context_t* context, elfheader_t* head, int mainbin)
     head->file = NULL;
     head->fileno = -1;
 
+    RefreshElfRanges(context);
+
     return 0;
 }
 
@@ -1132,6 +1170,7 @@ void RunElfInit(elfheader_t* h, x64emu_t *emu)
             if(lib_elf)
                 RunElfInit(lib_elf, emu);
         }
+    int sp = StartProfBegin("init", ElfName(h));
     printf_dump(LOG_DEBUG, "Calling Init for %s @%p\n", ElfName(h), (void*)p);
     if(h->initentry)
         RunFunctionWithEmu(emu, 0, p, 3, my_context->argc, my_context->argv, my_context->envv);
@@ -1145,6 +1184,7 @@ void RunElfInit(elfheader_t* h, x64emu_t *emu)
         }
     }
 
+    StartProfEnd(sp);
     if(h->malloc_hook_2)
         startMallocHook();
 
@@ -1236,8 +1276,102 @@ int IsAddressInElfSpace(const elfheader_t* h, uintptr_t addr)
     }
     return 0;
 }
+typedef struct elfrange_s {
+    uintptr_t       start;
+    uintptr_t       end;    // exclusive
+    elfheader_t*    h;
+} elfrange_t;
+
+typedef struct elfranges_s {
+    int             size;
+    int             cap;
+    elfranges_t*    old;    // previous (too small) arrays, readers may still be using them
+    elfrange_t      r[];
+} elfranges_t;
+
+// rebuild the sorted ranges of all elfs. The array is updated in place when it's big enough, so readers
+// have to check elfranges_gen didn't change while they were using it. Old arrays are only freed at exit
+void RefreshElfRanges(box64context_t *context)
+{
+    uint32_t gen;
+    while(1) {
+        gen = __atomic_load_n(&context->elfranges_gen, __ATOMIC_RELAXED);
+        if(!(gen&1) && __atomic_compare_exchange_n(&context->elfranges_gen, &gen, gen+1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+        sched_yield();
+    }
+    int n = 0;
+    for(int i=0; i<context->elfsize; ++i)
+        if(context->elfs[i] && context->elfs[i]->multiblocks)
+            n += context->elfs[i]->multiblock_n;
+    elfranges_t* ranges = context->elfranges;
+    if(!ranges || ranges->cap<n) {
+        int cap = ranges?ranges->cap:0;
+        while(cap<n) cap = cap?(cap*2):64;
+        elfranges_t* tmp = (elfranges_t*)box_calloc(1, sizeof(elfranges_t)+cap*sizeof(elfrange_t));
+        tmp->cap = cap;
+        tmp->old = ranges;
+        ranges = tmp;
+    }
+    ranges->size = 0;
+    for(int i=0; i<context->elfsize; ++i) {
+        elfheader_t* h = context->elfs[i];
+        if(!h || !h->multiblocks)
+            continue;
+        for(int j=0; j<h->multiblock_n; ++j) {
+            if(!h->multiblocks[j].p || !h->multiblocks[j].asize)
+                continue;
+            elfrange_t r = {(uintptr_t)h->multiblocks[j].p, (uintptr_t)h->multiblocks[j].p+h->multiblocks[j].asize, h};
+            // insertion sort, the array is mostly sorted already
+            int k = ranges->size++;
+            while(k && ranges->r[k-1].start>r.start) {
+                ranges->r[k] = ranges->r[k-1];
+                --k;
+            }
+            ranges->r[k] = r;
+        }
+    }
+    __atomic_store_n(&context->elfranges, ranges, __ATOMIC_RELEASE);
+    __atomic_store_n(&context->elfranges_gen, gen+2, __ATOMIC_RELEASE);
+}
+
+void FreeElfRanges(box64context_t *context)
+{
+    elfranges_t* ranges = context->elfranges;
+    context->elfranges = NULL;
+    while(ranges) {
+        elfranges_t* old = ranges->old;
+        box_free(ranges);
+        ranges = old;
+    }
+}
+
 elfheader_t* FindElfAddress(box64context_t *context, uintptr_t addr)
 {
+    // binary search in the sorted ranges, as long as no one is updating them
+    for(int retry=0; retry<4; ++retry) {
+        uint32_t gen = __atomic_load_n(&context->elfranges_gen, __ATOMIC_ACQUIRE);
+        elfranges_t* ranges = __atomic_load_n(&context->elfranges, __ATOMIC_ACQUIRE);
+        if((gen&1) || !ranges)
+            break;  // update in progress (maybe from this thread, in a signal handler)
+        int size = __atomic_load_n(&ranges->size, __ATOMIC_RELAXED);
+        if(size>ranges->cap)
+            size = ranges->cap;
+        elfheader_t* ret = NULL;
+        int lo = 0, hi = size;
+        while(lo<hi) {
+            int mid = lo+(hi-lo)/2;
+            if(ranges->r[mid].start<=addr)
+                lo = mid+1;
+            else
+                hi = mid;
+        }
+        if(lo && addr<ranges->r[lo-1].end)
+            ret = ranges->r[lo-1].h;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&context->elfranges_gen, __ATOMIC_RELAXED)==gen)
+            return ret;
+    }
     for (int i=0; i<context->elfsize; ++i)
         if(IsAddressInElfSpace(context->elfs[i], addr))
             return context->elfs[i];
@@ -1245,11 +1379,84 @@ elfheader_t* FindElfAddress(box64context_t *context, uintptr_t addr)
     return NULL;
 }
 
+typedef struct elfsymaddr_s {
+    uintptr_t   offs;
+    size_t      idx;    // index in SymTab, or in DynSym (minus numSymTab)
+} elfsymaddr_t;
+
+typedef struct elfsymindex_s {
+    size_t          size;   // size of the mapping
+    size_t          n;
+    elfsymaddr_t    s[];
+} elfsymindex_t;
+
+static int elfsymaddr_less(const elfsymaddr_t* a, const elfsymaddr_t* b)
+{
+    return (a->offs<b->offs) || (a->offs==b->offs && a->idx<b->idx);
+}
+
+static void elfsymaddr_siftdown(elfsymaddr_t* s, size_t i, size_t n)
+{
+    while(2*i+1<n) {
+        size_t c = 2*i+1;
+        if(c+1<n && elfsymaddr_less(&s[c], &s[c+1]))
+            ++c;
+        if(!elfsymaddr_less(&s[i], &s[c]))
+            return;
+        elfsymaddr_t tmp = s[i]; s[i] = s[c]; s[c] = tmp;
+        i = c;
+    }
+}
+
+// index of all the symbols sorted by address. Can be built from a signal handler, so no malloc and no qsort here,
+// and internal_mmap, as the mmap wrapper takes mutex_prot (that might be held by the interrupted code)
+static elfsymindex_t* GetElfSymIndex(elfheader_t* h)
+{
+    elfsymindex_t* index = __atomic_load_n(&h->symindex, __ATOMIC_ACQUIRE);
+    if(index)
+        return index;
+    size_t n = h->numSymTab + h->numDynSym;
+    size_t size = (sizeof(elfsymindex_t)+n*sizeof(elfsymaddr_t)+box64_pagesize-1)&~(box64_pagesize-1);
+    index = (elfsymindex_t*)internal_mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(index==MAP_FAILED)
+        return NULL;
+    index->size = size;
+    index->n = n;
+    for(size_t i=0; i<h->numSymTab; ++i) {
+        index->s[i].offs = h->SymTab[i].st_value + h->delta;
+        index->s[i].idx = i;
+    }
+    for(size_t i=0; i<h->numDynSym; ++i) {
+        index->s[h->numSymTab+i].offs = h->DynSym[i].st_value + h->delta;
+        index->s[h->numSymTab+i].idx = h->numSymTab+i;
+    }
+    // heap sort
+    for(size_t i=n/2; i-->0;)
+        elfsymaddr_siftdown(index->s, i, n);
+    for(size_t i=n; i-->1;) {
+        elfsymaddr_t tmp = index->s[0]; index->s[0] = index->s[i]; index->s[i] = tmp;
+        elfsymaddr_siftdown(index->s, 0, i);
+    }
+    elfsymindex_t* expected = NULL;
+    if(!__atomic_compare_exchange_n(&h->symindex, &expected, index, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // another thread was faster
+        internal_munmap(index, size);
+        index = expected;
+    }
+    return index;
+}
+
+static void FreeElfSymIndex(elfheader_t* h)
+{
+    if(h->symindex)
+        internal_munmap(h->symindex, h->symindex->size);
+    h->symindex = NULL;
+}
+
 const char* FindNearestSymbolName(elfheader_t* h, void* p, uintptr_t* start, uint64_t* sz)
 {
     uintptr_t addr = (uintptr_t)p;
 
-    uint32_t distance = 0x7fffffff;
     const char* ret = NULL;
     uintptr_t s = 0;
     uint64_t size = 0;
@@ -1273,29 +1480,60 @@ const char* FindNearestSymbolName(elfheader_t* h, void* p, uintptr_t* start, uin
     if(!h || h->fini_done)
         return ret;
 
-    for (size_t i=0; i<h->numSymTab && distance!=0; ++i) {
-        const char * symname = h->StrTab+h->SymTab[i].st_name;
-        uintptr_t offs = h->SymTab[i].st_value + h->delta;
-
-        if(offs<=addr) {
-            if(distance>addr-offs) {
-                distance = addr-offs;
-                ret = symname;
-                s = offs;
-                size = h->SymTab[i].st_size;
+    elfsymindex_t* index = GetElfSymIndex(h);
+    if(index) {
+        // last symbol at or before addr, the first one in SymTab/DynSym order if there are many at that address
+        size_t lo = 0, hi = index->n;
+        while(lo<hi) {
+            size_t mid = lo+(hi-lo)/2;
+            if(index->s[mid].offs<=addr)
+                lo = mid+1;
+            else
+                hi = mid;
+        }
+        if(lo) {
+            size_t i = lo-1;
+            while(i && index->s[i-1].offs==index->s[i].offs)
+                --i;
+            if(addr-index->s[i].offs<0x7fffffff) {
+                size_t idx = index->s[i].idx;
+                s = index->s[i].offs;
+                if(idx<h->numSymTab) {
+                    ret = h->StrTab+h->SymTab[idx].st_name;
+                    size = h->SymTab[idx].st_size;
+                } else {
+                    idx -= h->numSymTab;
+                    ret = h->DynStr+h->DynSym[idx].st_name;
+                    size = h->DynSym[idx].st_size;
+                }
             }
         }
-    }
-    for (size_t i=0; i<h->numDynSym && distance!=0; ++i) {
-        const char * symname = h->DynStr+h->DynSym[i].st_name;
-        uintptr_t offs = h->DynSym[i].st_value + h->delta;
-
-        if(offs<=addr) {
-            if(distance>addr-offs) {
-                distance = addr-offs;
-                ret = symname;
-                s = offs;
-                size = h->DynSym[i].st_size;
+    } else {
+        uint32_t distance = 0x7fffffff;
+        for (size_t i=0; i<h->numSymTab && distance!=0; ++i) {
+            const char * symname = h->StrTab+h->SymTab[i].st_name;
+            uintptr_t offs = h->SymTab[i].st_value + h->delta;
+
+            if(offs<=addr) {
+                if(distance>addr-offs) {
+                    distance = addr-offs;
+                    ret = symname;
+                    s = offs;
+                    size = h->SymTab[i].st_size;
+                }
+            }
+        }
+        for (size_t i=0; i<h->numDynSym && distance!=0; ++i) {
+            const char * symname = h->DynStr+h->DynSym[i].st_name;
+            uintptr_t offs = h->DynSym[i].st_value + h->delta;
+
+            if(offs<=addr) {
+                if(distance>addr-offs) {
+                    distance = addr-offs;
+                    ret = symname;
+                    s = offs;
+                    size = h->DynSym[i].st_size;
+                }
             }
         }
     }
@@ -4,6 +4,7 @@
 typedef struct library_s library_t;
 typedef struct needed_libs_s needed_libs_t;
 typedef struct cleanup_s cleanup_t;
+typedef struct elfsymindex_s elfsymindex_t;
 
 #include <elf.h>
 #include "elfloader.h"
@@ -111,6 +112,8 @@ typedef struct elfheader_s {
     multiblock_t*  multiblocks;
     int         multiblock_n;
 
+    elfsymindex_t* symindex;    // SymTab/DynSym sorted by address, built on 1st FindNearestSymbolName
+
     library_t   *lib;       // attached lib (exept on main elf)
     needed_libs_t* needed;
 
@@ -178,6 +181,9 @@ typedef struct elfheader_s {
 
 elfheader_t* ParseElfHeader(FILE* f, const char* name, int exec);
 
+int ElfImageCacheNeeded(elfheader_t* head);
+int OpenElfImageCache(elfheader_t* head);
+
 const char* BindSym(int bind);
 
 Elf64_Half GetSymbolVersionFlag(elfheader_t* h, int index);
@@ -81,6 +81,9 @@ typedef struct x64emu_s {
     uint64_t    fpu_tags;   // tags for the x87 regs, stacked, only on a 16bits anyway
     // old ip
     uintptr_t   old_ip;
+    #ifdef DYNAREC
+    uintptr_t   held_stripe[2]; // address of the lock_stripes entries taken by a split LOCK'd access, released if a signal cancels it
+    #endif
     // deferred flags
     int         dummy1;     // to align on 64bits with df
     deferred_flags_t df;
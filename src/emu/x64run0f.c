@@ -23,6 +23,7 @@
 #include "bridge.h"
 #include "signals.h"
 #include "x64shaext.h"
+#include "x64ssevec.h"
 #ifdef DYNAREC
 #include "custommem.h"
 #include "../dynarec/native_lock.h"
@@ -728,8 +729,7 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->ud[i] &= EX->ud[i];
+            SSE_OP(GX, GX, EX, ud, &);
             break;
         case 0x55:                      /* ANDNPS Gx, Ex */
             nextop = F8;
@@ -742,29 +742,25 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->ud[i] |= EX->ud[i];
+            SSE_OP(GX, GX, EX, ud, |);
             break;
         case 0x57:                      /* XORPS Gx, Ex */
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->ud[i] ^= EX->ud[i];
+            SSE_OP(GX, GX, EX, ud, ^);
             break;
         case 0x58:                      /* ADDPS Gx, Ex */
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->f[i] += EX->f[i];
+            SSE_OP(GX, GX, EX, f, +);
             break;
         case 0x59:                      /* MULPS Gx, Ex */
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->f[i] *= EX->f[i];
+            SSE_OP(GX, GX, EX, f, *);
             break;
         case 0x5A:                      /* CVTPS2PD Gx, Ex */
             nextop = F8;
@@ -786,8 +782,7 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->f[i] -= EX->f[i];
+            SSE_OP(GX, GX, EX, f, -);
             break;
         case 0x5D:                      /* MINPS Gx, Ex */
             nextop = F8;
@@ -802,8 +797,7 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i)
-                GX->f[i] /= EX->f[i];
+            SSE_OP(GX, GX, EX, f, /);
             break;
         case 0x5F:                      /* MAXPS Gx, Ex */
             nextop = F8;
@@ -23,6 +23,7 @@
 
 #include "modrm.h"
 #include "x64compstrings.h"
+#include "x64ssevec.h"
 
 static uint8_t ff_mult(uint8_t a, uint8_t b)
 {
@@ -1273,8 +1274,7 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[0] &= EX->q[0];
-        GX->q[1] &= EX->q[1];
+        SSE_OP(GX, GX, EX, q, &);
         break;
     case 0x55:                      /* ANDNPD Gx, Ex */
         nextop = F8;
@@ -1287,15 +1287,13 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[0] |= EX->q[0];
-        GX->q[1] |= EX->q[1];
+        SSE_OP(GX, GX, EX, q, |);
         break;
     case 0x57:                      /* XORPD Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[0] ^= EX->q[0];
-        GX->q[1] ^= EX->q[1];
+        SSE_OP(GX, GX, EX, q, ^);
         break;
     case 0x58:                      /* ADDPD Gx, Ex */
         nextop = F8;
@@ -1458,22 +1456,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i)
-            GX->ub[i] = (GX->sb[i]>EX->sb[i])?0xFF:0x00;
+        SSE_CMP(GX, GX, EX, sb, >);
         break;
     case 0x65:  /* PCMPGTW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->uw[i] = (GX->sw[i]>EX->sw[i])?0xFFFF:0x0000;
+        SSE_CMP(GX, GX, EX, sw, >);
         break;
     case 0x66:  /* PCMPGTD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<4; ++i)
-            GX->ud[i] = (GX->sd[i]>EX->sd[i])?0xFFFFFFFF:0x00000000;
+        SSE_CMP(GX, GX, EX, sd, >);
         break;
     case 0x67:  /* PACKUSWB Gx,Ex */
         nextop = F8;
@@ -1568,9 +1563,7 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         GETEX(1);
         GETGX;
         tmp8u = F8;
-        if(EX==GX) {eax1 = *GX; EX = &eax1;}   // copy is needed
-        for (int i=0; i<4; ++i)
-            GX->ud[i] = EX->ud[(tmp8u>>(i*2))&3];
+        sse_pshufd(GX, EX, tmp8u);
         break;
     case 0x71:  /* GRP */
         nextop = F8;
@@ -1682,22 +1675,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            GX->ub[i] = (GX->ub[i]==EX->ub[i])?0xff:0;
+        SSE_CMP(GX, GX, EX, ub, ==);
         break;
     case 0x75:  /* PCMPEQW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<8; ++i)
-            GX->uw[i] = (GX->uw[i]==EX->uw[i])?0xffff:0;
+        SSE_CMP(GX, GX, EX, uw, ==);
         break;
     case 0x76:  /* PCMPEQD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<4; ++i)
-            GX->ud[i] = (GX->ud[i]==EX->ud[i])?0xffffffff:0;
+        SSE_CMP(GX, GX, EX, ud, ==);
         break;
 
     case 0x7C:  /* HADDPD Gx, Ex */
@@ -2241,17 +2231,13 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sq[0] += EX->sq[0];
-        GX->sq[1] += EX->sq[1];
+        SSE_OP(GX, GX, EX, q, +);
         break;
     case 0xD5:  /* PMULLW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->sw[i] * EX->sw[i];
-            GX->sw[i] = tmp32s&0xffff;
-        }
+        SSE_OP(GX, GX, EX, uw, *);
         break;
     case 0xD6:                      /* MOVQ Ex,Gx */
         nextop = F8;
@@ -2277,58 +2263,43 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i) {
-            tmp16s = (int16_t)GX->ub[i] - EX->ub[i];
-            GX->ub[i] = (tmp16s<0)?0:tmp16s;
-        }
+        SSE_SUBUS(GX, GX, EX, ub);
         break;
     case 0xD9:  /* PSUBUSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->uw[i] - EX->uw[i];
-            GX->uw[i] = (tmp32s<0)?0:tmp32s;
-        }
+        SSE_SUBUS(GX, GX, EX, uw);
         break;
     case 0xDA:  /* PMINUB Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            if(EX->ub[i]<GX->ub[i]) GX->ub[i] = EX->ub[i];
+        SSE_MIN(GX, GX, EX, ub);
         break;
     case 0xDB:  /* PAND Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[0] &= EX->q[0];
-        GX->q[1] &= EX->q[1];
+        SSE_OP(GX, GX, EX, q, &);
         break;
     case 0xDC:  /* PADDUSB Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i) {
-            tmp16s = (int16_t)GX->ub[i] + EX->ub[i];
-            GX->ub[i] = (tmp16s>255)?255:tmp16s;
-        }
+        SSE_ADDUS(GX, GX, EX, ub);
         break;
     case 0xDD:  /* PADDUSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->uw[i] + EX->uw[i];
-            GX->uw[i] = (tmp32s>65535)?65535:tmp32s;
-        }
+        SSE_ADDUS(GX, GX, EX, uw);
         break;
     case 0xDE:  /* PMAXUB Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            if(EX->ub[i]>GX->ub[i]) GX->ub[i] = EX->ub[i];
+        SSE_MAX(GX, GX, EX, ub);
         break;
     case 0xDF:  /* PANDN Gx,Ex */
         nextop = F8;
@@ -2428,15 +2399,13 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<8; ++i)
-            GX->sw[i] = (GX->sw[i]<EX->sw[i])?GX->sw[i]:EX->sw[i];
+        SSE_MIN(GX, GX, EX, sw);
         break;
     case 0xEB:  /* POR Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[0] |= EX->q[0];
-        GX->q[1] |= EX->q[1];
+        SSE_OP(GX, GX, EX, q, |);
         break;
     case 0xEC:  /* PADDSB Gx,Ex */
         nextop = F8;
@@ -2460,15 +2429,13 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->sw[i] = (GX->sw[i]>EX->sw[i])?GX->sw[i]:EX->sw[i];
+        SSE_MAX(GX, GX, EX, sw);
         break;
     case 0xEF:                      /* PXOR Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[0] ^= EX->q[0];
-        GX->q[1] ^= EX->q[1];
+        SSE_OP(GX, GX, EX, q, ^);
         break;
 
     case 0xF1:  /* PSLLW Gx, Ex */
@@ -2539,54 +2506,43 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i)
-            GX->sb[i] -= EX->sb[i];
+        SSE_OP(GX, GX, EX, ub, -);
         break;
     case 0xF9:  /* PSUBW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->sw[i] -= EX->sw[i];
+        SSE_OP(GX, GX, EX, uw, -);
         break;
     case 0xFA:  /* PSUBD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sd[0] -= EX->sd[0];
-        GX->sd[1] -= EX->sd[1];
-        GX->sd[2] -= EX->sd[2];
-        GX->sd[3] -= EX->sd[3];
+        SSE_OP(GX, GX, EX, ud, -);
         break;
     case 0xFB:  /* PSUBQ Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sq[0] -= EX->sq[0];
-        GX->sq[1] -= EX->sq[1];
+        SSE_OP(GX, GX, EX, q, -);
         break;
     case 0xFC:  /* PADDB Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i)
-            GX->sb[i] += EX->sb[i];
+        SSE_OP(GX, GX, EX, ub, +);
         break;
     case 0xFD:  /* PADDW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->sw[i] += EX->sw[i];
+        SSE_OP(GX, GX, EX, uw, +);
         break;
     case 0xFE:  /* PADDD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sd[0] += EX->sd[0];
-        GX->sd[1] += EX->sd[1];
-        GX->sd[2] += EX->sd[2];
-        GX->sd[3] += EX->sd[3];
+        SSE_OP(GX, GX, EX, ud, +);
         break;
 
     default:
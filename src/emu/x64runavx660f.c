@@ -23,6 +23,7 @@
 #include "bridge.h"
 #include "signals.h"
 #include "x64shaext.h"
+#include "x64ssevec.h"
 #ifdef DYNAREC
 #include "custommem.h"
 #include "../dynarec/native_lock.h"
@@ -620,13 +621,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i)
-                GX->ub[i] = (VX->sb[i]>EX->sb[i])?0xFF:0x00;
+            SSE_CMP(GX, VX, EX, sb, >);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i)
-                    GY->ub[i] = (VY->sb[i]>EY->sb[i])?0xFF:0x00;
+                SSE_CMP(GY, VY, EY, sb, >);
             } else
                 GY->u128 = 0;
             break;
@@ -636,13 +635,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->uw[i] = (VX->sw[i]>EX->sw[i])?0xFFFF:0x0000;
+            SSE_CMP(GX, VX, EX, sw, >);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->uw[i] = (VY->sw[i]>EY->sw[i])?0xFFFF:0x0000;
+                SSE_CMP(GY, VY, EY, sw, >);
             } else
                 GY->u128 = 0;
             break;
@@ -652,13 +649,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i)
-                GX->ud[i] = (VX->sd[i]>EX->sd[i])?0xFFFFFFFF:0x00000000;
+            SSE_CMP(GX, VX, EX, sd, >);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i)
-                    GY->ud[i] = (VY->sd[i]>EY->sd[i])?0xFFFFFFFF:0x00000000;
+                SSE_CMP(GY, VY, EY, sd, >);
             } else
                 GY->u128 = 0;
             break;
@@ -1053,13 +1048,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = (VX->ub[i]==EX->ub[i])?0xff:0;
+            SSE_CMP(GX, VX, EX, ub, ==);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = (VY->ub[i]==EY->ub[i])?0xff:0;
+                SSE_CMP(GY, VY, EY, ub, ==);
             } else
                 GY->u128 = 0;
             break;
@@ -1069,13 +1062,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<8; ++i)
-                GX->uw[i] = (VX->uw[i]==EX->uw[i])?0xffff:0;
+            SSE_CMP(GX, VX, EX, uw, ==);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<8; ++i)
-                    GY->uw[i] = (VY->uw[i]==EY->uw[i])?0xffff:0;
+                SSE_CMP(GY, VY, EY, uw, ==);
             } else
                 GY->u128 = 0;
             break;
@@ -1085,13 +1076,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<4; ++i)
-                GX->ud[i] = (VX->ud[i]==EX->ud[i])?0xffffffff:0;
+            SSE_CMP(GX, VX, EX, ud, ==);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<4; ++i)
-                    GY->ud[i] = (VY->ud[i]==EY->ud[i])?0xffffffff:0;
+                SSE_CMP(GY, VY, EY, ud, ==);
             } else
                 GY->u128 = 0;
             break;
@@ -1414,13 +1403,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<2; ++i)
-                GX->sq[i] = VX->sq[i] + EX->sq[i];
+            SSE_OP(GX, VX, EX, q, +);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<2; ++i)
-                    GY->sq[i] = VY->sq[i] + EY->sq[i];
+                SSE_OP(GY, VY, EY, q, +);
             } else
                 GY->u128 = 0;
             break;
@@ -1516,12 +1503,10 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = (EX->ub[i]<VX->ub[i])?EX->ub[i]:VX->ub[i];
+            SSE_MIN(GX, VX, EX, ub);
             if(vex.l) {
                 GETEY; GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = (EY->ub[i]<VY->ub[i])?EY->ub[i]:VY->ub[i];
+                SSE_MIN(GY, VY, EY, ub);
             } else
                 GY->u128 = 0;
             break;
@@ -1530,14 +1515,12 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETEX(0);
             GETGX;
             GETVX;
-            GX->q[0] = VX->q[0] & EX->q[0];
-            GX->q[1] = VX->q[1] & EX->q[1];
+            SSE_OP(GX, VX, EX, q, &);
             GETGY;
             if(vex.l) {
                 GETEY;
                 GETVY;
-                GY->q[0] = VY->q[0] & EY->q[0];
-                GY->q[1] = VY->q[1] & EY->q[1];
+                SSE_OP(GY, VY, EY, q, &);
             } else {
                 GY->u128 = 0;
             }
@@ -1588,12 +1571,10 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = (EX->ub[i]>VX->ub[i])?EX->ub[i]:VX->ub[i];
+            SSE_MAX(GX, VX, EX, ub);
             if(vex.l) {
                 GETEY; GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = (EY->ub[i]>VY->ub[i])?EY->ub[i]:VY->ub[i];
+                SSE_MAX(GY, VY, EY, ub);
             } else
                 GY->u128 = 0;
             break;
@@ -1809,14 +1790,12 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETEX(0);
             GETGX;
             GETVX;
-            GX->q[0] = VX->q[0] | EX->q[0];
-            GX->q[1] = VX->q[1] | EX->q[1];
+            SSE_OP(GX, VX, EX, q, |);
             GETGY;
             if(vex.l) {
                 GETEY;
                 GETVY;
-                GY->q[0] = VY->q[0] | EY->q[0];
-                GY->q[1] = VY->q[1] | EY->q[1];
+                SSE_OP(GY, VY, EY, q, |);
             } else {
                 GY->u128 = 0;
             }
@@ -1881,14 +1860,12 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETEX(0);
             GETGX;
             GETVX;
-            GX->q[0] = VX->q[0] ^ EX->q[0];
-            GX->q[1] = VX->q[1] ^ EX->q[1];
+            SSE_OP(GX, VX, EX, q, ^);
             GETGY;
             if(vex.l) {
                 GETEY;
                 GETVY;
-                GY->q[0] = VY->q[0] ^ EY->q[0];
-                GY->q[1] = VY->q[1] ^ EY->q[1];
+                SSE_OP(GY, VY, EY, q, ^);
             } else 
                 GY->u128 = 0;
             break;
@@ -2017,13 +1994,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i)
-                GX->sb[i] = VX->sb[i] - EX->sb[i];
+            SSE_OP(GX, VX, EX, ub, -);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i)
-                    GY->sb[i] = VY->sb[i] - EY->sb[i];
+                SSE_OP(GY, VY, EY, ub, -);
             } else
                 GY->u128 = 0;
             break;
@@ -2033,13 +2008,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->sw[i] = VX->sw[i] - EX->sw[i];
+            SSE_OP(GX, VX, EX, uw, -);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->sw[i] = VY->sw[i] - EY->sw[i];
+                SSE_OP(GY, VY, EY, uw, -);
             } else
                 GY->u128 = 0;
             break;
@@ -2049,13 +2022,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i)
-                GX->sd[i] = VX->sd[i] - EX->sd[i];
+            SSE_OP(GX, VX, EX, ud, -);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i)
-                    GY->sd[i] = VY->sd[i] - EY->sd[i];
+                SSE_OP(GY, VY, EY, ud, -);
             } else
                 GY->u128 = 0;
             break;
@@ -2065,13 +2036,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<2; ++i)
-                GX->sq[i] = VX->sq[i] - EX->sq[i];
+            SSE_OP(GX, VX, EX, q, -);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<2; ++i)
-                    GY->sq[i] = VY->sq[i] - EY->sq[i];
+                SSE_OP(GY, VY, EY, q, -);
             } else
                 GY->u128 = 0;
             break;
@@ -2081,13 +2050,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i)
-                GX->sb[i] = VX->sb[i] + EX->sb[i];
+            SSE_OP(GX, VX, EX, ub, +);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i)
-                    GY->sb[i] = VY->sb[i] + EY->sb[i];
+                SSE_OP(GY, VY, EY, ub, +);
             } else
                 GY->u128 = 0;
             break;
@@ -2097,13 +2064,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->sw[i] = VX->sw[i] + EX->sw[i];
+            SSE_OP(GX, VX, EX, uw, +);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->sw[i] = VY->sw[i] + EY->sw[i];
+                SSE_OP(GY, VY, EY, uw, +);
             } else
                 GY->u128 = 0;
             break;
@@ -2113,13 +2078,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i)
-                GX->sd[i] = VX->sd[i] + EX->sd[i];
+            SSE_OP(GX, VX, EX, ud, +);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i)
-                    GY->sd[i] = VY->sd[i] + EY->sd[i];
+                SSE_OP(GY, VY, EY, ud, +);
             } else
                 GY->u128 = 0;
             break;
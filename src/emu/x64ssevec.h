@@ -0,0 +1,124 @@
+#ifndef __X64_SSEVEC_H__
+#define __X64_SSEVEC_H__
+
+#include <stdint.h>
+
+#include "regs.h"
+
+// Lane-wise helpers for the SSE/AVX opcodes of the interpreter.
+// With the compiler vector extensions, a whole 128bits register is loaded, computed and stored at once
+// (NEON on ARM64, LSX on LoongArch, RVV when enabled, SSE on x86_64), instead of relying on the auto-vectorizer
+// that mostly gives up because GX and EX might alias. Build with NOVECEXT to get the plain loops back.
+// D, A and B are sse_regs_t*, L is the lane field (sb, ub, sw, uw, sd, ud, sq, q, f, d).
+// D can be A or B, and A can be B.
+
+#if !defined(NOVECEXT) && (defined(__GNUC__) || defined(__clang__))
+#define SSE_VECEXT
+#endif
+
+#define SSE_LANES(R, L) ((int)(sizeof((R)->L)/sizeof((R)->L[0])))
+// integer lanes of the same size, to write the masks of SSE_CMP
+#define SSE_MASK_sb sb
+#define SSE_MASK_ub ub
+#define SSE_MASK_sw sw
+#define SSE_MASK_uw uw
+#define SSE_MASK_sd sd
+#define SSE_MASK_ud ud
+#define SSE_MASK_sq sq
+#define SSE_MASK_q  q
+#define SSE_MASK_f  ud
+#define SSE_MASK_d  q
+#define SSE_MASK(L) SSE_MASK_##L
+
+#ifdef SSE_VECEXT
+typedef int8_t   sse_vsb_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint8_t  sse_vub_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef int16_t  sse_vsw_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint16_t sse_vuw_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef int32_t  sse_vsd_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint32_t sse_vud_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef int64_t  sse_vsq_t __attribute__((vector_size(16), aligned(1), may_alias));
+typedef uint64_t sse_vq_t  __attribute__((vector_size(16), aligned(1), may_alias));
+typedef float    sse_vf_t  __attribute__((vector_size(16), aligned(1), may_alias));
+typedef double   sse_vd_t  __attribute__((vector_size(16), aligned(1), may_alias));
+
+#define SSEV(R, L) (*(sse_v##L##_t*)((R)->L))
+
+// D.L = A.L OP B.L
+#define SSE_OP(D, A, B, L, OP)  SSEV(D, L) = SSEV(A, L) OP SSEV(B, L)
+// D.L = (A.L OP B.L)?all ones:0 (the vector compare already gives an integer mask, bitcasted back)
+#define SSE_CMP(D, A, B, L, OP) SSEV(D, L) = (sse_v##L##_t)(SSEV(A, L) OP SSEV(B, L))
+// D.L = min/max(A.L, B.L), for integer lanes
+#define SSE_MIN(D, A, B, L)                                         \
+    do {                                                            \
+        sse_v##L##_t a_ = SSEV(A, L), b_ = SSEV(B, L);              \
+        sse_v##L##_t m_ = (sse_v##L##_t)(b_ < a_);                  \
+        SSEV(D, L) = (b_ & m_) | (a_ & ~m_);                        \
+    } while(0)
+#define SSE_MAX(D, A, B, L)                                         \
+    do {                                                            \
+        sse_v##L##_t a_ = SSEV(A, L), b_ = SSEV(B, L);              \
+        sse_v##L##_t m_ = (sse_v##L##_t)(b_ > a_);                  \
+        SSEV(D, L) = (b_ & m_) | (a_ & ~m_);                        \
+    } while(0)
+// D.L = saturated A.L +/- B.L, for unsigned lanes
+#define SSE_ADDUS(D, A, B, L)                                       \
+    do {                                                            \
+        sse_v##L##_t a_ = SSEV(A, L), b_ = SSEV(B, L);              \
+        sse_v##L##_t r_ = a_ + b_;                                  \
+        SSEV(D, L) = r_ | (sse_v##L##_t)(r_ < a_);                  \
+    } while(0)
+#define SSE_SUBUS(D, A, B, L)                                       \
+    do {                                                            \
+        sse_v##L##_t a_ = SSEV(A, L), b_ = SSEV(B, L);              \
+        SSEV(D, L) = (a_ - b_) & (sse_v##L##_t)(a_ >= b_);          \
+    } while(0)
+#else
+// type used to compute a lane, so the integer promotion can't overflow (uw*uw would be int*int)
+#define SSE_CALC_sb int32_t
+#define SSE_CALC_ub uint32_t
+#define SSE_CALC_sw int32_t
+#define SSE_CALC_uw uint32_t
+#define SSE_CALC_sd int64_t
+#define SSE_CALC_ud uint32_t
+#define SSE_CALC_sq int64_t
+#define SSE_CALC_q  uint64_t
+#define SSE_CALC_f  float
+#define SSE_CALC_d  double
+#define SSE_CALC(L) SSE_CALC_##L
+#define SSE_OP(D, A, B, L, OP)                                      \
+    for(int i_=0; i_<SSE_LANES(D, L); ++i_)                         \
+        (D)->L[i_] = (SSE_CALC(L))(A)->L[i_] OP (SSE_CALC(L))(B)->L[i_]
+#define SSE_CMP(D, A, B, L, OP)                                     \
+    for(int i_=0; i_<SSE_LANES(D, L); ++i_)                         \
+        (D)->SSE_MASK(L)[i_] = ((A)->L[i_] OP (B)->L[i_])?-1:0
+#define SSE_MIN(D, A, B, L)                                         \
+    for(int i_=0; i_<SSE_LANES(D, L); ++i_)                         \
+        (D)->L[i_] = ((B)->L[i_]<(A)->L[i_])?(B)->L[i_]:(A)->L[i_]
+#define SSE_MAX(D, A, B, L)                                         \
+    for(int i_=0; i_<SSE_LANES(D, L); ++i_)                         \
+        (D)->L[i_] = ((B)->L[i_]>(A)->L[i_])?(B)->L[i_]:(A)->L[i_]
+#define SSE_ADDUS(D, A, B, L)                                       \
+    for(int i_=0; i_<SSE_LANES(D, L); ++i_) {                       \
+        __typeof__((D)->L[0]) r_ = (A)->L[i_] + (B)->L[i_];         \
+        (D)->L[i_] = (r_<(A)->L[i_])?-1:r_;                         \
+    }
+#define SSE_SUBUS(D, A, B, L)                                       \
+    for(int i_=0; i_<SSE_LANES(D, L); ++i_)                         \
+        (D)->L[i_] = ((A)->L[i_]>=(B)->L[i_])?((A)->L[i_]-(B)->L[i_]):0
+#endif
+
+// D.ud[i] = S.ud[(ib>>(i*2))&3]
+static inline void sse_pshufd(sse_regs_t* d, sse_regs_t* s, uint8_t ib)
+{
+#if defined(SSE_VECEXT) && !defined(__clang__)
+    sse_vud_t m = {ib&3, (ib>>2)&3, (ib>>4)&3, (ib>>6)&3};
+    SSEV(d, ud) = __builtin_shuffle(SSEV(s, ud), m);
+#else
+    sse_regs_t tmp = *s;
+    for(int i=0; i<4; ++i)
+        d->ud[i] = tmp.ud[(ib>>(i*2))&3];
+#endif
+}
+
+#endif //__X64_SSEVEC_H__
@@ -250,18 +250,62 @@ static int sizeTLSData(int s)
     return (s+mask)&~mask;
 }
 
+// tlsdata of exited threads, kept to be reused by the next threads
+#define TLSDATA_POOL    16
+static tlsdatasize_t* tlsdata_pool[TLSDATA_POOL];
+static int tlsdata_pool_size = 0;
+
+int recycleTLSData(tlsdatasize_t* data)
+{
+    if(!my_context)
+        return 0;
+    int ret = 0;
+    mutex_lock(&my_context->mutex_tls);
+    if(tlsdata_pool_size<TLSDATA_POOL) {
+        tlsdata_pool[tlsdata_pool_size++] = data;
+        ret = 1;
+    }
+    mutex_unlock(&my_context->mutex_tls);
+    return ret;
+}
+
+void freeTLSDataPool()
+{
+    for(int i=0; i<tlsdata_pool_size; ++i) {
+        box_free(tlsdata_pool[i]->ptr);
+        box_free(tlsdata_pool[i]);
+    }
+    tlsdata_pool_size = 0;
+}
+
+// get a tlsdata of the same size from the pool, mutex_tls must be locked
+static tlsdatasize_t* getPooledTLSData(int dtssize, int datasize)
+{
+    for(int i=tlsdata_pool_size-1; i>=0; --i) {
+        tlsdatasize_t* data = tlsdata_pool[i];
+        if(sizeTLSData(data->tlssize)==datasize && data->size==dtssize+POS_TLS+datasize) {
+            tlsdata_pool[i] = tlsdata_pool[--tlsdata_pool_size];
+            return data;
+        }
+    }
+    return NULL;
+}
+
 static tlsdatasize_t* setupTLSData(box64context_t* context)
 {
     // Setup the GS segment:
     int dtssize = sizeDTS(context);
     int datasize = sizeTLSData(context->tlssize);
-    void *ptr_oversized = (char*)box_malloc(dtssize+POS_TLS+datasize);
+    tlsdatasize_t *data = getPooledTLSData(dtssize, datasize);
+    void *ptr_oversized = data?data->ptr:box_malloc(dtssize+POS_TLS+datasize);
     void *ptr = (void*)((uintptr_t)ptr_oversized + datasize);
     memcpy((void*)((uintptr_t)ptr-context->tlssize), context->tlsdata, context->tlssize);
-    tlsdatasize_t *data = (tlsdatasize_t*)box_calloc(1, sizeof(tlsdatasize_t));
+    if(!data)
+        data = (tlsdatasize_t*)box_calloc(1, sizeof(tlsdatasize_t));
     data->data = ptr;
     data->tlssize = context->tlssize;
     data->ptr = ptr_oversized;
+    data->size = dtssize+POS_TLS+datasize;
     data->n_elfs = context->elfsize;
     pthread_setspecific(context->tlskey, data);
     // copy canary...
@@ -0,0 +1 @@
+#define GITREV "a21aa9e"
@@ -28,6 +28,7 @@ typedef struct library_s library_t;
 typedef struct linkmap_s linkmap_t;
 typedef struct kh_threadstack_s kh_threadstack_t;
 typedef struct rbtree rbtree;
+typedef struct elfranges_s elfranges_t;
 typedef struct atfork_fnc_s {
     uintptr_t prepare;
     uintptr_t parent;
@@ -51,9 +52,12 @@ typedef struct tlsdatasize_s {
     int         n_elfs;
     void*       data;
     void*       ptr;
+    int         size;       // allocated size of ptr
 } tlsdatasize_t;
 
 void free_tlsdatasize(void* p);
+int recycleTLSData(tlsdatasize_t* data);
+void freeTLSDataPool();
 
 typedef struct needed_libs_s {
     int         cap;
@@ -116,6 +120,8 @@ typedef struct box64context_s {
     elfheader_t         **elfs;         // elf headers and memory
     int                 elfcap;
     int                 elfsize;        // number of elf loaded
+    elfranges_t         *elfranges;     // sorted memory ranges of the elfs, for FindElfAddress
+    uint32_t            elfranges_gen;  // odd while elfranges is being updated
 
 
     needed_libs_t       *neededlibs;    // needed libs for main elf
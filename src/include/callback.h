@@ -13,6 +13,8 @@ uint64_t RunSafeFunction(uintptr_t fnc, int nargs, ...);
 uint64_t RunFunctionWithEmu(x64emu_t *emu, int QuitOnLongJumpExit, uintptr_t fnc, int nargs, ...);
 // using the Windows x64 calling convention
 uint64_t RunFunctionWindows(uintptr_t fnc, int nargs, ...);
+// get a native function calling fnc, generated for the signature sign ("iFpp" for example), or NULL if not possible
+void* GetNativeCallback(uintptr_t fnc, const char* sign);
 
 
 #endif //__CALLBACK_H__
\ No newline at end of file
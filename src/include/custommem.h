@@ -73,12 +73,13 @@ uintptr_t getJumpAddress64(uintptr_t addr);
 #endif //SAVE_MEM
 #endif
 
+#define PROT_UFFD       0x200
 #define PROT_NEVERCLEAN 0x100
 #define PROT_DYNAREC    0x80
 #define PROT_DYNAREC_R  0x40
 #define PROT_NOPROT     0x20
-#define PROT_DYN        (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN)
-#define PROT_CUSTOM     (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN)
+#define PROT_DYN        (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN | PROT_UFFD)
+#define PROT_CUSTOM     (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN | PROT_UFFD)
 #define PROT_NEVERPROT  (PROT_NOPROT | PROT_NEVERCLEAN)
 #define PROT_WAIT       0xFF
 
@@ -117,6 +118,16 @@ void fini_custommem_helper(box64context_t* ctx);
 void addLockAddress(uintptr_t addr);    // add an address to the list of "LOCK"able
 int isLockAddress(uintptr_t addr);  // return 1 is the address is used as a LOCK, 0 else
 
+// ---- Striped locks, for the LOCK'd access split across a 16bytes boundary
+#define LOCK_STRIPES_BITS   8
+#define LOCK_STRIPES        (1<<LOCK_STRIPES_BITS)
+#define LOCK_STRIPE_SHIFT   6   // one stripe per cache line
+#define LOCK_STRIPE_IDX(addr) (((uintptr_t)(addr)>>4)&(LOCK_STRIPES-1))    // stripe of a 16bytes granule
+extern uint8_t lock_stripes[(LOCK_STRIPES+1)<<LOCK_STRIPE_SHIFT];   // +1 spare, never taken (see lock_stripe of the Dynarec)
+int isSplitLock(uintptr_t addr, int size);  // the LOCK'd access needs the stripes (same test as the Dynarec)
+void lockStripe(uintptr_t held[2], uintptr_t addr, int size);   // held gets the stripes until unlockStripe
+void unlockStripe(uintptr_t held[2]);   // release the stripes in held, also the ones of an access canceled by a signal
+
 void SetHotPage(uintptr_t addr);
 int isInHotPage(uintptr_t addr);
 int checkInHotPage(uintptr_t addr);
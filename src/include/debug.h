@@ -25,6 +25,8 @@ extern uintptr_t box64_dynarec_test_start, box64_dynarec_test_end;
 extern int box64_dynarec_bigblock;
 extern int box64_dynarec_forward;
 extern int box64_dynarec_strongmem;
+extern int box64_dynarec_strongmem_local;
+extern int box64_dynarec_strongmem_auto;
 extern int box64_dynarec_fastnan;
 extern int box64_dynarec_fastround;
 extern int box64_dynarec_x87double;
@@ -35,6 +37,12 @@ extern int box64_dynarec_bleeding_edge;
 extern int box64_dynarec_tbb;
 extern int box64_dynarec_wait;
 extern int box64_dynarec_missing;
+extern int box64_dynarec_fastpass;
+extern int box64_dynarec_linkstate;
+extern int box64_dynarec_uffd;
+extern int box64_dynarec_tune;
+extern int box64_dynarec_hugepage;
+extern char* box64_dynarec_symstats;
 extern int box64_dynarec_aligned_atomics;
 #ifdef ARM64
 extern int arm64_asimd;
@@ -69,6 +77,7 @@ extern int la64_lbt;
 extern int la64_lam_bh;
 extern int la64_lamcas;
 extern int la64_scq;
+extern int la64_lasx;
 #endif
 #endif
 extern int box64_libcef;
@@ -93,6 +102,7 @@ extern int box64_cefdisablegpu;
 extern int box64_cefdisablegpucompositor;
 extern int box64_maxcpu_immutable;
 extern int box64_malloc_hack;
+extern int box64_elfcache;
 extern int box64_dummy_crashhandler;
 extern int box64_sse_flushto0;
 extern int box64_x87_no80bits;
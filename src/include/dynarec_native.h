@@ -21,9 +21,10 @@ typedef struct instsize_s instsize_t;
 
 #define MAX_INSTS   32760
 
-void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size);
+int addInst(instsize_t* insts, size_t* size, size_t cap, int x64_size, int native_size);
 
 void CancelBlock64(int need_lock);
 void* FillBlock64(dynablock_t* block, uintptr_t addr, int alternate, int is32bits);
+void PrintDynarecStats(void);
 
 #endif //__DYNAREC_ARM_H_
\ No newline at end of file
@@ -1,9 +1,32 @@
 #ifndef __RCFILE_H__
 #define __RCFILE_H__
 
+#include <stdint.h>
+
 void LoadRCFile(const char* filename);
 void DeleteParams(void);
 void ApplyParams(const char* name);
 const char* GetLastApplyName();
 
+#ifdef DYNAREC
+// runtime evidence gathered with BOX64_DYNAREC_TUNE, used to suggest dynarec settings for the program
+typedef struct tune_stats_s {
+    int         pid;        // process gathering the stats (forked children don't write them)
+    uint32_t    blocks;     // dynablocks created
+    uint32_t    modified;   // dynablocks invalidated because their x64 code changed
+    uint32_t    smc;        // writes on protected pages with dynablocks
+    uint32_t    hotpage;    // hot page detected
+    uint32_t    unaligned;  // unaligned access fixed by the signal handler
+    uint32_t    entryflags; // dynablocks using flags coming from before the block
+} tune_stats_t;
+extern tune_stats_t tune_stats;
+#define TUNE_INC(A) do { if(box64_dynarec_tune) __atomic_add_fetch(&tune_stats.A, 1, __ATOMIC_RELAXED); } while(0)
+
+// name of the rcfile with the tuned sections (in HOME), loaded after the other rcfiles
+#define TUNED_RCFILE    "/.box64rc.tuned"
+void WriteTunedParams(void);
+// the tuned sections only add the settings that the sections of the same name in the other rcfiles don't have
+void LoadTunedRCFile(const char* filename);
+#endif
+
 #endif //__RCFILE_H__
\ No newline at end of file
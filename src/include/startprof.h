@@ -0,0 +1,18 @@
+#ifndef __STARTPROF_H__
+#define __STARTPROF_H__
+#include <stdint.h>
+
+// Startup profile (BOX64_STARTUP_PROFILE): monotonic timing of the phases of initialize(), and of the parse / map /
+// relocate / init of each library, with the number of blocks the Dynarec translated in each of them
+
+extern int box64_startup_profile;
+extern uint64_t startprof_blocks;   // blocks translated so far, only counted while profiling
+
+void StartProfInit(void);
+// return a handle for StartProfEnd (-1 if not profiling). lib can be NULL
+int StartProfBegin(const char* phase, const char* lib);
+void StartProfEnd(int idx);
+// print the summary or write the trace, and stop profiling
+void StartProfDone(void);
+
+#endif //__STARTPROF_H__
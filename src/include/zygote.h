@@ -0,0 +1,16 @@
+#ifndef __ZYGOTE_H__
+#define __ZYGOTE_H__
+
+#include <sys/types.h>
+
+// Resident box64 (started with "box64 --zygote") that forks to run the x86_64 programs exec'd by the other box64
+// processes using the same BOX64_ZYGOTE socket, instead of a new execve of box64 for each of them
+
+// Server side: only returns in the forked children, with the argc/argv/env of the program to run
+void ZygoteServer(int* argc, const char*** argv, char*** env);
+// Client side: only returns (with -1) if the zygote didn't take the exec, so a normal execve can be done
+int ZygoteExec(const char* const argv[], char* const envp[]);
+// Proxy side ("box64 --zygote-proxy fd pid", re-exec'd by ZygoteExec): waits for the child and exits with its status
+void ZygoteProxy(int s, pid_t pid);
+
+#endif //__ZYGOTE_H__
@@ -27,6 +27,7 @@
 #include "symbols.h"
 #include "elfs/elfloader_private.h"
 #include "library_inner.h"
+#include "startprof.h"
 
 #include "wrappedlibs.h"
 // create the native lib list
@@ -235,7 +236,10 @@ static void initWrappedLib(library_t *lib, box64context_t* context) {
     int nb = sizeof(wrappedlibs) / sizeof(wrappedlib_t);
     for (int i=0; i<nb; ++i) {
         if(strcmp(lib->name, wrappedlibs[i].name)==0) {
-            if(wrappedlibs[i].init(lib, context)) {
+            int sp = StartProfBegin("wrap", lib->name);
+            int ret = wrappedlibs[i].init(lib, context);
+            StartProfEnd(sp);
+            if(ret) {
                 // error!
                 const char* error_str = dlerror();
                 if(error_str)   // don't print the message if there is no error string from last error
@@ -284,7 +288,9 @@ static int loadEmulatedLib(const char* libname, library_t *lib, box64context_t*
             printf_log(LOG_NONE, "Error: Cannot open %s\n", libname);
             return 0;
         }
+        int sp = StartProfBegin("parse", libname);
         elfheader_t *elf_header = LoadAndCheckElfHeader(f, libname, 0);
+        StartProfEnd(sp);
         if(!elf_header) {
             printf_dump(LOG_DEBUG, "Error: reading elf header of %s\n", libname);    // this one can be too alarming...
             fclose(f);
@@ -297,11 +303,14 @@ static int loadEmulatedLib(const char* libname, library_t *lib, box64context_t*
             return 0;
         }
         // allocate and load elf
+        sp = StartProfBegin("map", libname);
         if(AllocLoadElfMemory(context, elf_header, 0)) {
             printf_log(LOG_NONE, "Error: loading for elf %s\n", libname);
             FreeElfHeader(&elf_header);
+            StartProfEnd(sp);
             return 0;
         }
+        StartProfEnd(sp);
         // can close the file now
         if(verneeded && !isElfHasNeededVer(elf_header, lib->name, verneeded)) {
             // incompatible, discard and continue the search
@@ -531,14 +540,18 @@ int FinalizeLibrary(library_t* lib, lib_t* local_maplib, int bindnow, int deepbi
         lib->e.finalized = 1;
         elfheader_t *elf_header = my_context->elfs[lib->e.elf_index];
         // finalize relocations
+        int sp = StartProfBegin("relocate", lib->name);
         if(RelocateElf(my_context->maplib, local_maplib, bindnow, deepbind, elf_header)) {
             printf_log(LOG_NONE, "Error: relocating symbols in elf %s\n", lib->name);
+            StartProfEnd(sp);
             return 1;
         }
         if(RelocateElfPlt(my_context->maplib, local_maplib, bindnow, deepbind, elf_header)) {
             printf_log(LOG_NONE, "Error: relocating Plt symbols in elf %s\n", lib->name);
+            StartProfEnd(sp);
             return 1;
         }
+        StartProfEnd(sp);
 #ifdef HAVE_TRACE
         if(trace_func) {
             int weak;
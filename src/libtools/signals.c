@@ -35,6 +35,7 @@
 #include "dynablock.h"
 #include "../dynarec/dynablock_private.h"
 #include "dynarec_native.h"
+#include "rcfile.h"
 #endif
 
 
@@ -1273,6 +1274,8 @@ void my_sigactionhandler_oldcode(int32_t sig, int simple, siginfo_t* info, void
             #ifdef DYNAREC
             if(Locks & is_dyndump_locked)
                 CancelBlock64(1);
+            // a split LOCK'd access canceled by the signal would keep its stripe
+            unlockStripe(emu->held_stripe);
             #endif
             #ifdef RV64
             emu->xSPSave = emu->old_savedsp;
@@ -1399,6 +1402,9 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
 #endif
     if((sig==SIGBUS) && (addr!=pc) && sigbus_specialcases(info, ucntx, pc, fpsimd)) {
         // special case fixed, restore everything and just continues
+        #ifdef DYNAREC
+        TUNE_INC(unaligned);
+        #endif
         if(box64_log>=LOG_DEBUG || box64_showsegv) {
             static void*  old_pc[2] = {0};
             static int old_pc_i = 0;
@@ -1443,11 +1449,13 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
             ++repeated_count;   // Access eoor multiple time on same page, disable dynarec on this page a few time...
             dynarec_log(LOG_DEBUG, "Detecting a Hotpage at %p (%d)\n", (void*)repeated_page, repeated_count);
             SetHotPage(repeated_page);
+            TUNE_INC(hotpage);
         } else {
             repeated_page = (uintptr_t)addr&~(box64_pagesize-1);
             repeated_count = 0;
         }
         // access error, unprotect the block (and mark them dirty)
+        TUNE_INC(smc);
         unprotectDB((uintptr_t)addr, 1, 1);    // unprotect 1 byte... But then, the whole page will be unprotected
         int db_need_test = db?getNeedTest((uintptr_t)db->x64_addr):0;
         if(db && ((addr>=db->x64_addr && addr<(db->x64_addr+db->x64_size)) || db_need_test)) {
@@ -1490,6 +1498,8 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
                 unlock_signal();
                 if(Locks & is_dyndump_locked)
                     CancelBlock64(1);
+                // the LOCK'd access will be done again, release its stripe
+                unlockStripe(emu->held_stripe);
                 emu->test.clean = 0;
                 #ifdef ANDROID
                 siglongjmp(*(JUMPBUFF*)emu->jmpbuf, 2);
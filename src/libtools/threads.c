@@ -28,6 +28,7 @@
 #ifdef DYNAREC
 #include "dynablock.h"
 #include "dynarec/native_lock.h"
+#include "rcfile.h"
 #endif
 
 //void _pthread_cleanup_push_defer(void* buffer, void* routine, void* arg);	// declare hidden functions
@@ -134,6 +135,69 @@ typedef struct emuthread_s {
 
 static pthread_key_t thread_key;
 
+// emuthread (with their x64emu_t and stack) of exited threads, kept to be reused by the next threads
+#define EMUTHREAD_POOL	16
+static emuthread_t* emuthread_pool[EMUTHREAD_POOL];
+static int emuthread_pool_size = 0;
+
+static int emuthread_recycle(emuthread_t *et)
+{
+	x64emu_t* emu = et->emu;
+	if(!my_context || !emu || !emu->stack2free || emu->stack2free==MAP_FAILED || emu->test.emu)
+		return 0;
+	box_free(et->cancels);
+	et->cancels = NULL;
+	et->cancel_size = et->cancel_cap = 0;
+	int ret = 0;
+	mutex_lock(&my_context->mutex_thread);
+	if(emuthread_pool_size<EMUTHREAD_POOL) {
+		emuthread_pool[emuthread_pool_size++] = et;
+		ret = 1;
+	}
+	mutex_unlock(&my_context->mutex_thread);
+	return ret;
+}
+
+// get an emuthread ready to run fnc(arg), with its own stack, reusing one from an exited thread if possible
+static emuthread_t* emuthread_get(x64emu_t* emu, uintptr_t fnc, void* arg, int stacksize)
+{
+	emuthread_t *et = NULL;
+	mutex_lock(&my_context->mutex_thread);
+	for(int i=emuthread_pool_size-1; i>=0 && !et; --i)
+		if(emuthread_pool[i]->emu->size_stack==stacksize) {
+			et = emuthread_pool[i];
+			emuthread_pool[i] = emuthread_pool[--emuthread_pool_size];
+		}
+	mutex_unlock(&my_context->mutex_thread);
+	if(et) {
+		x64emu_t* emuthread = et->emu;
+		uintptr_t stack = (uintptr_t)emuthread->stack2free;
+		memset(emuthread, 0, sizeof(x64emu_t));
+		NewX64EmuFromStack(emuthread, my_context, fnc, stack, stacksize, 1);
+	} else {
+		void* stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
+		if(stack!=MAP_FAILED)
+			setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
+		et = (emuthread_t*)box_calloc(1, sizeof(emuthread_t));
+		et->emu = NewX64Emu(my_context, fnc, (uintptr_t)stack, stacksize, 1);
+	}
+	SetupX64Emu(et->emu, emu);
+	et->fnc = fnc;
+	et->arg = arg;
+	return et;
+}
+
+static void emuthread_pool_free(box64context_t* context)
+{
+	mutex_lock(&context->mutex_thread);
+	for(int i=0; i<emuthread_pool_size; ++i) {
+		FreeX64Emu(&emuthread_pool[i]->emu);
+		box_free(emuthread_pool[i]);
+	}
+	emuthread_pool_size = 0;
+	mutex_unlock(&context->mutex_thread);
+}
+
 static void emuthread_destroy(void* p)
 {
 	emuthread_t *et = (emuthread_t*)p;
@@ -143,9 +207,10 @@ static void emuthread_destroy(void* p)
 	/*void* ptr;
 	if (my_context && (ptr = pthread_getspecific(my_context->tlskey)) != NULL)
         free_tlsdatasize(ptr);*/
-	// free x64emu
-	if(et) {
+	// free x64emu, or keep it for a next thread
+	if(et && !emuthread_recycle(et)) {
 		FreeX64Emu(&et->emu);
+		box_free(et->cancels);
 		box_free(et);
 	}
 }
@@ -211,8 +276,28 @@ x64emu_t* thread_get_emu()
 	return et->emu;
 }
 
+#ifdef DYNAREC
+static void auto_strongmem()
+{
+	// a 2nd thread is starting: enable strongmem and mark all existing blocks, so they get rebuilt with memory barriers
+	mutex_lock(&my_context->mutex_dyndump);
+	int changed = !box64_dynarec_strongmem;
+	if(changed)
+		box64_dynarec_strongmem = box64_dynarec_strongmem_auto;
+	mutex_unlock(&my_context->mutex_dyndump);
+	if(changed) {
+		printf_log(LOG_INFO, "Multithreaded program detected, enabling Dynarec StrongMem=%d\n", box64_dynarec_strongmem);
+		cleanDBFromAddressRange(0, 1LL<<48, 0);
+	}
+}
+#endif
+
 static void* pthread_routine(void* p)
 {
+	#ifdef DYNAREC
+	if(box64_dynarec_strongmem_auto && !box64_dynarec_strongmem)
+		auto_strongmem();
+	#endif
 	// free current emuthread if it exist
 	{
 		void* t = pthread_getspecific(thread_key);
@@ -487,8 +572,6 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 	int stacksize = 2*1024*1024;	//default stack size is 2Mo
 	void* attr_stack;
 	size_t attr_stacksize;
-	int own;
-	void* stack;
 
 	if(attr) {
 		size_t stsize;
@@ -496,25 +579,20 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 		if(pthread_attr_getstacksize(PTHREAD_ATTR(attr), &stsize)==0)
 			stacksize = stsize;
 	}
+	emuthread_t *et;
 	if(GetStackSize(emu, (uintptr_t)attr, &attr_stack, &attr_stacksize))
 	{
-		stack = attr_stack;
-		stacksize = attr_stacksize;
-		own = 0;
+		// stack is provided, not owned by the emu
+		et = (emuthread_t*)box_calloc(1, sizeof(emuthread_t));
+		x64emu_t *emuthread = NewX64Emu(my_context, (uintptr_t)start_routine, (uintptr_t)attr_stack, attr_stacksize, 0);
+		SetupX64Emu(emuthread, emu);
+		//SetFS(emuthread, GetFS(emu));
+		et->emu = emuthread;
+		et->fnc = (uintptr_t)start_routine;
+		et->arg = arg;
 	} else {
-		stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
-		if(stack!=MAP_FAILED)
-	        setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
-		own = 1;
+		et = emuthread_get(emu, (uintptr_t)start_routine, arg, stacksize);
 	}
-
-	emuthread_t *et = (emuthread_t*)box_calloc(1, sizeof(emuthread_t));
-    x64emu_t *emuthread = NewX64Emu(my_context, (uintptr_t)start_routine, (uintptr_t)stack, stacksize, own);
-	SetupX64Emu(emuthread, emu);
-	//SetFS(emuthread, GetFS(emu));
-	et->emu = emuthread;
-	et->fnc = (uintptr_t)start_routine;
-	et->arg = arg;
 	#ifdef DYNAREC
 	if(box64_dynarec) {
 		// pre-creation of the JIT code for the entry point of the thread
@@ -531,16 +609,7 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 void* my_prepare_thread(x64emu_t *emu, void* f, void* arg, int ssize, void** pet)
 {
 	int stacksize = (ssize)?ssize:(2*1024*1024);	//default stack size is 2Mo
-	void* stack = internal_mmap(NULL, stacksize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_GROWSDOWN, -1, 0);
-	if(stack!=MAP_FAILED)
-		setProtection((uintptr_t)stack, stacksize, PROT_READ|PROT_WRITE);
-	emuthread_t *et = (emuthread_t*)box_calloc(1, sizeof(emuthread_t));
-	x64emu_t *emuthread = NewX64Emu(emu->context, (uintptr_t)f, (uintptr_t)stack, stacksize, 1);
-	SetupX64Emu(emuthread, emu					);
-	//SetFS(emuthread, GetFS(emu));
-	et->emu = emuthread;
-	et->fnc = (uintptr_t)f;
-	et->arg = arg;
+	emuthread_t *et = emuthread_get(emu, (uintptr_t)f, arg, stacksize);
 	#ifdef DYNAREC
 	if(box64_dynarec) {
 		// pre-creation of the JIT code for the entry point of the thread
@@ -1131,6 +1200,7 @@ void fini_pthread_helper(box64context_t* context)
 {
 	CleanStackSize(context);
 	clean_current_emuthread();
+	emuthread_pool_free(context);
 }
 
 int checkUnlockMutex(void* m)
@@ -0,0 +1,388 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "debug.h"
+#include "x64emu.h"
+#include "x64run.h"
+#include "emu/x64emu_private.h"
+#include "emu/x64run_private.h"
+#include "box64context.h"
+#include "dynarec.h"
+#include "callback.h"
+#include "khash.h"
+
+// Native trampolines for x86_64 callbacks, generated at runtime from a wrapper like signature ("iFpp" for example)
+// Each trampoline is a small stub that loads its context in a scratch register and jumps to a generic entry point
+// The entry point saves the argument registers and calls RunNativeCallback that marshal the args to the x86_64 function
+// So there is no limit on the number of different callbacks, unlike the fixed SUPER() slots of the wrapped libs
+
+#if defined(__x86_64__) || defined(ARM64) || defined(RV64) || defined(LA64)
+#define HAVE_DYNCALLBACK
+
+#define STUB_SIZE   32
+#define CHUNK_SIZE  (64*1024)
+#define MAX_SIGN    24
+
+// the layout of a stub: [ctx][entry][code...], the code is relative to the stub so the stubs are all the same
+typedef struct dyncallback_s {
+    uintptr_t       fnc;
+    char            sign[MAX_SIGN];
+    void*           stub;
+    struct dyncallback_s* next;
+} dyncallback_t;
+
+KHASH_MAP_INIT_INT64(dyncallback, dyncallback_t*)
+
+static pthread_mutex_t mutex_dyncallback = PTHREAD_MUTEX_INITIALIZER;
+static kh_dyncallback_t* dyncallbacks = NULL;
+static uint8_t* chunk = NULL;
+static size_t chunk_used = CHUNK_SIZE;
+
+#if defined(__x86_64__)
+#define NINT    6
+#define FLOAT_IN_INT    0
+static const uint8_t stub_code[] = {
+    0x4C, 0x8B, 0x15, 0xE9, 0xFF, 0xFF, 0xFF,   // mov r10, [rip-23]
+    0xFF, 0x25, 0xEB, 0xFF, 0xFF, 0xFF,         // jmp [rip-21]
+};
+#elif defined(ARM64)
+#define NINT    8
+#define FLOAT_IN_INT    0
+static const uint32_t stub_code[] = {
+    0x58FFFF89, // ldr x9, [pc-16]
+    0x58FFFFB0, // ldr x16, [pc-12]
+    0xD61F0200, // br x16
+};
+#elif defined(RV64)
+#define NINT    8
+#define FLOAT_IN_INT    1
+static const uint32_t stub_code[] = {
+    0x00000297, // auipc t0, 0
+    0xFF82B303, // ld t1, -8(t0)
+    0xFF02B283, // ld t0, -16(t0)
+    0x00030067, // jr t1
+};
+#elif defined(LA64)
+#define NINT    8
+#define FLOAT_IN_INT    1
+static const uint32_t stub_code[] = {
+    0x1800000C, // pcaddi t0, 0
+    0x28FFE18D, // ld.d t1, t0, -8
+    0x28FFC18C, // ld.d t0, t0, -16
+    0x4C0001A0, // jr t1
+};
+#endif
+
+// regs[0..7] are the integer args registers, regs[8..15] are the float args registers, stack are the args passed on the stack
+// return value is put back in regs[0] and regs[8]
+void RunNativeCallback(dyncallback_t* cb, uint64_t* regs, uint64_t* stack);
+
+// generic entry point, the stub put its dyncallback_t* in a scratch register
+void box64_dyncallback_entry(void);
+#if defined(__x86_64__)
+__asm__ (
+"   .text\n"
+"   .p2align 4\n"
+"box64_dyncallback_entry:\n"
+"   push %rbp\n"
+"   mov %rsp, %rbp\n"
+"   sub $128, %rsp\n"
+"   mov %rdi, 0(%rsp)\n"
+"   mov %rsi, 8(%rsp)\n"
+"   mov %rdx, 16(%rsp)\n"
+"   mov %rcx, 24(%rsp)\n"
+"   mov %r8, 32(%rsp)\n"
+"   mov %r9, 40(%rsp)\n"
+"   movsd %xmm0, 64(%rsp)\n"
+"   movsd %xmm1, 72(%rsp)\n"
+"   movsd %xmm2, 80(%rsp)\n"
+"   movsd %xmm3, 88(%rsp)\n"
+"   movsd %xmm4, 96(%rsp)\n"
+"   movsd %xmm5, 104(%rsp)\n"
+"   movsd %xmm6, 112(%rsp)\n"
+"   movsd %xmm7, 120(%rsp)\n"
+"   mov %r10, %rdi\n"
+"   mov %rsp, %rsi\n"
+"   lea 16(%rbp), %rdx\n"
+"   call RunNativeCallback\n"
+"   mov 0(%rsp), %rax\n"
+"   movsd 64(%rsp), %xmm0\n"
+"   leave\n"
+"   ret\n"
+);
+#elif defined(ARM64)
+__asm__ (
+"   .text\n"
+"   .p2align 3\n"
+"box64_dyncallback_entry:\n"
+"   stp x29, x30, [sp, -144]!\n"
+"   mov x29, sp\n"
+"   stp x0, x1, [sp, 16]\n"
+"   stp x2, x3, [sp, 32]\n"
+"   stp x4, x5, [sp, 48]\n"
+"   stp x6, x7, [sp, 64]\n"
+"   stp d0, d1, [sp, 80]\n"
+"   stp d2, d3, [sp, 96]\n"
+"   stp d4, d5, [sp, 112]\n"
+"   stp d6, d7, [sp, 128]\n"
+"   mov x0, x9\n"
+"   add x1, sp, 16\n"
+"   add x2, sp, 144\n"
+"   bl RunNativeCallback\n"
+"   ldr x0, [sp, 16]\n"
+"   ldr d0, [sp, 80]\n"
+"   ldp x29, x30, [sp], 144\n"
+"   ret\n"
+);
+#elif defined(RV64)
+__asm__ (
+"   .text\n"
+"   .p2align 2\n"
+"box64_dyncallback_entry:\n"
+"   addi sp, sp, -144\n"
+"   sd ra, 136(sp)\n"
+"   sd a0, 0(sp)\n"
+"   sd a1, 8(sp)\n"
+"   sd a2, 16(sp)\n"
+"   sd a3, 24(sp)\n"
+"   sd a4, 32(sp)\n"
+"   sd a5, 40(sp)\n"
+"   sd a6, 48(sp)\n"
+"   sd a7, 56(sp)\n"
+"   fsd fa0, 64(sp)\n"
+"   fsd fa1, 72(sp)\n"
+"   fsd fa2, 80(sp)\n"
+"   fsd fa3, 88(sp)\n"
+"   fsd fa4, 96(sp)\n"
+"   fsd fa5, 104(sp)\n"
+"   fsd fa6, 112(sp)\n"
+"   fsd fa7, 120(sp)\n"
+"   mv a0, t0\n"
+"   mv a1, sp\n"
+"   addi a2, sp, 144\n"
+"   call RunNativeCallback\n"
+"   ld a0, 0(sp)\n"
+"   fld fa0, 64(sp)\n"
+"   ld ra, 136(sp)\n"
+"   addi sp, sp, 144\n"
+"   ret\n"
+);
+#elif defined(LA64)
+__asm__ (
+"   .text\n"
+"   .p2align 2\n"
+"box64_dyncallback_entry:\n"
+"   addi.d $sp, $sp, -144\n"
+"   st.d $ra, $sp, 136\n"
+"   st.d $a0, $sp, 0\n"
+"   st.d $a1, $sp, 8\n"
+"   st.d $a2, $sp, 16\n"
+"   st.d $a3, $sp, 24\n"
+"   st.d $a4, $sp, 32\n"
+"   st.d $a5, $sp, 40\n"
+"   st.d $a6, $sp, 48\n"
+"   st.d $a7, $sp, 56\n"
+"   fst.d $fa0, $sp, 64\n"
+"   fst.d $fa1, $sp, 72\n"
+"   fst.d $fa2, $sp, 80\n"
+"   fst.d $fa3, $sp, 88\n"
+"   fst.d $fa4, $sp, 96\n"
+"   fst.d $fa5, $sp, 104\n"
+"   fst.d $fa6, $sp, 112\n"
+"   fst.d $fa7, $sp, 120\n"
+"   move $a0, $t0\n"
+"   move $a1, $sp\n"
+"   addi.d $a2, $sp, 144\n"
+"   bl RunNativeCallback\n"
+"   ld.d $a0, $sp, 0\n"
+"   fld.d $fa0, $sp, 64\n"
+"   ld.d $ra, $sp, 136\n"
+"   addi.d $sp, $sp, 144\n"
+"   jr $ra\n"
+);
+#endif
+
+static int isIntArg(char c)
+{
+    switch(c) {
+        case 'i': case 'u': case 'I': case 'U': case 'l': case 'L':
+        case 'p': case 'w': case 'W': case 'c': case 'C':
+            return 1;
+    }
+    return 0;
+}
+
+static int CheckSign(const char* sign)
+{
+    if(strlen(sign)<2 || strlen(sign)>=MAX_SIGN || sign[1]!='F')
+        return 1;
+    if(sign[0]!='v' && sign[0]!='f' && sign[0]!='d' && !isIntArg(sign[0]))
+        return 1;
+    for(const char* p=sign+2; *p; ++p)
+        if(*p!='f' && *p!='d' && !isIntArg(*p))
+            return 1;
+    return 0;
+}
+
+// native integer value of a x86_64 register for the return type
+static uint64_t ExtendRet(char c, uint64_t v)
+{
+    switch(c) {
+        case 'i': return (int64_t)(int32_t)v;
+#if FLOAT_IN_INT
+        case 'u': return (int64_t)(int32_t)v;   // 32bits values are always sign extended on RV64 and LA64
+#else
+        case 'u': return (uint32_t)v;
+#endif
+        case 'w': return (int64_t)(int16_t)v;
+        case 'W': return (uint16_t)v;
+        case 'c': return (int64_t)(int8_t)v;
+        case 'C': return (uint8_t)v;
+    }
+    return v;
+}
+
+void RunNativeCallback(dyncallback_t* cb, uint64_t* regs, uint64_t* stack)
+{
+    x64emu_t *emu = thread_get_emu();
+    const char* args = cb->sign+2;
+    int n = strlen(args);
+    uint64_t vals[MAX_SIGN];
+    // get the native args
+    int ni = 0, nf = 0, ns = 0;
+    for(int i=0; i<n; ++i) {
+        if(args[i]=='f' || args[i]=='d') {
+            if(nf<8)
+                vals[i] = regs[8+nf++];
+            else if(FLOAT_IN_INT && ni<NINT)
+                vals[i] = regs[ni++];
+            else
+                vals[i] = stack[ns++];
+        } else {
+            vals[i] = (ni<NINT)?regs[ni++]:stack[ns++];
+        }
+    }
+    // count x86_64 args on the stack
+    int nargs = 0;
+    ni = nf = 0;
+    for(int i=0; i<n; ++i)
+        if(args[i]=='f' || args[i]=='d') {
+            if(nf<8) ++nf; else ++nargs;
+        } else {
+            if(ni<6) ++ni; else ++nargs;
+        }
+    int stackn = (nargs&1) + nargs;
+
+    Push64(emu, R_RBP); // push rbp
+    R_RBP = R_RSP;      // mov rbp, rsp
+    R_RSP -= stackn*sizeof(void*);
+    uint64_t *p = (uint64_t*)R_RSP;
+
+    static const int nn[] = {_DI, _SI, _DX, _CX, _R8, _R9};
+    ni = nf = 0;
+    for(int i=0; i<n; ++i) {
+        uint64_t v = vals[i];
+        switch(args[i]) {
+            case 'f':
+                if(nf<8) {
+                    emu->xmm[nf].q[0] = 0;
+                    emu->xmm[nf++].ud[0] = (uint32_t)v;
+                } else
+                    *(p++) = (uint32_t)v;
+                continue;
+            case 'd':
+                if(nf<8)
+                    emu->xmm[nf++].q[0] = v;
+                else
+                    *(p++) = v;
+                continue;
+            case 'i': v = (int64_t)(int32_t)v; break;
+            case 'u': v = (uint32_t)v; break;
+            case 'w': v = (int64_t)(int16_t)v; break;
+            case 'W': v = (uint16_t)v; break;
+            case 'c': v = (int64_t)(int8_t)v; break;
+            case 'C': v = (uint8_t)v; break;
+        }
+        if(ni<6)
+            emu->regs[nn[ni++]].q[0] = v;
+        else
+            *(p++) = v;
+    }
+
+    uintptr_t oldip = R_RIP;
+    DynaCall(emu, cb->fnc);
+
+    if(oldip==R_RIP) {
+        R_RSP = R_RBP;          // mov rsp, rbp
+        R_RBP = Pop64(emu);     // pop rbp
+    }
+
+    switch(cb->sign[0]) {
+        case 'v': break;
+        case 'f': regs[8] = 0xffffffff00000000LL | emu->xmm[0].ud[0]; break;    // NaN-boxed, for RV64
+        case 'd': regs[8] = emu->xmm[0].q[0]; break;
+        default: regs[0] = ExtendRet(cb->sign[0], R_RAX); break;
+    }
+}
+
+static void* NewStub(dyncallback_t* cb)
+{
+    if(chunk_used+STUB_SIZE>CHUNK_SIZE) {
+        void* p = mmap(NULL, CHUNK_SIZE, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if(p==MAP_FAILED)
+            return NULL;
+        chunk = (uint8_t*)p;
+        chunk_used = 0;
+    }
+    uint8_t* stub = chunk+chunk_used;
+    chunk_used += STUB_SIZE;
+    ((uintptr_t*)stub)[0] = (uintptr_t)cb;
+    ((uintptr_t*)stub)[1] = (uintptr_t)box64_dyncallback_entry;
+    memcpy(stub+16, stub_code, sizeof(stub_code));
+    __builtin___clear_cache((char*)stub, (char*)stub+STUB_SIZE);
+    return stub+16;
+}
+#endif
+
+void* GetNativeCallback(uintptr_t fnc, const char* sign)
+{
+#ifdef HAVE_DYNCALLBACK
+    if(!fnc || CheckSign(sign))
+        return NULL;
+    void* ret = NULL;
+    pthread_mutex_lock(&mutex_dyncallback);
+    if(!dyncallbacks)
+        dyncallbacks = kh_init(dyncallback);
+    int r;
+    khint_t k = kh_put(dyncallback, dyncallbacks, fnc, &r);
+    if(r)
+        kh_value(dyncallbacks, k) = NULL;
+    // the same function can be used with different signatures (a generic comparator for example)
+    for(dyncallback_t* cb = kh_value(dyncallbacks, k); cb && !ret; cb = cb->next)
+        if(!strcmp(cb->sign, sign))
+            ret = cb->stub;
+    if(!ret) {
+        dyncallback_t* cb = (dyncallback_t*)box_calloc(1, sizeof(dyncallback_t));
+        cb->fnc = fnc;
+        strcpy(cb->sign, sign);
+        cb->stub = NewStub(cb);
+        if(cb->stub) {
+            cb->next = kh_value(dyncallbacks, k);
+            kh_value(dyncallbacks, k) = cb;
+            ret = cb->stub;
+            printf_log(LOG_DEBUG, "Created native callback %p for x86_64 function %p (%s)\n", ret, (void*)fnc, sign);
+        } else
+            box_free(cb);
+    }
+    pthread_mutex_unlock(&mutex_dyncallback);
+    return ret;
+#else
+    (void)fnc; (void)sign;
+    return NULL;
+#endif
+}
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
+#include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -116,6 +118,7 @@ ENTRYBOOL(BOX64_JVM, box64_jvm)                         \
 ENTRYBOOL(BOX64_UNITYPLAYER, box64_unityplayer)         \
 ENTRYBOOL(BOX64_SDL2_JGUID, box64_sdl2_jguid)           \
 ENTRYINT(BOX64_MALLOC_HACK, box64_malloc_hack, 0, 2, 2) \
+ENTRYINT(BOX64_ELFCACHE, box64_elfcache, 0, 2, 2)     \
 ENTRYINTPOS(BOX64_MAXCPU, new_maxcpu)                   \
 ENTRYSTRING_(BOX64_ADDLIBS, new_addlibs)                \
 ENTRYSTRING_(BOX64_ENV, new_env)                        \
@@ -153,6 +156,8 @@ ENTRYINT(BOX64_DYNAREC_LOG, box64_dynarec_log, 0, 3, 2)             \
 ENTRYINT(BOX64_DYNAREC_BIGBLOCK, box64_dynarec_bigblock, 0, 3, 2)   \
 ENTRYSTRING_(BOX64_DYNAREC_FORWARD, box64_dynarec_forward)          \
 ENTRYINT(BOX64_DYNAREC_STRONGMEM, box64_dynarec_strongmem, 0, 4, 3) \
+ENTRYBOOL(BOX64_DYNAREC_STRONGMEM_LOCAL, box64_dynarec_strongmem_local) \
+ENTRYINT(BOX64_DYNAREC_STRONGMEM_AUTO, box64_dynarec_strongmem_auto, 0, 3, 2) \
 ENTRYBOOL(BOX64_DYNAREC_X87DOUBLE, box64_dynarec_x87double)         \
 ENTRYBOOL(BOX64_DYNAREC_DIV0, box64_dynarec_div0)                   \
 ENTRYBOOL(BOX64_DYNAREC_FASTNAN, box64_dynarec_fastnan)             \
@@ -169,6 +174,12 @@ ENTRYBOOL(BOX64_DYNAREC_WAIT, box64_dynarec_wait)                   \
 ENTRYSTRING_(BOX64_NODYNAREC, box64_nodynarec)                      \
 ENTRYSTRING_(BOX64_DYNAREC_TEST, box64_dynarec_test)                \
 ENTRYBOOL(BOX64_DYNAREC_MISSING, box64_dynarec_missing)             \
+ENTRYBOOL(BOX64_DYNAREC_FASTPASS, box64_dynarec_fastpass)           \
+ENTRYBOOL(BOX64_DYNAREC_LINKSTATE, box64_dynarec_linkstate)         \
+ENTRYBOOL(BOX64_DYNAREC_UFFD, box64_dynarec_uffd)                   \
+ENTRYBOOL(BOX64_DYNAREC_TUNE, box64_dynarec_tune)                   \
+ENTRYINT(BOX64_DYNAREC_HUGEPAGE, box64_dynarec_hugepage, 0, 2, 2)   \
+ENTRYDSTRING(BOX64_DYNAREC_SYMSTATS, box64_dynarec_symstats)        \
 
 #else
 #define SUPER3()                                                    \
@@ -178,6 +189,8 @@ IGNORE(BOX64_DYNAREC_LOG)                                           \
 IGNORE(BOX64_DYNAREC_BIGBLOCK)                                      \
 IGNORE(BOX64_DYNAREC_FORWARD)                                       \
 IGNORE(BOX64_DYNAREC_STRONGMEM)                                     \
+IGNORE(BOX64_DYNAREC_STRONGMEM_LOCAL)                               \
+IGNORE(BOX64_DYNAREC_STRONGMEM_AUTO)                                \
 IGNORE(BOX64_DYNAREC_X87DOUBLE)                                     \
 IGNORE(BOX64_DYNAREC_DIV0)                                          \
 IGNORE(BOX64_DYNAREC_FASTNAN)                                       \
@@ -194,6 +207,12 @@ IGNORE(BOX64_DYNAREC_WAIT)                                          \
 IGNORE(BOX64_NODYNAREC)                                             \
 IGNORE(BOX64_DYNAREC_TEST)                                          \
 IGNORE(BOX64_DYNAREC_MISSING)                                       \
+IGNORE(BOX64_DYNAREC_FASTPASS)                                      \
+IGNORE(BOX64_DYNAREC_LINKSTATE)                                     \
+IGNORE(BOX64_DYNAREC_UFFD)                                          \
+IGNORE(BOX64_DYNAREC_TUNE)                                          \
+IGNORE(BOX64_DYNAREC_HUGEPAGE)                                      \
+IGNORE(BOX64_DYNAREC_SYMSTATS)                                      \
 
 #endif
 
@@ -306,6 +325,47 @@ static void clearParam(my_params_t* param)
     #undef ENTRYULONG
 }
 
+#ifdef DYNAREC
+static int loading_tuned = 0;
+// a tuned section only brings the settings the section of the same name doesn't have (the strings are moved)
+static void mergeTunedParam(const char* secname, my_params_t* dst, my_params_t* src)
+{
+    #define ENTRYINT(NAME, name, minval, maxval, bits)                  \
+        if(src->is_##name##_present) {                                  \
+            if(dst->is_##name##_present)                                \
+                printf_log(LOG_INFO, "Tuned %s for [%s] ignored, already set in a rcfile\n", #NAME, secname); \
+            else {                                                      \
+                dst->is_##name##_present = 1;                           \
+                dst->name = src->name;                                  \
+            }                                                           \
+        }
+    #define ENTRYBOOL(NAME, name) ENTRYINT(NAME, name, 0, 1, 1)
+    #define CENTRYBOOL(NAME, name) ENTRYINT(NAME, name, 0, 1, 1)
+    #define ENTRYINTPOS(NAME, name) ENTRYINT(NAME, name, 0, 0, 0)
+    #define ENTRYSTRING(NAME, name)                                     \
+        if(src->is_##name##_present && !dst->is_##name##_present) {     \
+            dst->is_##name##_present = 1;                               \
+            dst->name = src->name;                                      \
+            src->name = NULL;                                           \
+        }
+    #define ENTRYSTRING_(NAME, name) ENTRYSTRING(NAME, name)
+    #define ENTRYDSTRING(NAME, name) ENTRYSTRING(NAME, name)
+    #define ENTRYADDR(NAME, name) ENTRYINT(NAME, name, 0, 0, 0)
+    #define ENTRYULONG(NAME, name) ENTRYINT(NAME, name, 0, 0, 0)
+    SUPER()
+    #undef ENTRYBOOL
+    #undef CENTRYBOOL
+    #undef ENTRYINT
+    #undef ENTRYINTPOS
+    #undef ENTRYSTRING
+    #undef ENTRYSTRING_
+    #undef ENTRYDSTRING
+    #undef ENTRYADDR
+    #undef ENTRYULONG
+    clearParam(src);
+}
+#endif
+
 static void addParam(const char* name, my_params_t* param)
 {
     khint_t k;
@@ -314,6 +374,12 @@ static void addParam(const char* name, my_params_t* param)
         int ret;
         k = kh_put(params, params, box_strdup(name), &ret);
     } else {
+        #ifdef DYNAREC
+        if(loading_tuned) {
+            mergeTunedParam(name, &kh_value(params, k), param);
+            return;
+        }
+        #endif
         clearParam(&kh_value(params, k));
     }
     my_params_t *p = &kh_value(params, k);
@@ -716,6 +782,8 @@ void ApplyParams(const char* name)
     }
     if(!olddynarec && box64_dynarec)
         GatherDynarecExtensions();
+    if(param->is_box64_dynarec_tune_present && box64_dynarec_tune)
+        tune_stats.pid = getpid();
     if(param->is_box64_dynarec_test_present && box64_dynarec_test) {
         box64_dynarec_fastnan = 0;
         box64_dynarec_fastround = 0;
@@ -729,3 +797,88 @@ void ApplyParams(const char* name)
         box64_dump = 1;
     }
 }
+
+#ifdef DYNAREC
+tune_stats_t tune_stats = {0};
+
+void LoadTunedRCFile(const char* filename)
+{
+    loading_tuned = 1;
+    LoadRCFile(filename);
+    loading_tuned = 0;
+}
+
+// append the suggested settings for the program, from the evidence gathered while it was running
+static void WriteTunedSection(FILE* f, const char* name)
+{
+    tune_stats_t* t = &tune_stats;
+    fprintf(f, "[%s]\n", name);
+    fprintf(f, "# BOX64_DYNAREC_TUNE: blocks=%u modified=%u smc=%u hotpage=%u unaligned=%u entryflags=%u\n",
+        t->blocks, t->modified, t->smc, t->hotpage, t->unaligned, t->entryflags);
+    // code that is written while running (JIT, self-modifying code): small blocks, and no assumption on the return addresses
+    if(t->hotpage || t->modified*16>t->blocks) {
+        fprintf(f, "BOX64_DYNAREC_BIGBLOCK=0\n");
+        fprintf(f, "BOX64_DYNAREC_CALLRET=0\n");
+    } else if(!t->modified && !t->smc) {
+        fprintf(f, "BOX64_DYNAREC_BIGBLOCK=2\n");
+        fprintf(f, "BOX64_DYNAREC_CALLRET=1\n");
+    }
+    // no block ever used flags set before it, so flags don't need to survive a call or a ret
+    if(!t->entryflags)
+        fprintf(f, "BOX64_DYNAREC_SAFEFLAGS=0\n");
+    #ifdef ARM64
+    // many blocks use flags set before them: let them skip the deferred flags check
+    else if(t->entryflags*4>t->blocks)
+        fprintf(f, "BOX64_DYNAREC_LINKSTATE=1\n");
+    #endif
+    fprintf(f, "\n");
+}
+
+void WriteTunedParams(void)
+{
+    if(!box64_dynarec_tune || !tune_stats.blocks || tune_stats.pid!=getpid())
+        return;
+    const char* home = getenv("HOME");
+    if(!home || !GetLastApplyName()[0])
+        return;
+    char* name = LowerCase(GetLastApplyName());
+    char filename[4096];
+    char tmp[4096+8];
+    snprintf(filename, sizeof(filename), "%s%s", home, TUNED_RCFILE);
+    snprintf(tmp, sizeof(tmp), "%s.XXXXXX", filename);
+    int fd = mkstemp(tmp);
+    FILE* f = (fd<0)?NULL:fdopen(fd, "w");
+    if(!f) {
+        printf_log(LOG_INFO, "Warning, cannot write tuned settings to %s\n", filename);
+        if(fd>=0) close(fd);
+        free(name);
+        return;
+    }
+    // copy all the other sections of the current file
+    FILE* old = fopen(filename, "r");
+    if(old) {
+        char* line = NULL;
+        size_t lsize = 0;
+        int skip = 0;
+        while(getline(&line, &lsize, old) != -1) {
+            if(line[0]=='[') {
+                char* p = strchr(line, ']');
+                skip = (p && (p-line-1)==(ptrdiff_t)strlen(name) && !strncmp(line+1, name, p-line-1));
+            }
+            if(!skip)
+                fputs(line, f);
+        }
+        free(line);
+        fclose(old);
+    }
+    WriteTunedSection(f, name);
+    int ret = fclose(f);
+    // rename is atomic, other processes will see the old or the new file
+    if(ret || rename(tmp, filename)) {
+        printf_log(LOG_INFO, "Warning, cannot write tuned settings to %s\n", filename);
+        unlink(tmp);
+    } else
+        printf_log(LOG_INFO, "Tuned settings for [%s] written in %s\n", name, filename);
+    free(name);
+}
+#endif
@@ -0,0 +1,192 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "startprof.h"
+
+// BOX64_STARTUP_PROFILE=1 prints a summary at the end of initialize(), any other value is the name of a
+// Chrome trace (about:tracing / Perfetto) JSON file to write, with "%p" replaced by the pid.
+// Events are kept in a flat array, in the order they begin, with their nesting depth.
+
+int box64_startup_profile = 0;
+uint64_t startprof_blocks = 0;
+
+typedef struct startprof_event_s {
+    const char* phase;  // always a literal
+    char*       lib;
+    uint64_t    start;
+    uint64_t    end;
+    uint64_t    blocks;
+    int         depth;
+} startprof_event_t;
+
+static startprof_event_t* events = NULL;
+static int n_events = 0;
+static int cap_events = 0;
+static int depth = 0;
+static uint64_t t0 = 0;
+static char* trace_file = NULL;
+
+static uint64_t startprof_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+void StartProfInit(void)
+{
+    // can be called again, in the children of the zygote
+    box64_startup_profile = 0;
+    for(int i=0; i<n_events; ++i)
+        free(events[i].lib);
+    n_events = depth = 0;
+    startprof_blocks = 0;
+    free(trace_file);
+    trace_file = NULL;
+    const char* p = getenv("BOX64_STARTUP_PROFILE");
+    if(!p || !p[0] || !strcmp(p, "0"))
+        return;
+    if(strcmp(p, "1"))
+        trace_file = strdup(p);
+    box64_startup_profile = 1;
+    t0 = startprof_now();
+}
+
+int StartProfBegin(const char* phase, const char* lib)
+{
+    if(!box64_startup_profile)
+        return -1;
+    if(n_events==cap_events) {
+        cap_events += 64;
+        events = (startprof_event_t*)realloc(events, cap_events*sizeof(startprof_event_t));
+    }
+    startprof_event_t* e = &events[n_events];
+    e->phase = phase;
+    if(lib) {
+        const char* p = strrchr(lib, '/');
+        e->lib = strdup(p?(p+1):lib);
+    } else
+        e->lib = NULL;
+    e->depth = depth++;
+    e->blocks = startprof_blocks;
+    e->end = 0;
+    e->start = startprof_now();
+    return n_events++;
+}
+
+void StartProfEnd(int idx)
+{
+    if(idx<0 || !box64_startup_profile)
+        return;
+    startprof_event_t* e = &events[idx];
+    e->end = startprof_now();
+    e->blocks = startprof_blocks - e->blocks;
+    --depth;
+}
+
+static void writeJSONString(FILE* f, const char* s)
+{
+    fputc('"', f);
+    for(; *s; ++s) {
+        if(*s=='"' || *s=='\\')
+            fputc('\\', f);
+        if((unsigned char)*s<0x20)
+            continue;
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void writeTrace(void)
+{
+    char name[4096] = {0};
+    const char* pid = strstr(trace_file, "%p");
+    if(pid)
+        snprintf(name, sizeof(name), "%.*s%d%s", (int)(pid-trace_file), trace_file, getpid(), pid+2);
+    else
+        snprintf(name, sizeof(name), "%s", trace_file);
+    FILE* f = fopen(name, "w");
+    if(!f) {
+        printf_log(LOG_NONE, "Warning, cannot write startup profile to \"%s\"\n", name);
+        return;
+    }
+    fprintf(f, "{\"traceEvents\":[\n");
+    for(int i=0; i<n_events; ++i) {
+        startprof_event_t* e = &events[i];
+        fprintf(f, "%s{\"name\":", i?",\n":"");
+        writeJSONString(f, e->lib?e->lib:e->phase);
+        fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"phase\":\"%s\",\"blocks\":%lu}}",
+            e->phase, (e->start-t0)/1000., (e->end-e->start)/1000., getpid(), getpid(), e->phase, (unsigned long)e->blocks);
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(f);
+    printf_log(LOG_INFO, "Startup profile written to \"%s\"\n", name);
+}
+
+static void printSummary(uint64_t total)
+{
+    printf_log(LOG_NONE, "Startup profile: %.3f ms, %lu blocks translated\n", total/1000000., (unsigned long)startprof_blocks);
+    for(int i=0; i<n_events; ++i) {
+        startprof_event_t* e = &events[i];
+        printf_log(LOG_NONE, "  %*s%-*s %-28s %10.3f ms %6lu blocks\n", e->depth*2, "", 12-e->depth*2>0?12-e->depth*2:0, e->phase,
+            e->lib?e->lib:"", (e->end-e->start)/1000000., (unsigned long)e->blocks);
+    }
+    // and the total per phase of the libraries (events nested in the same phase are only counted once)
+    printf_log(LOG_NONE, "Per phase:\n");
+    for(int i=0; i<n_events; ++i) {
+        if(!events[i].lib)
+            continue;
+        int seen = 0;
+        for(int j=0; j<i && !seen; ++j)
+            if(events[j].lib && !strcmp(events[j].phase, events[i].phase))
+                seen = 1;
+        if(seen)
+            continue;
+        uint64_t t = 0, blocks = 0;
+        int n = 0;
+        for(int j=i; j<n_events; ++j)
+            if(events[j].lib && !strcmp(events[j].phase, events[i].phase)) {
+                int nested = 0;
+                for(int k=i; k<j && !nested; ++k)
+                    if(events[k].lib && events[k].end>=events[j].end && !strcmp(events[k].phase, events[j].phase))
+                        nested = 1;
+                ++n;
+                if(!nested) {
+                    t += events[j].end-events[j].start;
+                    blocks += events[j].blocks;
+                }
+            }
+        printf_log(LOG_NONE, "  %-12s %4d libs %10.3f ms %6lu blocks\n", events[i].phase, n, t/1000000., (unsigned long)blocks);
+    }
+}
+
+void StartProfDone(void)
+{
+    if(!box64_startup_profile)
+        return;
+    uint64_t total = startprof_now()-t0;
+    // close the phases still opened, if any
+    for(int i=0; i<n_events; ++i)
+        if(!events[i].end) {
+            events[i].end = startprof_now();
+            events[i].blocks = startprof_blocks - events[i].blocks;
+        }
+    if(trace_file)
+        writeTrace();
+    else
+        printSummary(total);
+    box64_startup_profile = 0;
+    for(int i=0; i<n_events; ++i)
+        free(events[i].lib);
+    free(events);
+    events = NULL;
+    n_events = cap_events = depth = 0;
+    free(trace_file);
+    trace_file = NULL;
+}
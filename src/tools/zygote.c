@@ -0,0 +1,458 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <poll.h>
+#include <dlfcn.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/signalfd.h>
+#include <sys/resource.h>
+#include <sys/un.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "fileutils.h"
+#include "zygote.h"
+
+// The client (a box64 process doing an execve of an x86_64 program) sends its argv, env, cwd, umask, signal
+// mask, rlimits and the fds that would survive the exec. The zygote forks, and the child sets all that up, joins
+// the process group of the client and carries on with initialize(). The client re-execs itself as a proxy for the
+// child (so its other threads are gone, as with an execve, and it keeps the pid the parent is waiting for):
+// it forwards the signals sent to it, and exits with the status of the child, that the zygote sends back.
+// Differences with a real execve: the zygote only takes clients of its own session (the terminal and the job
+// control stay the same) and of its own uid/gid, the supplementary groups and the capabilities are the ones of
+// the zygote, the pid of the program is not the one of the caller, and a signal sent to the whole process group
+// reaches the program twice (directly and through the proxy).
+
+#define ZYGOTE_MAGIC    0x4f47595a  // "ZYGO"
+#define ZYGOTE_MAXFDS   250         // less than SCM_MAX_FD
+
+typedef struct zygote_req_s {
+    uint32_t    magic;
+    uint32_t    argc;
+    uint32_t    envc;
+    uint32_t    nfds;
+    uint32_t    blobsz;     // argv, then env, then cwd strings
+    uint32_t    umask;
+    uint64_t    ignored;    // signals ignored (they stay ignored after an exec)
+    sigset_t    sigmask;
+    struct rlimit rlim[RLIM_NLIMITS];
+    int         fds[ZYGOTE_MAXFDS]; // fd numbers, in the order of the SCM_RIGHTS
+} zygote_req_t;
+
+typedef struct zygote_child_s {
+    pid_t   pid;
+    int     fd;     // connection to the client waiting for it, or -1
+} zygote_child_t;
+
+static int readall(int fd, void* buff, size_t sz)
+{
+    while(sz) {
+        ssize_t r = read(fd, buff, sz);
+        if(r<0 && errno==EINTR)
+            continue;
+        if(r<=0)
+            return 0;
+        buff += r;
+        sz -= r;
+    }
+    return 1;
+}
+
+static int writeall(int fd, const void* buff, size_t sz)
+{
+    while(sz) {
+        ssize_t r = send(fd, buff, sz, MSG_NOSIGNAL);
+        if(r<0 && errno==EINTR)
+            continue;
+        if(r<=0)
+            return 0;
+        buff += r;
+        sz -= r;
+    }
+    return 1;
+}
+
+static const char* GetZygotePath()
+{
+    const char* path = getenv("BOX64_ZYGOTE");
+    if(path && *path && strcmp(path, "0"))
+        return path;
+    return NULL;
+}
+
+// ---- Client ----
+static volatile pid_t zygote_child = 0;
+static void zygote_forward(int sig, siginfo_t* info, void* ucntx)
+{
+    // the ones from the terminal (^C, hangup...) already went to the whole process group, so to the child too
+    if(zygote_child>0 && info->si_code!=SI_KERNEL)
+        kill(zygote_child, sig);
+}
+
+void ZygoteProxy(int s, pid_t pid)
+{
+    zygote_child = pid;
+    static const int forwarded[] = {SIGHUP, SIGINT, SIGQUIT, SIGTERM, SIGUSR1, SIGUSR2, SIGALRM, SIGWINCH};
+    struct sigaction action = {0};
+    action.sa_sigaction = zygote_forward;
+    action.sa_flags = SA_RESTART|SA_SIGINFO;
+    sigset_t unblock;
+    sigemptyset(&unblock);
+    for(int i=0; i<(int)(sizeof(forwarded)/sizeof(forwarded[0])); ++i) {
+        sigaction(forwarded[i], &action, NULL);
+        sigaddset(&unblock, forwarded[i]);
+    }
+    sigprocmask(SIG_UNBLOCK, &unblock, NULL);
+    int status = 0;
+    if(!readall(s, &status, sizeof(status)))
+        _exit(127);
+    if(WIFSIGNALED(status)) {
+        int sig = WTERMSIG(status);
+        signal(sig, SIG_DFL);
+        sigemptyset(&unblock);
+        sigaddset(&unblock, sig);
+        sigprocmask(SIG_UNBLOCK, &unblock, NULL);
+        raise(sig);
+        _exit(128+sig);
+    }
+    _exit(WEXITSTATUS(status));
+}
+
+int ZygoteExec(const char* const argv[], char* const envp[])
+{
+    const char* path = GetZygotePath();
+    if(!path)
+        return -1;
+    zygote_req_t req = {0};
+    req.magic = ZYGOTE_MAGIC;
+    // the fds that would survive the exec
+    DIR* dir = opendir("/proc/self/fd");
+    if(!dir)
+        return -1;
+    struct dirent* d;
+    while((d=readdir(dir))) {
+        if(d->d_name[0]=='.')
+            continue;
+        int fd = atoi(d->d_name);
+        int flags = (fd==dirfd(dir))?-1:fcntl(fd, F_GETFD);
+        if(flags<0 || (flags&FD_CLOEXEC))
+            continue;
+        if(req.nfds==ZYGOTE_MAXFDS) {
+            closedir(dir);
+            return -1;
+        }
+        req.fds[req.nfds++] = fd;
+    }
+    closedir(dir);
+    char cwd[PATH_MAX];
+    if(!getcwd(cwd, sizeof(cwd)))
+        return -1;
+    size_t sz = strlen(cwd)+1;
+    for(req.argc=0; argv[req.argc]; ++req.argc)
+        sz += strlen(argv[req.argc])+1;
+    for(req.envc=0; envp && envp[req.envc]; ++req.envc)
+        sz += strlen(envp[req.envc])+1;
+    req.blobsz = sz;
+    req.umask = umask(0);
+    umask(req.umask);
+    sigprocmask(SIG_SETMASK, NULL, &req.sigmask);
+    for(int i=0; i<RLIM_NLIMITS; ++i)
+        getrlimit(i, &req.rlim[i]);
+    for(int i=1; i<64; ++i)
+        if(my_context && my_context->signals[i]==(uintptr_t)SIG_IGN)
+            req.ignored |= 1LL<<i;
+
+    int s = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+    if(s<0)
+        return -1;
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path)-1);
+    if(connect(s, (struct sockaddr*)&addr, sizeof(addr))) {
+        printf_log(LOG_DEBUG, "Cannot connect to zygote \"%s\" (%s), doing a normal exec\n", path, strerror(errno));
+        close(s);
+        return -1;
+    }
+    char* blob = (char*)box_malloc(sz);
+    char* p = blob;
+    for(uint32_t i=0; i<req.argc; ++i)
+        p = stpcpy(p, argv[i])+1;
+    for(uint32_t i=0; i<req.envc; ++i)
+        p = stpcpy(p, envp[i])+1;
+    strcpy(p, cwd);
+    // the header carries the fds
+    char cbuf[CMSG_SPACE(sizeof(int)*ZYGOTE_MAXFDS)];
+    struct iovec iov = { &req, sizeof(req) };
+    struct msghdr msg = {0};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if(req.nfds) {
+        msg.msg_control = cbuf;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int)*req.nfds);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int)*req.nfds);
+        memcpy(CMSG_DATA(cmsg), req.fds, sizeof(int)*req.nfds);
+    }
+    pid_t pid = 0;
+    int ok = (sendmsg(s, &msg, MSG_NOSIGNAL)==sizeof(req)) && writeall(s, blob, sz) && readall(s, &pid, sizeof(pid));
+    box_free(blob);
+    if(!ok || pid<=0) {
+        printf_log(LOG_INFO, "Warning, zygote \"%s\" refused the exec of \"%s\", doing a normal exec\n", path, argv[1]);
+        close(s);
+        return -1;
+    }
+    printf_log(LOG_DEBUG, "Exec of \"%s\" done by zygote, as pid %d\n", argv[1], pid);
+    // from now on, this process is only a proxy for the child
+    // the child owns the fds now (so a pipe gets its EOF when the child closes it)
+    for(uint32_t i=0; i<req.nfds; ++i)
+        close(req.fds[i]);
+    // re-exec box64 as the proxy, that gets rid of the other threads the way the execve would have
+    char sfd[16], spid[16];
+    snprintf(sfd, sizeof(sfd), "%d", s);
+    snprintf(spid, sizeof(spid), "%d", pid);
+    const char* proxy[] = {"box64", "--zygote-proxy", sfd, spid, NULL};
+    fcntl(s, F_SETFD, 0);
+    execve("/proc/self/exe", (char* const*)proxy, envp);
+    printf_log(LOG_INFO, "Warning, cannot re-exec the zygote proxy (%s), other threads keep running\n", strerror(errno));
+    fcntl(s, F_SETFD, FD_CLOEXEC);
+    ZygoteProxy(s, pid);
+    return -1;  // not reached
+}
+
+// ---- Server ----
+// setup the forked child as the client would be after its exec
+static void zygote_setup_child(zygote_req_t* req, pid_t pgid, int* fds, char* blob, int* argc, const char*** argv, char*** env)
+{
+    // in the process group of the client, same session (checked by the zygote), so same terminal and job
+    setpgid(0, pgid);
+    // move the received fds out of the way, put them at their place, and close all the others
+    int base = 3;
+    for(uint32_t i=0; i<req->nfds; ++i)
+        if(req->fds[i]>=base)
+            base = req->fds[i]+1;
+    for(uint32_t i=0; i<req->nfds; ++i) {
+        int tmp = fcntl(fds[i], F_DUPFD_CLOEXEC, base);
+        close(fds[i]);
+        fds[i] = tmp;
+    }
+    for(uint32_t i=0; i<req->nfds; ++i) {
+        dup2(fds[i], req->fds[i]);
+        close(fds[i]);
+    }
+    DIR* dir = opendir("/proc/self/fd");
+    if(dir) {
+        int toclose[64];
+        int n;
+        do {
+            n = 0;
+            struct dirent* d;
+            rewinddir(dir);
+            while((d=readdir(dir)) && n<64) {
+                if(d->d_name[0]=='.')
+                    continue;
+                int fd = atoi(d->d_name);
+                int keep = (fd==dirfd(dir));
+                for(uint32_t i=0; i<req->nfds && !keep; ++i)
+                    if(req->fds[i]==fd)
+                        keep = 1;
+                if(!keep)
+                    toclose[n++] = fd;
+            }
+            for(int i=0; i<n; ++i)
+                close(toclose[i]);
+        } while(n);
+        closedir(dir);
+    }
+    char* p = blob;
+    char** nargv = (char**)box_calloc(req->argc+1, sizeof(char*));
+    for(uint32_t i=0; i<req->argc; ++i) {
+        nargv[i] = p;
+        p += strlen(p)+1;
+    }
+    char** nenv = (char**)box_calloc(req->envc+1, sizeof(char*));
+    for(uint32_t i=0; i<req->envc; ++i) {
+        nenv[i] = p;
+        p += strlen(p)+1;
+    }
+    if(chdir(p))
+        printf_log(LOG_INFO, "Warning, zygote child cannot change directory to \"%s\" (%s)\n", p, strerror(errno));
+    umask(req->umask);
+    for(int i=0; i<RLIM_NLIMITS; ++i)
+        if(setrlimit(i, &req->rlim[i]))
+            printf_log(LOG_INFO, "Warning, zygote child cannot set rlimit %d (%s)\n", i, strerror(errno));
+    for(int i=1; i<64; ++i)
+        if((req->ignored>>i)&1)
+            signal(i, SIG_IGN);
+    sigprocmask(SIG_SETMASK, &req->sigmask, NULL);
+    *argc = req->argc;
+    *argv = (const char**)nargv;
+    *env = nenv;
+    environ = nenv;
+}
+
+void ZygoteServer(int* argc, const char*** argv, char*** env)
+{
+    char def[PATH_MAX];
+    const char* path = GetZygotePath();
+    if(!path) {
+        snprintf(def, sizeof(def), "%s/box64-zygote-%d", GetTmpDir(), getuid());
+        setenv("BOX64_ZYGOTE", def, 1);
+        path = def;
+    }
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path)-1);
+    int ls = socket(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0);
+    unlink(path);
+    mode_t old = umask(0077);
+    int ret = (ls<0)?-1:bind(ls, (struct sockaddr*)&addr, sizeof(addr));
+    umask(old);
+    if(ret || listen(ls, 64)) {
+        printf_log(LOG_NONE, "Error: cannot listen on zygote socket \"%s\" (%s)\n", path, strerror(errno));
+        exit(1);
+    }
+    printf_log(LOG_INFO, "BOX64: Zygote listening on \"%s\" (use BOX64_ZYGOTE=%s for the box64 processes)\n", path, path);
+    #ifndef STATICBUILD
+    // native libs most of the programs will end up using through the wrapped libs
+    static const char* preload[] = {"libstdc++.so.6", "libgcc_s.so.1", "libz.so.1"};
+    for(int i=0; i<(int)(sizeof(preload)/sizeof(preload[0])); ++i)
+        if(!dlopen(preload[i], RTLD_LAZY|RTLD_GLOBAL))
+            printf_log(LOG_DEBUG, "Zygote cannot preload %s\n", preload[i]);
+    #endif
+    sigset_t chld, oldmask;
+    sigemptyset(&chld);
+    sigaddset(&chld, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &chld, &oldmask);
+    int sfd = signalfd(-1, &chld, SFD_CLOEXEC);
+    if(sfd<0) {
+        printf_log(LOG_NONE, "Error: zygote cannot create its signalfd (%s)\n", strerror(errno));
+        exit(1);
+    }
+    zygote_child_t* children = NULL;
+    int nchildren = 0, capchildren = 0;
+    struct pollfd* pfd = NULL;
+    while(1) {
+        pfd = (struct pollfd*)box_realloc(pfd, (2+nchildren)*sizeof(struct pollfd));
+        pfd[0].fd = ls;
+        pfd[0].events = POLLIN;
+        pfd[1].fd = sfd;
+        pfd[1].events = POLLIN;
+        for(int i=0; i<nchildren; ++i) {
+            pfd[2+i].fd = children[i].fd;
+            pfd[2+i].events = POLLIN;
+        }
+        if(poll(pfd, 2+nchildren, -1)<0) {
+            if(errno==EINTR)
+                continue;
+            printf_log(LOG_NONE, "Error: zygote poll failed (%s)\n", strerror(errno));
+            exit(1);
+        }
+        // a client sends nothing after its request, so it's gone: the exec'd program goes with it
+        for(int i=0; i<nchildren; ++i)
+            if(pfd[2+i].revents) {
+                kill(children[i].pid, SIGKILL);
+                close(children[i].fd);
+                children[i].fd = -1;
+            }
+        if(pfd[1].revents) {
+            struct signalfd_siginfo si;
+            if(read(sfd, &si, sizeof(si))<0) {}
+            int status;
+            pid_t pid;
+            while((pid=waitpid(-1, &status, WNOHANG))>0)
+                for(int i=0; i<nchildren; ++i)
+                    if(children[i].pid==pid) {
+                        if(children[i].fd>=0) {
+                            writeall(children[i].fd, &status, sizeof(status));
+                            close(children[i].fd);
+                        }
+                        children[i] = children[--nchildren];
+                        break;
+                    }
+        }
+        if(!(pfd[0].revents&POLLIN))
+            continue;
+        int c = accept4(ls, NULL, NULL, SOCK_CLOEXEC);
+        if(c<0)
+            continue;
+        struct ucred cred = {0};
+        socklen_t l = sizeof(cred);
+        struct timeval tv = {1, 0}; // don't get stuck on a bad client
+        setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        zygote_req_t req;
+        int fds[ZYGOTE_MAXFDS];
+        uint32_t nfds = 0;
+        char cbuf[CMSG_SPACE(sizeof(int)*ZYGOTE_MAXFDS)];
+        struct iovec iov = { &req, sizeof(req) };
+        struct msghdr msg = {0};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = cbuf;
+        msg.msg_controllen = sizeof(cbuf);
+        ssize_t n = -1;
+        pid_t pgid = -1;
+        // same credentials and session only, the child cannot move to another one
+        if(!getsockopt(c, SOL_SOCKET, SO_PEERCRED, &cred, &l) && cred.uid==getuid() && cred.gid==getgid()
+          && getsid(cred.pid)==getsid(0) && (pgid=getpgid(cred.pid))>0)
+            n = recvmsg(c, &msg, MSG_CMSG_CLOEXEC);
+        else
+            printf_log(LOG_DEBUG, "Zygote refused pid %d, not of its uid/gid or session\n", cred.pid);
+        for(struct cmsghdr* cmsg = (n>0)?CMSG_FIRSTHDR(&msg):NULL; cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+            if(cmsg->cmsg_level==SOL_SOCKET && cmsg->cmsg_type==SCM_RIGHTS) {
+                uint32_t cnt = (cmsg->cmsg_len-CMSG_LEN(0))/sizeof(int);
+                if(cnt+nfds>ZYGOTE_MAXFDS) cnt = ZYGOTE_MAXFDS-nfds;
+                memcpy(fds+nfds, CMSG_DATA(cmsg), cnt*sizeof(int));
+                nfds += cnt;
+            }
+        int ok = (n>0) && readall(c, ((char*)&req)+n, sizeof(req)-n) && (req.magic==ZYGOTE_MAGIC) && (req.nfds==nfds);
+        char* blob = ok?(char*)box_malloc(req.blobsz+1):NULL;
+        if(ok && !readall(c, blob, req.blobsz))
+            ok = 0;
+        pid_t pid = ok?fork():-1;
+        if(!pid) {
+            // the child doesn't need anything from the zygote loop
+            close(ls);
+            close(sfd);
+            close(c);
+            for(int i=0; i<nchildren; ++i)
+                if(children[i].fd>=0)
+                    close(children[i].fd);
+            box_free(children);
+            box_free(pfd);
+            blob[req.blobsz] = '\0';
+            zygote_setup_child(&req, pgid, fds, blob, argc, argv, env);
+            return;
+        }
+        for(uint32_t i=0; i<nfds; ++i)
+            close(fds[i]);
+        box_free(blob);
+        if(pid>0)
+            setpgid(pid, pgid); // also from here, so it's done before the client can signal the group
+        if(pid<0 || !writeall(c, &pid, sizeof(pid))) {
+            // the client will do a normal exec
+            close(c);
+            continue;
+        }
+        printf_log(LOG_DEBUG, "Zygote forked pid %d\n", pid);
+        if(nchildren==capchildren) {
+            capchildren += 16;
+            children = (zygote_child_t*)box_realloc(children, capchildren*sizeof(zygote_child_t));
+        }
+        children[nchildren].pid = pid;
+        children[nchildren].fd = c;
+        ++nchildren;
+    }
+}
@@ -41,6 +41,7 @@
 #include <sys/resource.h>
 #include <sys/prctl.h>
 #include <sys/ptrace.h>
+#include <pthread.h>
 #undef LOG_INFO
 #undef LOG_DEBUG
 
@@ -64,6 +65,9 @@
 #include "bridge.h"
 #include "globalsymbols.h"
 #include "rcfile.h"
+#include "zygote.h"
+#include "custommem.h"
+#include "khash.h"
 #ifndef LOG_INFO
 #define LOG_INFO 1
 #endif
@@ -158,6 +162,7 @@ static void* findcompareFct(void* fct)
     if(!fct) return NULL;
     void* p;
     if((p = GetNativeFnc((uintptr_t)fct))) return p;
+    if((p = GetNativeCallback((uintptr_t)fct, "iFpp"))) return p;
     #define GO(A) if(my_compare_fct_##A == (uintptr_t)fct) return my_compare_##A;
     SUPER()
     #undef GO
@@ -1719,95 +1724,219 @@ static int shm_unlink(const char *name) {
 }
 #endif
 
-#define TMP_CPUINFO "box64_tmpcpuinfo"
 #define TMP_CPUTOPO "box64_tmpcputopo%d"
-#define TMP_CLOCKSOURCE "box64_tmpclocksource"
 #endif
+#define TMP_CPUINFO "box64_tmpcpuinfo"
+#define TMP_CLOCKSOURCE "box64_tmpclocksource"
 #define TMP_MEMMAP  "box64_tmpmemmap"
 #define TMP_CMDLINE "box64_tmpcmdline"
 #define TMP_CPUPRESENT "box64_cpupresent"
 #define TMP_CPUCACHE_ASSOC "box64_cpucacheassoc"
 #define TMP_CPUCACHE_COHER "box64_cpucachecoher"
 #define TMP_CPUCACHE_SIZE "box64_cpucachesize"
-EXPORT int32_t my_open(x64emu_t* emu, void* pathname, int32_t flags, uint32_t mode)
+
+// Virtual files: the /proc and /sys files generated for the emulated program, found with a hash table on the path.
+// Their content is generated once in a sealed memfd, and each open gets a new file description on it (through
+// /proc/self/fd, so the file offset is not shared). The maps view is the exception: it comes from the kernel's maps, that
+// also changes with the native mmaps box64 doesn't track, so it's generated again on each open.
+typedef enum vfile_kind_e {
+    VFILE_NONE = 0,
+    VFILE_CMDLINE,
+    VFILE_MAPS,
+    VFILE_CPUINFO,
+    VFILE_CPUPRESENT,
+    VFILE_CLOCKSOURCE,
+    VFILE_LAST
+} vfile_kind_t;
+
+typedef struct vfile_memo_s {
+    int         fd;
+    dev_t       dev;
+    ino_t       ino;
+} vfile_memo_t;
+
+#define VFILE_MINFD 100 // keep the memoized fds away from the low numbers the program may expect
+
+KHASH_MAP_INIT_STR(vfiles, int)
+static kh_vfiles_t* vfiles = NULL;
+static pthread_once_t vfiles_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t vfiles_mutex = PTHREAD_MUTEX_INITIALIZER;
+static vfile_memo_t vfiles_memo[VFILE_LAST];
+static const char* vfiles_name[VFILE_LAST] = {NULL, TMP_CMDLINE, TMP_MEMMAP, TMP_CPUINFO, TMP_CPUPRESENT, TMP_CLOCKSOURCE};
+
+static void initVirtualFiles(void)
+{
+    vfiles = kh_init(vfiles);
+    int ret;
+    khint_t k;
+    #define GO(P, K) k = kh_put(vfiles, vfiles, P, &ret); kh_value(vfiles, k) = K
+    GO("/proc/self/cmdline", VFILE_CMDLINE);
+    GO("/proc/self/maps", VFILE_MAPS);
+    #ifndef NOALIGN
+    GO("/proc/cpuinfo", VFILE_CPUINFO);
+    GO("/sys/devices/system/cpu/present", VFILE_CPUPRESENT);
+    GO("/sys/devices/system/cpu/online", VFILE_CPUPRESENT);
+    GO("/sys/bus/clocksource/devices/clocksource0/current_clocksource", VFILE_CLOCKSOURCE);
+    #endif
+    #undef GO
+    for(int i=0; i<VFILE_LAST; ++i)
+        vfiles_memo[i].fd = -1;
+}
+
+static int getVirtualFile(const char* path)
 {
-    if(isProcSelf((const char*) pathname, "cmdline")) {
-        // special case for self command line...
-        #if 0
-        char tmpcmdline[200] = {0};
-        char tmpbuff[100] = {0};
-        sprintf(tmpbuff, "%s/cmdlineXXXXXX", getenv("TMP")?getenv("TMP"):".");
-        int tmp = mkstemp(tmpbuff);
-        int dummy;
-        if(tmp<0) return open(pathname, flags, mode);
-        dummy = write(tmp, emu->context->fullpath, strlen(emu->context->fullpath)+1);
-        for (int i=1; i<emu->context->argc; ++i)
-            dummy = write(tmp, emu->context->argv[i], strlen(emu->context->argv[i])+1);
-        lseek(tmp, 0, SEEK_SET);
-        #else
-        int tmp = shm_open(TMP_CMDLINE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode);
-        shm_unlink(TMP_CMDLINE);    // remove the shm file, but it will still exist because it's currently in use
-        int dummy = write(tmp, emu->context->fullpath, strlen(emu->context->fullpath)+1);
-        (void)dummy;
-        for (int i=1; i<emu->context->argc; ++i)
-            if(emu->context->argv[i])
-                dummy = write(tmp, emu->context->argv[i], strlen(emu->context->argv[i])+1);
-        lseek(tmp, 0, SEEK_SET);
+    if(strncmp(path, "/proc/", 6) && strncmp(path, "/sys/", 5))
+        return VFILE_NONE;
+    pthread_once(&vfiles_once, initVirtualFiles);
+    char tmp[64];
+    if(path[1]=='p' && path[6]>='0' && path[6]<='9') {
+        // /proc/<pid>/xxx is /proc/self/xxx for the current pid
+        char* end;
+        if(strtol(path+6, &end, 10)!=getpid() || *end!='/' || strlen(end)>=sizeof(tmp)-strlen("/proc/self"))
+            return VFILE_NONE;
+        sprintf(tmp, "/proc/self%s", end);
+        path = tmp;
+    }
+    khint_t k = kh_get(vfiles, vfiles, path);
+    if(k==kh_end(vfiles))
+        return VFILE_NONE;
+    int kind = kh_value(vfiles, k);
+    if(kind==VFILE_CPUPRESENT && !(box64_maxcpu && getNCpu()>=box64_maxcpu))
+        return VFILE_NONE;  // only to limit the number of cores
+    return kind;
+}
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC         0x0001U
+#define MFD_ALLOW_SEALING   0x0002U
+#endif
+static int createVirtualFd(const char* name, int cloexec)
+{
+    int fd = -1;
+    #ifdef __NR_memfd_create
+    fd = syscall(__NR_memfd_create, name, MFD_ALLOW_SEALING|(cloexec?MFD_CLOEXEC:0));
+    #endif
+    if(fd<0) {
+        fd = shm_open(name, O_RDWR | O_CREAT, S_IRWXU);
+        if(fd<0)
+            return -1;
+        shm_unlink(name);    // remove the shm file, but it will still exist because it's currently in use
+        if(!cloexec)
+            fcntl(fd, F_SETFD, 0);
+    }
+    return fd;
+}
+
+static void fillVirtualFile(x64emu_t* emu, int kind, int fd)
+{
+    switch(kind) {
+        case VFILE_CMDLINE: {
+            int dummy = write(fd, emu->context->fullpath, strlen(emu->context->fullpath)+1);
+            (void)dummy;
+            for (int i=1; i<emu->context->argc; ++i)
+                if(emu->context->argv[i])
+                    dummy = write(fd, emu->context->argv[i], strlen(emu->context->argv[i])+1);
+            } break;
+        case VFILE_MAPS: CreateMemorymapFile(emu->context, fd); break;
+        #ifndef NOALIGN
+        case VFILE_CPUINFO: CreateCPUInfoFile(fd); break;
+        case VFILE_CPUPRESENT: CreateCPUPresentFile(fd); break;
+        case VFILE_CLOCKSOURCE: CreateClocksourceFile(fd); break;
         #endif
-        return tmp;
     }
-    if(isProcSelf((const char*)pathname, "exe")) {
-        return open(emu->context->fullpath, flags, mode);
+    lseek(fd, 0, SEEK_SET);
+}
+
+// return a new fd on the virtual file, generating it if needed, or -1
+static int openVirtualFile(x64emu_t* emu, int kind, int cloexec)
+{
+    struct stat st;
+    int ret = -1;
+    if(kind==VFILE_MAPS)
+        goto private;
+    pthread_mutex_lock(&vfiles_mutex);
+    vfile_memo_t* memo = &vfiles_memo[kind];
+    if(memo->fd>=0 && (fstat(memo->fd, &st) || st.st_dev!=memo->dev || st.st_ino!=memo->ino))
+        memo->fd = -1;  // closed (and maybe reused) by the program, not ours anymore
+    if(memo->fd<0) {
+        int fd = createVirtualFd(vfiles_name[kind], 1);
+        if(fd>=0) {
+            fillVirtualFile(emu, kind, fd);
+            #ifdef F_ADD_SEALS
+            fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK|F_SEAL_GROW|F_SEAL_WRITE|F_SEAL_SEAL);
+            #endif
+            int hi = fcntl(fd, F_DUPFD_CLOEXEC, VFILE_MINFD);
+            if(hi>=0) {
+                close(fd);
+                fd = hi;
+            }
+            if(!fstat(fd, &st)) {
+                memo->fd = fd;
+                memo->dev = st.st_dev;
+                memo->ino = st.st_ino;
+            } else
+                close(fd);
+        }
     }
-    #ifndef NOALIGN
-    if(strcmp((const char*)pathname, "/proc/cpuinfo")==0) {
-        // special case for cpuinfo
-        int tmp = shm_open(TMP_CPUINFO, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUINFO);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCPUInfoFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
+    if(memo->fd>=0) {
+        char tmp[64];
+        sprintf(tmp, "/proc/self/fd/%d", memo->fd);
+        ret = open(tmp, O_RDONLY|(cloexec?O_CLOEXEC:0));
     }
-    if(!strcmp((const char*)pathname, "/sys/bus/clocksource/devices/clocksource0/current_clocksource")) {
-        // special case to say tsc as current clocksource
-        int tmp = shm_open(TMP_CLOCKSOURCE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CLOCKSOURCE);    // remove the shm file, but it will still exist because it's currently in use
-        CreateClocksourceFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
+    pthread_mutex_unlock(&vfiles_mutex);
+private:
+    if(ret<0) {
+        // cannot share it (or not worth it), so generate a private one
+        ret = createVirtualFd(vfiles_name[kind], cloexec);
+        if(ret>=0)
+            fillVirtualFile(emu, kind, ret);
     }
-    int cpu, index;
-    if(isSysCpuCache(pathname, "ways_of_associativity", &cpu, &index) && !FileExist(pathname, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_ASSOC, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_ASSOC);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheAssoc(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
+    return ret;
+}
+
+// return a new fd if path is a virtual file, or -1 to use the real one
+static int openVirtual(x64emu_t* emu, const char* path, int cloexec)
+{
+    int kind = getVirtualFile(path);
+    if(kind!=VFILE_NONE)
+        return openVirtualFile(emu, kind, cloexec);
+    #ifndef NOALIGN
+    if(!strncmp(path, "/sys/devices/system/cpu/cpu", strlen("/sys/devices/system/cpu/cpu"))) {
+        // create a dummy one for the missing cache informations
+        int cpu, index;
+        const char* name = NULL;
+        void (*create)(int, int, int) = NULL;
+        if(isSysCpuCache(path, "ways_of_associativity", &cpu, &index)) {
+            name = TMP_CPUCACHE_ASSOC;
+            create = CreateCpuCacheAssoc;
+        } else if(isSysCpuCache(path, "coherency_line_size", &cpu, &index)) {
+            name = TMP_CPUCACHE_COHER;
+            create = CreateCpuCacheCoher;
+        } else if(isSysCpuCache(path, "size", &cpu, &index)) {
+            name = TMP_CPUCACHE_SIZE;
+            create = CreateCpuCacheSize;
+        }
+        if(create && !FileExist(path, IS_FILE)) {
+            int tmp = createVirtualFd(name, cloexec);
+            if(tmp>=0) {
+                create(tmp, cpu, index);
+                lseek(tmp, 0, SEEK_SET);
+            }
+            return tmp;
+        }
     }
-    if(isSysCpuCache(pathname, "coherency_line_size", &cpu, &index) && !FileExist(pathname, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_COHER, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_COHER);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheCoher(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
+    #endif
+    return -1;
+}
+
+EXPORT int32_t my_open(x64emu_t* emu, void* pathname, int32_t flags, uint32_t mode)
+{
+    if(isProcSelf((const char*)pathname, "exe")) {
+        return open(emu->context->fullpath, flags, mode);
     }
-    if(isSysCpuCache(pathname, "size", &cpu, &index) && !FileExist(pathname, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_SIZE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_SIZE);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheAssoc(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
+    int tmp = openVirtual(emu, (const char*)pathname, flags&O_CLOEXEC);
+    if(tmp>=0)
         return tmp;
-    }
-    #endif
     int ret = open(pathname, flags, mode);
     return ret;
 }
@@ -1846,163 +1975,24 @@ EXPORT int32_t my___open(x64emu_t* emu, void* pathname, int32_t flags, uint32_t
 
 EXPORT int32_t my_open64(x64emu_t* emu, void* pathname, int32_t flags, uint32_t mode)
 {
-    if(isProcSelf((const char*)pathname, "cmdline")) {
-        // special case for self command line...
-        #if 0
-        char tmpcmdline[200] = {0};
-        char tmpbuff[100] = {0};
-        sprintf(tmpbuff, "%s/cmdlineXXXXXX", getenv("TMP")?getenv("TMP"):".");
-        int tmp = mkstemp64(tmpbuff);
-        int dummy;
-        if(tmp<0) return open64(pathname, flags, mode);
-        dummy = write(tmp, emu->context->fullpath, strlen(emu->context->fullpath)+1);
-        for (int i=1; i<emu->context->argc; ++i)
-            dummy = write(tmp, emu->context->argv[i], strlen(emu->context->argv[i])+1);
-        lseek64(tmp, 0, SEEK_SET);
-        #else
-        int tmp = shm_open(TMP_CMDLINE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open64(pathname, flags, mode);
-        shm_unlink(TMP_CMDLINE);    // remove the shm file, but it will still exist because it's currently in use
-        int dummy = write(tmp, emu->context->fullpath, strlen(emu->context->fullpath)+1);
-        (void)dummy;
-        for (int i=1; i<emu->context->argc; ++i)
-            if(emu->context->argv[i])
-                dummy = write(tmp, emu->context->argv[i], strlen(emu->context->argv[i])+1);
-        lseek(tmp, 0, SEEK_SET);
-        #endif
-        return tmp;
-    }
     if(isProcSelf((const char*)pathname, "exe")) {
         return open64(emu->context->fullpath, flags, mode);
     }
-    #ifndef NOALIGN
-    if(strcmp((const char*)pathname, "/proc/cpuinfo")==0) {
-        // special case for cpuinfo
-        int tmp = shm_open(TMP_CPUINFO, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open64(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUINFO);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCPUInfoFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
-    }
-    if(box64_maxcpu && (!strcmp(pathname, "/sys/devices/system/cpu/present") || !strcmp(pathname, "/sys/devices/system/cpu/online")) && (getNCpu()>=box64_maxcpu)) {
-        // special case for cpu present (to limit to 64 cores)
-        int tmp = shm_open(TMP_CPUPRESENT, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open64(pathname, mode); // error fallback
-        shm_unlink(TMP_CPUPRESENT);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCPUPresentFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
-    }
-    if(!strcmp((const char*)pathname, "/sys/bus/clocksource/devices/clocksource0/current_clocksource")) {
-        // special case to say tsc as current clocksource
-        int tmp = shm_open(TMP_CLOCKSOURCE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open64(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CLOCKSOURCE);    // remove the shm file, but it will still exist because it's currently in use
-        CreateClocksourceFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
-    }
-    int cpu, index;
-    if(isSysCpuCache(pathname, "ways_of_associativity", &cpu, &index) && !FileExist(pathname, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_ASSOC, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_ASSOC);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheAssoc(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
-    }
-    if(isSysCpuCache(pathname, "coherency_line_size", &cpu, &index) && !FileExist(pathname, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_COHER, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_COHER);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheCoher(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
+    int tmp = openVirtual(emu, (const char*)pathname, flags&O_CLOEXEC);
+    if(tmp>=0)
         return tmp;
-    }
-    if(isSysCpuCache(pathname, "size", &cpu, &index) && !FileExist(pathname, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_SIZE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return open(pathname, flags, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_SIZE);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheAssoc(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return tmp;
-    }
-    #endif
     return open64(pathname, flags, mode);
 }
 
 EXPORT FILE* my_fopen64(x64emu_t* emu, const char* path, const char* mode)
 {
-    if(isProcSelf(path, "maps")) {
-        // special case for self memory map
-        int tmp = shm_open(TMP_MEMMAP, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_MEMMAP);    // remove the shm file, but it will still exist because it's currently in use
-        CreateMemorymapFile(emu->context, tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
+    int tmp = openVirtual(emu, path, strchr(mode, 'e')?1:0);
+    if(tmp>=0) {
+        FILE* f = fdopen(tmp, mode);
+        if(f)
+            return f;
+        close(tmp); // probably a mode not compatible with a read-only fd, use the real file
     }
-    #ifndef NOALIGN
-    if(strcmp(path, "/proc/cpuinfo")==0) {
-        // special case for cpuinfo
-        int tmp = shm_open(TMP_CPUINFO, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_CPUINFO);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCPUInfoFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
-    }
-    if(box64_maxcpu && (!strcmp(path, "/sys/devices/system/cpu/present") || !strcmp(path, "/sys/devices/system/cpu/online")) && (getNCpu()>=box64_maxcpu)) {
-        // special case for cpu present (to limit to 64 cores)
-        int tmp = shm_open(TMP_CPUPRESENT, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_CPUPRESENT);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCPUPresentFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
-    }
-    if(strcmp(path, "/sys/bus/clocksource/devices/clocksource0/current_clocksource")==0) {
-        // special case to say tsc as current clocksource
-        int tmp = shm_open(TMP_CLOCKSOURCE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_CLOCKSOURCE);    // remove the shm file, but it will still exist because it's currently in use
-        CreateClocksourceFile(tmp);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
-    }
-    int cpu, index;
-    if(isSysCpuCache(path, "ways_of_associativity", &cpu, &index) && !FileExist(path, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_ASSOC, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_ASSOC);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheAssoc(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
-    }
-    if(isSysCpuCache(path, "coherency_line_size", &cpu, &index) && !FileExist(path, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_COHER, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_COHER);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheCoher(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
-    }
-    if(isSysCpuCache(path, "size", &cpu, &index) && !FileExist(path, IS_FILE)) {
-        // Create a dummy one
-        int tmp = shm_open(TMP_CPUCACHE_SIZE, O_RDWR | O_CREAT, S_IRWXU);
-        if(tmp<0) return fopen64(path, mode); // error fallback
-        shm_unlink(TMP_CPUCACHE_SIZE);    // remove the shm file, but it will still exist because it's currently in use
-        CreateCpuCacheAssoc(tmp, cpu, index);
-        lseek(tmp, 0, SEEK_SET);
-        return fdopen(tmp, mode);
-    }
-    #endif
     if(isProcSelf(path, "exe")) {
         return fopen64(emu->context->fullpath, mode);
     }
@@ -2150,6 +2140,7 @@ setenv("BOX64_DYNAREC", "0", 1);
 setenv("WINEDEBUG", "+server", 1);
 //setenv("BOX64_DYNAREC", "0", 1);
 }*/
+        if(!x86) ZygoteExec(newargv, envv?envv:environ);
         int ret;
         if(envv)
             ret = execve(newargv[0], (char* const*)newargv, envv);
@@ -2195,6 +2186,8 @@ EXPORT int32_t my_execve(x64emu_t* emu, const char* path, char* const argv[], ch
             newargv[toadd] = path;
         }
         printf_log(LOG_DEBUG, " => execve(\"%s\", %p [\"%s\", \"%s\", \"%s\"...:%d], %p)\n", newargv[0], newargv, newargv[0], (n+toadd-skip_first)?newargv[1]:"", ((n+toadd-skip_first)>1)?newargv[2]:"",n, envp);
+        if(!x86)
+            ZygoteExec(newargv, envp);  // only returns if the zygote didn't take it
         int ret = execve(newargv[0], (char* const*)newargv, envp);
         return ret;
     }
@@ -2216,21 +2209,16 @@ EXPORT int32_t my_execve(x64emu_t* emu, const char* path, char* const argv[], ch
         while(argv[n]) ++n;
         const char** newargv = (const char**)alloca((n+1)*sizeof(char*));
         memcpy(newargv, argv, sizeof(char*)*(n+1));
-        // create a dummy cpuinfo in temp (that will stay there, sorry)
-        const char* tmpdir = GetTmpDir();
-        char template[100] = {0};
-        sprintf(template, "%s/box64cpuinfoXXXXXX", tmpdir);
-        int fd = mkstemp(template);
-        CreateCPUInfoFile(fd);
-        // get back the name
-        char cpuinfo_file[100] = {0};
-        sprintf(template, "/proc/self/fd/%d", fd);
-        int rl = readlink(template, cpuinfo_file, sizeof(cpuinfo_file));
-        close(fd);
-        chmod(cpuinfo_file, 0666);
-        newargv[cpuinfo] = cpuinfo_file;
+        // give it the fake cpuinfo, as an fd that survives the exec
+        int fd = openVirtualFile(emu, VFILE_CPUINFO, 0);
+        char cpuinfo_file[64] = {0};
+        sprintf(cpuinfo_file, "/proc/self/fd/%d", fd);
+        if(fd>=0)
+            newargv[cpuinfo] = cpuinfo_file;
         printf_log(LOG_DEBUG, " => execve(\"%s\", %p [\"%s\", \"%s\", \"%s\"...:%d], %p)\n", path, newargv, newargv[0], newargv[1], newargv[2],n, envp);
         int ret = execve(path, (char* const*)newargv, envp);
+        if(fd>=0)
+            close(fd);
         return ret;
     }
     if(!strcmp(path + strlen(path) - strlen("/cat"), "/cat")
@@ -2241,21 +2229,16 @@ EXPORT int32_t my_execve(x64emu_t* emu, const char* path, char* const argv[], ch
         while(argv[n]) ++n;
         const char** newargv = (const char**)alloca((n+1)*sizeof(char*));
         memcpy(newargv, argv, sizeof(char*)*(n+1));
-        // create a dummy cpuinfo in temp (that will stay there, sorry)
-        const char* tmpdir = GetTmpDir();
-        char template[100] = {0};
-        sprintf(template, "%s/box64cpuinfoXXXXXX", tmpdir);
-        int fd = mkstemp(template);
-        CreateCPUInfoFile(fd);
-        // get back the name
-        char cpuinfo_file[100] = {0};
-        sprintf(template, "/proc/self/fd/%d", fd);
-        int rl = readlink(template, cpuinfo_file, sizeof(cpuinfo_file));
-        close(fd);
-        chmod(cpuinfo_file, 0666);
-        newargv[cpuinfo] = cpuinfo_file;
+        // give it the fake cpuinfo, as an fd that survives the exec
+        int fd = openVirtualFile(emu, VFILE_CPUINFO, 0);
+        char cpuinfo_file[64] = {0};
+        sprintf(cpuinfo_file, "/proc/self/fd/%d", fd);
+        if(fd>=0)
+            newargv[cpuinfo] = cpuinfo_file;
         printf_log(LOG_DEBUG, " => execve(\"%s\", %p [\"%s\", \"%s\", \"%s\"...:%d], %p)\n", path, newargv, newargv[0], newargv[1], newargv[2],n, envp);
         int ret = execve(path, (char* const*)newargv, envp);
+        if(fd>=0)
+            close(fd);
         return ret;
     }
     /*if(!strcmp(path + strlen(path) - strlen("/bwrap"), "/bwrap")) {
@@ -2302,6 +2285,7 @@ EXPORT int32_t my_execvp(x64emu_t* emu, const char* path, char* const argv[])
         if(my_environ!=my_context->envv) envv = my_environ;
         if(my__environ!=my_context->envv) envv = my__environ;
         if(my___environ!=my_context->envv) envv = my___environ;
+        if(!x86) ZygoteExec((const char* const*)newargv, envv?envv:environ);
         int ret;
         if(envv)
             ret = execvpe(newargv[0], newargv, envv);
@@ -2348,6 +2332,7 @@ EXPORT int32_t my_execl(x64emu_t* emu, const char* path)
     if (!(x64 || x86 || script || self)) {
         ret = execv(path, newargv);
     } else {
+        if(!x86) ZygoteExec((const char* const*)newargv, environ);
         ret = execv(newargv[0], newargv);
     }
     box_free(newargv);
@@ -2379,6 +2364,7 @@ EXPORT int32_t my_execle(x64emu_t* emu, const char* path)
         newargv[j++] = getVargN(emu, k+1);
     if(self) newargv[1] = emu->context->fullpath;
     printf_log(LOG_DEBUG, " => execle(\"%s\", %p [\"%s\", \"%s\"...:%d], %p)\n", newargv[0], newargv, newargv[1], i?newargv[2]:"", i, envp);
+    if((x64 || script || self) && !x86) ZygoteExec((const char* const*)newargv, envp);
     int ret = execve(newargv[0], newargv, envp);
     box_free(newargv);
     return ret;
@@ -2412,6 +2398,7 @@ EXPORT int32_t my_execlp(x64emu_t* emu, const char* path)
     if(my_environ!=my_context->envv) envv = my_environ;
     if(my__environ!=my_context->envv) envv = my__environ;
     if(my___environ!=my_context->envv) envv = my___environ;
+    if((x64 || script || self) && !x86) ZygoteExec((const char* const*)newargv, envv?envv:environ);
     int ret;
     if(envv)
         ret = execvpe(newargv[0], newargv, envv);
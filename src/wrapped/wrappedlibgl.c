@@ -68,6 +68,8 @@ static void* find_debug_callback_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFiiuiipp");
+    if(p) return p;
     #define GO(A) if(my_debug_callback_fct_##A == (uintptr_t)fct) return my_debug_callback_##A;
     SUPER()
     #undef GO
@@ -90,6 +92,8 @@ static void* find_egl_debug_callback_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFipippp");
+    if(p) return p;
     #define GO(A) if(my_egl_debug_callback_fct_##A == (uintptr_t)fct) return my_egl_debug_callback_##A;
     SUPER()
     #undef GO
@@ -112,6 +116,8 @@ static void* find_program_callback_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFip");
+    if(p) return p;
     #define GO(A) if(my_program_callback_fct_##A == (uintptr_t)fct) return my_program_callback_##A;
     SUPER()
     #undef GO
@@ -134,6 +140,8 @@ static void* find_set_blob_func_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFplpl");
+    if(p) return p;
     #define GO(A) if(my_set_blob_func_fct_##A == (uintptr_t)fct) return my_set_blob_func_##A;
     SUPER()
     #undef GO
@@ -156,6 +164,8 @@ static void* find_get_blob_func_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "lFplpl");
+    if(p) return p;
     #define GO(A) if(my_get_blob_func_fct_##A == (uintptr_t)fct) return my_get_blob_func_##A;
     SUPER()
     #undef GO
@@ -258,6 +258,8 @@ static void* find_Allocation_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "pFpLLi");
+    if(p) return p;
     #define GO(A) if(my_Allocation_fct_##A == (uintptr_t)fct) return my_Allocation_##A;
     SUPER()
     #undef GO
@@ -280,6 +282,8 @@ static void* find_Reallocation_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "pFppLLi");
+    if(p) return p;
     #define GO(A) if(my_Reallocation_fct_##A == (uintptr_t)fct) return my_Reallocation_##A;
     SUPER()
     #undef GO
@@ -302,6 +306,8 @@ static void* find_Free_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFpp");
+    if(p) return p;
     #define GO(A) if(my_Free_fct_##A == (uintptr_t)fct) return my_Free_##A;
     SUPER()
     #undef GO
@@ -324,6 +330,8 @@ static void* find_InternalAllocNotification_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFpLii");
+    if(p) return p;
     #define GO(A) if(my_InternalAllocNotification_fct_##A == (uintptr_t)fct) return my_InternalAllocNotification_##A;
     SUPER()
     #undef GO
@@ -346,6 +354,8 @@ static void* find_InternalFreeNotification_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "vFpLii");
+    if(p) return p;
     #define GO(A) if(my_InternalFreeNotification_fct_##A == (uintptr_t)fct) return my_InternalFreeNotification_##A;
     SUPER()
     #undef GO
@@ -368,6 +378,8 @@ static void* find_DebugReportCallbackEXT_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "iFiiULippp");
+    if(p) return p;
     #define GO(A) if(my_DebugReportCallbackEXT_fct_##A == (uintptr_t)fct) return my_DebugReportCallbackEXT_##A;
     SUPER()
     #undef GO
@@ -390,6 +402,8 @@ static void* find_DebugUtilsMessengerCallback_Fct(void* fct)
 {
     if(!fct) return fct;
     if(GetNativeFnc((uintptr_t)fct))  return GetNativeFnc((uintptr_t)fct);
+    void* p = GetNativeCallback((uintptr_t)fct, "iFiipp");
+    if(p) return p;
     #define GO(A) if(my_DebugUtilsMessengerCallback_fct_##A == (uintptr_t)fct) return my_DebugUtilsMessengerCallback_##A;
     SUPER()
     #undef GO
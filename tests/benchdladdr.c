@@ -0,0 +1,53 @@
+// Address to symbol benchmark: resolves random addresses inside the program functions with dladdr
+// Under box64, this goes thru FindElfAddress and FindNearestSymbolName
+// Build with `gcc -O2 -rdynamic benchdladdr.c -o benchdladdr -ldl`
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <dlfcn.h>
+
+#define LOOKUPS 200000
+
+// a few hundreds of functions, so there is a decent symbol table to search
+#define F(N)    int __attribute__((noinline)) func##N(int a) { return a*N+(a>>3); }
+#define F4(N)   F(N##0) F(N##1) F(N##2) F(N##3)
+#define F16(N)  F4(N##0) F4(N##1) F4(N##2) F4(N##3)
+#define F64(N)  F16(N##0) F16(N##1) F16(N##2) F16(N##3)
+F64(1) F64(2) F64(3) F64(4) F64(5) F64(6) F64(7) F64(8)
+#undef F
+#define F(N)    (void*)func##N,
+static void* funcs[] = { F64(1) F64(2) F64(3) F64(4) F64(5) F64(6) F64(7) F64(8) };
+#define NFUNCS  (sizeof(funcs)/sizeof(funcs[0]))
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1000000000.;
+}
+
+int main(int argc, char** argv)
+{
+    int lookups = (argc>1)?atoi(argv[1]):LOOKUPS;
+    uint32_t seed = 42;
+    int found = 0, exact = 0;
+    double t = now();
+    for(int i=0; i<lookups; ++i) {
+        seed = seed*1103515245 + 12345;
+        int f = (seed>>16)%NFUNCS;
+        Dl_info info;
+        // address somewhere at the start of the function
+        void* p = (char*)funcs[f] + ((seed>>8)&3);
+        if(dladdr(p, &info) && info.dli_sname) {
+            ++found;
+            if(info.dli_saddr==funcs[f])
+                ++exact;
+        }
+    }
+    t = now()-t;
+    printf("%d lookups in %zu functions: %d found, %d exact\n", lookups, NFUNCS, found, exact);
+    printf("%.3fs, %.0f lookups/s\n", t, (t>0.)?(lookups/t):0.);
+    return 0;
+}
@@ -0,0 +1,509 @@
+// Per-opcode-family micro-benchmarks, to track the quality of the translated code
+// Each kernel is its own function, so BOX64_DYNAREC_SYMSTATS=bench_ can give the native code size of each one
+// Usage: benchkernels [-j] [scale] (-j prints one JSON object per kernel, -q exits at once)
+// Build with `gcc -O2 -fno-tree-loop-distribute-patterns -msse2 -pthread benchkernels.c -o benchkernels`
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <immintrin.h>
+#include <cpuid.h>
+
+#define NOINLINE __attribute__((noinline))
+
+static uint8_t buf1[4096] __attribute__((aligned(64)));
+static uint8_t buf2[4096] __attribute__((aligned(64)));
+static float fbuf[1024] __attribute__((aligned(64)));
+
+// integer ALU, with flags carried from one opcode to the next
+NOINLINE static uint64_t bench_alu(uint64_t n)
+{
+    uint64_t a = 1, b = 3, c = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        __asm__ volatile (
+            "add %1, %0\n\t"
+            "adc $7, %2\n\t"
+            "rol $3, %1\n\t"
+            "sub %2, %0\n\t"
+            "sbb $1, %1\n\t"
+            "xor %0, %2\n\t"
+            "shr $1, %2\n\t"
+            "cmovc %1, %0\n\t"
+            : "+r"(a), "+r"(b), "+r"(c) :: "cc");
+    }
+    return a+b+c;
+}
+
+// byte and word opcodes, carry chains and signed conditions, that need most of the flags
+NOINLINE static uint64_t bench_flags(uint64_t n)
+{
+    uint64_t a = 5, b = 0x81, c = 0, d = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        __asm__ volatile (
+            "addb %b1, %b0\n\t"
+            "sets %b3\n\t"
+            "adcw $3, %w2\n\t"
+            "sbbq %1, %2\n\t"
+            "subw %w2, %w1\n\t"
+            "cmovg %2, %0\n\t"
+            "incb %b1\n\t"
+            "setle %b3\n\t"
+            "cmpb $0x40, %b0\n\t"
+            "cmovle %1, %2\n\t"
+            : "+r"(a), "+r"(b), "+r"(c), "+q"(d) :: "cc");
+    }
+    return a+b+c+d;
+}
+
+// REP string opcodes
+NOINLINE static uint64_t bench_string(uint64_t n)
+{
+    uint64_t r = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        void* d = buf2; const void* s = buf1; uint64_t cnt = 256;
+        __asm__ volatile ("rep movsb" : "+D"(d), "+S"(s), "+c"(cnt) :: "memory");
+        d = buf2+256; cnt = 32;
+        __asm__ volatile ("rep stosq" : "+D"(d), "+c"(cnt) : "a"(i) : "memory");
+        s = buf1; d = buf2; cnt = 256;
+        __asm__ volatile ("repe cmpsb" : "+D"(d), "+S"(s), "+c"(cnt) :: "memory", "cc");
+        r += cnt;
+    }
+    return r;
+}
+
+// large REP string opcodes, as used by the memcpy/memset/strlen of glibc (ERMS) and static binaries
+static uint8_t big1[65536] __attribute__((aligned(64)));
+static uint8_t big2[65536] __attribute__((aligned(64)));
+NOINLINE static uint64_t bench_copybw(uint64_t n)
+{
+    uint64_t r = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        void* d = big2+1; const void* s = big1; uint64_t cnt = sizeof(big1)-1;
+        __asm__ volatile ("rep movsb" : "+D"(d), "+S"(s), "+c"(cnt) :: "memory");
+        d = big1; cnt = sizeof(big1)-1;
+        __asm__ volatile ("rep stosb" : "+D"(d), "+c"(cnt) : "a"(i|1) : "memory");
+        d = big1; cnt = sizeof(big1);
+        __asm__ volatile ("repne scasb" : "+D"(d), "+c"(cnt) : "a"(0) : "memory", "cc");
+        r += cnt;
+    }
+    return r;
+}
+
+// CRC32 and PCLMULQDQ over a large buffer, as in the checksum loops of zlib-ng, ISA-L or the GHASH of OpenSSL
+__attribute__((target("sse4.2"))) NOINLINE static uint64_t bench_crc32(uint64_t n)
+{
+    uint64_t crc = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        const uint64_t* p = (const uint64_t*)big1;
+        for(int j=0; j<(int)(sizeof(big1)/8); ++j)
+            crc = _mm_crc32_u64(crc, p[j]);
+        crc = _mm_crc32_u16(crc, (uint16_t)i);
+        crc = _mm_crc32_u8(crc, (uint8_t)i);
+    }
+    return crc;
+}
+__attribute__((target("pclmul,sse4.1"))) NOINLINE static uint64_t bench_pclmul(uint64_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    const __m128i k = _mm_set_epi64x(0x87ULL, 0xc200000000000000ULL);
+    for(uint64_t i=0; i<n; ++i) {
+        const __m128i* p = (const __m128i*)big1;
+        for(int j=0; j<(int)(sizeof(big1)/16); ++j) {
+            __m128i v = _mm_xor_si128(acc, _mm_load_si128(p+j));
+            acc = _mm_xor_si128(_mm_clmulepi64_si128(v, k, 0x00), _mm_clmulepi64_si128(v, k, 0x11));
+        }
+    }
+    return _mm_extract_epi64(acc, 0)^_mm_extract_epi64(acc, 1);
+}
+
+// SHA-NI: the SHA-256 and SHA-1 compression of a large buffer, as done by OpenSSL or the kernels of Go and Rust crypto crates
+static const uint32_t sha256_k[64] __attribute__((aligned(16))) = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+__attribute__((target("sha,sse4.1"))) NOINLINE static uint64_t bench_sha(uint64_t n)
+{
+    __m128i state0 = _mm_set_epi32(0x6a09e667, 0xbb67ae85, 0x510e527f, 0x9b05688c);
+    __m128i state1 = _mm_set_epi32(0x3c6ef372, 0xa54ff53a, 0x1f83d9ab, 0x5be0cd19);
+    __m128i abcd = _mm_set_epi32(0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476);
+    __m128i e0 = _mm_set_epi32(0xc3d2e1f0, 0, 0, 0);
+    for(uint64_t i=0; i<n; ++i)
+        for(int b=0; b<(int)(sizeof(big1)/64); ++b) {
+            const __m128i* p = (const __m128i*)(big1+b*64);
+            // SHA-256, 64 rounds
+            __m128i m[4] = { _mm_load_si128(p), _mm_load_si128(p+1), _mm_load_si128(p+2), _mm_load_si128(p+3) };
+            __m128i s0 = state0, s1 = state1;
+            for(int r=0; r<16; ++r) {
+                __m128i w = m[r&3];
+                if(r>=4) {
+                    w = _mm_add_epi32(_mm_sha256msg1_epu32(m[r&3], m[(r+1)&3]), _mm_alignr_epi8(m[(r+3)&3], m[(r+2)&3], 4));
+                    w = m[r&3] = _mm_sha256msg2_epu32(w, m[(r+3)&3]);
+                }
+                __m128i k = _mm_add_epi32(w, _mm_load_si128((const __m128i*)sha256_k+r));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, k);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(k, 0x0e));
+            }
+            state0 = _mm_add_epi32(state0, s0);
+            state1 = _mm_add_epi32(state1, s1);
+            // SHA-1, 80 rounds
+            __m128i w0 = _mm_load_si128(p), w1 = _mm_load_si128(p+1), w2 = _mm_load_si128(p+2), w3 = _mm_load_si128(p+3);
+            __m128i a0 = abcd, e = e0, e1;
+            for(int r=0; r<20; ++r) {
+                e1 = abcd;
+                abcd = _mm_sha1rnds4_epu32(abcd, _mm_sha1nexte_epu32(e, w0), 0);
+                e = e1;
+                __m128i t = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w0, w1), w2), w3);
+                w0 = w1; w1 = w2; w2 = w3; w3 = t;
+            }
+            abcd = _mm_add_epi32(abcd, a0);
+            e0 = _mm_sha1nexte_epu32(e, e0);
+        }
+    return _mm_extract_epi64(state0, 0)^_mm_extract_epi64(state1, 1)^_mm_extract_epi64(abcd, 0)^_mm_extract_epi64(e0, 1);
+}
+
+// SSE packed float
+NOINLINE static uint64_t bench_sse(uint64_t n)
+{
+    __m128 acc = _mm_setzero_ps();
+    __m128 m = _mm_set1_ps(1.0001f);
+    for(uint64_t i=0; i<n; ++i)
+        for(int j=0; j<64; j+=4) {
+            __m128 v = _mm_load_ps(fbuf+j);
+            acc = _mm_add_ps(_mm_mul_ps(v, m), acc);
+            acc = _mm_max_ps(acc, _mm_sqrt_ps(v));
+        }
+    float f[4];
+    _mm_storeu_ps(f, acc);
+    return (uint64_t)(f[0]+f[1]+f[2]+f[3]);
+}
+
+// SSE2 packed integer (add/sub/saturation/compare/min/max/logic/mul), meant for the interpreter (BOX64_DYNAREC=0)
+NOINLINE static uint64_t bench_sseint(uint64_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    __m128i acc2 = _mm_set1_epi16(1);
+    for(uint64_t i=0; i<n; ++i)
+        for(int j=0; j<256; j+=16) {
+            __m128i v = _mm_load_si128((__m128i*)(buf1+j));
+            acc = _mm_add_epi8(acc, v);
+            acc = _mm_sub_epi16(acc, _mm_adds_epu8(v, acc));
+            acc = _mm_add_epi32(acc, _mm_cmpeq_epi8(acc, v));
+            acc = _mm_xor_si128(acc, _mm_min_epu8(acc, v));
+            acc2 = _mm_max_epi16(acc2, _mm_subs_epu16(acc, v));
+            acc2 = _mm_and_si128(_mm_mullo_epi16(acc2, v), _mm_cmpgt_epi32(acc, acc2));
+            acc2 = _mm_add_epi64(acc2, acc);
+        }
+    uint64_t r[2];
+    _mm_storeu_si128((__m128i*)r, _mm_xor_si128(acc, acc2));
+    return r[0]^r[1];
+}
+
+// SSE packed float arithmetic and logic, meant for the interpreter (BOX64_DYNAREC=0)
+NOINLINE static uint64_t bench_ssefloat(uint64_t n)
+{
+    __m128 acc = _mm_set1_ps(1.f);
+    __m128 m = _mm_set1_ps(0.999f);
+    __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for(uint64_t i=0; i<n; ++i)
+        for(int j=0; j<64; j+=4) {
+            __m128 v = _mm_load_ps(fbuf+j);
+            acc = _mm_sub_ps(_mm_mul_ps(acc, m), v);
+            acc = _mm_and_ps(acc, mask);
+            acc = _mm_add_ps(_mm_div_ps(acc, _mm_add_ps(v, m)), m);
+        }
+    float f[4];
+    _mm_storeu_ps(f, acc);
+    return (uint64_t)(f[0]+f[1]+f[2]+f[3]);
+}
+
+// PSHUFD and compares, meant for the interpreter (BOX64_DYNAREC=0)
+NOINLINE static uint64_t bench_shuffle(uint64_t n)
+{
+    __m128i acc = _mm_set_epi32(1, 2, 3, 4);
+    for(uint64_t i=0; i<n; ++i)
+        for(int j=0; j<256; j+=16) {
+            __m128i v = _mm_load_si128((__m128i*)(buf1+j));
+            acc = _mm_shuffle_epi32(acc, 0x1b);
+            acc = _mm_add_epi32(acc, _mm_shuffle_epi32(v, 0x39));
+            acc = _mm_sub_epi32(acc, _mm_cmpgt_epi8(v, acc));
+            acc = _mm_xor_si128(acc, _mm_shuffle_epi32(_mm_cmpeq_epi16(acc, v), 0x4e));
+        }
+    uint64_t r[2];
+    _mm_storeu_si128((__m128i*)r, acc);
+    return r[0]^r[1];
+}
+
+// AVX packed float, only run if the CPU (or box64) exposes AVX
+__attribute__((target("avx"))) NOINLINE static uint64_t bench_avx(uint64_t n)
+{
+    __m256 acc = _mm256_setzero_ps();
+    __m256 m = _mm256_set1_ps(1.0001f);
+    for(uint64_t i=0; i<n; ++i)
+        for(int j=0; j<64; j+=8) {
+            __m256 v = _mm256_load_ps(fbuf+j);
+            acc = _mm256_add_ps(_mm256_mul_ps(v, m), acc);
+            acc = _mm256_max_ps(acc, _mm256_sqrt_ps(v));
+        }
+    float f[8];
+    _mm256_storeu_ps(f, acc);
+    return (uint64_t)(f[0]+f[1]+f[2]+f[3]+f[4]+f[5]+f[6]+f[7]);
+}
+
+// x87, using long double
+NOINLINE static uint64_t bench_x87(uint64_t n)
+{
+    long double a = 1.0L, b = 0.5L;
+    for(uint64_t i=0; i<n; ++i) {
+        a = a*1.0000001L + b;
+        b = b/1.0000003L - 0.25L;
+        if(a>1e6L) a *= 0.5L;
+    }
+    return (uint64_t)(a+b);
+}
+
+// x87 transcendental opcodes
+NOINLINE static uint64_t bench_x87trig(uint64_t n)
+{
+    double a = 0.5, r = 0.;
+    for(uint64_t i=0; i<n; ++i) {
+        double s, c, t;
+        __asm__ volatile ("fsin" : "=t"(s) : "0"(a));
+        __asm__ volatile ("fcos" : "=t"(c) : "0"(a));
+        __asm__ volatile ("fpatan" : "=t"(t) : "0"(c), "u"(s) : "st(1)");
+        __asm__ volatile ("fyl2x" : "=t"(s) : "0"(t+1.5), "u"(0.5) : "st(1)");
+        __asm__ volatile ("f2xm1" : "=t"(c) : "0"(s*0.25));
+        __asm__ volatile ("fscale" : "=t"(t) : "0"(c), "u"(3.0));
+        r += t;
+        a += 1e-6;
+    }
+    return (uint64_t)r;
+}
+
+// self-modifying code: patch the immediate of a small function, then call it
+NOINLINE static uint64_t bench_smc(uint64_t n)
+{
+    static uint8_t* code = NULL;
+    if(!code) {
+        code = mmap(NULL, 4096, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if(code==MAP_FAILED) {
+            code = NULL;
+            return 0;
+        }
+        static const uint8_t fnc[] = {0xb8, 0, 0, 0, 0, 0xc3};  // mov eax, imm32 / ret
+        memcpy(code, fnc, sizeof(fnc));
+    }
+    uint64_t r = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        *(volatile uint32_t*)(code+1) = (uint32_t)i;
+        r += ((uint32_t(*)(void))code)();
+    }
+    return r;
+}
+
+// a lot of small functions, called in a scattered order, to stress the iTLB/dTLB with the translated code and the jump table
+#define BIGCODE_N       8192
+#define BIGCODE_STRIDE  256
+NOINLINE static uint64_t bench_bigcode(uint64_t n)
+{
+    static uint8_t* code = NULL;
+    if(!code) {
+        code = mmap(NULL, BIGCODE_N*BIGCODE_STRIDE, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if(code==MAP_FAILED) {
+            code = NULL;
+            return 0;
+        }
+        for(uint32_t i=0; i<BIGCODE_N; ++i) {
+            uint8_t* p = code+i*BIGCODE_STRIDE;
+            *p++ = 0x89; *p++ = 0xf8;                                   // mov eax, edi
+            *p++ = 0x69; *p++ = 0xc0; memcpy(p, &(uint32_t){i*2+1}, 4); p+=4;  // imul eax, eax, imm32
+            *p++ = 0x05; memcpy(p, &i, 4); p+=4;                        // add eax, imm32
+            *p++ = 0xc1; *p++ = 0xc0; *p++ = 5;                         // rol eax, 5
+            *p++ = 0x35; memcpy(p, &(uint32_t){~i}, 4); p+=4;           // xor eax, imm32
+            *p++ = 0xc3;                                                // ret
+        }
+    }
+    uint32_t r = 1;
+    for(uint64_t i=0; i<n; ++i)
+        r = ((uint32_t(*)(uint32_t))(code+((i*7919)&(BIGCODE_N-1))*BIGCODE_STRIDE))(r);
+    return r;
+}
+
+// LOCK'd opcodes
+NOINLINE static uint64_t bench_atomics(uint64_t n)
+{
+    static uint64_t counter = 0;
+    static uint32_t flag = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        __atomic_fetch_add(&counter, 1, __ATOMIC_SEQ_CST);
+        uint32_t expected = i&1;
+        __atomic_compare_exchange_n(&flag, &expected, (i+1)&1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+        __atomic_exchange_n(&flag, i&1, __ATOMIC_SEQ_CST);
+    }
+    return counter+flag;
+}
+
+// LOCK'd access on misaligned counters, split across a 16bytes boundary and a cache line, with a second thread contending
+static uint8_t misal[128] __attribute__((aligned(64)));
+static void* misalign_thread(void* arg)
+{
+    uint64_t n = (uintptr_t)arg;
+    uint32_t* c32 = (uint32_t*)(misal+14);
+    uint64_t* c64 = (uint64_t*)(misal+60);
+    for(uint64_t i=0; i<n; ++i) {
+        __asm__ volatile ("lock addl $1, %0" : "+m"(*c32) :: "memory", "cc");
+        uint64_t one = 1;
+        __asm__ volatile ("lock xaddq %1, %0" : "+m"(*c64), "+r"(one) :: "memory", "cc");
+    }
+    return NULL;
+}
+NOINLINE static uint64_t bench_misalign(uint64_t n)
+{
+    pthread_t t;
+    memset(misal, 0, sizeof(misal));
+    pthread_create(&t, NULL, misalign_thread, (void*)(uintptr_t)n);
+    misalign_thread((void*)(uintptr_t)n);
+    pthread_join(t, NULL);
+    uint32_t c32; uint64_t c64;
+    memcpy(&c32, misal+14, sizeof(c32));
+    memcpy(&c64, misal+60, sizeof(c64));
+    if(c32!=2*(uint32_t)n || c64!=2*n)
+        printf("misalign: lost updates (%u / %lu for %lu)\n", c32, (unsigned long)c64, (unsigned long)(2*n));
+    return c32+c64;
+}
+
+// indirect calls and returns
+NOINLINE static uint64_t fn0(uint64_t a) { return a+1; }
+NOINLINE static uint64_t fn1(uint64_t a) { return a^3; }
+NOINLINE static uint64_t fn2(uint64_t a) { return a*5; }
+NOINLINE static uint64_t fn3(uint64_t a) { return a-7; }
+static uint64_t (*volatile fns[4])(uint64_t) = { fn0, fn1, fn2, fn3 };
+NOINLINE static uint64_t bench_indirect(uint64_t n)
+{
+    uint64_t r = 0;
+    for(uint64_t i=0; i<n; ++i)
+        r = fns[i&3](r);
+    return r;
+}
+
+// process spawn latency: fork and exec this program again, that exits at once
+NOINLINE static uint64_t bench_spawn(uint64_t n)
+{
+    uint64_t r = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        pid_t pid = fork();
+        if(!pid) {
+            execl("/proc/self/exe", "benchkernels", "-q", NULL);
+            _exit(127);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        r += WEXITSTATUS(status);
+    }
+    return r;
+}
+
+// memcpy like loop
+NOINLINE static uint64_t bench_memcpy(uint64_t n)
+{
+    uint64_t r = 0;
+    for(uint64_t i=0; i<n; ++i) {
+        const uint64_t* s = (const uint64_t*)buf1;
+        uint64_t* d = (uint64_t*)buf2;
+        for(int j=0; j<512; ++j)
+            d[j] = s[j];
+        r += d[i&511];
+    }
+    return r;
+}
+
+typedef struct kernel_s {
+    const char* name;
+    uint64_t (*fnc)(uint64_t);
+    uint64_t iterations;    // for scale 1
+    int needs;              // NEED_xxx: only run if the CPU (or box64) exposes it
+} kernel_t;
+#define NEED_AVX    1
+#define NEED_SHA    2
+
+static kernel_t kernels[] = {
+    {"alu",      bench_alu,      20000000, 0},
+    {"flags",    bench_flags,    20000000, 0},
+    {"string",   bench_string,     500000, 0},
+    {"copybw",   bench_copybw,       2000, 0},
+    {"crc32",    bench_crc32,        2000, 0},
+    {"pclmul",   bench_pclmul,       2000, 0},
+    {"sha",      bench_sha,           200, NEED_SHA},
+    {"sse",      bench_sse,       1000000, 0},
+    {"sseint",   bench_sseint,     200000, 0},
+    {"ssefloat", bench_ssefloat,   500000, 0},
+    {"shuffle",  bench_shuffle,    200000, 0},
+    {"avx",      bench_avx,       1000000, NEED_AVX},
+    {"x87",      bench_x87,      10000000, 0},
+    {"x87trig",  bench_x87trig,   2000000, 0},
+    {"smc",      bench_smc,         20000, 0},
+    {"bigcode",  bench_bigcode,   2000000, 0},
+    {"atomics",  bench_atomics,   5000000, 0},
+    {"misalign", bench_misalign,    50000, 0},
+    {"indirect", bench_indirect, 20000000, 0},
+    {"spawn",    bench_spawn,         200, 0},
+    {"memcpy",   bench_memcpy,     500000, 0},
+};
+
+static uint64_t now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+    int json = 0;
+    double scale = 1.;
+    for(int i=1; i<argc; ++i)
+        if(!strcmp(argv[i], "-q"))
+            return 0;
+        else if(!strcmp(argv[i], "-j"))
+            json = 1;
+        else
+            scale = atof(argv[i]);
+    for(int i=0; i<(int)sizeof(buf1); ++i)
+        buf1[i] = i*7;
+    for(int i=0; i<(int)(sizeof(fbuf)/sizeof(fbuf[0])); ++i)
+        fbuf[i] = i*0.5f;
+    __builtin_cpu_init();
+    unsigned int eax, ebx, ecx, edx;
+    int has_sha = __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx&(1<<29));
+    uint64_t check = 0;
+    for(int k=0; k<(int)(sizeof(kernels)/sizeof(kernels[0])); ++k) {
+        kernel_t* kr = &kernels[k];
+        if((kr->needs&NEED_AVX) && !__builtin_cpu_supports("avx"))
+            continue;
+        if((kr->needs&NEED_SHA) && !has_sha)
+            continue;
+        uint64_t n = kr->iterations*scale;
+        if(!n) n = 1;
+        kr->fnc(n/16+1);    // warm up (and translate)
+        uint64_t t = now();
+        check += kr->fnc(n);
+        double ns = (double)(now()-t)/n;
+        if(json)
+            printf("{\"kernel\":\"%s\",\"iterations\":%lu,\"ns_per_iter\":%.3f}\n", kr->name, (unsigned long)n, ns);
+        else
+            printf("%-10s: %10.3f ns/iter (%lu iterations)\n", kr->name, ns, (unsigned long)n);
+    }
+    if(!json)
+        printf("checksum  : %016lx\n", (unsigned long)check);
+    return 0;
+}
@@ -0,0 +1,144 @@
+// String search micro-benchmark for the SSE4.2 PCMPxSTRx opcodes
+// Build with `gcc -O2 -msse4.2 benchstring.c -o benchstring`
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <nmmintrin.h>
+
+#define BUFSIZE (256*1024)
+#define LOOPS   200
+
+static char buf[BUFSIZE+16] __attribute__((aligned(16)));
+static uint16_t wbuf[BUFSIZE/2+8] __attribute__((aligned(16)));
+
+// strcspn like: count chars before one of the set (equal any, implicit length)
+static size_t any_implicit(const char* s, const char* set)
+{
+    __m128i vset = _mm_loadu_si128((const __m128i*)set);
+    size_t i = 0;
+    while(1) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s+i));
+        if(_mm_cmpistrc(vset, v, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ANY))
+            return i + _mm_cmpistri(vset, v, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ANY);
+        if(_mm_cmpistrz(vset, v, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ANY))
+            return i + strlen(s+i);
+        i += 16;
+    }
+}
+
+// JSON like scan: find first char outside of the ranges (ranges, explicit length, negative polarity)
+static size_t range_explicit(const char* s, size_t len)
+{
+    const __m128i ranges = _mm_setr_epi8('a','z', 'A','Z', '0','9', ' ',' ', 0,0,0,0,0,0,0,0);
+    size_t i = 0;
+    while(i<len) {
+        int l = (len-i>16)?16:(int)(len-i);
+        __m128i v = _mm_loadu_si128((const __m128i*)(s+i));
+        int r = _mm_cmpestri(ranges, 8, v, l, _SIDD_UBYTE_OPS|_SIDD_CMP_RANGES|_SIDD_MASKED_NEGATIVE_POLARITY);
+        if(r<16)
+            return i+r;
+        i += 16;
+    }
+    return len;
+}
+
+// strcmp like: first different char (equal each, implicit length, negative polarity)
+static int each_implicit(const char* a, const char* b)
+{
+    size_t i = 0;
+    while(1) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a+i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b+i));
+        if(_mm_cmpistrc(va, vb, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_EACH|_SIDD_NEGATIVE_POLARITY)) {
+            int idx = _mm_cmpistri(va, vb, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_EACH|_SIDD_NEGATIVE_POLARITY);
+            return (unsigned char)a[i+idx] - (unsigned char)b[i+idx];
+        }
+        if(_mm_cmpistrz(va, vb, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_EACH))
+            return 0;
+        i += 16;
+    }
+}
+
+// strstr like: (equal ordered, implicit length), needle is at most 16 chars
+static const char* ordered_implicit(const char* s, const char* needle)
+{
+    __m128i vn = _mm_loadu_si128((const __m128i*)needle);
+    size_t nlen = strlen(needle);
+    size_t i = 0;
+    while(1) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s+i));
+        if(_mm_cmpistrc(vn, v, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ORDERED)) {
+            int idx = _mm_cmpistri(vn, v, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ORDERED);
+            if(!strncmp(s+i+idx, needle, nlen))
+                return s+i+idx;
+            i += idx+1;
+        } else {
+            if(_mm_cmpistrz(vn, v, _SIDD_UBYTE_OPS|_SIDD_CMP_EQUAL_ORDERED))
+                return NULL;
+            i += 16;
+        }
+    }
+}
+
+// wide chars: mask of matching chars (equal any, words, explicit length, mask output)
+static uint64_t any_words_mask(const uint16_t* s, size_t len)
+{
+    const __m128i set = _mm_setr_epi16('<', '>', '&', '"', 0, 0, 0, 0);
+    uint64_t r = 0;
+    for(size_t i=0; i<len; i+=8) {
+        __m128i v = _mm_load_si128((const __m128i*)(s+i));
+        __m128i m = _mm_cmpestrm(set, 4, v, 8, _SIDD_UWORD_OPS|_SIDD_CMP_EQUAL_ANY|_SIDD_BIT_MASK);
+        r += __builtin_popcount(_mm_cvtsi128_si32(m));
+    }
+    return r;
+}
+
+static double elapsed(clock_t start)
+{
+    return (double)(clock()-start)/CLOCKS_PER_SEC;
+}
+
+int main(int argc, char** argv)
+{
+    int loops = (argc>1)?atoi(argv[1]):LOOPS;
+    // fill the buffer with some text-like content
+    uint32_t seed = 42;
+    for(int i=0; i<BUFSIZE; ++i) {
+        seed = seed*1103515245 + 12345;
+        int c = (seed>>16)%64;
+        buf[i] = (c<26)?('a'+c):((c<52)?('A'+c-26):((c<62)?('0'+c-52):' '));
+    }
+    strcpy(buf+BUFSIZE-32, "needle{in}haystack");
+    buf[BUFSIZE] = 0;
+    for(int i=0; i<BUFSIZE/2; ++i)
+        wbuf[i] = buf[i*2]=='Z'?'<':buf[i*2];
+    char* copy = malloc(BUFSIZE+16);
+    memcpy(copy, buf, BUFSIZE+16);
+    copy[BUFSIZE-100] = '!';
+
+    clock_t t;
+    size_t r1 = 0, r2 = 0;
+    int r3 = 0;
+    uint64_t r5 = 0;
+    const char* r4 = NULL;
+
+    t = clock();
+    for(int l=0; l<loops; ++l) r1 += any_implicit(buf, "{}[]\"");
+    printf("equal any      (strcspn) : %zu\t%.3fs\n", r1, elapsed(t));
+    t = clock();
+    for(int l=0; l<loops; ++l) r2 += range_explicit(buf, BUFSIZE);
+    printf("ranges         (json)    : %zu\t%.3fs\n", r2, elapsed(t));
+    t = clock();
+    for(int l=0; l<loops; ++l) r3 += each_implicit(buf, copy);
+    printf("equal each     (strcmp)  : %d\t%.3fs\n", r3, elapsed(t));
+    t = clock();
+    for(int l=0; l<loops; ++l) r4 = ordered_implicit(buf, "haystack");
+    printf("equal ordered  (strstr)  : %td\t%.3fs\n", r4?(r4-buf):-1, elapsed(t));
+    t = clock();
+    for(int l=0; l<loops; ++l) r5 += any_words_mask(wbuf, BUFSIZE/2);
+    printf("equal any word (mask)    : %lu\t%.3fs\n", (unsigned long)r5, elapsed(t));
+    free(copy);
+    return 0;
+}
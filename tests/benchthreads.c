@@ -0,0 +1,58 @@
+// Thread creation benchmark: create and join a lot of short lived threads
+// Build with `gcc -O2 benchthreads.c -o benchthreads -pthread`
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#define NTHREADS    20000
+#define BATCH       8
+
+static __thread uint64_t tls_counter = 0;
+
+static void* worker(void* arg)
+{
+    uint64_t v = (uintptr_t)arg;
+    tls_counter += v;   // touch the TLS
+    return (void*)(uintptr_t)(tls_counter*3);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1000000000.;
+}
+
+int main(int argc, char** argv)
+{
+    int n = (argc>1)?atoi(argv[1]):NTHREADS;
+    uint64_t sum = 0;
+    pthread_t th[BATCH];
+    // one at a time
+    double t = now();
+    for(int i=0; i<n; ++i) {
+        void* r;
+        pthread_create(&th[0], NULL, worker, (void*)(uintptr_t)i);
+        pthread_join(th[0], &r);
+        sum += (uintptr_t)r;
+    }
+    double t1 = now()-t;
+    // a few at a time
+    t = now();
+    for(int i=0; i<n; i+=BATCH) {
+        for(int j=0; j<BATCH; ++j)
+            pthread_create(&th[j], NULL, worker, (void*)(uintptr_t)(i+j));
+        for(int j=0; j<BATCH; ++j) {
+            void* r;
+            pthread_join(th[j], &r);
+            sum += (uintptr_t)r;
+        }
+    }
+    double t2 = now()-t;
+    printf("%d threads: checksum %lu\n", n, (unsigned long)sum);
+    printf("create/join 1 by 1 : %.3fs, %.0f threads/s\n", t1, n/t1);
+    printf("create/join by %d   : %.3fs, %.0f threads/s\n", BATCH, t2, n/t2);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Translation throughput benchmark: generates a lot of x86_64 code and runs each function once
+// so most of the time under box64 is spent creating dynarec blocks. Use with BOX64_DYNAREC_LOG=1 to get the stats
+// Build with `gcc -O2 benchtranslate.c -o benchtranslate`
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define NFUNCS  2048
+#define NOPS    128
+#define FUNCSZ  (NOPS*8+16)
+
+typedef uint64_t (*func_t)(uint64_t, uint64_t);
+
+static uint32_t seed = 42;
+static uint32_t rnd(void)
+{
+    seed = seed*1103515245 + 12345;
+    return seed>>16;
+}
+
+// emit a function computing some mix of rdi/rsi, with a few short forward jumps
+static int gen_func(uint8_t* p)
+{
+    uint8_t* s = p;
+    *p++ = 0x48; *p++ = 0x89; *p++ = 0xF8;   // mov rax, rdi
+    *p++ = 0x48; *p++ = 0x89; *p++ = 0xF1;   // mov rcx, rsi
+    for(int i=0; i<NOPS; ++i) {
+        uint8_t imm = rnd();
+        switch(rnd()%8) {
+            case 0: *p++ = 0x48; *p++ = 0x05; memcpy(p, &(uint32_t){rnd()}, 4); p+=4; break; // add rax, imm32
+            case 1: *p++ = 0x48; *p++ = 0x31; *p++ = 0xC8; break;              // xor rax, rcx
+            case 2: *p++ = 0x48; *p++ = 0x6B; *p++ = 0xC0; *p++ = imm|1; break; // imul rax, rax, imm8
+            case 3: *p++ = 0x48; *p++ = 0x8D; *p++ = 0x4C; *p++ = 0x48; *p++ = imm; break; // lea rcx, [rax+rcx*2+imm8]
+            case 4: *p++ = 0x48; *p++ = 0xC1; *p++ = 0xC0; *p++ = imm&63; break; // rol rax, imm8
+            case 5: *p++ = 0x48; *p++ = 0x89; *p++ = 0xC2; *p++ = 0x48; *p++ = 0x29; *p++ = 0xD1; break; // mov rdx, rax; sub rcx, rdx
+            case 6: *p++ = 0xA8; *p++ = imm; *p++ = 0x74; *p++ = 0x03; *p++ = 0x48; *p++ = 0xFF; *p++ = 0xC1; break; // test al, imm8; jz +3; inc rcx
+            case 7: *p++ = 0x48; *p++ = 0x39; *p++ = 0xC8; *p++ = 0x48; *p++ = 0x0F; *p++ = 0x42; *p++ = 0xC1; break; // cmp rax, rcx; cmovb rax, rcx
+        }
+    }
+    *p++ = 0x48; *p++ = 0x01; *p++ = 0xC8;   // add rax, rcx
+    *p++ = 0xC3;                             // ret
+    return p-s;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec/1000000000.;
+}
+
+int main(int argc, char** argv)
+{
+    int nfuncs = (argc>1)?atoi(argv[1]):NFUNCS;
+    uint8_t* code = mmap(NULL, (size_t)nfuncs*FUNCSZ, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(code==MAP_FAILED) {
+        printf("Cannot allocate code buffer\n");
+        return 1;
+    }
+    size_t total = 0;
+    for(int i=0; i<nfuncs; ++i)
+        total += gen_func(code+(size_t)i*FUNCSZ);
+    uint64_t r = 0;
+    // 1st run: translation + execution
+    double t = now();
+    for(int i=0; i<nfuncs; ++i)
+        r += ((func_t)(code+(size_t)i*FUNCSZ))(i, r);
+    double first = now()-t;
+    // 2nd run: execution only
+    t = now();
+    for(int i=0; i<nfuncs; ++i)
+        r += ((func_t)(code+(size_t)i*FUNCSZ))(i, r);
+    double second = now()-t;
+    double tr = first-second;
+    printf("%d functions, %zu bytes of code: checksum %016lx\n", nfuncs, total, (unsigned long)r);
+    printf("first run  : %.3fs\n", first);
+    printf("second run : %.3fs\n", second);
+    printf("translation: %.2f MB/s\n", (tr>0.)?(total/tr/(1024.*1024.)):0.);
+    munmap(code, (size_t)nfuncs*FUNCSZ);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <search.h>
+// Build with `gcc -O0 test31.c -o test31`
+// Use a lot of different comparison callbacks, more than the fixed slots of the wrapped libc
+
+#define N 64
+
+static int data[N];
+
+#define CMP(A)                                              \
+static int cmp##A(const void* a, const void* b)             \
+{                                                           \
+    int x = *(const int*)a, y = *(const int*)b;             \
+    return (x%(A+2)) - (y%(A+2));                           \
+}
+
+#define ALL()   \
+GO(0)  GO(1)  GO(2)  GO(3)  GO(4)  GO(5)  GO(6)  GO(7)  \
+GO(8)  GO(9)  GO(10) GO(11) GO(12) GO(13) GO(14) GO(15) \
+GO(16) GO(17) GO(18) GO(19) GO(20) GO(21) GO(22) GO(23)
+
+#define GO(A) CMP(A)
+ALL()
+#undef GO
+
+typedef int(*cmp_t)(const void*, const void*);
+static cmp_t cmps[] = {
+#define GO(A) cmp##A,
+ALL()
+#undef GO
+};
+
+static int cmp_val(const void* a, const void* b)
+{
+    return *(const int*)a - *(const int*)b;
+}
+
+int main(int argc, char** argv)
+{
+    for(int i=0; i<N; ++i)
+        data[i] = i*3;
+    int sum = 0;
+    for(int j=0; j<2; ++j)
+        for(int i=0; i<(int)(sizeof(cmps)/sizeof(cmps[0])); ++i) {
+            int key = 100+i;
+            size_t n = N;
+            int* p = lfind(&key, data, &n, sizeof(int), cmps[i]);
+            if(p) sum += *p;
+            if(!j) printf("cmp%d: %d\n", i, p?*p:-1);
+        }
+    int key = 42;
+    int* p = bsearch(&key, data, N, sizeof(int), cmp_val);
+    printf("bsearch: %d\n", p?(int)(p-data):-1);
+    key = 43;
+    p = bsearch(&key, data, N, sizeof(int), cmp_val);
+    printf("bsearch: %d\n", p?(int)(p-data):-1);
+    printf("sum: %d\n", sum);
+    return 0;
+}